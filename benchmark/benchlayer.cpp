@@ -0,0 +1,605 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <algorithm>
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "cpu.h"
+#include "layer.h"
+#include "modelbin.h"
+#include "paramdict.h"
+
+#include "testutil.h"
+
+// generate random weights of whatever size the layer asks for
+class ModelBinFromRandom : public ncnn::ModelBin
+{
+public:
+    ModelBinFromRandom()
+        : bytes(0)
+    {
+    }
+
+    virtual ncnn::Mat load(int w, int /*type*/) const
+    {
+        // positive values keep int8 scales and norm factors valid
+        ncnn::Mat m = RandomMat(w, 0.01f, 1.2f);
+        bytes += m.total() * m.elemsize;
+        return m;
+    }
+
+public:
+    mutable size_t bytes;
+};
+
+struct BenchResult
+{
+    int ret;
+    double time_min;
+    double time_median;
+    double time_avg;
+    double flops;
+    double bytes;
+    std::string in_elempack;
+    std::string out_elempack;
+};
+
+static int g_warmup_loop_count = 4;
+static int g_loop_count = 10;
+
+static std::vector<int> parse_int_list(const char* s)
+{
+    std::vector<int> v;
+    while (*s)
+    {
+        v.push_back(atoi(s));
+        const char* comma = strchr(s, ',');
+        if (!comma)
+            break;
+        s = comma + 1;
+    }
+    return v;
+}
+
+static std::vector<std::string> parse_string_list(const char* s)
+{
+    std::vector<std::string> v;
+    while (*s)
+    {
+        const char* comma = strchr(s, ',');
+        if (!comma)
+        {
+            v.push_back(std::string(s));
+            break;
+        }
+        v.push_back(std::string(s, comma - s));
+        s = comma + 1;
+    }
+    return v;
+}
+
+// same syntax as a layer line in ncnn param file, like  0=64 1=3 4=1 -23310=2,1.5,2.5
+static int parse_param(const char* s, ncnn::ParamDict& pd)
+{
+    std::vector<std::string> tokens;
+    {
+        std::string str(s);
+        size_t i = 0;
+        while (i < str.size())
+        {
+            while (i < str.size() && str[i] == ' ')
+                i++;
+            size_t j = i;
+            while (j < str.size() && str[j] != ' ')
+                j++;
+            if (j > i)
+                tokens.push_back(str.substr(i, j - i));
+            i = j;
+        }
+    }
+
+    for (size_t i = 0; i < tokens.size(); i++)
+    {
+        const std::string& t = tokens[i];
+        size_t eq = t.find('=');
+        if (eq == std::string::npos)
+        {
+            fprintf(stderr, "invalid param %s\n", t.c_str());
+            return -1;
+        }
+
+        int id = atoi(t.substr(0, eq).c_str());
+        std::string value = t.substr(eq + 1);
+
+        bool is_float = value.find_first_of(".eE") != std::string::npos;
+
+        if (id <= -23300)
+        {
+            // array  count,v0,v1,...
+            id = -id - 23300;
+
+            std::vector<std::string> elems = parse_string_list(value.c_str());
+            if (elems.empty())
+                return -1;
+
+            int len = atoi(elems[0].c_str());
+            if (len != (int)elems.size() - 1)
+            {
+                fprintf(stderr, "array param %d length mismatch\n", id);
+                return -1;
+            }
+
+            ncnn::Mat v(len);
+            for (int j = 0; j < len; j++)
+            {
+                if (is_float)
+                    v[j] = (float)atof(elems[j + 1].c_str());
+                else
+                    ((int*)v)[j] = atoi(elems[j + 1].c_str());
+            }
+            pd.set(id, v);
+        }
+        else if (is_float)
+        {
+            pd.set(id, (float)atof(value.c_str()));
+        }
+        else
+        {
+            pd.set(id, atoi(value.c_str()));
+        }
+    }
+
+    return 0;
+}
+
+static std::vector<ncnn::Mat> parse_shape_list(const char* s)
+{
+    std::vector<ncnn::Mat> mats;
+
+    // [w,h,c],[w,h,c]
+    std::vector<std::string> shapes;
+    {
+        std::string str(s);
+        size_t i = 0;
+        while ((i = str.find('[', i)) != std::string::npos)
+        {
+            size_t j = str.find(']', i);
+            if (j == std::string::npos)
+                break;
+            shapes.push_back(str.substr(i + 1, j - i - 1));
+            i = j + 1;
+        }
+    }
+
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        std::vector<int> shape = parse_int_list(shapes[i].c_str());
+        switch (shape.size())
+        {
+        case 4:
+            mats.push_back(RandomMat(shape[0], shape[1], shape[2], shape[3]));
+            break;
+        case 3:
+            mats.push_back(RandomMat(shape[0], shape[1], shape[2]));
+            break;
+        case 2:
+            mats.push_back(RandomMat(shape[0], shape[1]));
+            break;
+        case 1:
+            mats.push_back(RandomMat(shape[0]));
+            break;
+        default:
+            fprintf(stderr, "unsupported input shape size %d\n", (int)shape.size());
+            break;
+        }
+    }
+
+    return mats;
+}
+
+static std::string shape_string(const ncnn::Mat& m)
+{
+    char tmp[64];
+    if (m.dims == 1) sprintf(tmp, "[%d]", m.w);
+    if (m.dims == 2) sprintf(tmp, "[%d,%d]", m.w, m.h);
+    if (m.dims == 3) sprintf(tmp, "[%d,%d,%d]", m.w, m.h, m.c);
+    if (m.dims == 4) sprintf(tmp, "[%d,%d,%d,%d]", m.w, m.h, m.d, m.c);
+    return std::string(tmp);
+}
+
+static double mat_bytes(const ncnn::Mat& m)
+{
+    return (double)m.w * m.h * m.d * m.c * m.elemsize;
+}
+
+static double mat_elemcount(const ncnn::Mat& m)
+{
+    return (double)m.w * m.h * m.d * m.c * m.elempack;
+}
+
+// multiply-add counts as two flops, other layers count one op per output element
+static double estimate_flops(const std::string& type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& a, const std::vector<ncnn::Mat>& c)
+{
+    const double outsize = c.empty() ? 0.0 : mat_elemcount(c[0]);
+
+    if (type == "Convolution" || type == "ConvolutionDepthWise" || type == "Convolution1D" || type == "ConvolutionDepthWise1D"
+            || type == "Convolution3D" || type == "ConvolutionDepthWise3D" || type == "InnerProduct")
+    {
+        const int num_output = pd.get(0, 0);
+        const double weight_data_size = pd.get(6, 0);
+        if (num_output == 0)
+            return outsize;
+
+        // every output element consumes weight_data_size / num_output weights
+        return 2.0 * outsize * weight_data_size / num_output;
+    }
+
+    if (type == "MatMul" && a.size() == 2)
+    {
+        // A is [K,M], K is its innermost dim
+        return 2.0 * outsize * a[0].w;
+    }
+
+    if (type == "Gemm")
+    {
+        const int transA = pd.get(2, 0);
+        int K = pd.get(9, 0);
+        if (K == 0 && !a.empty())
+            K = transA ? a[0].h : a[0].w;
+        return 2.0 * outsize * K;
+    }
+
+    return outsize;
+}
+
+static void set_precision(ncnn::Option& opt, const std::string& precision)
+{
+    opt.use_fp16_packed = false;
+    opt.use_fp16_storage = false;
+    opt.use_fp16_arithmetic = false;
+    opt.use_bf16_storage = false;
+    opt.use_int8_inference = true;
+
+    if (precision == "fp16")
+    {
+        opt.use_fp16_packed = true;
+        opt.use_fp16_storage = true;
+        opt.use_fp16_arithmetic = true;
+    }
+    if (precision == "bf16")
+    {
+        opt.use_bf16_storage = true;
+    }
+}
+
+static BenchResult bench_layer(const std::string& type, const ncnn::ParamDict& _pd, const std::vector<ncnn::Mat>& a, int top_blob_count, const ncnn::Option& _opt, const std::string& precision, bool naive)
+{
+    BenchResult r;
+    r.ret = 233;
+    r.time_min = 0;
+    r.time_median = 0;
+    r.time_avg = 0;
+    r.flops = 0;
+    r.bytes = 0;
+
+    const int typeindex = ncnn::layer_to_index(type.c_str());
+
+    ncnn::ParamDict pd = _pd;
+    if (precision == "int8")
+    {
+        // int8_scale_term
+        if (type == "Convolution" || type == "ConvolutionDepthWise" || type == "InnerProduct")
+        {
+            if (pd.get(8, 0) == 0)
+                pd.set(8, 1);
+        }
+        else
+        {
+            return r;
+        }
+    }
+
+    ncnn::Option opt = _opt;
+    set_precision(opt, precision);
+    if (naive)
+    {
+        opt.use_packing_layout = false;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_storage = false;
+    }
+
+    ncnn::Layer* op = naive ? ncnn::create_layer_naive(typeindex) : ncnn::create_layer_cpu(typeindex);
+    if (!op)
+    {
+        r.ret = -1;
+        return r;
+    }
+
+    op->load_param(pd);
+
+    if (op->one_blob_only && a.size() != 1)
+    {
+        fprintf(stderr, "layer with one_blob_only but consume multiple inputs\n");
+        delete op;
+        r.ret = -1;
+        return r;
+    }
+
+    ModelBinFromRandom mb;
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    // same skipping rules as test_layer_cpu
+    if ((!op->support_packing && opt.use_packing_layout) || (!op->support_bf16_storage && !op->support_fp16_storage && (opt.use_bf16_storage || opt.use_fp16_arithmetic)))
+    {
+        op->destroy_pipeline(opt);
+        delete op;
+        return r;
+    }
+
+    std::vector<ncnn::Mat> a4(a.size());
+    for (size_t i = 0; i < a4.size(); i++)
+    {
+        convert_to_optimal_layout(a[i], a4[i], opt, op, 0);
+    }
+
+    std::vector<double> times;
+
+    std::vector<ncnn::Mat> c;
+    for (int i = 0; i < g_warmup_loop_count + g_loop_count; i++)
+    {
+        c.clear();
+        c.resize(top_blob_count);
+
+        if (op->support_inplace)
+        {
+            for (size_t j = 0; j < a4.size(); j++)
+            {
+                c[j] = a4[j].clone();
+            }
+        }
+
+        double start = ncnn::get_current_time();
+
+        int ret = op->support_inplace ? op->forward_inplace(c, opt) : op->forward(a4, c, opt);
+
+        double end = ncnn::get_current_time();
+
+        if (ret != 0)
+        {
+            op->destroy_pipeline(opt);
+            delete op;
+            r.ret = ret;
+            return r;
+        }
+
+        if (i >= g_warmup_loop_count)
+            times.push_back(end - start);
+    }
+
+    for (size_t i = 0; i < a4.size(); i++)
+    {
+        char tmp[16];
+        sprintf(tmp, "%s%d", i == 0 ? "" : ",", a4[i].elempack);
+        r.in_elempack += tmp;
+        r.bytes += mat_bytes(a4[i]);
+    }
+    for (size_t i = 0; i < c.size(); i++)
+    {
+        char tmp[16];
+        sprintf(tmp, "%s%d", i == 0 ? "" : ",", c[i].elempack);
+        r.out_elempack += tmp;
+        r.bytes += mat_bytes(c[i]);
+    }
+    r.bytes += mb.bytes;
+
+    r.flops = estimate_flops(type, pd, a, c);
+
+    std::sort(times.begin(), times.end());
+    r.time_min = times.front();
+    r.time_median = times[times.size() / 2];
+    r.time_avg = 0;
+    for (size_t i = 0; i < times.size(); i++)
+        r.time_avg += times[i];
+    r.time_avg /= times.size();
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    r.ret = 0;
+    return r;
+}
+
+static void show_usage()
+{
+    fprintf(stderr, "Usage: benchlayer type=<layer type> shape=[w,h,c],... [(key=value)...]\n");
+    fprintf(stderr, "  param=\"0=64 1=3 4=1 6=36864\"   layer params in ncnn param syntax\n");
+    fprintf(stderr, "  outputs=1                      top blob count\n");
+    fprintf(stderr, "  threads=1,2,4                  thread counts to sweep\n");
+    fprintf(stderr, "  precision=fp32,fp16,bf16,int8  precisions to sweep\n");
+    fprintf(stderr, "  packing=0,1                    use_packing_layout values to sweep\n");
+    fprintf(stderr, "  impl=naive,cpu                 reference layer and/or arch optimized layer\n");
+    fprintf(stderr, "  loop=10 warmup=4\n");
+    fprintf(stderr, "  powersave=0\n");
+    fprintf(stderr, "  format=table|csv|json\n");
+}
+
+int main(int argc, char** argv)
+{
+    std::string type;
+    std::string param;
+    std::vector<ncnn::Mat> inputs;
+    int top_blob_count = 1;
+    std::vector<int> threads(1, ncnn::get_physical_big_cpu_count());
+    std::vector<std::string> precisions(1, "fp32");
+    std::vector<int> packings(1, 1);
+    std::vector<std::string> impls(1, "cpu");
+    int powersave = 0;
+    std::string format = "table";
+
+    SRAND(7767517);
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0)
+        {
+            show_usage();
+            return -1;
+        }
+
+        // key=value
+        char* kv = argv[i];
+
+        char* eqs = strchr(kv, '=');
+        if (eqs == NULL)
+        {
+            fprintf(stderr, "unrecognized arg %s\n", kv);
+            continue;
+        }
+
+        // split k v
+        eqs[0] = '\0';
+        const char* key = kv;
+        const char* value = eqs + 1;
+
+        if (strcmp(key, "type") == 0)
+            type = value;
+        else if (strcmp(key, "param") == 0)
+            param = value;
+        else if (strcmp(key, "shape") == 0)
+            inputs = parse_shape_list(value);
+        else if (strcmp(key, "outputs") == 0)
+            top_blob_count = atoi(value);
+        else if (strcmp(key, "threads") == 0)
+            threads = parse_int_list(value);
+        else if (strcmp(key, "precision") == 0)
+            precisions = parse_string_list(value);
+        else if (strcmp(key, "packing") == 0)
+            packings = parse_int_list(value);
+        else if (strcmp(key, "impl") == 0)
+            impls = parse_string_list(value);
+        else if (strcmp(key, "loop") == 0)
+            g_loop_count = std::max(atoi(value), 1);
+        else if (strcmp(key, "warmup") == 0)
+            g_warmup_loop_count = std::max(atoi(value), 0);
+        else if (strcmp(key, "powersave") == 0)
+            powersave = atoi(value);
+        else if (strcmp(key, "format") == 0)
+            format = value;
+        else
+            fprintf(stderr, "unrecognized key %s\n", key);
+    }
+
+    if (type.empty() || inputs.empty())
+    {
+        show_usage();
+        return -1;
+    }
+
+    if (ncnn::layer_to_index(type.c_str()) == -1)
+    {
+        fprintf(stderr, "layer type %s not exists or not registered\n", type.c_str());
+        return -1;
+    }
+
+    ncnn::ParamDict pd;
+    if (parse_param(param.c_str(), pd) != 0)
+        return -1;
+
+    ncnn::set_cpu_powersave(powersave);
+    ncnn::set_omp_dynamic(0);
+
+    std::string shapes;
+    for (size_t i = 0; i < inputs.size(); i++)
+    {
+        shapes += shape_string(inputs[i]);
+    }
+
+    if (format == "table")
+    {
+        fprintf(stderr, "%s %s %s\n", type.c_str(), param.c_str(), shapes.c_str());
+        fprintf(stderr, "%6s %7s %7s %7s %10s %10s %10s %9s %9s\n", "impl", "prec", "threads", "pack", "min", "median", "avg", "GFLOPS", "GB/s");
+    }
+    if (format == "csv")
+    {
+        fprintf(stdout, "type,param,shape,impl,precision,threads,packing,in_elempack,out_elempack,min_ms,median_ms,avg_ms,gflops,gbps\n");
+    }
+    if (format == "json")
+    {
+        fprintf(stdout, "[\n");
+    }
+
+    bool first_row = true;
+
+    for (size_t ii = 0; ii < impls.size(); ii++)
+    {
+        const bool naive = impls[ii] == "naive";
+
+        for (size_t pi = 0; pi < precisions.size(); pi++)
+        {
+            for (size_t ki = 0; ki < packings.size(); ki++)
+            {
+                for (size_t ti = 0; ti < threads.size(); ti++)
+                {
+                    const int num_threads = threads[ti];
+
+                    ncnn::set_omp_num_threads(num_threads);
+
+                    ncnn::Option opt;
+                    opt.lightmode = false;
+                    opt.num_threads = num_threads;
+                    opt.use_packing_layout = packings[ki] != 0;
+
+                    BenchResult r = bench_layer(type, pd, inputs, top_blob_count, opt, precisions[pi], naive);
+
+                    if (r.ret == 233)
+                    {
+                        if (format == "table")
+                            fprintf(stderr, "%6s %7s %7d %7d  skipped (not supported)\n", impls[ii].c_str(), precisions[pi].c_str(), num_threads, packings[ki]);
+                        continue;
+                    }
+                    if (r.ret != 0)
+                    {
+                        fprintf(stderr, "benchmark %s failed %d\n", type.c_str(), r.ret);
+                        continue;
+                    }
+
+                    // flops per ms to GFLOPS and bytes per ms to GB/s
+                    const double gflops = r.flops / r.time_min / 1e6;
+                    const double gbps = r.bytes / r.time_min / 1e6;
+
+                    if (format == "table")
+                    {
+                        fprintf(stderr, "%6s %7s %7d %7s %10.4f %10.4f %10.4f %9.2f %9.2f\n", impls[ii].c_str(), precisions[pi].c_str(), num_threads, r.in_elempack.c_str(), r.time_min, r.time_median, r.time_avg, gflops, gbps);
+                    }
+                    if (format == "csv")
+                    {
+                        fprintf(stdout, "%s,\"%s\",\"%s\",%s,%s,%d,%d,\"%s\",\"%s\",%.6f,%.6f,%.6f,%.4f,%.4f\n", type.c_str(), param.c_str(), shapes.c_str(), impls[ii].c_str(), precisions[pi].c_str(), num_threads, packings[ki], r.in_elempack.c_str(), r.out_elempack.c_str(), r.time_min, r.time_median, r.time_avg, gflops, gbps);
+                    }
+                    if (format == "json")
+                    {
+                        fprintf(stdout, "%s  {\"type\": \"%s\", \"param\": \"%s\", \"shape\": \"%s\", \"impl\": \"%s\", \"precision\": \"%s\", \"threads\": %d, \"packing\": %d, \"in_elempack\": \"%s\", \"out_elempack\": \"%s\", \"min_ms\": %.6f, \"median_ms\": %.6f, \"avg_ms\": %.6f, \"gflops\": %.4f, \"gbps\": %.4f}", first_row ? "" : ",\n", type.c_str(), param.c_str(), shapes.c_str(), impls[ii].c_str(), precisions[pi].c_str(), num_threads, packings[ki], r.in_elempack.c_str(), r.out_elempack.c_str(), r.time_min, r.time_median, r.time_avg, gflops, gbps);
+                    }
+
+                    first_row = false;
+                }
+            }
+        }
+    }
+
+    if (format == "json")
+    {
+        fprintf(stdout, "\n]\n");
+    }
+
+    return 0;
+}
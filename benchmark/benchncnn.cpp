@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause
 
 #include <float.h>
+#include <math.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -12,10 +13,14 @@
 #include "benchmark.h"
 #include "cpu.h"
 #include "datareader.h"
+#include "extractorpool.h"
 #include "net.h"
 #include "gpu.h"
+#include "platform.h"
 
 #ifndef NCNN_SIMPLESTL
+#include <algorithm>
+#include <functional>
 #include <vector>
 #endif
 
@@ -36,41 +41,229 @@ public:
 static int g_warmup_loop_count = 8;
 static int g_loop_count = 4;
 static bool g_enable_cooling_down = true;
+static int g_cooling_down_ms = 10 * 1000;
+
+// adaptive loop count, used when loop count is 0
+static int g_min_loop_count = 8;
+static int g_max_loop_count = 1000;
+static double g_max_loop_time = 60 * 1000;
+static double g_target_relative_ci = 0.01;
+
+// throughput mode, run this many extractors concurrently on one net
+static int g_stream_count = 0;
+
+// sweep streams x threads-per-stream splits of num threads
+static bool g_enable_sweep = false;
+
+// print the layers holding the most memory at peak for one inference
+static bool g_enable_memreport = false;
 
 static ncnn::UnlockedPoolAllocator g_blob_pool_allocator;
 static ncnn::PoolAllocator g_workspace_pool_allocator;
 
+// wrap the pool allocators only in the memory pass, so that the timed runs do not pay for the counting
+static ncnn::TrackingAllocator g_blob_stats_allocator(&g_blob_pool_allocator);
+static ncnn::TrackingAllocator g_workspace_stats_allocator(&g_workspace_pool_allocator);
+
 #if NCNN_VULKAN
 static ncnn::VulkanDevice* g_vkdev = 0;
 static ncnn::VkAllocator* g_blob_vkallocator = 0;
 static ncnn::VkAllocator* g_staging_vkallocator = 0;
 #endif // NCNN_VULKAN
 
-void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncnn::Option& opt, bool fixed_path = true)
+struct BenchmarkResult
 {
-    // Skip if int8 model name and using GPU
-    if (opt.use_vulkan_compute && strstr(comment, "int8") != NULL)
+    const char* name;
+    int loop_count;
+    double time_min;
+    double time_max;
+    double time_avg;
+    double time_stddev;
+    double time_p50;
+    double time_p90;
+    double time_p99;
+    int stream_count;
+    double throughput;
+    size_t peak_rss_kb;
+    size_t blob_peak_bytes;
+    size_t workspace_peak_bytes;
+    size_t conversion_bytes;
+};
+
+static std::vector<BenchmarkResult> g_results;
+
+static void reset_peak_rss()
+{
+#if defined __linux__
+    // writing 5 to clear_refs resets VmHWM, supported since linux 4.0
+    FILE* fp = fopen("/proc/self/clear_refs", "w");
+    if (fp)
     {
-        if (!fixed_path)
-            fprintf(stderr, "%20s  skipped (int8+GPU not supported)\n", comment);
-        return;
+        fprintf(fp, "5");
+        fclose(fp);
     }
+#endif
+}
 
-    g_blob_pool_allocator.clear();
-    g_workspace_pool_allocator.clear();
+static size_t get_peak_rss_kb()
+{
+    size_t peak_rss_kb = 0;
+#if defined __linux__
+    FILE* fp = fopen("/proc/self/status", "r");
+    if (fp)
+    {
+        char line[256];
+        while (fgets(line, 256, fp))
+        {
+            unsigned long v = 0;
+            if (sscanf(line, "VmHWM: %lu kB", &v) == 1)
+            {
+                peak_rss_kb = v;
+                break;
+            }
+        }
+        fclose(fp);
+    }
+#endif
+    return peak_rss_kb;
+}
 
-#if NCNN_VULKAN
-    if (opt.use_vulkan_compute)
+// nearest-rank percentile of sorted times
+static double percentile(const std::vector<double>& sorted_times, double p)
+{
+    int rank = (int)ceil(p / 100.0 * sorted_times.size());
+    rank = std::min(std::max(rank, 1), (int)sorted_times.size());
+    return sorted_times[rank - 1];
+}
+
+static int run_inference(const ncnn::Net& net, ncnn::Extractor& ex, const std::vector<ncnn::Mat>& _in)
+{
+    const std::vector<const char*>& input_names = net.input_names();
+    const std::vector<const char*>& output_names = net.output_names();
+
+    for (size_t j = 0; j < input_names.size(); ++j)
     {
-        g_blob_vkallocator->clear();
-        g_staging_vkallocator->clear();
+        ncnn::Mat in = _in[j];
+        ex.input(input_names[j], in);
     }
-#endif // NCNN_VULKAN
 
-    ncnn::Net net;
+    for (size_t j = 0; j < output_names.size(); ++j)
+    {
+        ncnn::Mat out;
+        int ret = ex.extract(output_names[j], out);
+        if (ret != 0)
+            return ret;
+    }
 
-    net.opt = opt;
+    return 0;
+}
+
+static int run_inference(const ncnn::Net& net, const std::vector<ncnn::Mat>& _in)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    return run_inference(net, ex, _in);
+}
 
+struct StreamContext
+{
+    const ncnn::Net* net;
+    ncnn::ExtractorPool* pool;
+    const std::vector<ncnn::Mat>* inputs;
+    int loop_count;
+    int ret;
+};
+
+static int run_inference(const ncnn::Net& net, ncnn::ExtractorPool& pool, const std::vector<ncnn::Mat>& _in)
+{
+    int worker = pool.acquire();
+
+    int ret;
+    {
+        ncnn::Extractor ex = pool.create_extractor(worker);
+        ret = run_inference(net, ex, _in);
+    }
+
+    pool.release(worker);
+
+    return ret;
+}
+
+static void* stream_worker(void* args)
+{
+    StreamContext* ctx = (StreamContext*)args;
+
+    for (int i = 0; i < ctx->loop_count; i++)
+    {
+        ctx->ret = run_inference(*ctx->net, *ctx->pool, *ctx->inputs);
+        if (ctx->ret != 0)
+            break;
+    }
+
+    return 0;
+}
+
+// run streams concurrently on one net, returns inferences per second, or -1 on error
+static double benchmark_throughput(const ncnn::Net& net, const std::vector<ncnn::Mat>& _in, int stream_count, int loop_count)
+{
+    ncnn::ExtractorPool pool(&net, stream_count);
+
+    // warm up the allocators of every worker
+    {
+        int ret = 0;
+        std::vector<int> workers(stream_count);
+        for (int i = 0; i < stream_count; i++)
+        {
+            workers[i] = pool.acquire();
+            ncnn::Extractor ex = pool.create_extractor(workers[i]);
+            if (ret == 0)
+                ret = run_inference(net, ex, _in);
+        }
+        for (int i = 0; i < stream_count; i++)
+        {
+            pool.release(workers[i]);
+        }
+
+        if (ret != 0)
+            return -1;
+    }
+
+    // one context per stream, each records its own error
+    std::vector<StreamContext> ctxs(stream_count);
+    for (int i = 0; i < stream_count; i++)
+    {
+        ctxs[i].net = &net;
+        ctxs[i].pool = &pool;
+        ctxs[i].inputs = &_in;
+        ctxs[i].loop_count = loop_count;
+        ctxs[i].ret = 0;
+    }
+
+    double start = ncnn::get_current_time();
+
+    std::vector<ncnn::Thread*> threads(stream_count);
+    for (int i = 0; i < stream_count; i++)
+    {
+        threads[i] = new ncnn::Thread(stream_worker, &ctxs[i]);
+    }
+    for (int i = 0; i < stream_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+
+    double end = ncnn::get_current_time();
+
+    for (int i = 0; i < stream_count; i++)
+    {
+        if (ctxs[i].ret != 0)
+            return -1;
+    }
+
+    return stream_count * loop_count * 1000.0 / (end - start);
+}
+
+static int load_model(ncnn::Net& net, const char* comment, bool fixed_path)
+{
 #if NCNN_VULKAN
     if (net.opt.use_vulkan_compute)
     {
@@ -84,27 +277,103 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
 #define MODEL_DIR ""
 #endif
 
+    int ret;
     if (fixed_path)
     {
         char parampath[256];
         sprintf(parampath, MODEL_DIR "%s.param", comment);
-        net.load_param(parampath);
+        ret = net.load_param(parampath);
     }
     else
     {
-        net.load_param(comment);
+        ret = net.load_param(comment);
     }
+    if (ret != 0)
+        return ret;
 
     DataReaderFromEmpty dr;
-    net.load_model(dr);
+    return net.load_model(dr);
+}
+
+// try every split of num_threads into streams x threads-per-stream
+static void benchmark_sweep(const char* comment, const std::vector<ncnn::Mat>& _in, const ncnn::Option& opt, bool fixed_path, int loop_count)
+{
+    int best_stream_count = 0;
+    double best_throughput = 0;
+
+    for (int stream_count = 1; stream_count <= opt.num_threads; stream_count *= 2)
+    {
+        ncnn::Net net;
+        net.opt = opt;
+        net.opt.num_threads = ncnn::ExtractorPool::threads_per_worker(stream_count, opt.num_threads);
+
+        if (load_model(net, comment, fixed_path) != 0)
+            return;
+
+        if (net.input_names().size() > _in.size())
+        {
+            fprintf(stderr, "input %ld tensors while model has %ld inputs\n", _in.size(), net.input_names().size());
+            return;
+        }
+
+        double throughput = benchmark_throughput(net, _in, stream_count, loop_count);
+        if (throughput < 0)
+        {
+            fprintf(stderr, "%20s  inference failed with %d streams\n", comment, stream_count);
+            return;
+        }
+
+        fprintf(stderr, "%20s  streams = %2d  threads = %2d  throughput = %.2f/s\n", comment, stream_count, net.opt.num_threads, throughput);
+
+        if (throughput > best_throughput)
+        {
+            best_throughput = throughput;
+            best_stream_count = stream_count;
+        }
+    }
+
+    fprintf(stderr, "%20s  best streams = %d  threads = %d  throughput = %.2f/s\n", comment, best_stream_count, ncnn::ExtractorPool::threads_per_worker(best_stream_count, opt.num_threads), best_throughput);
+}
+
+void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncnn::Option& opt, bool fixed_path = true)
+{
+    // Skip if int8 model name and using GPU
+    if (opt.use_vulkan_compute && strstr(comment, "int8") != NULL)
+    {
+        if (!fixed_path)
+            fprintf(stderr, "%20s  skipped (int8+GPU not supported)\n", comment);
+        return;
+    }
+
+    g_blob_pool_allocator.clear();
+    g_workspace_pool_allocator.clear();
+
+#if NCNN_VULKAN
+    if (opt.use_vulkan_compute)
+    {
+        g_blob_vkallocator->clear();
+        g_staging_vkallocator->clear();
+    }
+#endif // NCNN_VULKAN
+
+    reset_peak_rss();
+
+    ncnn::Net net;
+
+    net.opt = opt;
+
+    if (load_model(net, comment, fixed_path) != 0)
+    {
+        fprintf(stderr, "%20s  load model failed\n", comment);
+        return;
+    }
 
     const std::vector<const char*>& input_names = net.input_names();
-    const std::vector<const char*>& output_names = net.output_names();
 
     if (g_enable_cooling_down)
     {
-        // sleep 10 seconds for cooling down SOC  :(
-        ncnn::sleep(10 * 1000);
+        // sleep for cooling down SOC  :(
+        ncnn::sleep(g_cooling_down_ms);
     }
 
     if (input_names.size() > _in.size())
@@ -123,54 +392,151 @@ void benchmark(const char* comment, const std::vector<ncnn::Mat>& _in, const ncn
     // warm up
     for (int i = 0; i < g_warmup_loop_count; i++)
     {
-        ncnn::Extractor ex = net.create_extractor();
-        for (size_t j = 0; j < input_names.size(); ++j)
+        if (run_inference(net, _in) != 0)
+        {
+            fprintf(stderr, "%20s  inference failed\n", comment);
+            return;
+        }
+    }
+
+    BenchmarkResult r;
+    r.name = comment;
+    r.stream_count = 0;
+    r.throughput = 0;
+
+    std::vector<double> times;
+    double time_sum = 0;
+    double time_sqsum = 0;
+
+    const bool adaptive = g_loop_count <= 0;
+    const int max_loop_count = adaptive ? g_max_loop_count : g_loop_count;
+
+    for (int i = 0; i < max_loop_count; i++)
+    {
+        double start = ncnn::get_current_time();
+
+        int ret = run_inference(net, _in);
+
+        double end = ncnn::get_current_time();
+
+        if (ret != 0)
         {
-            ncnn::Mat in = _in[j];
-            ex.input(input_names[j], in);
+            fprintf(stderr, "%20s  inference failed\n", comment);
+            return;
         }
 
-        for (size_t j = 0; j < output_names.size(); ++j)
+        double time = end - start;
+
+        times.push_back(time);
+        time_sum += time;
+        time_sqsum += time * time;
+
+        if (adaptive && (int)times.size() >= g_min_loop_count)
         {
-            ncnn::Mat out;
-            ex.extract(output_names[j], out);
+            // stop once the 95% confidence interval of the mean is narrow enough
+            const int n = (int)times.size();
+            const double mean = time_sum / n;
+            const double variance = std::max((time_sqsum - time_sum * mean) / (n - 1), 0.0);
+            const double ci = 1.96 * sqrt(variance / n);
+
+            if (ci <= g_target_relative_ci * mean || time_sum >= g_max_loop_time)
+                break;
         }
     }
 
-    double time_min = DBL_MAX;
-    double time_max = -DBL_MAX;
-    double time_avg = 0;
+    const int n = (int)times.size();
+
+    r.loop_count = n;
+    r.time_avg = time_sum / n;
+    r.time_stddev = n > 1 ? sqrt(std::max((time_sqsum - time_sum * r.time_avg) / (n - 1), 0.0)) : 0.0;
 
-    for (int i = 0; i < g_loop_count; i++)
+    std::partial_sort(times.begin(), times.end(), times.end(), std::less<double>());
+    r.time_min = times.front();
+    r.time_max = times.back();
+    r.time_p50 = percentile(times, 50);
+    r.time_p90 = percentile(times, 90);
+    r.time_p99 = percentile(times, 99);
+
+    if (g_stream_count > 0)
     {
-        double start = ncnn::get_current_time();
+        r.stream_count = g_stream_count;
+        r.throughput = benchmark_throughput(net, _in, g_stream_count, std::max(n, 1));
+        if (r.throughput < 0)
         {
-            ncnn::Extractor ex = net.create_extractor();
-            for (size_t j = 0; j < input_names.size(); ++j)
-            {
-                ncnn::Mat in = _in[j];
-                ex.input(input_names[j], in);
-            }
+            fprintf(stderr, "%20s  inference failed with %d streams\n", comment, g_stream_count);
+            return;
+        }
+    }
 
-            for (size_t j = 0; j < output_names.size(); ++j)
-            {
-                ncnn::Mat out;
-                ex.extract(output_names[j], out);
-            }
+    r.peak_rss_kb = get_peak_rss_kb();
+
+    // memory pass, one untimed inference through the tracking wrappers
+    g_blob_stats_allocator.reset();
+    g_workspace_stats_allocator.reset();
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_blob_allocator(&g_blob_stats_allocator);
+        ex.set_workspace_allocator(&g_workspace_stats_allocator);
+        if (run_inference(net, ex, _in) != 0)
+        {
+            fprintf(stderr, "%20s  inference failed\n", comment);
+            return;
         }
 
-        double end = ncnn::get_current_time();
+        // layout and precision conversions of one inference
+        r.conversion_bytes = ex.conversion_bytes();
+    }
+    r.blob_peak_bytes = g_blob_stats_allocator.peak_bytes();
+    r.workspace_peak_bytes = g_workspace_stats_allocator.peak_bytes();
 
-        double time = end - start;
+    g_results.push_back(r);
 
-        time_min = std::min(time_min, time);
-        time_max = std::max(time_max, time);
-        time_avg += time;
+    if (g_enable_sweep)
+    {
+        benchmark_sweep(comment, _in, opt, fixed_path, std::max(n, 1));
     }
 
-    time_avg /= g_loop_count;
+    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f  p50 = %7.2f  p90 = %7.2f  p99 = %7.2f", comment, r.time_min, r.time_max, r.time_avg, r.time_p50, r.time_p90, r.time_p99);
+    if (adaptive)
+    {
+        fprintf(stderr, "  loops = %d", r.loop_count);
+    }
+    if (r.stream_count > 0)
+    {
+        fprintf(stderr, "  streams = %d  throughput = %.2f/s", r.stream_count, r.throughput);
+    }
+    fprintf(stderr, "\n");
 
-    fprintf(stderr, "%20s  min = %7.2f  max = %7.2f  avg = %7.2f\n", comment, time_min, time_max, time_avg);
+    if (g_enable_memreport)
+    {
+        fprintf(stderr, "%20s  blob memory\n", comment);
+        g_blob_stats_allocator.print_report(net.layers());
+        fprintf(stderr, "%20s  workspace memory\n", comment);
+        g_workspace_stats_allocator.print_report(net.layers());
+    }
+}
+
+static int write_json(const char* path)
+{
+    FILE* fp = fopen(path, "wb");
+    if (!fp)
+    {
+        fprintf(stderr, "fopen %s failed\n", path);
+        return -1;
+    }
+
+    fprintf(fp, "[\n");
+    for (size_t i = 0; i < g_results.size(); i++)
+    {
+        const BenchmarkResult& r = g_results[i];
+        fprintf(fp, "  {\"name\": \"%s\", \"loop_count\": %d, \"min_ms\": %.4f, \"max_ms\": %.4f, \"avg_ms\": %.4f, \"stddev_ms\": %.4f, \"p50_ms\": %.4f, \"p90_ms\": %.4f, \"p99_ms\": %.4f, ", r.name, r.loop_count, r.time_min, r.time_max, r.time_avg, r.time_stddev, r.time_p50, r.time_p90, r.time_p99);
+        fprintf(fp, "\"streams\": %d, \"throughput\": %.4f, \"peak_rss_kb\": %lu, \"blob_peak_bytes\": %lu, \"workspace_peak_bytes\": %lu, \"conversion_bytes\": %lu}%s\n", r.stream_count, r.throughput, (unsigned long)r.peak_rss_kb, (unsigned long)r.blob_peak_bytes, (unsigned long)r.workspace_peak_bytes, (unsigned long)r.conversion_bytes, i + 1 == g_results.size() ? "" : ",");
+    }
+    fprintf(fp, "]\n");
+
+    fclose(fp);
+
+    return 0;
 }
 
 void benchmark(const char* comment, const ncnn::Mat& _in, const ncnn::Option& opt, bool fixed_path = true)
@@ -185,6 +551,12 @@ void show_usage()
     fprintf(stderr, "Usage: benchncnn [loop count] [num threads] [powersave] [gpu device] [cooling down] [(key=value)...]\n");
     fprintf(stderr, "  param=model.param\n");
     fprintf(stderr, "  shape=[227,227,3],...\n");
+    fprintf(stderr, "  min_loop=8 max_loop=1000 max_time=60000 rel_ci=0.01  (loop count 0 only)\n");
+    fprintf(stderr, "  cooling_down_ms=10000\n");
+    fprintf(stderr, "  streams=4\n");
+    fprintf(stderr, "  sweep=1\n");
+    fprintf(stderr, "  memreport=1\n");
+    fprintf(stderr, "  json=result.json\n");
 }
 
 static std::vector<ncnn::Mat> parse_shape_list(char* s)
@@ -257,6 +629,7 @@ int main(int argc, char** argv)
     int gpu_device = -1;
     int cooling_down = 1;
     char* model = 0;
+    const char* json_path = 0;
     std::vector<ncnn::Mat> inputs;
 
     for (int i = 1; i < argc; i++)
@@ -316,6 +689,24 @@ int main(int argc, char** argv)
             model = value;
         if (strcmp(key, "shape") == 0)
             inputs = parse_shape_list(value);
+        if (strcmp(key, "min_loop") == 0)
+            g_min_loop_count = std::max(atoi(value), 2);
+        if (strcmp(key, "max_loop") == 0)
+            g_max_loop_count = std::max(atoi(value), 1);
+        if (strcmp(key, "max_time") == 0)
+            g_max_loop_time = atof(value);
+        if (strcmp(key, "rel_ci") == 0)
+            g_target_relative_ci = atof(value);
+        if (strcmp(key, "cooling_down_ms") == 0)
+            g_cooling_down_ms = atoi(value);
+        if (strcmp(key, "streams") == 0)
+            g_stream_count = atoi(value);
+        if (strcmp(key, "json") == 0)
+            json_path = value;
+        if (strcmp(key, "sweep") == 0)
+            g_enable_sweep = atoi(value) != 0;
+        if (strcmp(key, "memreport") == 0)
+            g_enable_memreport = atoi(value) != 0;
     }
 
     if (model && inputs.empty())
@@ -379,11 +770,16 @@ int main(int argc, char** argv)
     opt.use_packing_layout = true;
     opt.use_shader_pack8 = false;
 
-    fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    if (g_loop_count > 0)
+        fprintf(stderr, "loop_count = %d\n", g_loop_count);
+    else
+        fprintf(stderr, "loop_count = auto (%d ~ %d, rel_ci = %g)\n", g_min_loop_count, g_max_loop_count, g_target_relative_ci);
     fprintf(stderr, "num_threads = %d\n", num_threads);
     fprintf(stderr, "powersave = %d\n", ncnn::get_cpu_powersave());
     fprintf(stderr, "gpu_device = %d\n", gpu_device);
     fprintf(stderr, "cooling_down = %d\n", (int)g_enable_cooling_down);
+    if (g_stream_count > 0)
+        fprintf(stderr, "streams = %d\n", g_stream_count);
 
     if (model != 0)
     {
@@ -470,5 +866,10 @@ int main(int argc, char** argv)
     delete g_staging_vkallocator;
 #endif // NCNN_VULKAN
 
+    if (json_path)
+    {
+        write_json(json_path);
+    }
+
     return 0;
 }
@@ -14,6 +14,7 @@
 #include <paramdict.h>
 
 #include "pybind11_mat.h"
+#include "pybind11_dlpack.h"
 #include "pybind11_datareader.h"
 #include "pybind11_allocator.h"
 #include "pybind11_modelbin.h"
@@ -257,38 +258,93 @@ PYBIND11_MODULE(ncnn, m)
             pybind11::pybind11_fail(ss.str());
         }
 
-        size_t elemsize = info.itemsize;
-
-        Mat* v = nullptr;
-        if (info.ndim == 1)
+        // the mat is a view over the buffer memory, which must be c-contiguous
+        py::ssize_t expected_stride = info.itemsize;
+        for (py::ssize_t i = info.ndim - 1; i >= 0; i--)
         {
-            v = new Mat((int)info.shape[0], info.ptr, elemsize);
+            if (info.shape[i] > 1 && info.strides[i] != expected_stride)
+            {
+                pybind11::pybind11_fail("convert numpy.ndarray to ncnn.Mat requires c-contiguous array, use numpy.ascontiguousarray");
+            }
+            expected_stride *= info.shape[i];
         }
-        else if (info.ndim == 2)
+
+        int shape[4];
+        for (py::ssize_t i = 0; i < info.ndim; i++)
         {
-            v = new Mat((int)info.shape[1], (int)info.shape[0], info.ptr, elemsize);
+            shape[i] = (int)info.shape[i];
         }
-        else if (info.ndim == 3)
+
+        return std::unique_ptr<Mat>(new_mat_view(info.ptr, (int)info.ndim, shape, info.itemsize));
+    }),
+    py::arg("array"), py::keep_alive<1, 2>()) // array should be kept alive until the mat view is freed by gc
+    .def_static(
+    "from_dlpack", [](py::object tensor) -> py::object {
+        py::object capsule = tensor.attr("__dlpack__")();
+        if (!PyCapsule_IsValid(capsule.ptr(), "dltensor"))
         {
-            v = new Mat((int)info.shape[2], (int)info.shape[1], (int)info.shape[0], info.ptr, elemsize);
+            pybind11::pybind11_fail("from_dlpack expects an unconsumed dltensor capsule");
+        }
+
+        DLManagedTensor* dlm = (DLManagedTensor*)PyCapsule_GetPointer(capsule.ptr(), "dltensor");
+        const DLTensor& t = dlm->dl_tensor;
 
-            // in ncnn, buffer to construct ncnn::Mat need align to ncnn::alignSize
-            // with (w * h * elemsize, 16) / elemsize, but the buffer from numpy not
-            // so we set the cstep as numpy's cstep
-            v->cstep = (int)info.shape[2] * (int)info.shape[1];
+        if (t.device.device_type != kDLCPU)
+        {
+            pybind11::pybind11_fail("from_dlpack only cpu tensor support now");
+        }
+        if (t.ndim < 1 || t.ndim > 4)
+        {
+            std::stringstream ss;
+            ss << "from_dlpack only dims 1, 2, 3 or 4 support now, but given " << t.ndim;
+            pybind11::pybind11_fail(ss.str());
         }
-        else if (info.ndim == 4)
+        if (t.dtype.lanes != 1 || (t.dtype.bits != 8 && t.dtype.bits != 16 && t.dtype.bits != 32))
         {
-            v = new Mat((int)info.shape[3], (int)info.shape[2], (int)info.shape[1], (int)info.shape[0], info.ptr, elemsize);
+            std::stringstream ss;
+            ss << "from_dlpack only elemsize 1, 2, 4 support now, but given bits " << (int)t.dtype.bits << " lanes " << t.dtype.lanes;
+            pybind11::pybind11_fail(ss.str());
+        }
 
-            // in ncnn, buffer to construct ncnn::Mat need align to ncnn::alignSize
-            // with (w * h * d elemsize, 16) / elemsize, but the buffer from numpy not
-            // so we set the cstep as numpy's cstep
-            v->cstep = (int)info.shape[3] * (int)info.shape[2] * (int)info.shape[1];
+        const size_t elemsize = t.dtype.bits / 8;
+
+        // strides are counted in elements, null means c-contiguous
+        if (t.strides)
+        {
+            int64_t expected_stride = 1;
+            for (int i = t.ndim - 1; i >= 0; i--)
+            {
+                if (t.shape[i] > 1 && t.strides[i] != expected_stride)
+                {
+                    pybind11::pybind11_fail("from_dlpack requires c-contiguous tensor");
+                }
+                expected_stride *= t.shape[i];
+            }
         }
-        return std::unique_ptr<Mat>(v);
-    }),
-    py::arg("array"))
+
+        int shape[4];
+        for (int i = 0; i < t.ndim; i++)
+        {
+            shape[i] = (int)t.shape[i];
+        }
+
+        // take over the tensor, the producer must not free it any more
+        PyCapsule_SetName(capsule.ptr(), "used_dltensor");
+        py::capsule owner(dlm, [](void* p) {
+            DLManagedTensor* dlm = (DLManagedTensor*)p;
+            if (dlm->deleter)
+                dlm->deleter(dlm);
+        });
+
+        void* data = (unsigned char*)t.data + t.byte_offset;
+        py::object mat = py::cast(std::unique_ptr<Mat>(new_mat_view(data, t.ndim, shape, elemsize)));
+
+        // tensor should be kept alive until the mat view is freed by gc
+        py::detail::keep_alive_impl(mat, owner);
+
+        return mat;
+    },
+    py::arg("tensor"), "zero-copy view over an object implementing __dlpack__")
     .def_buffer([](Mat& m) -> py::buffer_info {
         return to_buffer_info(m);
     })
@@ -843,23 +899,69 @@ PYBIND11_MODULE(ncnn, m)
     .def("set_num_threads", &Extractor::set_num_threads, py::arg("num_threads"))
     .def("set_blob_allocator", &Extractor::set_blob_allocator, py::arg("allocator"))
     .def("set_workspace_allocator", &Extractor::set_workspace_allocator, py::arg("allocator"))
+    .def("set_streaming", &Extractor::set_streaming, py::arg("enable"))
+    .def("next_chunk", &Extractor::next_chunk)
+    .def("reset_streaming", &Extractor::reset_streaming)
 #if NCNN_STRING
-    .def("input", (int (Extractor::*)(const char*, const Mat&)) & Extractor::input, py::arg("blob_name"), py::arg("in"))
-    .def("extract", (int (Extractor::*)(const char*, Mat&, int)) & Extractor::extract, py::arg("blob_name"), py::arg("feat"), py::arg("type") = 0)
+    .def("input", (int (Extractor::*)(const char*, const Mat&)) & Extractor::input, py::arg("blob_name"), py::arg("in"), py::call_guard<py::gil_scoped_release>())
+    .def("extract", (int (Extractor::*)(const char*, Mat&, int)) & Extractor::extract, py::arg("blob_name"), py::arg("feat"), py::arg("type") = 0, py::call_guard<py::gil_scoped_release>())
     .def(
     "extract", [](Extractor& ex, const char* blob_name, int type) {
         ncnn::Mat feat;
-        int ret = ex.extract(blob_name, feat, type);
+        int ret;
+        {
+            py::gil_scoped_release release;
+            ret = ex.extract(blob_name, feat, type);
+        }
         return py::make_tuple(ret, feat.clone());
     },
     py::arg("blob_name"), py::arg("type") = 0)
+    .def(
+    "extract_many", [](py::object self, const std::vector<std::string>& blob_names, int type) {
+        Extractor& ex = self.cast<Extractor&>();
+
+        std::vector<Mat> feats(blob_names.size());
+        int ret = 0;
+        {
+            py::gil_scoped_release release;
+            for (size_t i = 0; i < blob_names.size(); i++)
+            {
+                ret = ex.extract(blob_names[i].c_str(), feats[i], type);
+                if (ret != 0)
+                    break;
+            }
+        }
+
+        py::list arrays;
+        if (ret != 0)
+            return py::make_tuple(ret, arrays);
+
+        for (size_t i = 0; i < feats.size(); i++)
+        {
+            // the array is a view over the blob memory, no copy
+            py::object feat = py::cast(feats[i]);
+
+            // blob memory comes from the extractor allocators,
+            // extractor should be kept alive until the array is freed by gc
+            py::detail::keep_alive_impl(feat, self);
+
+            arrays.append(py::array(to_buffer_info(*feat.cast<Mat*>()), feat));
+        }
+
+        return py::make_tuple(ret, arrays);
+    },
+    py::arg("blob_names"), py::arg("type") = 0, "extract several blobs at once and return them as numpy.ndarray views")
 #endif
-    .def("input", (int (Extractor::*)(int, const Mat&)) & Extractor::input)
-    .def("extract", (int (Extractor::*)(int, Mat&, int)) & Extractor::extract, py::arg("blob_index"), py::arg("feat"), py::arg("type") = 0)
+    .def("input", (int (Extractor::*)(int, const Mat&)) & Extractor::input, py::call_guard<py::gil_scoped_release>())
+    .def("extract", (int (Extractor::*)(int, Mat&, int)) & Extractor::extract, py::arg("blob_index"), py::arg("feat"), py::arg("type") = 0, py::call_guard<py::gil_scoped_release>())
     .def(
     "extract", [](Extractor& ex, int blob_index, int type) {
         ncnn::Mat feat;
-        int ret = ex.extract(blob_index, feat, type);
+        int ret;
+        {
+            py::gil_scoped_release release;
+            ret = ex.extract(blob_index, feat, type);
+        }
         return py::make_tuple(ret, feat.clone());
     },
     py::arg("blob_index"), py::arg("type") = 0);
@@ -941,22 +1043,23 @@ PYBIND11_MODULE(ncnn, m)
     },
     py::arg("index"), py::arg("creator"), py::arg("destroyer"))
 #if NCNN_STRING
-    .def("load_param", (int (Net::*)(const DataReader&)) & Net::load_param, py::arg("dr"))
+    .def("load_param", (int (Net::*)(const DataReader&)) & Net::load_param, py::arg("dr"), py::call_guard<py::gil_scoped_release>())
 #endif // NCNN_STRING
-    .def("load_param_bin", (int (Net::*)(const DataReader&)) & Net::load_param_bin, py::arg("dr"))
-    .def("load_model", (int (Net::*)(const DataReader&)) & Net::load_model, py::arg("dr"))
+    .def("load_param_bin", (int (Net::*)(const DataReader&)) & Net::load_param_bin, py::arg("dr"), py::call_guard<py::gil_scoped_release>())
+    .def("load_model", (int (Net::*)(const DataReader&)) & Net::load_model, py::arg("dr"), py::call_guard<py::gil_scoped_release>())
 
 #if NCNN_STDIO
 #if NCNN_STRING
-    .def("load_param", (int (Net::*)(const char*)) & Net::load_param, py::arg("protopath"))
-    .def("load_param_mem", (int (Net::*)(const char*)) & Net::load_param_mem, py::arg("mem"))
+    .def("load_param", (int (Net::*)(const char*)) & Net::load_param, py::arg("protopath"), py::call_guard<py::gil_scoped_release>())
+    .def("load_param_mem", (int (Net::*)(const char*)) & Net::load_param_mem, py::arg("mem"), py::call_guard<py::gil_scoped_release>())
 #endif // NCNN_STRING
-    .def("load_param_bin", (int (Net::*)(const char*)) & Net::load_param_bin, py::arg("protopath"))
-    .def("load_model", (int (Net::*)(const char*)) & Net::load_model, py::arg("modelpath"))
+    .def("load_param_bin", (int (Net::*)(const char*)) & Net::load_param_bin, py::arg("protopath"), py::call_guard<py::gil_scoped_release>())
+    .def("load_model", (int (Net::*)(const char*)) & Net::load_model, py::arg("modelpath"), py::call_guard<py::gil_scoped_release>())
     .def(
     "load_model_mem", [](Net& net, const char* mem) {
         const unsigned char* _mem = (const unsigned char*)mem;
         DataReaderFromMemoryCopy dr(_mem);
+        py::gil_scoped_release release;
         net.load_model(dr);
     },
     py::arg("mem"))
@@ -0,0 +1,54 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef PYBIND11_NCNN_DLPACK_H
+#define PYBIND11_NCNN_DLPACK_H
+
+#include <stdint.h>
+
+// the subset of dlpack.h abi needed to consume a cpu tensor
+// see https://github.com/dmlc/dlpack/blob/main/include/dlpack/dlpack.h
+enum
+{
+    kDLCPU = 1
+};
+
+enum
+{
+    kDLInt = 0,
+    kDLUInt = 1,
+    kDLFloat = 2
+};
+
+struct DLDevice
+{
+    int32_t device_type;
+    int32_t device_id;
+};
+
+struct DLDataType
+{
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+};
+
+struct DLTensor
+{
+    void* data;
+    DLDevice device;
+    int32_t ndim;
+    DLDataType dtype;
+    int64_t* shape;
+    int64_t* strides;
+    uint64_t byte_offset;
+};
+
+struct DLManagedTensor
+{
+    DLTensor dl_tensor;
+    void* manager_ctx;
+    void (*deleter)(struct DLManagedTensor* self);
+};
+
+#endif
@@ -101,4 +101,38 @@ py::buffer_info to_buffer_info(ncnn::Mat& m, const std::string& format = "")
                           );
 }
 
+// construct a Mat header over external c-contiguous data, with no memory copy
+// shape is in numpy order, outermost dimension first
+ncnn::Mat* new_mat_view(void* data, int ndim, const int* shape, size_t elemsize)
+{
+    ncnn::Mat* v = nullptr;
+    if (ndim == 1)
+    {
+        v = new ncnn::Mat(shape[0], data, elemsize);
+    }
+    else if (ndim == 2)
+    {
+        v = new ncnn::Mat(shape[1], shape[0], data, elemsize);
+    }
+    else if (ndim == 3)
+    {
+        v = new ncnn::Mat(shape[2], shape[1], shape[0], data, elemsize);
+
+        // in ncnn, buffer to construct ncnn::Mat need align to ncnn::alignSize
+        // with (w * h * elemsize, 16) / elemsize, but the buffer from numpy not
+        // so we set the cstep as numpy's cstep
+        v->cstep = (size_t)shape[2] * shape[1];
+    }
+    else if (ndim == 4)
+    {
+        v = new ncnn::Mat(shape[3], shape[2], shape[1], shape[0], data, elemsize);
+
+        // in ncnn, buffer to construct ncnn::Mat need align to ncnn::alignSize
+        // with (w * h * d elemsize, 16) / elemsize, but the buffer from numpy not
+        // so we set the cstep as numpy's cstep
+        v->cstep = (size_t)shape[3] * shape[2] * shape[1];
+    }
+    return v;
+}
+
 #endif
@@ -73,3 +73,49 @@ def test_extractor_index():
 
     # not use with sentence, call clear manually to ensure ex destruct before net
     ex.clear()
+
+
+def test_extractor_extract_many():
+    dr = ncnn.DataReaderFromEmpty()
+
+    net = ncnn.Net()
+    net.load_param("tests/test.param")
+    net.load_model(dr)
+
+    in_mat = ncnn.Mat((227, 227, 3))
+    with net.create_extractor() as ex:
+        ex.input("data", in_mat)
+        ret, arrays = ex.extract_many(["conv0_fwd", "output"])
+        assert ret == 0 and len(arrays) == 2
+        assert arrays[0].shape == (3, 225, 225)
+        assert arrays[1].shape == (1,)
+
+        ret, arrays = ex.extract_many(["conv0_fwd", "not_exist"])
+        assert ret != 0 and len(arrays) == 0
+
+
+def test_extractor_threads():
+    import threading
+
+    dr = ncnn.DataReaderFromEmpty()
+
+    net = ncnn.Net()
+    net.load_param("tests/test.param")
+    net.load_model(dr)
+
+    results = [None] * 4
+
+    def worker(i):
+        # extract runs with the gil released
+        with net.create_extractor() as ex:
+            ex.input("data", ncnn.Mat((227, 227, 3)))
+            ret, out_mat = ex.extract("output")
+            results[i] = ret == 0 and out_mat.w == 1
+
+    threads = [threading.Thread(target=worker, args=(i,)) for i in range(4)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    assert all(results)
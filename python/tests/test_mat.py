@@ -283,6 +283,36 @@ def test_numpy():
     array2[0] = 100
     assert array[0] == 100
 
+def test_numpy_view():
+    array = np.random.rand(3, 4, 5).astype(np.float32)
+    mat = ncnn.Mat(array)
+    del array
+    # the mat keeps the array alive
+    array2 = mat.numpy()
+    assert array2.shape == (3, 4, 5)
+
+    array = np.random.rand(4, 5).astype(np.float32).T
+    with pytest.raises(RuntimeError, match="c-contiguous"):
+        mat = ncnn.Mat(array)
+
+
+@pytest.mark.skipif(
+    not hasattr(np.ndarray, "__dlpack__"), reason="numpy without dlpack support"
+)
+def test_from_dlpack():
+    array = np.random.rand(3, 4, 5).astype(np.float32)
+    mat = ncnn.Mat.from_dlpack(array)
+    assert mat.dims == 3 and mat.w == 5 and mat.h == 4 and mat.c == 3
+    array2 = mat.numpy()
+    assert (array2 == array).all()
+    array[0, 0, 0] = 100
+    assert array2[0, 0, 0] == 100
+
+    array = np.array([1, 2, 3], dtype=np.int8)
+    mat = ncnn.Mat.from_dlpack(array)
+    assert mat.dims == 1 and mat.w == 3 and mat.elemsize == 1
+
+
 def test_fill():
     mat = ncnn.Mat(1)
     mat.fill(1.0)
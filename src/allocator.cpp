@@ -4,12 +4,17 @@
 #include "allocator.h"
 
 #include "gpu.h"
+#include "layer.h"
 #include "pipeline.h"
 
 #if __ANDROID_API__ >= 26
 #include <android/hardware_buffer.h>
 #endif // __ANDROID_API__ >= 26
 
+#if defined __ANDROID__ || defined __linux__
+#include <sys/mman.h>
+#endif // __ANDROID__ || __linux__
+
 namespace ncnn {
 
 Allocator::~Allocator()
@@ -346,6 +351,581 @@ void UnlockedPoolAllocator::fastFree(void* ptr)
     ncnn::fastFree(ptr);
 }
 
+// each HugePageAllocator buffer follows its block record
+struct HugePageBlock
+{
+    // requested and usable bytes
+    size_t size;
+    size_t capacity;
+    // length of the mapping starting at the record, 0 if from fastMalloc
+    size_t map_size;
+    // backed by hugetlbfs pages or advised with MADV_HUGEPAGE
+    int huge;
+};
+
+static const size_t huge_page_size = 2 * 1024 * 1024;
+
+static size_t huge_page_block_header_size()
+{
+    return alignSize(sizeof(HugePageBlock), NCNN_MALLOC_ALIGN);
+}
+
+static HugePageBlock* map_huge_page_block(size_t size, bool use_hugetlb)
+{
+#if defined __ANDROID__ || defined __linux__
+    const size_t map_size = alignSize(huge_page_block_header_size() + size + NCNN_MALLOC_OVERREAD, (int)huge_page_size);
+
+    unsigned char* base = 0;
+    int huge = 0;
+
+#ifdef MAP_HUGETLB
+    if (use_hugetlb)
+    {
+        void* ptr = mmap(0, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (ptr != MAP_FAILED)
+        {
+            base = (unsigned char*)ptr;
+            huge = 1;
+        }
+    }
+#else
+    (void)use_hugetlb;
+#endif // MAP_HUGETLB
+
+    if (!base)
+    {
+        // map one more huge page and trim to a 2 MiB aligned range, so that every page can be huge
+        void* ptr = mmap(0, map_size + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (ptr == MAP_FAILED)
+            return 0;
+
+        unsigned char* unaligned = (unsigned char*)ptr;
+        base = alignPtr(unaligned, (int)huge_page_size);
+
+        const size_t head = base - unaligned;
+        if (head)
+            munmap(unaligned, head);
+        if (huge_page_size - head)
+            munmap(base + map_size, huge_page_size - head);
+
+#ifdef MADV_HUGEPAGE
+        huge = madvise(base, map_size, MADV_HUGEPAGE) == 0 ? 1 : 0;
+#endif // MADV_HUGEPAGE
+    }
+
+    HugePageBlock* block = (HugePageBlock*)base;
+    block->size = size;
+    block->capacity = map_size - huge_page_block_header_size() - NCNN_MALLOC_OVERREAD;
+    block->map_size = map_size;
+    block->huge = huge;
+    return block;
+#else
+    (void)size;
+    (void)use_hugetlb;
+    return 0;
+#endif
+}
+
+static void unmap_huge_page_block(HugePageBlock* block)
+{
+#if defined __ANDROID__ || defined __linux__
+    munmap(block, block->map_size);
+#else
+    (void)block;
+#endif
+}
+
+class HugePageAllocatorPrivate
+{
+public:
+    Mutex lock;
+    bool use_hugetlb;
+    size_t size_drop_threshold;
+    std::list<HugePageBlock*> budgets;
+
+    int payout_count;
+    size_t allocated_bytes;
+    size_t peak_allocated_bytes;
+    size_t huge_page_bytes;
+    int fallback_count;
+};
+
+HugePageAllocator::HugePageAllocator()
+    : Allocator(), d(new HugePageAllocatorPrivate)
+{
+    d->use_hugetlb = false;
+    d->size_drop_threshold = 0;
+    d->payout_count = 0;
+    d->allocated_bytes = 0;
+    d->peak_allocated_bytes = 0;
+    d->huge_page_bytes = 0;
+    d->fallback_count = 0;
+}
+
+HugePageAllocator::~HugePageAllocator()
+{
+    clear();
+
+    if (d->payout_count != 0)
+    {
+        NCNN_LOGE("FATAL ERROR! huge page allocator destroyed too early, %d buffers still in use", d->payout_count);
+    }
+
+    delete d;
+}
+
+HugePageAllocator::HugePageAllocator(const HugePageAllocator&)
+    : d(0)
+{
+}
+
+HugePageAllocator& HugePageAllocator::operator=(const HugePageAllocator&)
+{
+    return *this;
+}
+
+void HugePageAllocator::set_use_hugetlb(bool enable)
+{
+    d->use_hugetlb = enable;
+}
+
+void HugePageAllocator::set_size_drop_threshold(size_t threshold)
+{
+    d->size_drop_threshold = threshold;
+}
+
+void HugePageAllocator::clear()
+{
+    MutexLockGuard guard(d->lock);
+
+    std::list<HugePageBlock*>::iterator it = d->budgets.begin();
+    for (; it != d->budgets.end(); ++it)
+    {
+        unmap_huge_page_block(*it);
+    }
+    d->budgets.clear();
+}
+
+size_t HugePageAllocator::allocated_bytes() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->allocated_bytes;
+}
+
+size_t HugePageAllocator::peak_allocated_bytes() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->peak_allocated_bytes;
+}
+
+size_t HugePageAllocator::huge_page_bytes() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->huge_page_bytes;
+}
+
+int HugePageAllocator::fallback_count() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->fallback_count;
+}
+
+void* HugePageAllocator::fastMalloc(size_t size)
+{
+    const size_t header_size = huge_page_block_header_size();
+
+    HugePageBlock* block = 0;
+    bool fallback = false;
+
+    if (size >= huge_page_size)
+    {
+        // reuse a kept mapping at most twice as large
+        {
+            MutexLockGuard guard(d->lock);
+
+            std::list<HugePageBlock*>::iterator it = d->budgets.begin();
+            for (; it != d->budgets.end(); ++it)
+            {
+                if ((*it)->capacity >= size && (*it)->capacity / 2 <= size)
+                {
+                    block = *it;
+                    block->size = size;
+                    d->budgets.erase(it);
+                    break;
+                }
+            }
+        }
+
+        if (!block)
+            block = map_huge_page_block(size, d->use_hugetlb);
+
+        fallback = !block || !block->huge;
+    }
+
+    if (!block)
+    {
+        void* ptr = ncnn::fastMalloc(header_size + size);
+        if (!ptr)
+            return 0;
+
+        block = (HugePageBlock*)ptr;
+        block->size = size;
+        block->capacity = size;
+        block->map_size = 0;
+        block->huge = 0;
+    }
+
+    {
+        MutexLockGuard guard(d->lock);
+
+        d->payout_count++;
+        d->allocated_bytes += size;
+        d->peak_allocated_bytes = std::max(d->peak_allocated_bytes, d->allocated_bytes);
+        if (block->huge)
+            d->huge_page_bytes += size;
+        if (fallback)
+            d->fallback_count++;
+    }
+
+    return (unsigned char*)block + header_size;
+}
+
+void HugePageAllocator::fastFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    HugePageBlock* block = (HugePageBlock*)((unsigned char*)ptr - huge_page_block_header_size());
+
+    MutexLockGuard guard(d->lock);
+
+    d->payout_count--;
+    d->allocated_bytes -= block->size;
+    if (block->huge)
+        d->huge_page_bytes -= block->size;
+
+    if (block->map_size == 0)
+    {
+        ncnn::fastFree(block);
+        return;
+    }
+
+    if (d->budgets.size() < d->size_drop_threshold)
+    {
+        d->budgets.push_back(block);
+        return;
+    }
+
+    unmap_huge_page_block(block);
+}
+
+// each TrackingAllocator buffer follows the size and the layer it was allocated for
+struct TrackingHeader
+{
+    size_t size;
+    int layer_index;
+};
+
+static size_t tracking_header_size()
+{
+    return alignSize(sizeof(TrackingHeader), NCNN_MALLOC_ALIGN);
+}
+
+class TrackingAllocatorPrivate
+{
+public:
+    // the stats of layer i are at i + 1, buffers outside of any layer at 0
+    // bytes_at_peak is brought up to date, so live_bytes may change
+    TrackingAllocator::LayerStats& layer_stats(int layer_index);
+
+    // a layer untouched since the last peak still holds its live bytes at peak
+    void sync_bytes_at_peak(size_t i);
+
+    Allocator* allocator;
+
+    Mutex lock;
+    size_t live_bytes;
+    size_t peak_bytes;
+    int malloc_count;
+    std::vector<TrackingAllocator::LayerStats> layers;
+
+    // bumped on every new peak, layers[i].bytes_at_peak is valid for peak_versions[i]
+    int peak_version;
+    std::vector<int> peak_versions;
+
+    // written by the extractor thread, read by its openmp workers
+    int layer_index;
+};
+
+// the live tracking allocators, so that an extractor finds them behind its Allocator pointers
+static int g_tracking_allocator_count = 0;
+
+static Mutex& tracking_allocators_lock()
+{
+    static Mutex lock;
+    return lock;
+}
+
+static std::vector<TrackingAllocator*>& tracking_allocators()
+{
+    static std::vector<TrackingAllocator*> allocators;
+    return allocators;
+}
+
+TrackingAllocator::LayerStats& TrackingAllocatorPrivate::layer_stats(int layer_index)
+{
+    while ((int)layers.size() <= layer_index + 1)
+    {
+        TrackingAllocator::LayerStats stats;
+        memset(&stats, 0, sizeof(stats));
+        stats.layer_index = (int)layers.size() - 1;
+        layers.push_back(stats);
+        peak_versions.push_back(peak_version);
+    }
+
+    sync_bytes_at_peak(layer_index + 1);
+
+    return layers[layer_index + 1];
+}
+
+void TrackingAllocatorPrivate::sync_bytes_at_peak(size_t i)
+{
+    if (peak_versions[i] == peak_version)
+        return;
+
+    layers[i].bytes_at_peak = layers[i].live_bytes;
+    peak_versions[i] = peak_version;
+}
+
+TrackingAllocator::TrackingAllocator(Allocator* allocator)
+    : Allocator(), d(new TrackingAllocatorPrivate)
+{
+    d->allocator = allocator;
+    d->live_bytes = 0;
+    d->peak_bytes = 0;
+    d->malloc_count = 0;
+    d->peak_version = 0;
+    d->layer_index = -1;
+
+    MutexLockGuard guard(tracking_allocators_lock());
+    tracking_allocators().push_back(this);
+    NCNN_XADD(&g_tracking_allocator_count, 1);
+}
+
+TrackingAllocator::~TrackingAllocator()
+{
+    {
+        MutexLockGuard guard(tracking_allocators_lock());
+        std::vector<TrackingAllocator*>& allocators = tracking_allocators();
+        for (size_t i = 0; i < allocators.size(); i++)
+        {
+            if (allocators[i] == this)
+            {
+                allocators.erase(allocators.begin() + i);
+                break;
+            }
+        }
+        NCNN_XADD(&g_tracking_allocator_count, -1);
+    }
+
+    if (d->live_bytes != 0)
+    {
+        NCNN_LOGE("FATAL ERROR! tracking allocator destroyed too early, %lu bytes still in use", (unsigned long)d->live_bytes);
+    }
+
+    delete d;
+}
+
+TrackingAllocator::TrackingAllocator(const TrackingAllocator&)
+    : d(0)
+{
+}
+
+TrackingAllocator& TrackingAllocator::operator=(const TrackingAllocator&)
+{
+    return *this;
+}
+
+void TrackingAllocator::reset()
+{
+    MutexLockGuard guard(d->lock);
+
+    d->peak_bytes = d->live_bytes;
+    d->malloc_count = 0;
+    d->peak_version++;
+
+    for (size_t i = 0; i < d->layers.size(); i++)
+    {
+        LayerStats& stats = d->layers[i];
+        stats.malloc_count = 0;
+        stats.peak_bytes = stats.live_bytes;
+        memset(stats.size_histogram, 0, sizeof(stats.size_histogram));
+    }
+}
+
+size_t TrackingAllocator::live_bytes() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->live_bytes;
+}
+
+size_t TrackingAllocator::peak_bytes() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->peak_bytes;
+}
+
+int TrackingAllocator::malloc_count() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->malloc_count;
+}
+
+std::vector<TrackingAllocator::LayerStats> TrackingAllocator::layer_stats() const
+{
+    MutexLockGuard guard(d->lock);
+
+    std::vector<LayerStats> layer_stats;
+    for (size_t i = 0; i < d->layers.size(); i++)
+    {
+        d->sync_bytes_at_peak(i);
+
+        if (d->layers[i].malloc_count > 0 || d->layers[i].live_bytes > 0)
+            layer_stats.push_back(d->layers[i]);
+    }
+
+    return layer_stats;
+}
+
+static bool compare_bytes_at_peak(const TrackingAllocator::LayerStats& a, const TrackingAllocator::LayerStats& b)
+{
+    return a.bytes_at_peak > b.bytes_at_peak;
+}
+
+void TrackingAllocator::print_report(const std::vector<Layer*>& layers, int top_count) const
+{
+    std::vector<LayerStats> layer_stats = this->layer_stats();
+    std::stable_sort(layer_stats.begin(), layer_stats.end(), compare_bytes_at_peak);
+
+    NCNN_LOGE("peak %lu bytes, live %lu bytes, %d mallocs", (unsigned long)peak_bytes(), (unsigned long)live_bytes(), malloc_count());
+    NCNN_LOGE("%-24s %-24s %12s %12s %8s", "layer", "type", "at_peak", "peak", "mallocs");
+
+    for (int i = 0; i < (int)layer_stats.size() && i < top_count; i++)
+    {
+        const LayerStats& stats = layer_stats[i];
+
+        char index[16];
+        sprintf(index, "#%d", stats.layer_index);
+
+        const char* name = stats.layer_index < 0 ? "(outside layers)" : index;
+        const char* type = "";
+#if NCNN_STRING
+        if (stats.layer_index >= 0 && stats.layer_index < (int)layers.size())
+        {
+            const Layer* layer = layers[stats.layer_index];
+            name = layer->name.c_str();
+            type = layer->type.c_str();
+        }
+#else
+        (void)layers;
+#endif // NCNN_STRING
+
+        NCNN_LOGE("%-24s %-24s %12lu %12lu %8d", name, type, (unsigned long)stats.bytes_at_peak, (unsigned long)stats.peak_bytes, stats.malloc_count);
+    }
+}
+
+int TrackingAllocator::layer_index() const
+{
+    return load_acquire(&d->layer_index);
+}
+
+void TrackingAllocator::set_layer_index(int layer_index)
+{
+    store_release(&d->layer_index, layer_index);
+}
+
+TrackingAllocator* TrackingAllocator::find(const Allocator* allocator)
+{
+    // most extractors run without any tracking allocator alive
+    if (!allocator || load_acquire(&g_tracking_allocator_count) == 0)
+        return 0;
+
+    MutexLockGuard guard(tracking_allocators_lock());
+
+    const std::vector<TrackingAllocator*>& allocators = tracking_allocators();
+    for (size_t i = 0; i < allocators.size(); i++)
+    {
+        if (allocators[i] == allocator)
+            return allocators[i];
+    }
+
+    return 0;
+}
+
+void* TrackingAllocator::fastMalloc(size_t size)
+{
+    const size_t header_size = tracking_header_size();
+
+    unsigned char* ptr = (unsigned char*)(d->allocator ? d->allocator->fastMalloc(header_size + size) : ncnn::fastMalloc(header_size + size));
+    if (!ptr)
+        return 0;
+
+    TrackingHeader* header = (TrackingHeader*)ptr;
+    header->size = size;
+    header->layer_index = load_acquire(&d->layer_index);
+
+    int bucket = 0;
+    while (bucket < 31 && (size >> (bucket + 1)) != 0)
+    {
+        bucket++;
+    }
+
+    {
+        MutexLockGuard guard(d->lock);
+
+        LayerStats& stats = d->layer_stats(header->layer_index);
+        stats.malloc_count++;
+        stats.live_bytes += size;
+        stats.peak_bytes = std::max(stats.peak_bytes, stats.live_bytes);
+        stats.size_histogram[bucket]++;
+
+        d->malloc_count++;
+        d->live_bytes += size;
+        if (d->live_bytes > d->peak_bytes)
+        {
+            // the other layers take their live bytes at the new peak when they next change
+            d->peak_bytes = d->live_bytes;
+            d->peak_version++;
+            stats.bytes_at_peak = stats.live_bytes;
+            d->peak_versions[header->layer_index + 1] = d->peak_version;
+        }
+    }
+
+    return ptr + header_size;
+}
+
+void TrackingAllocator::fastFree(void* ptr)
+{
+    if (!ptr)
+        return;
+
+    unsigned char* base = (unsigned char*)ptr - tracking_header_size();
+    const TrackingHeader* header = (const TrackingHeader*)base;
+
+    {
+        MutexLockGuard guard(d->lock);
+
+        d->layer_stats(header->layer_index).live_bytes -= header->size;
+        d->live_bytes -= header->size;
+    }
+
+    if (d->allocator)
+        d->allocator->fastFree(base);
+    else
+        ncnn::fastFree(base);
+}
+
+
 #if NCNN_VULKAN
 VkAllocator::VkAllocator(const VulkanDevice* _vkdev)
     : vkdev(_vkdev)
@@ -9,6 +9,10 @@
 #include <windows.h>
 #endif
 
+#if defined _MSC_VER && !defined __clang__
+#include <intrin.h>
+#endif
+
 #include "platform.h"
 
 #include <stdlib.h>
@@ -21,6 +25,8 @@
 
 namespace ncnn {
 
+class Layer;
+
 // the alignment of all the allocated buffers
 #if NCNN_AVX512
 #define NCNN_MALLOC_ALIGN 64
@@ -139,6 +145,30 @@ static NCNN_FORCEINLINE int NCNN_XADD(int* addr, int delta)
 }
 #endif // NCNN_THREADS
 
+// flag load and store ordering the data written before the store
+static NCNN_FORCEINLINE int load_acquire(const int* addr)
+{
+#if defined _MSC_VER && !defined __clang__
+    return (int)_InterlockedCompareExchange((long volatile*)addr, 0, 0);
+#elif defined __ATOMIC_ACQUIRE
+    return __atomic_load_n(addr, __ATOMIC_ACQUIRE);
+#else
+    return (int)__sync_fetch_and_add((int*)addr, 0);
+#endif
+}
+
+static NCNN_FORCEINLINE void store_release(int* addr, int value)
+{
+#if defined _MSC_VER && !defined __clang__
+    _InterlockedExchange((long volatile*)addr, value);
+#elif defined __ATOMIC_RELEASE
+    __atomic_store_n(addr, value, __ATOMIC_RELEASE);
+#else
+    __sync_synchronize();
+    *(volatile int*)addr = value;
+#endif
+}
+
 class NCNN_EXPORT Allocator
 {
 public:
@@ -205,6 +235,113 @@ private:
     UnlockedPoolAllocatorPrivate* const d;
 };
 
+// backs large buffers with 2 MiB pages to cut the tlb misses of gemm on big weights and feature maps
+//
+// buffers of at least the huge page size are mapped 2 MiB aligned and advised with MADV_HUGEPAGE,
+// or taken from the hugetlbfs pool first when enabled, smaller buffers and other platforms use fastMalloc
+// freed mappings are kept for reuse like PoolAllocator, so it also serves as blob allocator
+// thread-safe
+class HugePageAllocatorPrivate;
+class NCNN_EXPORT HugePageAllocator : public Allocator
+{
+public:
+    HugePageAllocator();
+    ~HugePageAllocator();
+
+    // try MAP_HUGETLB before transparent huge pages, needs reserved pages in /proc/sys/vm/nr_hugepages
+    // default false
+    void set_use_hugetlb(bool enable);
+
+    // freed mappings kept for reuse, set a few when serving blobs
+    // default threshold = 0, weights released after create_pipeline go back to the system
+    void set_size_drop_threshold(size_t);
+
+    // release all kept mappings immediately
+    void clear();
+
+    // bytes of the buffers in use, and the highest it has been
+    size_t allocated_bytes() const;
+    size_t peak_allocated_bytes() const;
+
+    // bytes of the buffers in use which are backed by huge pages or advised to be
+    size_t huge_page_bytes() const;
+
+    // large buffers which got neither hugetlbfs pages nor the MADV_HUGEPAGE advice
+    int fallback_count() const;
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+private:
+    HugePageAllocator(const HugePageAllocator&);
+    HugePageAllocator& operator=(const HugePageAllocator&);
+
+private:
+    HugePageAllocatorPrivate* const d;
+};
+
+// counts the memory passing through another allocator, per layer of the cpu extractor using it
+//
+// use it as blob or workspace allocator to find the layers behind the peak memory,
+// bytes_at_peak of a layer are its buffers still alive when the allocator reached its peak,
+// such as the outputs waiting for their consumers in light mode
+// the extractor sets the running layer on the allocator, so the openmp workers are charged to it too,
+// give every concurrent extractor its own tracking allocator to keep their layers apart
+// thread-safe if the wrapped allocator is
+class TrackingAllocatorPrivate;
+class NCNN_EXPORT TrackingAllocator : public Allocator
+{
+public:
+    // allocator null means ncnn::fastMalloc, it must outlive the tracking allocator
+    TrackingAllocator(Allocator* allocator = 0);
+    ~TrackingAllocator();
+
+    struct LayerStats
+    {
+        // -1 for the buffers allocated outside of any layer
+        int layer_index;
+        int malloc_count;
+
+        size_t live_bytes;
+        size_t peak_bytes;
+        size_t bytes_at_peak;
+
+        // malloc count by size, bucket i holds [2^i, 2^(i+1)) bytes
+        int size_histogram[32];
+    };
+
+    // start counting again, the buffers in use stay live
+    void reset();
+
+    size_t live_bytes() const;
+    size_t peak_bytes() const;
+    int malloc_count() const;
+
+    // the layers with any malloc, in layer order
+    std::vector<LayerStats> layer_stats() const;
+
+    // print the layers holding the most bytes at peak, named from layers if given, such as net.layers()
+    void print_report(const std::vector<Layer*>& layers = std::vector<Layer*>(), int top_count = 10) const;
+
+    // the layer charged with the following mallocs on any thread, -1 if none
+    // Extractor sets it around each layer forward
+    int layer_index() const;
+    void set_layer_index(int layer_index);
+
+    // the live tracking allocator behind allocator, null if it is not one
+    static TrackingAllocator* find(const Allocator* allocator);
+
+    virtual void* fastMalloc(size_t size);
+    virtual void fastFree(void* ptr);
+
+private:
+    TrackingAllocator(const TrackingAllocator&);
+    TrackingAllocator& operator=(const TrackingAllocator&);
+
+private:
+    TrackingAllocatorPrivate* const d;
+};
+
 #if NCNN_VULKAN
 
 class VulkanDevice;
@@ -0,0 +1,431 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "asyncextractor.h"
+
+#include "extractorpool.h"
+
+#include <list>
+
+namespace ncnn {
+
+class ExtractFuturePrivate
+{
+public:
+    ExtractFuturePrivate()
+        : refcount(1), done(false), ret(0), callback(0), userdata(0)
+    {
+    }
+
+    void addref()
+    {
+        NCNN_XADD(&refcount, 1);
+    }
+
+    void release()
+    {
+        if (NCNN_XADD(&refcount, -1) == 1)
+            delete this;
+    }
+
+    int refcount;
+
+    Mutex lock;
+    ConditionVariable condition;
+    bool done;
+    int ret;
+
+    std::vector<int> input_indexes;
+    std::vector<Mat> inputs;
+    std::vector<int> output_indexes;
+    std::vector<Mat> outputs;
+
+    extract_callback_func callback;
+    void* userdata;
+};
+
+ExtractFuture::ExtractFuture()
+    : d(0)
+{
+}
+
+ExtractFuture::ExtractFuture(const ExtractFuture& f)
+    : d(f.d)
+{
+    if (d)
+        d->addref();
+}
+
+ExtractFuture& ExtractFuture::operator=(const ExtractFuture& f)
+{
+    if (this == &f)
+        return *this;
+
+    if (f.d)
+        f.d->addref();
+
+    if (d)
+        d->release();
+
+    d = f.d;
+
+    return *this;
+}
+
+ExtractFuture::~ExtractFuture()
+{
+    if (d)
+        d->release();
+}
+
+bool ExtractFuture::valid() const
+{
+    return d != 0;
+}
+
+bool ExtractFuture::ready() const
+{
+    if (!d)
+        return false;
+
+    MutexLockGuard guard(d->lock);
+    return d->done;
+}
+
+int ExtractFuture::wait() const
+{
+    if (!d)
+    {
+        NCNN_LOGE("ExtractFuture wait on invalid future");
+        return -1;
+    }
+
+    MutexLockGuard guard(d->lock);
+    while (!d->done)
+    {
+        d->condition.wait(d->lock);
+    }
+
+    return d->ret;
+}
+
+int ExtractFuture::get(std::vector<Mat>& outputs) const
+{
+    int ret = wait();
+    if (d)
+        outputs = d->outputs;
+
+    return ret;
+}
+
+class AsyncExtractorPrivate;
+struct AsyncExtractorWorkerArgs
+{
+    AsyncExtractorPrivate* d;
+    int worker;
+};
+
+class AsyncExtractorPrivate
+{
+public:
+    // queue the request, false if the queue is full and block is false
+    bool enqueue(ExtractFuturePrivate* request, bool block);
+
+    // run one request on the extractor of a pool worker and finish its future
+    void run(ExtractFuturePrivate* request, int worker);
+
+    const Net* net;
+    ExtractorPool* pool;
+
+    std::vector<Thread*> threads;
+    std::vector<AsyncExtractorWorkerArgs> worker_args;
+
+    int queue_size;
+    std::list<ExtractFuturePrivate*> queue;
+
+    // requests taken by a worker and not yet finished
+    int running_count;
+    bool stopping;
+
+    Mutex lock;
+    ConditionVariable queue_not_empty;
+    ConditionVariable queue_not_full;
+    ConditionVariable idle;
+};
+
+bool AsyncExtractorPrivate::enqueue(ExtractFuturePrivate* request, bool block)
+{
+#if NCNN_THREADS
+    {
+        MutexLockGuard guard(lock);
+
+        while ((int)queue.size() >= queue_size)
+        {
+            if (!block)
+                return false;
+
+            queue_not_full.wait(lock);
+        }
+
+        // one reference for the queue
+        request->addref();
+        queue.push_back(request);
+    }
+
+    queue_not_empty.signal();
+#else
+    (void)block;
+    run(request, 0);
+#endif // NCNN_THREADS
+
+    return true;
+}
+
+void AsyncExtractorPrivate::run(ExtractFuturePrivate* request, int worker)
+{
+    int ret = 0;
+    std::vector<Mat> outputs(request->output_indexes.size());
+    {
+        Extractor ex = pool->create_extractor(worker);
+
+        for (size_t i = 0; i < request->input_indexes.size() && ret == 0; i++)
+        {
+            ret = ex.input(request->input_indexes[i], request->inputs[i]);
+        }
+
+        for (size_t i = 0; i < request->output_indexes.size() && ret == 0; i++)
+        {
+            Mat out;
+            ret = ex.extract(request->output_indexes[i], out);
+
+            // the worker blob allocator is not shared with the caller
+            outputs[i] = out.allocator ? out.clone() : out;
+        }
+    }
+
+    // drop the input references as early as possible
+    request->inputs.clear();
+    request->outputs = outputs;
+    request->ret = ret;
+
+    if (request->callback)
+    {
+        request->callback(ret, request->outputs, request->userdata);
+    }
+
+    {
+        MutexLockGuard guard(request->lock);
+        request->done = true;
+    }
+
+    request->condition.broadcast();
+}
+
+static void* async_extractor_worker(void* args)
+{
+    AsyncExtractorWorkerArgs* worker_args = (AsyncExtractorWorkerArgs*)args;
+    AsyncExtractorPrivate* d = worker_args->d;
+    const int worker = worker_args->worker;
+
+    for (;;)
+    {
+        ExtractFuturePrivate* request = 0;
+        {
+            MutexLockGuard guard(d->lock);
+
+            while (d->queue.empty() && !d->stopping)
+            {
+                d->queue_not_empty.wait(d->lock);
+            }
+
+            // stop once the queue is drained
+            if (d->queue.empty())
+                break;
+
+            request = d->queue.front();
+            d->queue.pop_front();
+            d->running_count++;
+        }
+
+        d->queue_not_full.signal();
+
+        d->run(request, worker);
+
+        request->release();
+
+        {
+            MutexLockGuard guard(d->lock);
+            d->running_count--;
+            if (d->queue.empty() && d->running_count == 0)
+                d->idle.broadcast();
+        }
+    }
+
+    return 0;
+}
+
+AsyncExtractor::AsyncExtractor(const Net* net, int worker_count, int queue_size)
+    : d(new AsyncExtractorPrivate)
+{
+    if (worker_count <= 0)
+        worker_count = 1;
+
+    d->net = net;
+    d->pool = new ExtractorPool(net, worker_count);
+    d->queue_size = queue_size > 0 ? queue_size : 1;
+    d->running_count = 0;
+    d->stopping = false;
+
+#if NCNN_THREADS
+    d->worker_args.resize(worker_count);
+    d->threads.resize(worker_count);
+    for (int i = 0; i < worker_count; i++)
+    {
+        // each thread owns one pool worker for its lifetime
+        d->worker_args[i].d = d;
+        d->worker_args[i].worker = d->pool->acquire();
+        d->threads[i] = new Thread(async_extractor_worker, &d->worker_args[i]);
+    }
+#endif // NCNN_THREADS
+}
+
+AsyncExtractor::~AsyncExtractor()
+{
+    {
+        MutexLockGuard guard(d->lock);
+        d->stopping = true;
+    }
+
+    d->queue_not_empty.broadcast();
+
+    for (size_t i = 0; i < d->threads.size(); i++)
+    {
+        d->threads[i]->join();
+        delete d->threads[i];
+
+        d->pool->release(d->worker_args[i].worker);
+    }
+
+    delete d->pool;
+    delete d;
+}
+
+AsyncExtractor::AsyncExtractor(const AsyncExtractor&)
+    : d(0)
+{
+}
+
+AsyncExtractor& AsyncExtractor::operator=(const AsyncExtractor&)
+{
+    return *this;
+}
+
+#if NCNN_STRING
+static int find_blob_indexes(const Net* net, const std::vector<const char*>& names, std::vector<int>& indexes)
+{
+    const std::vector<Blob>& blobs = net->blobs();
+
+    indexes.resize(names.size());
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        indexes[i] = -1;
+        for (size_t j = 0; j < blobs.size(); j++)
+        {
+            if (blobs[j].name == names[i])
+            {
+                indexes[i] = (int)j;
+                break;
+            }
+        }
+
+        if (indexes[i] == -1)
+        {
+            NCNN_LOGE("AsyncExtractor blob %s not exists", names[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+ExtractFuture AsyncExtractor::submit(const std::vector<const char*>& input_names, const std::vector<Mat>& inputs, const std::vector<const char*>& output_names, extract_callback_func callback, void* userdata)
+{
+    std::vector<int> input_indexes;
+    std::vector<int> output_indexes;
+    if (find_blob_indexes(d->net, input_names, input_indexes) != 0 || find_blob_indexes(d->net, output_names, output_indexes) != 0)
+        return ExtractFuture();
+
+    return submit(input_indexes, inputs, output_indexes, callback, userdata);
+}
+
+ExtractFuture AsyncExtractor::try_submit(const std::vector<const char*>& input_names, const std::vector<Mat>& inputs, const std::vector<const char*>& output_names, extract_callback_func callback, void* userdata)
+{
+    std::vector<int> input_indexes;
+    std::vector<int> output_indexes;
+    if (find_blob_indexes(d->net, input_names, input_indexes) != 0 || find_blob_indexes(d->net, output_names, output_indexes) != 0)
+        return ExtractFuture();
+
+    return try_submit(input_indexes, inputs, output_indexes, callback, userdata);
+}
+#endif // NCNN_STRING
+
+static ExtractFuturePrivate* create_request(const std::vector<int>& input_indexes, const std::vector<Mat>& inputs, const std::vector<int>& output_indexes, extract_callback_func callback, void* userdata)
+{
+    if (input_indexes.size() != inputs.size())
+    {
+        NCNN_LOGE("AsyncExtractor %d input indexes for %d inputs", (int)input_indexes.size(), (int)inputs.size());
+        return 0;
+    }
+
+    ExtractFuturePrivate* request = new ExtractFuturePrivate;
+    request->input_indexes = input_indexes;
+    request->inputs = inputs;
+    request->output_indexes = output_indexes;
+    request->callback = callback;
+    request->userdata = userdata;
+
+    return request;
+}
+
+ExtractFuture AsyncExtractor::submit(const std::vector<int>& input_indexes, const std::vector<Mat>& inputs, const std::vector<int>& output_indexes, extract_callback_func callback, void* userdata)
+{
+    ExtractFuture future;
+    future.d = create_request(input_indexes, inputs, output_indexes, callback, userdata);
+    if (future.d)
+        d->enqueue(future.d, true);
+
+    return future;
+}
+
+ExtractFuture AsyncExtractor::try_submit(const std::vector<int>& input_indexes, const std::vector<Mat>& inputs, const std::vector<int>& output_indexes, extract_callback_func callback, void* userdata)
+{
+    ExtractFuture future;
+    future.d = create_request(input_indexes, inputs, output_indexes, callback, userdata);
+    if (future.d && !d->enqueue(future.d, false))
+        return ExtractFuture();
+
+    return future;
+}
+
+void AsyncExtractor::wait_all()
+{
+    MutexLockGuard guard(d->lock);
+
+    while (!d->queue.empty() || d->running_count > 0)
+    {
+        d->idle.wait(d->lock);
+    }
+}
+
+int AsyncExtractor::worker_count() const
+{
+    return d->pool->worker_count();
+}
+
+int AsyncExtractor::pending_count() const
+{
+    MutexLockGuard guard(d->lock);
+    return (int)d->queue.size();
+}
+
+} // namespace ncnn
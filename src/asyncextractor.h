@@ -0,0 +1,103 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_ASYNCEXTRACTOR_H
+#define NCNN_ASYNCEXTRACTOR_H
+
+#include "mat.h"
+#include "net.h"
+#include "platform.h"
+
+namespace ncnn {
+
+// called on the worker thread when a request has finished, before its future becomes ready
+// outputs are in the order of the requested output blobs
+typedef void (*extract_callback_func)(int ret, const std::vector<Mat>& outputs, void* userdata);
+
+// the result of a request queued to an AsyncExtractor
+// copies refer to the same request
+class ExtractFuturePrivate;
+class NCNN_EXPORT ExtractFuture
+{
+public:
+    // invalid future
+    ExtractFuture();
+    ExtractFuture(const ExtractFuture& f);
+    ExtractFuture& operator=(const ExtractFuture& f);
+    ~ExtractFuture();
+
+    // false if the request was not queued
+    bool valid() const;
+
+    // true once the request has finished
+    bool ready() const;
+
+    // block until the request has finished
+    // return the extract result, 0 if success
+    int wait() const;
+
+    // block until the request has finished and get the outputs in the order of the requested output blobs
+    // return the extract result, 0 if success
+    int get(std::vector<Mat>& outputs) const;
+
+private:
+    friend class AsyncExtractor;
+    ExtractFuturePrivate* d;
+};
+
+// run extract requests of one loaded net on worker threads
+//
+// submit() only queues the inputs and returns a future, so the caller may preprocess
+// the next input or postprocess the previous outputs while the workers run inference
+// at most queue_size requests wait for a worker, a full queue blocks submit() and fails try_submit()
+// requests start in the submission order, each worker extracts with its own ExtractorPool allocators
+// the outputs are copied out of the worker allocators and may be kept freely
+//
+// every worker runs layers with net->opt.num_threads threads,
+// load the net with the per-worker thread budget, see ExtractorPool::threads_per_worker()
+// without NCNN_THREADS the request runs in submit()
+class AsyncExtractorPrivate;
+class NCNN_EXPORT AsyncExtractor
+{
+public:
+    // net must be loaded and must outlive the async extractor
+    AsyncExtractor(const Net* net, int worker_count, int queue_size);
+
+    // finish all queued requests, then stop the workers
+    virtual ~AsyncExtractor();
+
+#if NCNN_STRING
+    // queue a request, block while the queue is full
+    // the input mats are referenced until the request has finished
+    // return an invalid future if a blob name is unknown
+    ExtractFuture submit(const std::vector<const char*>& input_names, const std::vector<Mat>& inputs, const std::vector<const char*>& output_names, extract_callback_func callback = 0, void* userdata = 0);
+
+    // queue a request, return an invalid future if the queue is full
+    ExtractFuture try_submit(const std::vector<const char*>& input_names, const std::vector<Mat>& inputs, const std::vector<const char*>& output_names, extract_callback_func callback = 0, void* userdata = 0);
+#endif // NCNN_STRING
+
+    // queue a request by blob indexes, block while the queue is full
+    ExtractFuture submit(const std::vector<int>& input_indexes, const std::vector<Mat>& inputs, const std::vector<int>& output_indexes, extract_callback_func callback = 0, void* userdata = 0);
+
+    // queue a request by blob indexes, return an invalid future if the queue is full
+    ExtractFuture try_submit(const std::vector<int>& input_indexes, const std::vector<Mat>& inputs, const std::vector<int>& output_indexes, extract_callback_func callback = 0, void* userdata = 0);
+
+    // block until every queued request has finished
+    void wait_all();
+
+    int worker_count() const;
+
+    // requests waiting for a worker
+    int pending_count() const;
+
+private:
+    AsyncExtractor(const AsyncExtractor&);
+    AsyncExtractor& operator=(const AsyncExtractor&);
+
+private:
+    AsyncExtractorPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_ASYNCEXTRACTOR_H
@@ -0,0 +1,220 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "extractorpool.h"
+
+#include "cpu.h"
+
+#if NCNN_VULKAN
+#include "gpu.h"
+#endif // NCNN_VULKAN
+
+namespace ncnn {
+
+class ExtractorPoolWorker
+{
+public:
+    ExtractorPoolWorker()
+        : busy(false)
+    {
+#if NCNN_VULKAN
+        blob_vkallocator = 0;
+        staging_vkallocator = 0;
+#endif // NCNN_VULKAN
+    }
+
+    bool busy;
+
+    UnlockedPoolAllocator blob_allocator;
+    PoolAllocator workspace_allocator;
+
+#if NCNN_VULKAN
+    VkAllocator* blob_vkallocator;
+    VkAllocator* staging_vkallocator;
+#endif // NCNN_VULKAN
+};
+
+class ExtractorPoolPrivate
+{
+public:
+    const Net* net;
+    std::vector<ExtractorPoolWorker*> workers;
+
+    Mutex lock;
+    ConditionVariable condition;
+};
+
+ExtractorPool::ExtractorPool(const Net* net, int worker_count)
+    : d(new ExtractorPoolPrivate)
+{
+    d->net = net;
+
+    d->workers.resize(worker_count > 0 ? worker_count : 1);
+    for (size_t i = 0; i < d->workers.size(); i++)
+    {
+        ExtractorPoolWorker* worker = new ExtractorPoolWorker;
+
+#if NCNN_VULKAN
+        if (net->opt.use_vulkan_compute && net->vulkan_device())
+        {
+            worker->blob_vkallocator = net->vulkan_device()->acquire_blob_allocator();
+            worker->staging_vkallocator = net->vulkan_device()->acquire_staging_allocator();
+        }
+#endif // NCNN_VULKAN
+
+        d->workers[i] = worker;
+    }
+
+    // every worker runs layers with net->opt.num_threads threads
+    const int worker_threads = threads_per_worker((int)d->workers.size());
+    if (net->opt.num_threads > worker_threads)
+    {
+        NCNN_LOGE("ExtractorPool %d workers with num_threads %d oversubscribe the cpu, load the net with num_threads %d", (int)d->workers.size(), net->opt.num_threads, worker_threads);
+    }
+}
+
+ExtractorPool::~ExtractorPool()
+{
+    for (size_t i = 0; i < d->workers.size(); i++)
+    {
+        ExtractorPoolWorker* worker = d->workers[i];
+
+        if (worker->busy)
+        {
+            NCNN_LOGE("ExtractorPool destroyed while worker %d is still in use", (int)i);
+        }
+
+#if NCNN_VULKAN
+        if (worker->blob_vkallocator)
+            d->net->vulkan_device()->reclaim_blob_allocator(worker->blob_vkallocator);
+        if (worker->staging_vkallocator)
+            d->net->vulkan_device()->reclaim_staging_allocator(worker->staging_vkallocator);
+#endif // NCNN_VULKAN
+
+        delete worker;
+    }
+
+    delete d;
+}
+
+ExtractorPool::ExtractorPool(const ExtractorPool&)
+    : d(0)
+{
+}
+
+ExtractorPool& ExtractorPool::operator=(const ExtractorPool&)
+{
+    return *this;
+}
+
+int ExtractorPool::worker_count() const
+{
+    return (int)d->workers.size();
+}
+
+int ExtractorPool::acquire()
+{
+    MutexLockGuard guard(d->lock);
+
+    for (;;)
+    {
+        for (size_t i = 0; i < d->workers.size(); i++)
+        {
+            if (!d->workers[i]->busy)
+            {
+                d->workers[i]->busy = true;
+                return (int)i;
+            }
+        }
+
+        d->condition.wait(d->lock);
+    }
+}
+
+int ExtractorPool::try_acquire()
+{
+    MutexLockGuard guard(d->lock);
+
+    for (size_t i = 0; i < d->workers.size(); i++)
+    {
+        if (!d->workers[i]->busy)
+        {
+            d->workers[i]->busy = true;
+            return (int)i;
+        }
+    }
+
+    return -1;
+}
+
+void ExtractorPool::release(int worker)
+{
+    if (worker < 0 || worker >= (int)d->workers.size())
+    {
+        NCNN_LOGE("ExtractorPool release invalid worker %d", worker);
+        return;
+    }
+
+    {
+        MutexLockGuard guard(d->lock);
+        d->workers[worker]->busy = false;
+    }
+
+    d->condition.signal();
+}
+
+Extractor ExtractorPool::create_extractor(int worker) const
+{
+    Extractor ex = d->net->create_extractor();
+
+    if (worker < 0 || worker >= (int)d->workers.size())
+    {
+        NCNN_LOGE("ExtractorPool create_extractor invalid worker %d", worker);
+        return ex;
+    }
+
+    ExtractorPoolWorker* w = d->workers[worker];
+
+    ex.set_blob_allocator(&w->blob_allocator);
+    ex.set_workspace_allocator(&w->workspace_allocator);
+
+#if NCNN_VULKAN
+    if (w->blob_vkallocator)
+    {
+        ex.set_blob_vkallocator(w->blob_vkallocator);
+        ex.set_workspace_vkallocator(w->blob_vkallocator);
+        ex.set_staging_vkallocator(w->staging_vkallocator);
+    }
+#endif // NCNN_VULKAN
+
+    return ex;
+}
+
+void ExtractorPool::clear()
+{
+    MutexLockGuard guard(d->lock);
+
+    for (size_t i = 0; i < d->workers.size(); i++)
+    {
+        ExtractorPoolWorker* worker = d->workers[i];
+        if (worker->busy)
+            continue;
+
+        worker->blob_allocator.clear();
+        worker->workspace_allocator.clear();
+    }
+}
+
+int ExtractorPool::threads_per_worker(int worker_count, int thread_budget)
+{
+    if (thread_budget <= 0)
+        thread_budget = get_physical_big_cpu_count();
+
+    if (worker_count <= 0)
+        worker_count = 1;
+
+    int num_threads = thread_budget / worker_count;
+    return num_threads > 0 ? num_threads : 1;
+}
+
+} // namespace ncnn
@@ -0,0 +1,60 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_EXTRACTORPOOL_H
+#define NCNN_EXTRACTORPOOL_H
+
+#include "net.h"
+#include "platform.h"
+
+namespace ncnn {
+
+// serve one loaded net from several threads concurrently
+//
+// each worker owns an unlocked blob allocator and a locked workspace allocator,
+// which is the allocator setup recommended for one network with concurrent inference
+// a worker is used by one thread at a time between acquire() and release()
+//
+// every worker runs layers with net->opt.num_threads threads,
+// load the net with the per-worker thread budget, see threads_per_worker()
+// the pool warns when net->opt.num_threads exceeds threads_per_worker(worker_count)
+class ExtractorPoolPrivate;
+class NCNN_EXPORT ExtractorPool
+{
+public:
+    // net must be loaded and must outlive the pool
+    ExtractorPool(const Net* net, int worker_count);
+    virtual ~ExtractorPool();
+
+    int worker_count() const;
+
+    // block until a worker is idle, return its index
+    int acquire();
+
+    // return the index of an idle worker, or -1 if all workers are busy
+    int try_acquire();
+
+    // give the worker back to the pool
+    void release(int worker);
+
+    // create an extractor bound to the worker allocators
+    Extractor create_extractor(int worker) const;
+
+    // release the pooled memory of all idle workers
+    void clear();
+
+    // split thread_budget threads evenly among worker_count workers, at least one thread each
+    // thread_budget = 0 means all physical big cpu cores
+    static int threads_per_worker(int worker_count, int thread_budget = 0);
+
+private:
+    ExtractorPool(const ExtractorPool&);
+    ExtractorPool& operator=(const ExtractorPool&);
+
+private:
+    ExtractorPoolPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_EXTRACTORPOOL_H
@@ -23,7 +23,7 @@ Layer::Layer()
     support_int8_storage = false;
     support_tensor_storage = false;
 
-    support_reserved_000 = false;
+    support_streaming = false;
     support_reserved_00 = false;
 
     featmask = 0;
@@ -98,6 +98,11 @@ int Layer::forward_inplace(Mat& /*bottom_top_blob*/, const Option& /*opt*/) cons
     return -1;
 }
 
+int Layer::forward_streaming(const Mat& /*bottom_blob*/, Mat& /*top_blob*/, Mat& /*state*/, const Option& /*opt*/) const
+{
+    return -1;
+}
+
 #if NCNN_VULKAN
 int Layer::upload_model(VkTransfer& /*cmd*/, const Option& /*opt*/)
 {
@@ -238,6 +243,7 @@ public:
         support_bf16_storage = layer_cpu->support_bf16_storage;
         support_fp16_storage = layer_cpu->support_fp16_storage;
         support_int8_storage = layer_cpu->support_int8_storage;
+        support_streaming = layer_cpu->support_streaming;
 
         support_vulkan = 0;
         support_tensor_storage = 0;
@@ -367,6 +373,11 @@ public:
         return layer_cpu->forward_inplace(bottom_top_blob, opt);
     }
 
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const
+    {
+        return layer_cpu->forward_streaming(bottom_blob, top_blob, state, opt);
+    }
+
 #if NCNN_VULKAN
 public:
     virtual int upload_model(VkTransfer& cmd, const Option& opt)
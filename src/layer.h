@@ -66,7 +66,8 @@ public:
     // shader tensor storage
     bool support_tensor_storage;
 
-    bool support_reserved_000;
+    // support stateful chunked inference with forward_streaming
+    bool support_streaming;
 
     bool support_reserved_00;
 
@@ -95,6 +96,12 @@ public:
     virtual int forward_inplace(std::vector<Mat>& bottom_top_blobs, const Option& opt) const;
     virtual int forward_inplace(Mat& bottom_top_blob, const Option& opt) const;
 
+    // implement streaming inference on consecutive chunks of one stream along w
+    // state keeps the left context between chunks, empty state marks the start of a stream
+    // top_blob holds only the outputs completed by this chunk, possibly none
+    // return 0 if success
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const;
+
 #if NCNN_VULKAN
 public:
     // upload weight blob from host to device
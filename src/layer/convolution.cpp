@@ -6,6 +6,7 @@
 #include "layer_type.h"
 
 #include "fused_activation.h"
+#include "sparse_weight.h"
 
 namespace ncnn {
 
@@ -36,6 +37,13 @@ int Convolution::load_param(const ParamDict& pd)
     activation_params = pd.get(10, Mat());
 
     dynamic_weight = pd.get(19, 0);
+    sparse_format = pd.get(20, 0);
+
+    if (sparse_format && int8_scale_term)
+    {
+        NCNN_LOGE("2:4 sparse weight does not support int8_scale_term %d", int8_scale_term);
+        return -1;
+    }
 
     if (dynamic_weight)
     {
@@ -60,7 +68,36 @@ int Convolution::load_model(const ModelBin& mb)
     if (dynamic_weight)
         return 0;
 
-    weight_data = mb.load(weight_data_size, 0);
+    if (sparse_format == 1)
+    {
+        const int num_input_maxk = weight_data_size / num_output;
+        if (num_input_maxk % 4 != 0)
+        {
+            NCNN_LOGE("2:4 sparse weight requires num_input * maxk %d to be a multiple of 4", num_input_maxk);
+            return -1;
+        }
+
+        // unpack to dense, the optimized implementations pack it again
+        Mat weight_sparse_data = mb.load(weight_data_size / 2, 0);
+        Mat weight_sparse_index = mb.load(weight_data_size / 4, 0);
+        if (weight_sparse_data.empty() || weight_sparse_index.empty())
+            return -100;
+
+        // the index bytes are stored as int8 data, never converted
+        if (weight_sparse_index.elemsize != 1u)
+        {
+            NCNN_LOGE("2:4 sparse weight index must be int8 data, got elemsize %d", (int)weight_sparse_index.elemsize);
+            return -1;
+        }
+
+        int ret = sparse_2to4_unpack(weight_sparse_data, weight_sparse_index, weight_data, num_input_maxk, num_output);
+        if (ret != 0)
+            return ret;
+    }
+    else
+    {
+        weight_data = mb.load(weight_data_size, 0);
+    }
     if (weight_data.empty())
         return -100;
 
@@ -75,6 +112,11 @@ int Convolution::load_model(const ModelBin& mb)
     if (int8_scale_term)
     {
         weight_data_int8_scales = mb.load(num_output, 1);
+    }
+
+    // int8_scale_term 3 quantizes the activations dynamically without stored scales
+    if (int8_scale_term && int8_scale_term != 3)
+    {
         bottom_blob_int8_scales = mb.load(1, 1);
     }
 
@@ -383,13 +425,43 @@ int Convolution::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Optio
     const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
     const int kernel_extent_h = dilation_h * (kernel_h - 1) + 1;
 
+    const bool dynamic_quantize = int8_scale_term == 3;
+    if (dynamic_quantize && elemsize == 1)
+    {
+        NCNN_LOGE("Convolution dynamic int8 quantization needs fp32 input");
+        return -1;
+    }
+
+    // dynamic activation scale for the whole blob
+    Mat bottom_blob_int8_scales_dynamic;
+    if (dynamic_quantize)
+    {
+        bottom_blob_int8_scales_dynamic.create(1, (size_t)4u, opt.workspace_allocator);
+        if (bottom_blob_int8_scales_dynamic.empty())
+            return -100;
+
+        float absmax = 0.f;
+        for (int q = 0; q < channels; q++)
+        {
+            const float* ptr = bottom_blob.channel(q);
+            for (int i = 0; i < w * h; i++)
+            {
+                absmax = std::max(absmax, (float)fabsf(ptr[i]));
+            }
+        }
+
+        bottom_blob_int8_scales_dynamic[0] = absmax == 0.f ? 1.f : 127.f / absmax;
+    }
+
+    const Mat& bottom_scales = dynamic_quantize ? bottom_blob_int8_scales_dynamic : bottom_blob_int8_scales;
+
     Mat bottom_blob_unbordered = bottom_blob;
     if (elemsize != 1)
     {
         Option opt_g = opt;
         opt_g.blob_allocator = opt.workspace_allocator;
 
-        quantize_to_int8(bottom_blob, bottom_blob_unbordered, bottom_blob_int8_scales, opt_g);
+        quantize_to_int8(bottom_blob, bottom_blob_unbordered, bottom_scales, opt_g);
         if (bottom_blob_unbordered.empty())
             return -100;
     }
@@ -468,7 +540,7 @@ int Convolution::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Optio
                 if (weight_data_int8_scales[p] == 0)
                     scale_in = 0;
                 else
-                    scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+                    scale_in = 1.f / (bottom_scales[0] * weight_data_int8_scales[p]);
 
                 float sumfp32 = sum * scale_in;
 
@@ -55,6 +55,9 @@ public:
 
     int dynamic_weight;
 
+    // 0=dense 1=2:4 structured sparse
+    int sparse_format;
+
     // model
     Mat weight_data;
     Mat bias_data;
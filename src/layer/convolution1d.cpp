@@ -4,6 +4,7 @@
 #include "convolution1d.h"
 
 #include "fused_activation.h"
+#include "streaming_window.h"
 
 namespace ncnn {
 
@@ -34,6 +35,8 @@ int Convolution1D::load_param(const ParamDict& pd)
         one_blob_only = false;
     }
 
+    support_streaming = !dynamic_weight && pad_left >= 0 && stride_w <= dilation_w * (kernel_w - 1) + 1;
+
     return 0;
 }
 
@@ -175,6 +178,34 @@ int Convolution1D::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat
     return 0;
 }
 
+int Convolution1D::forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const
+{
+    const int kernel_extent_w = dilation_w * (kernel_w - 1) + 1;
+
+    Mat bottom_blob_joined;
+    int out_offset = 0;
+    int out_count = 0;
+    int ret = streaming_window_prepare(bottom_blob, state, bottom_blob_joined, kernel_extent_w, stride_w, pad_left, BORDER_CONSTANT, pad_value, out_offset, out_count, opt);
+    if (ret != 0)
+        return ret;
+
+    if (out_count == 0)
+    {
+        top_blob.create(0, num_output, bottom_blob.elemsize / bottom_blob.elempack, opt.blob_allocator);
+        return 0;
+    }
+
+    // the arch specific forward also applies pad_left and pad_right, which only touch the outputs cut away here
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+    Mat top_blob_all;
+    ret = forward(bottom_blob_joined, top_blob_all, opt_b);
+    if (ret != 0)
+        return ret;
+
+    return streaming_slice_w(top_blob_all, top_blob, out_offset, out_count, opt.blob_allocator);
+}
+
 void Convolution1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     make_padding(bottom_blob, bottom_blob_bordered, kernel_w, opt);
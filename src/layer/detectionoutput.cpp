@@ -3,6 +3,8 @@
 
 #include "detectionoutput.h"
 
+#include "nms.h"
+
 namespace ncnn {
 
 DetectionOutput::DetectionOutput()
@@ -26,110 +28,6 @@ int DetectionOutput::load_param(const ParamDict& pd)
     return 0;
 }
 
-struct BBoxRect
-{
-    float xmin;
-    float ymin;
-    float xmax;
-    float ymax;
-    int label;
-};
-
-static inline float intersection_area(const BBoxRect& a, const BBoxRect& b)
-{
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin)
-    {
-        // no intersection
-        return 0.f;
-    }
-
-    float inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    float inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
-
-template<typename T>
-static void qsort_descent_inplace(std::vector<T>& datas, std::vector<float>& scores, int left, int right)
-{
-    int i = left;
-    int j = right;
-    float p = scores[(left + right) / 2];
-
-    while (i <= j)
-    {
-        while (scores[i] > p)
-            i++;
-
-        while (scores[j] < p)
-            j--;
-
-        if (i <= j)
-        {
-            // swap
-            std::swap(datas[i], datas[j]);
-            std::swap(scores[i], scores[j]);
-
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j)
-        qsort_descent_inplace(datas, scores, left, j);
-
-    if (i < right)
-        qsort_descent_inplace(datas, scores, i, right);
-}
-
-template<typename T>
-static void qsort_descent_inplace(std::vector<T>& datas, std::vector<float>& scores)
-{
-    if (datas.empty() || scores.empty())
-        return;
-
-    qsort_descent_inplace(datas, scores, 0, static_cast<int>(scores.size() - 1));
-}
-
-static void nms_sorted_bboxes(const std::vector<BBoxRect>& bboxes, std::vector<size_t>& picked, float nms_threshold)
-{
-    picked.clear();
-
-    const size_t n = bboxes.size();
-
-    std::vector<float> areas(n);
-    for (size_t i = 0; i < n; i++)
-    {
-        const BBoxRect& r = bboxes[i];
-
-        float width = r.xmax - r.xmin;
-        float height = r.ymax - r.ymin;
-
-        areas[i] = width * height;
-    }
-
-    for (size_t i = 0; i < n; i++)
-    {
-        const BBoxRect& a = bboxes[i];
-
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++)
-        {
-            const BBoxRect& b = bboxes[picked[j]];
-
-            // intersection over union
-            float inter_area = intersection_area(a, b);
-            float union_area = areas[i] + areas[picked[j]] - inter_area;
-            //             float IoU = inter_area / union_area
-            if (inter_area / union_area > nms_threshold)
-                keep = 0;
-        }
-
-        if (keep)
-            picked.push_back(i);
-    }
-}
-
 int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     const Mat& location = bottom_blobs[0];
@@ -144,10 +42,9 @@ int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
     int num_class_copy = mxnet_ssd_style ? confidence.h : num_class;
 
     // apply location with priorbox
-    Mat bboxes;
-    bboxes.create(4, num_prior, 4u, opt.workspace_allocator);
-    if (bboxes.empty())
-        return -100;
+    // the boxes are kept in structure of arrays layout for nms
+    NmsBoxes boxes;
+    boxes.resize(num_prior);
 
     const float* location_ptr = location;
     const float* priorbox_ptr = priorbox.row(0);
@@ -166,8 +63,6 @@ int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
         const float* pb = priorbox_ptr + i * 4;
         const float* var = variance_ptr ? variance_ptr + i * 4 : variances;
 
-        float* bbox = bboxes.row(i);
-
         // CENTER_SIZE
         float pb_w = pb[2] - pb[0];
         float pb_h = pb[3] - pb[1];
@@ -179,25 +74,22 @@ int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
         float bbox_w = expf(var[2] * loc[2]) * pb_w;
         float bbox_h = expf(var[3] * loc[3]) * pb_h;
 
-        bbox[0] = bbox_cx - bbox_w * 0.5f;
-        bbox[1] = bbox_cy - bbox_h * 0.5f;
-        bbox[2] = bbox_cx + bbox_w * 0.5f;
-        bbox[3] = bbox_cy + bbox_h * 0.5f;
+        boxes.set(i, bbox_cx - bbox_w * 0.5f, bbox_cy - bbox_h * 0.5f, bbox_cx + bbox_w * 0.5f, bbox_cy + bbox_h * 0.5f);
     }
 
     // sort and nms for each class
-    std::vector<std::vector<BBoxRect> > all_class_bbox_rects;
-    std::vector<std::vector<float> > all_class_bbox_scores;
-    all_class_bbox_rects.resize(num_class_copy);
-    all_class_bbox_scores.resize(num_class_copy);
+    std::vector<std::vector<int> > all_class_picked;
+    std::vector<std::vector<float> > all_class_scores;
+    all_class_picked.resize(num_class_copy);
+    all_class_scores.resize(num_class_copy);
 
     // start from 1 to ignore background class
     #pragma omp parallel for num_threads(opt.num_threads)
     for (int i = 1; i < num_class_copy; i++)
     {
         // filter by confidence_threshold
-        std::vector<BBoxRect> class_bbox_rects;
-        std::vector<float> class_bbox_scores;
+        std::vector<int> class_priors;
+        std::vector<float> class_scores;
 
         for (int j = 0; j < num_prior; j++)
         {
@@ -208,61 +100,58 @@ int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
 
             if (score > confidence_threshold)
             {
-                const float* bbox = bboxes.row(j);
-                BBoxRect c = {bbox[0], bbox[1], bbox[2], bbox[3], i};
-                class_bbox_rects.push_back(c);
-                class_bbox_scores.push_back(score);
+                class_priors.push_back(j);
+                class_scores.push_back(score);
             }
         }
 
-        // sort inplace
-        qsort_descent_inplace(class_bbox_rects, class_bbox_scores);
+        if (class_priors.empty())
+            continue;
 
         // keep nms_top_k
-        if (nms_top_k < (int)class_bbox_rects.size())
+        std::vector<int> order;
+        nms_sort_descent(&class_scores[0], (int)class_scores.size(), order, nms_top_k);
+
+        for (size_t j = 0; j < order.size(); j++)
         {
-            class_bbox_rects.resize(nms_top_k);
-            class_bbox_scores.resize(nms_top_k);
+            order[j] = class_priors[order[j]];
         }
 
         // apply nms
-        std::vector<size_t> picked;
-        nms_sorted_bboxes(class_bbox_rects, picked, nms_threshold);
+        std::vector<int> picked;
+        nms_sorted(boxes, order.empty() ? 0 : &order[0], (int)order.size(), nms_threshold, picked);
 
         // select
         for (size_t j = 0; j < picked.size(); j++)
         {
-            size_t z = picked[j];
-            all_class_bbox_rects[i].push_back(class_bbox_rects[z]);
-            all_class_bbox_scores[i].push_back(class_bbox_scores[z]);
+            const int z = picked[j];
+            all_class_picked[i].push_back(z);
+            all_class_scores[i].push_back(mxnet_ssd_style ? confidence[i * num_prior + z] : confidence[z * num_class_copy + i]);
         }
     }
 
     // gather all class
-    std::vector<BBoxRect> bbox_rects;
+    std::vector<int> bbox_priors;
+    std::vector<int> bbox_labels;
     std::vector<float> bbox_scores;
 
     for (int i = 1; i < num_class_copy; i++)
     {
-        const std::vector<BBoxRect>& class_bbox_rects = all_class_bbox_rects[i];
-        const std::vector<float>& class_bbox_scores = all_class_bbox_scores[i];
+        const std::vector<int>& class_picked = all_class_picked[i];
+        const std::vector<float>& class_scores = all_class_scores[i];
 
-        bbox_rects.insert(bbox_rects.end(), class_bbox_rects.begin(), class_bbox_rects.end());
-        bbox_scores.insert(bbox_scores.end(), class_bbox_scores.begin(), class_bbox_scores.end());
+        bbox_priors.insert(bbox_priors.end(), class_picked.begin(), class_picked.end());
+        bbox_labels.insert(bbox_labels.end(), class_picked.size(), i);
+        bbox_scores.insert(bbox_scores.end(), class_scores.begin(), class_scores.end());
     }
 
-    // global sort inplace
-    qsort_descent_inplace(bbox_rects, bbox_scores);
-
-    // keep_top_k
-    if (keep_top_k < (int)bbox_rects.size())
-    {
-        bbox_rects.resize(keep_top_k);
-        bbox_scores.resize(keep_top_k);
-    }
+    // global sort and keep_top_k
+    std::vector<int> order;
+    if (!bbox_scores.empty())
+        nms_sort_descent(&bbox_scores[0], (int)bbox_scores.size(), order, keep_top_k);
 
     // fill result
-    int num_detected = static_cast<int>(bbox_rects.size());
+    int num_detected = static_cast<int>(order.size());
     if (num_detected == 0)
         return 0;
 
@@ -273,16 +162,16 @@ int DetectionOutput::forward(const std::vector<Mat>& bottom_blobs, std::vector<M
 
     for (int i = 0; i < num_detected; i++)
     {
-        const BBoxRect& r = bbox_rects[i];
-        float score = bbox_scores[i];
+        const int z = order[i];
+        const int prior = bbox_priors[z];
         float* outptr = top_blob.row(i);
 
-        outptr[0] = static_cast<float>(r.label);
-        outptr[1] = score;
-        outptr[2] = r.xmin;
-        outptr[3] = r.ymin;
-        outptr[4] = r.xmax;
-        outptr[5] = r.ymax;
+        outptr[0] = static_cast<float>(bbox_labels[z]);
+        outptr[1] = bbox_scores[z];
+        outptr[2] = boxes.x0[prior];
+        outptr[3] = boxes.y0[prior];
+        outptr[4] = boxes.x1[prior];
+        outptr[5] = boxes.y1[prior];
     }
 
     return 0;
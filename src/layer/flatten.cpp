@@ -22,6 +22,16 @@ int Flatten::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) c
     size_t elemsize = bottom_blob.elemsize;
     int size = w * h * d;
 
+    if (bottom_blob.dims < 3 || bottom_blob.cstep == (size_t)size)
+    {
+        // no channel padding, reference the data as is
+        top_blob = bottom_blob.reshape(size * channels, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        return 0;
+    }
+
     top_blob.create(size * channels, elemsize, opt.blob_allocator);
     if (top_blob.empty())
         return -100;
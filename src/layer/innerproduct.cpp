@@ -6,6 +6,7 @@
 #include "layer_type.h"
 
 #include "fused_activation.h"
+#include "sparse_weight.h"
 
 namespace ncnn {
 
@@ -23,6 +24,13 @@ int InnerProduct::load_param(const ParamDict& pd)
     int8_scale_term = pd.get(8, 0);
     activation_type = pd.get(9, 0);
     activation_params = pd.get(10, Mat());
+    sparse_format = pd.get(11, 0);
+
+    if (sparse_format && int8_scale_term)
+    {
+        NCNN_LOGE("2:4 sparse weight does not support int8_scale_term %d", int8_scale_term);
+        return -1;
+    }
 
     if (int8_scale_term)
     {
@@ -39,7 +47,36 @@ int InnerProduct::load_param(const ParamDict& pd)
 
 int InnerProduct::load_model(const ModelBin& mb)
 {
-    weight_data = mb.load(weight_data_size, 0);
+    if (sparse_format == 1)
+    {
+        const int num_input = weight_data_size / num_output;
+        if (num_input % 4 != 0)
+        {
+            NCNN_LOGE("2:4 sparse weight requires num_input %d to be a multiple of 4", num_input);
+            return -1;
+        }
+
+        // unpack to dense, the optimized implementations pack it again
+        Mat weight_sparse_data = mb.load(weight_data_size / 2, 0);
+        Mat weight_sparse_index = mb.load(weight_data_size / 4, 0);
+        if (weight_sparse_data.empty() || weight_sparse_index.empty())
+            return -100;
+
+        // the index bytes are stored as int8 data, never converted
+        if (weight_sparse_index.elemsize != 1u)
+        {
+            NCNN_LOGE("2:4 sparse weight index must be int8 data, got elemsize %d", (int)weight_sparse_index.elemsize);
+            return -1;
+        }
+
+        int ret = sparse_2to4_unpack(weight_sparse_data, weight_sparse_index, weight_data, num_input, num_output);
+        if (ret != 0)
+            return ret;
+    }
+    else
+    {
+        weight_data = mb.load(weight_data_size, 0);
+    }
     if (weight_data.empty())
         return -100;
 
@@ -54,6 +91,11 @@ int InnerProduct::load_model(const ModelBin& mb)
     if (int8_scale_term)
     {
         weight_data_int8_scales = mb.load(num_output, 1);
+    }
+
+    // int8_scale_term 3 quantizes the activations dynamically without stored scales
+    if (int8_scale_term && int8_scale_term != 3)
+    {
         bottom_blob_int8_scales = mb.load(1, 1);
     }
 #endif // NCNN_INT8
@@ -174,6 +216,48 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
     size_t elemsize = bottom_blob.elemsize;
     int size = w * h;
 
+    const bool dynamic_quantize = int8_scale_term == 3;
+    if (dynamic_quantize && elemsize == 1)
+    {
+        NCNN_LOGE("InnerProduct dynamic int8 quantization needs fp32 input");
+        return -1;
+    }
+
+    // dynamic activation scales, one per row in gemm, otherwise one for the whole blob
+    Mat bottom_blob_int8_scales_dynamic;
+    if (dynamic_quantize)
+    {
+        const bool per_row = bottom_blob.dims == 2 && w == num_input;
+        const int num_scale = per_row ? h : 1;
+
+        bottom_blob_int8_scales_dynamic.create(num_scale, (size_t)4u, opt.workspace_allocator);
+        if (bottom_blob_int8_scales_dynamic.empty())
+            return -100;
+
+        bottom_blob_int8_scales_dynamic.fill(0.f);
+
+        for (int q = 0; q < channels; q++)
+        {
+            for (int j = 0; j < bottom_blob.h * bottom_blob.d; j++)
+            {
+                const float* ptr = (const float*)bottom_blob.channel(q) + j * w;
+                float& absmax = bottom_blob_int8_scales_dynamic[per_row ? j : 0];
+                for (int i = 0; i < w; i++)
+                {
+                    absmax = std::max(absmax, (float)fabsf(ptr[i]));
+                }
+            }
+        }
+
+        for (int i = 0; i < num_scale; i++)
+        {
+            float absmax = bottom_blob_int8_scales_dynamic[i];
+            bottom_blob_int8_scales_dynamic[i] = absmax == 0.f ? 1.f : 127.f / absmax;
+        }
+    }
+
+    const Mat& bottom_scales = dynamic_quantize ? bottom_blob_int8_scales_dynamic : bottom_blob_int8_scales;
+
     Mat bottom_blob_int8 = bottom_blob;
     if (elemsize != 1)
     {
@@ -181,7 +265,7 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
         opt_g.blob_allocator = opt.workspace_allocator;
         opt_g.use_packing_layout = false;
 
-        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_g);
+        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_scales, opt_g);
     }
 
     if (bottom_blob.dims == 2 && w == num_input)
@@ -211,7 +295,7 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
                 if (weight_data_int8_scales[p] == 0)
                     scale_in = 0;
                 else
-                    scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+                    scale_in = 1.f / (bottom_scales[bottom_scales.w == h ? j : 0] * weight_data_int8_scales[p]);
 
                 float sumfp32 = sum * scale_in;
 
@@ -255,7 +339,7 @@ int InnerProduct::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Opti
         if (weight_data_int8_scales[p] == 0)
             scale_in = 0;
         else
-            scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+            scale_in = 1.f / (bottom_scales[0] * weight_data_int8_scales[p]);
 
         float sumfp32 = sum * scale_in;
 
@@ -37,6 +37,9 @@ public:
     int activation_type;
     Mat activation_params;
 
+    // 0=dense 1=2:4 structured sparse
+    int sparse_format;
+
     // model
     Mat weight_data;
     Mat bias_data;
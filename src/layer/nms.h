@@ -0,0 +1,248 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NMS_H
+#define NMS_H
+
+#include "mat.h"
+#include "option.h"
+
+#include <algorithm>
+#include <vector>
+
+#if __SSE2__
+#include <emmintrin.h>
+#endif // __SSE2__
+#if __ARM_NEON
+#include <arm_neon.h>
+#endif // __ARM_NEON
+
+// greedy non-maximum suppression shared by the detection layers
+//
+// boxes are kept in structure of arrays layout, so that a candidate is tested against
+// a block of kept boxes at once, a candidate is suppressed when
+// inter_area > nms_threshold * union_area holds for any kept box
+
+struct NmsBoxes
+{
+    void resize(int n)
+    {
+        x0.resize(n);
+        y0.resize(n);
+        x1.resize(n);
+        y1.resize(n);
+        area.resize(n);
+    }
+
+    int size() const
+    {
+        return (int)x0.size();
+    }
+
+    void set(int i, float _x0, float _y0, float _x1, float _y1)
+    {
+        x0[i] = _x0;
+        y0[i] = _y0;
+        x1[i] = _x1;
+        y1[i] = _y1;
+        area[i] = (_x1 - _x0) * (_y1 - _y0);
+    }
+
+    std::vector<float> x0;
+    std::vector<float> y0;
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> area;
+};
+
+struct NmsScoreGreater
+{
+    NmsScoreGreater(const float* _scores)
+        : scores(_scores)
+    {
+    }
+
+    // ties keep the index order so that the result does not depend on the sort algorithm
+    bool operator()(int a, int b) const
+    {
+        return scores[a] > scores[b] || (scores[a] == scores[b] && a < b);
+    }
+
+    const float* scores;
+};
+
+// indices of the scores from the highest to the lowest
+// only the top_k best are sorted and kept when 0 <= top_k < n
+static inline void nms_sort_descent(const float* scores, int n, std::vector<int>& order, int top_k = -1)
+{
+    order.resize(n);
+    for (int i = 0; i < n; i++)
+    {
+        order[i] = i;
+    }
+
+    if (top_k >= 0 && top_k < n)
+    {
+        std::partial_sort(order.begin(), order.begin() + top_k, order.end(), NmsScoreGreater(scores));
+        order.resize(top_k);
+    }
+    else
+    {
+        std::sort(order.begin(), order.end(), NmsScoreGreater(scores));
+    }
+}
+
+// whether the box overlaps any of the n kept boxes more than nms_threshold
+static inline int nms_overlap_any(const float* kx0, const float* ky0, const float* kx1, const float* ky1, const float* karea, int n, float x0, float y0, float x1, float y1, float area, float nms_threshold)
+{
+    int j = 0;
+#if __SSE2__
+    {
+        const __m128 _x0 = _mm_set1_ps(x0);
+        const __m128 _y0 = _mm_set1_ps(y0);
+        const __m128 _x1 = _mm_set1_ps(x1);
+        const __m128 _y1 = _mm_set1_ps(y1);
+        const __m128 _area = _mm_set1_ps(area);
+        const __m128 _thr = _mm_set1_ps(nms_threshold);
+        const __m128 _zero = _mm_setzero_ps();
+        for (; j + 3 < n; j += 4)
+        {
+            __m128 _inter_w = _mm_max_ps(_mm_sub_ps(_mm_min_ps(_x1, _mm_loadu_ps(kx1 + j)), _mm_max_ps(_x0, _mm_loadu_ps(kx0 + j))), _zero);
+            __m128 _inter_h = _mm_max_ps(_mm_sub_ps(_mm_min_ps(_y1, _mm_loadu_ps(ky1 + j)), _mm_max_ps(_y0, _mm_loadu_ps(ky0 + j))), _zero);
+            __m128 _inter = _mm_mul_ps(_inter_w, _inter_h);
+            __m128 _union = _mm_sub_ps(_mm_add_ps(_area, _mm_loadu_ps(karea + j)), _inter);
+            if (_mm_movemask_ps(_mm_cmpgt_ps(_inter, _mm_mul_ps(_thr, _union))))
+                return 1;
+        }
+    }
+#endif // __SSE2__
+#if __ARM_NEON
+    {
+        const float32x4_t _x0 = vdupq_n_f32(x0);
+        const float32x4_t _y0 = vdupq_n_f32(y0);
+        const float32x4_t _x1 = vdupq_n_f32(x1);
+        const float32x4_t _y1 = vdupq_n_f32(y1);
+        const float32x4_t _area = vdupq_n_f32(area);
+        const float32x4_t _thr = vdupq_n_f32(nms_threshold);
+        const float32x4_t _zero = vdupq_n_f32(0.f);
+        for (; j + 3 < n; j += 4)
+        {
+            float32x4_t _inter_w = vmaxq_f32(vsubq_f32(vminq_f32(_x1, vld1q_f32(kx1 + j)), vmaxq_f32(_x0, vld1q_f32(kx0 + j))), _zero);
+            float32x4_t _inter_h = vmaxq_f32(vsubq_f32(vminq_f32(_y1, vld1q_f32(ky1 + j)), vmaxq_f32(_y0, vld1q_f32(ky0 + j))), _zero);
+            float32x4_t _inter = vmulq_f32(_inter_w, _inter_h);
+            float32x4_t _union = vsubq_f32(vaddq_f32(_area, vld1q_f32(karea + j)), _inter);
+            uint32x4_t _mask = vcgtq_f32(_inter, vmulq_f32(_thr, _union));
+            uint32x2_t _mask2 = vorr_u32(vget_low_u32(_mask), vget_high_u32(_mask));
+            if (vget_lane_u32(vpmax_u32(_mask2, _mask2), 0))
+                return 1;
+        }
+    }
+#endif // __ARM_NEON
+
+    int suppressed = 0;
+    for (; j < n; j++)
+    {
+        const float inter_w = std::max(std::min(x1, kx1[j]) - std::max(x0, kx0[j]), 0.f);
+        const float inter_h = std::max(std::min(y1, ky1[j]) - std::max(y0, ky0[j]), 0.f);
+        const float inter_area = inter_w * inter_h;
+        const float union_area = area + karea[j] - inter_area;
+
+        // inter_area / union_area > nms_threshold
+        suppressed |= inter_area > nms_threshold * union_area;
+    }
+
+    return suppressed;
+}
+
+// greedy nms over the n boxes listed in order, usually sorted by nms_sort_descent
+// picked receives the kept box indices in that order, at most max_picked of them when max_picked >= 0
+static inline void nms_sorted(const NmsBoxes& boxes, const int* order, int n, float nms_threshold, std::vector<int>& picked, int max_picked = -1)
+{
+    picked.clear();
+
+    if (max_picked < 0 || max_picked > n)
+        max_picked = n;
+
+    if (max_picked == 0)
+        return;
+
+    // the kept boxes are copied out contiguously for the block overlap test
+    NmsBoxes kept;
+    kept.resize(max_picked);
+
+    int num_kept = 0;
+    for (int i = 0; i < n && num_kept < max_picked; i++)
+    {
+        const int z = order[i];
+
+        const float x0 = boxes.x0[z];
+        const float y0 = boxes.y0[z];
+        const float x1 = boxes.x1[z];
+        const float y1 = boxes.y1[z];
+        const float area = boxes.area[z];
+
+        if (nms_overlap_any(&kept.x0[0], &kept.y0[0], &kept.x1[0], &kept.y1[0], &kept.area[0], num_kept, x0, y0, x1, y1, area, nms_threshold))
+            continue;
+
+        kept.x0[num_kept] = x0;
+        kept.y0[num_kept] = y0;
+        kept.x1[num_kept] = x1;
+        kept.y1[num_kept] = y1;
+        kept.area[num_kept] = area;
+        num_kept++;
+
+        picked.push_back(z);
+    }
+}
+
+// class-aware nms, boxes with different labels never suppress each other
+// every class runs its own nms in parallel, picked holds the same boxes in the same order
+// as a single greedy pass over order that only compares boxes of equal label
+static inline void nms_sorted_batched(const NmsBoxes& boxes, const int* order, int n, const int* labels, int num_class, float nms_threshold, std::vector<int>& picked, int max_picked, const ncnn::Option& opt)
+{
+    picked.clear();
+
+    if (max_picked < 0 || max_picked > n)
+        max_picked = n;
+
+    if (max_picked == 0)
+        return;
+
+    // split the order by class, the order within a class is unchanged
+    std::vector<std::vector<int> > class_order(num_class);
+    for (int i = 0; i < n; i++)
+    {
+        class_order[labels[order[i]]].push_back(order[i]);
+    }
+
+    std::vector<std::vector<int> > class_picked(num_class);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int c = 0; c < num_class; c++)
+    {
+        const std::vector<int>& co = class_order[c];
+        if (co.empty())
+            continue;
+
+        nms_sorted(boxes, &co[0], (int)co.size(), nms_threshold, class_picked[c], max_picked);
+    }
+
+    // merge back in the global order
+    std::vector<unsigned char> keep(boxes.size(), 0);
+    for (int c = 0; c < num_class; c++)
+    {
+        const std::vector<int>& cp = class_picked[c];
+        for (size_t i = 0; i < cp.size(); i++)
+        {
+            keep[cp[i]] = 1;
+        }
+    }
+
+    for (int i = 0; i < n && (int)picked.size() < max_picked; i++)
+    {
+        if (keep[order[i]])
+            picked.push_back(order[i]);
+    }
+}
+
+#endif // NMS_H
@@ -4,6 +4,7 @@
 #include "pooling1d.h"
 
 #include "layer_type.h"
+#include "streaming_window.h"
 
 #include <float.h>
 
@@ -28,6 +29,9 @@ int Pooling1D::load_param(const ParamDict& pd)
     adaptive_pooling = pd.get(7, 0);
     out_w = pd.get(8, 0);
 
+    // the stream start padding is counted as regular input
+    support_streaming = !global_pooling && !adaptive_pooling && stride_w <= kernel_w && (pad_mode == 0 || pad_mode == 1) && (pooling_type == PoolMethod_MAX || avgpool_count_include_pad || pad_left == 0);
+
     return 0;
 }
 
@@ -251,6 +255,37 @@ int Pooling1D::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt)
     return 0;
 }
 
+int Pooling1D::forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const
+{
+    float pad_value = 0.f;
+    if (pooling_type == PoolMethod_MAX)
+    {
+        pad_value = bottom_blob.elemsize == 1 ? -128.f : -FLT_MAX;
+    }
+
+    Mat bottom_blob_joined;
+    int out_offset = 0;
+    int out_count = 0;
+    int ret = streaming_window_prepare(bottom_blob, state, bottom_blob_joined, kernel_w, stride_w, pad_left, BORDER_CONSTANT, pad_value, out_offset, out_count, opt);
+    if (ret != 0)
+        return ret;
+
+    if (out_count == 0)
+    {
+        top_blob.create(0, bottom_blob.h, bottom_blob.elemsize, opt.blob_allocator);
+        return 0;
+    }
+
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+    Mat top_blob_all;
+    ret = forward(bottom_blob_joined, top_blob_all, opt_b);
+    if (ret != 0)
+        return ret;
+
+    return streaming_slice_w(top_blob_all, top_blob, out_offset, out_count, opt.blob_allocator);
+}
+
 void Pooling1D::make_padding(const Mat& bottom_blob, Mat& bottom_blob_bordered, const Option& opt) const
 {
     int w = bottom_blob.w;
@@ -17,6 +17,8 @@ public:
 
     virtual int forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 
+    virtual int forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const;
+
     enum PoolMethod
     {
         PoolMethod_MAX = 0,
@@ -3,6 +3,8 @@
 
 #include "proposal.h"
 
+#include "nms.h"
+
 namespace ncnn {
 
 Proposal::Proposal()
@@ -76,109 +78,6 @@ int Proposal::load_param(const ParamDict& pd)
     return 0;
 }
 
-struct Rect
-{
-    float x1;
-    float y1;
-    float x2;
-    float y2;
-};
-
-static inline float intersection_area(const Rect& a, const Rect& b)
-{
-    if (a.x1 > b.x2 || a.x2 < b.x1 || a.y1 > b.y2 || a.y2 < b.y1)
-    {
-        // no intersection
-        return 0.f;
-    }
-
-    float inter_width = std::min(a.x2, b.x2) - std::max(a.x1, b.x1);
-    float inter_height = std::min(a.y2, b.y2) - std::max(a.y1, b.y1);
-
-    return inter_width * inter_height;
-}
-
-template<typename T>
-static void qsort_descent_inplace(std::vector<T>& datas, std::vector<float>& scores, int left, int right)
-{
-    int i = left;
-    int j = right;
-    float p = scores[(left + right) / 2];
-
-    while (i <= j)
-    {
-        while (scores[i] > p)
-            i++;
-
-        while (scores[j] < p)
-            j--;
-
-        if (i <= j)
-        {
-            // swap
-            std::swap(datas[i], datas[j]);
-            std::swap(scores[i], scores[j]);
-
-            i++;
-            j--;
-        }
-    }
-
-    if (left < j)
-        qsort_descent_inplace(datas, scores, left, j);
-
-    if (i < right)
-        qsort_descent_inplace(datas, scores, i, right);
-}
-
-template<typename T>
-static void qsort_descent_inplace(std::vector<T>& datas, std::vector<float>& scores)
-{
-    if (datas.empty() || scores.empty())
-        return;
-
-    qsort_descent_inplace(datas, scores, 0, static_cast<int>(scores.size() - 1));
-}
-
-static void nms_sorted_bboxes(const std::vector<Rect>& bboxes, std::vector<size_t>& picked, float nms_threshold)
-{
-    picked.clear();
-
-    const size_t n = bboxes.size();
-
-    std::vector<float> areas(n);
-    for (size_t i = 0; i < n; i++)
-    {
-        const Rect& r = bboxes[i];
-
-        float width = r.x2 - r.x1;
-        float height = r.y2 - r.y1;
-
-        areas[i] = width * height;
-    }
-
-    for (size_t i = 0; i < n; i++)
-    {
-        const Rect& a = bboxes[i];
-
-        int keep = 1;
-        for (size_t j = 0; j < picked.size(); j++)
-        {
-            const Rect& b = bboxes[picked[j]];
-
-            // intersection over union
-            float inter_area = intersection_area(a, b);
-            float union_area = areas[i] + areas[picked[j]] - inter_area;
-            //             float IoU = inter_area / union_area
-            if (inter_area / union_area > nms_threshold)
-                keep = 0;
-        }
-
-        if (keep)
-            picked.push_back(i);
-    }
-}
-
 int Proposal::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
     const Mat& score_blob = bottom_blobs[0];
@@ -274,12 +173,16 @@ int Proposal::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     }
 
     // remove predicted boxes with either height or width < threshold
-    std::vector<Rect> proposal_boxes;
+    NmsBoxes proposal_boxes;
     std::vector<float> scores;
 
     float im_scale = im_info_blob[2];
     float min_boxsize = min_size * im_scale;
 
+    // room for every box, shrunk to the kept ones afterwards
+    proposal_boxes.resize(num_anchors * w * h);
+    scores.reserve(num_anchors * w * h);
+
     for (int q = 0; q < num_anchors; q++)
     {
         Mat pbs = proposals.channel(q);
@@ -294,29 +197,26 @@ int Proposal::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
 
             if (pb_w >= min_boxsize && pb_h >= min_boxsize)
             {
-                Rect r = {pb[0], pb[1], pb[2], pb[3]};
-                proposal_boxes.push_back(r);
+                const int z = (int)scores.size();
+                proposal_boxes.set(z, pb[0], pb[1], pb[2], pb[3]);
                 scores.push_back(scoreptr[i]);
             }
         }
     }
 
-    // sort all (proposal, score) pairs by score from highest to lowest
-    qsort_descent_inplace(proposal_boxes, scores);
+    proposal_boxes.resize((int)scores.size());
 
-    // take top pre_nms_topN
-    if (pre_nms_topN > 0 && pre_nms_topN < (int)proposal_boxes.size())
-    {
-        proposal_boxes.resize(pre_nms_topN);
-        scores.resize(pre_nms_topN);
-    }
+    // sort all (proposal, score) pairs by score from highest to lowest
+    // and take top pre_nms_topN
+    std::vector<int> order;
+    if (!scores.empty())
+        nms_sort_descent(&scores[0], (int)scores.size(), order, pre_nms_topN > 0 ? pre_nms_topN : -1);
 
-    // apply nms with nms_thresh
-    std::vector<size_t> picked;
-    nms_sorted_bboxes(proposal_boxes, picked, nms_thresh);
+    // apply nms with nms_thresh and take after_nms_topN
+    std::vector<int> picked;
+    nms_sorted(proposal_boxes, order.empty() ? 0 : &order[0], (int)order.size(), nms_thresh, picked, std::max(after_nms_topN, 0));
 
-    // take after_nms_topN
-    int picked_count = std::min((int)picked.size(), after_nms_topN);
+    int picked_count = (int)picked.size();
 
     // return the top proposals
     Mat& roi_blob = top_blobs[0];
@@ -328,10 +228,10 @@ int Proposal::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& to
     {
         float* outptr = roi_blob.channel(i);
 
-        outptr[0] = proposal_boxes[picked[i]].x1;
-        outptr[1] = proposal_boxes[picked[i]].y1;
-        outptr[2] = proposal_boxes[picked[i]].x2;
-        outptr[3] = proposal_boxes[picked[i]].y2;
+        outptr[0] = proposal_boxes.x0[picked[i]];
+        outptr[1] = proposal_boxes.y0[picked[i]];
+        outptr[2] = proposal_boxes.x1[picked[i]];
+        outptr[3] = proposal_boxes.y1[picked[i]];
     }
 
     if (top_blobs.size() > 1)
@@ -0,0 +1,111 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_SPARSE_WEIGHT_H
+#define LAYER_SPARSE_WEIGHT_H
+
+#include "mat.h"
+
+namespace ncnn {
+
+// 2:4 structured sparse weight
+// every group of 4 consecutive weights in an output row keeps at most 2 non-zero values
+//   sparse_data  = the 2 kept values of each group                        [num_input / 2, num_output]
+//   sparse_index = one byte per group, the offset of the first kept value
+//                  in bit 0-1 and the offset of the second in bit 2-3     [num_input / 4, num_output] int8
+
+// returns 0 if weight_data is 2:4 sparse
+static inline int sparse_2to4_pack(const Mat& weight_data, Mat& sparse_data, Mat& sparse_index, int num_input, int num_output, Allocator* allocator = 0)
+{
+    if (num_input % 4 != 0 || weight_data.elemsize != 4u)
+        return -1;
+
+    const int groups = num_input / 4;
+
+    sparse_data.create(groups * 2, num_output, (size_t)4u, allocator);
+    sparse_index.create(groups, num_output, (size_t)1u, allocator);
+    if (sparse_data.empty() || sparse_index.empty())
+        return -100;
+
+    for (int p = 0; p < num_output; p++)
+    {
+        const float* kptr = (const float*)weight_data + num_input * p;
+        float* sptr = sparse_data.row(p);
+        unsigned char* iptr = sparse_index.row<unsigned char>(p);
+
+        for (int g = 0; g < groups; g++)
+        {
+            int offsets[4];
+            int nz = 0;
+            for (int k = 0; k < 4; k++)
+            {
+                if (kptr[k] != 0.f)
+                {
+                    if (nz == 2)
+                        return -1;
+
+                    offsets[nz++] = k;
+                }
+            }
+
+            // pad with zero weights at unused offsets, kept in ascending order
+            for (int k = 0; nz < 2; k++)
+            {
+                if (nz == 1 && offsets[0] == k)
+                    continue;
+
+                offsets[nz++] = k;
+            }
+            if (offsets[0] > offsets[1])
+            {
+                int tmp = offsets[0];
+                offsets[0] = offsets[1];
+                offsets[1] = tmp;
+            }
+
+            sptr[0] = kptr[offsets[0]];
+            sptr[1] = kptr[offsets[1]];
+            iptr[0] = (unsigned char)(offsets[0] | (offsets[1] << 2));
+
+            kptr += 4;
+            sptr += 2;
+            iptr += 1;
+        }
+    }
+
+    return 0;
+}
+
+static inline int sparse_2to4_unpack(const Mat& sparse_data, const Mat& sparse_index, Mat& weight_data, int num_input, int num_output, Allocator* allocator = 0)
+{
+    if (sparse_data.elemsize != 4u || sparse_index.elemsize != 1u)
+        return -1;
+
+    const int groups = num_input / 4;
+
+    weight_data.create(num_input * num_output, (size_t)4u, allocator);
+    if (weight_data.empty())
+        return -100;
+
+    weight_data.fill(0.f);
+
+    const float* sptr = sparse_data;
+    const unsigned char* iptr = (const unsigned char*)sparse_index.data;
+    float* kptr = weight_data;
+
+    for (int i = 0; i < groups * num_output; i++)
+    {
+        kptr[iptr[0] & 3] += sptr[0];
+        kptr[(iptr[0] >> 2) & 3] += sptr[1];
+
+        kptr += 4;
+        sptr += 2;
+        iptr += 1;
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
+
+#endif // LAYER_SPARSE_WEIGHT_H
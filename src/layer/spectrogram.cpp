@@ -3,6 +3,8 @@
 
 #include "spectrogram.h"
 
+#include "streaming_window.h"
+
 namespace ncnn {
 
 Spectrogram::Spectrogram()
@@ -23,6 +25,8 @@ int Spectrogram::load_param(const ParamDict& pd)
     normalized = pd.get(7, 0);
     onesided = pd.get(8, 1);
 
+    support_streaming = hoplen <= n_fft;
+
     // assert winlen <= n_fft
     // generate window
     window_data.create(normalized == 2 ? n_fft + 1 : n_fft);
@@ -207,4 +211,52 @@ int Spectrogram::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
     return 0;
 }
 
+int Spectrogram::forward_streaming(const Mat& bottom_blob, Mat& top_blob, Mat& state, const Option& opt) const
+{
+    // with reflect padding, the first chunk must hold more than n_fft / 2 samples
+    const int pad_left = center ? n_fft / 2 : 0;
+    const int border_type = pad_type == 0 ? BORDER_CONSTANT : pad_type == 1 ? BORDER_REPLICATE : BORDER_REFLECT;
+
+    Mat bottom_blob_joined;
+    int out_offset = 0;
+    int out_count = 0;
+    int ret = streaming_window_prepare(bottom_blob, state, bottom_blob_joined, n_fft, hoplen, pad_left, border_type, 0.f, out_offset, out_count, opt);
+    if (ret != 0)
+        return ret;
+
+    const int freqs = onesided ? n_fft / 2 + 1 : n_fft;
+    const size_t elemsize = bottom_blob.elemsize;
+
+    if (out_count == 0)
+    {
+        if (power == 0)
+            top_blob.create(2, 0, freqs, elemsize, opt.blob_allocator);
+        else
+            top_blob.create(0, freqs, elemsize, opt.blob_allocator);
+        return 0;
+    }
+
+    Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+    Mat top_blob_all;
+    ret = forward(bottom_blob_joined, top_blob_all, opt_b);
+    if (ret != 0)
+        return ret;
+
+    if (power != 0)
+        return streaming_slice_w(top_blob_all, top_blob, out_offset, out_count, opt.blob_allocator);
+
+    // frames run along h of the complex output
+    top_blob.create(2, out_count, freqs, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    for (int q = 0; q < freqs; q++)
+    {
+        memcpy(top_blob.channel(q), top_blob_all.channel(q).row(out_offset), out_count * 2 * elemsize);
+    }
+
+    return 0;
+}
+
 } // namespace ncnn
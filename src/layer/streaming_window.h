@@ -0,0 +1,141 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef STREAMING_WINDOW_H
+#define STREAMING_WINDOW_H
+
+#include "mat.h"
+
+// streaming inference of layers sliding a window along w
+//
+// the state keeps the samples after the last consumed window, so that the next window
+// always starts at state column 0, an empty state (dims == 0) marks the start of a stream
+// the stream start is padded like the non-streaming forward, the stream end is never padded
+
+// copy columns [start, start + count) of a 1d or 2d blob, count may be zero
+static int streaming_slice_w(const ncnn::Mat& src, ncnn::Mat& dst, int start, int count, ncnn::Allocator* allocator)
+{
+    const int h = src.dims == 1 ? 1 : src.h;
+    const size_t elemsize = src.elemsize;
+
+    if (src.dims == 1)
+        dst.create(count, elemsize, src.elempack, allocator);
+    else
+        dst.create(count, h, elemsize, src.elempack, allocator);
+
+    if (count == 0)
+        return 0;
+
+    if (dst.empty())
+        return -100;
+
+    for (int i = 0; i < h; i++)
+    {
+        const unsigned char* ptr = src.row<const unsigned char>(i) + start * elemsize;
+        unsigned char* outptr = dst.row<unsigned char>(i);
+
+        memcpy(outptr, ptr, count * elemsize);
+    }
+
+    return 0;
+}
+
+// append the columns of b to a
+static int streaming_concat_w(const ncnn::Mat& a, const ncnn::Mat& b, ncnn::Mat& dst, ncnn::Allocator* allocator)
+{
+    const int h = b.dims == 1 ? 1 : b.h;
+    const size_t elemsize = b.elemsize;
+
+    if (a.elemsize != b.elemsize || a.elempack != b.elempack || (a.dims == 1 ? 1 : a.h) != h)
+    {
+        NCNN_LOGE("streaming state shape mismatch");
+        return -1;
+    }
+
+    if (b.dims == 1)
+        dst.create(a.w + b.w, elemsize, b.elempack, allocator);
+    else
+        dst.create(a.w + b.w, h, elemsize, b.elempack, allocator);
+    if (dst.empty())
+        return -100;
+
+    for (int i = 0; i < h; i++)
+    {
+        unsigned char* outptr = dst.row<unsigned char>(i);
+
+        if (a.w > 0)
+            memcpy(outptr, a.row<const unsigned char>(i), a.w * elemsize);
+        if (b.w > 0)
+            memcpy(outptr + a.w * elemsize, b.row<const unsigned char>(i), b.w * elemsize);
+    }
+
+    return 0;
+}
+
+// join state and the new chunk into bottom_blob_joined and carve the next state
+//
+// pad_left is the left padding the layer forward applies by itself, columns are prepended
+// to bottom_blob_joined so that this padding lines up with the window grid,
+// the new outputs are then [out_offset, out_offset + out_count) of the layer forward
+static int streaming_window_prepare(const ncnn::Mat& bottom_blob, ncnn::Mat& state, ncnn::Mat& bottom_blob_joined, int kernel_extent, int stride, int pad_left, int border_type, float pad_value, int& out_offset, int& out_count, const ncnn::Option& opt)
+{
+    ncnn::Option opt_b = opt;
+    opt_b.blob_allocator = opt.workspace_allocator;
+
+    // the stream content not consumed yet
+    ncnn::Mat stream;
+    if (bottom_blob.empty())
+    {
+        // nothing new in this chunk
+        out_offset = 0;
+        out_count = 0;
+        return 0;
+    }
+    else if (state.dims == 0)
+    {
+        stream = bottom_blob;
+        if (pad_left > 0)
+        {
+            copy_make_border(bottom_blob, stream, 0, 0, pad_left, 0, border_type, pad_value, opt_b);
+            if (stream.empty())
+                return -100;
+        }
+    }
+    else
+    {
+        int ret = streaming_concat_w(state, bottom_blob, stream, opt.workspace_allocator);
+        if (ret != 0)
+            return ret;
+    }
+
+    const int w = stream.w;
+
+    out_count = w >= kernel_extent ? (w - kernel_extent) / stride + 1 : 0;
+
+    // keep the samples after the last consumed window
+    // always in a fresh buffer, the previous state may be shared by a copied extractor
+    ncnn::Mat next_state;
+    int ret = streaming_slice_w(stream, next_state, out_count * stride, w - out_count * stride, opt.blob_allocator);
+    if (ret != 0)
+        return ret;
+
+    state = next_state;
+
+    const int align = (stride - pad_left % stride) % stride;
+    if (align > 0 && out_count > 0)
+    {
+        copy_make_border(stream, bottom_blob_joined, 0, 0, align, 0, ncnn::BORDER_CONSTANT, 0.f, opt_b);
+        if (bottom_blob_joined.empty())
+            return -100;
+    }
+    else
+    {
+        bottom_blob_joined = stream;
+    }
+
+    out_offset = (pad_left + align) / stride;
+
+    return 0;
+}
+
+#endif // STREAMING_WINDOW_H
@@ -0,0 +1,200 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "topk.h"
+
+#include <algorithm>
+
+namespace ncnn {
+
+TopK::TopK()
+{
+    one_blob_only = false;
+    support_inplace = false;
+}
+
+int TopK::load_param(const ParamDict& pd)
+{
+    axis = pd.get(0, -1);
+    k = pd.get(1, 1);
+    largest = pd.get(2, 1);
+    sorted = pd.get(3, 1);
+
+    if (k <= 0)
+    {
+        NCNN_LOGE("TopK k must be positive, got %d", k);
+        return -1;
+    }
+
+    return 0;
+}
+
+struct TopKPairGreater
+{
+    // ties keep the lower index first
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+struct TopKPairLess
+{
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.first < b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+struct TopKPairIndexLess
+{
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.second < b.second;
+    }
+};
+
+int TopK::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const int dims = bottom_blob.dims;
+    const int positive_axis = axis < 0 ? dims + axis : axis;
+
+    if (positive_axis < 0 || positive_axis >= dims)
+    {
+        NCNN_LOGE("TopK axis %d out of range for %d dims", axis, dims);
+        return -1;
+    }
+
+    // shape from the outermost axis
+    int shape[4] = {1, 1, 1, 1};
+    if (dims == 1)
+    {
+        shape[0] = bottom_blob.w;
+    }
+    if (dims == 2)
+    {
+        shape[0] = bottom_blob.h;
+        shape[1] = bottom_blob.w;
+    }
+    if (dims == 3)
+    {
+        shape[0] = bottom_blob.c;
+        shape[1] = bottom_blob.h;
+        shape[2] = bottom_blob.w;
+    }
+    if (dims == 4)
+    {
+        shape[0] = bottom_blob.c;
+        shape[1] = bottom_blob.d;
+        shape[2] = bottom_blob.h;
+        shape[3] = bottom_blob.w;
+    }
+
+    const int n = shape[positive_axis];
+    const int _k = std::min(k, n);
+
+    if (_k <= 0)
+    {
+        NCNN_LOGE("TopK k %d out of range for axis of %d elements", k, n);
+        return -1;
+    }
+
+    int outshape[4] = {shape[0], shape[1], shape[2], shape[3]};
+    outshape[positive_axis] = _k;
+
+    Mat& top_blob = top_blobs[0];
+    if (dims == 1)
+        top_blob.create(outshape[0], 4u, opt.blob_allocator);
+    if (dims == 2)
+        top_blob.create(outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (dims == 3)
+        top_blob.create(outshape[2], outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (dims == 4)
+        top_blob.create(outshape[3], outshape[2], outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // int32 indices
+    Mat* indices_blob = top_blobs.size() > 1 ? &top_blobs[1] : 0;
+    if (indices_blob)
+    {
+        indices_blob->create_like(top_blob, opt.blob_allocator);
+        if (indices_blob->empty())
+            return -100;
+    }
+
+    // rows of n elements along axis, step elements apart
+    // the channel axis steps over cstep, other axes stay within one channel
+    int channels;
+    int outer;
+    int inner;
+    size_t step;
+    size_t outstep;
+    if (dims >= 3 && positive_axis == 0)
+    {
+        channels = 1;
+        outer = 1;
+        inner = (int)(bottom_blob.w * bottom_blob.h * bottom_blob.d);
+        step = bottom_blob.cstep;
+        outstep = top_blob.cstep;
+    }
+    else
+    {
+        const int plane_axis0 = dims >= 3 ? 1 : 0;
+
+        channels = dims >= 3 ? bottom_blob.c : 1;
+        outer = 1;
+        for (int i = plane_axis0; i < positive_axis; i++)
+        {
+            outer *= shape[i];
+        }
+        inner = 1;
+        for (int i = positive_axis + 1; i < dims; i++)
+        {
+            inner *= shape[i];
+        }
+        step = inner;
+        outstep = inner;
+    }
+
+    const int num_row = channels * outer * inner;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = 0; r < num_row; r++)
+    {
+        const int q = r / (outer * inner);
+        const int o = r / inner % outer;
+        const int i = r % inner;
+
+        const float* ptr = (const float*)bottom_blob + q * bottom_blob.cstep + (size_t)o * n * inner + i;
+        float* outptr = (float*)top_blob + q * top_blob.cstep + (size_t)o * _k * inner + i;
+        int* indptr = indices_blob ? (int*)*indices_blob + q * indices_blob->cstep + (size_t)o * _k * inner + i : 0;
+
+        std::vector<std::pair<float, int> > vec(n);
+        for (int j = 0; j < n; j++)
+        {
+            vec[j] = std::make_pair(ptr[j * step], j);
+        }
+
+        if (largest)
+            std::partial_sort(vec.begin(), vec.begin() + _k, vec.end(), TopKPairGreater());
+        else
+            std::partial_sort(vec.begin(), vec.begin() + _k, vec.end(), TopKPairLess());
+
+        // unsorted results follow the input order
+        if (!sorted)
+            std::sort(vec.begin(), vec.begin() + _k, TopKPairIndexLess());
+
+        for (int j = 0; j < _k; j++)
+        {
+            outptr[j * outstep] = vec[j].first;
+            if (indptr)
+                indptr[j * outstep] = vec[j].second;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -945,6 +945,11 @@ static int get_reverse_op_type(int op_type)
 
 int BinaryOp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+#if NCNN_INT8
+    if (bottom_blobs[0].elembits() == 8)
+        return forward_int8(bottom_blobs, top_blobs, opt);
+#endif
+
     const Mat& A = bottom_blobs[0];
     const Mat& B = bottom_blobs[1];
     const int outdims = std::max(A.dims, B.dims);
@@ -1099,4 +1104,118 @@ int BinaryOp_x86::forward_inplace(Mat& bottom_top_blob, const Option& opt) const
     return 0;
 }
 
+#if NCNN_INT8
+static void binary_op_int8(const signed char* ptr, const signed char* ptr1, signed char* outptr, int size, int op_type)
+{
+    // swap the operands so that rsub becomes sub
+    if (op_type == BinaryOp::Operation_RSUB)
+    {
+        std::swap(ptr, ptr1);
+        op_type = BinaryOp::Operation_SUB;
+    }
+
+    int i = 0;
+#if __SSE2__
+    for (; i + 15 < size; i += 16)
+    {
+        __m128i _p = _mm_loadu_si128((const __m128i*)ptr);
+        __m128i _p1 = _mm_loadu_si128((const __m128i*)ptr1);
+        __m128i _outp;
+        if (op_type == BinaryOp::Operation_ADD)
+        {
+            _outp = _mm_adds_epi8(_p, _p1);
+        }
+        else if (op_type == BinaryOp::Operation_SUB)
+        {
+            _outp = _mm_subs_epi8(_p, _p1);
+        }
+        else
+        {
+            // max and min without sse4.1
+            __m128i _gt = _mm_cmpgt_epi8(_p, _p1);
+            if (op_type == BinaryOp::Operation_MIN)
+                _gt = _mm_xor_si128(_gt, _mm_set1_epi8(-1));
+            _outp = _mm_or_si128(_mm_and_si128(_gt, _p), _mm_andnot_si128(_gt, _p1));
+        }
+        _mm_storeu_si128((__m128i*)outptr, _outp);
+        ptr += 16;
+        ptr1 += 16;
+        outptr += 16;
+    }
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        int v;
+        if (op_type == BinaryOp::Operation_ADD)
+            v = *ptr + *ptr1;
+        else if (op_type == BinaryOp::Operation_SUB)
+            v = *ptr - *ptr1;
+        else if (op_type == BinaryOp::Operation_MAX)
+            v = std::max(*ptr, *ptr1);
+        else
+            v = std::min(*ptr, *ptr1);
+
+        *outptr = (signed char)std::min(std::max(v, -128), 127);
+        ptr++;
+        ptr1++;
+        outptr++;
+    }
+}
+
+int BinaryOp_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // the quantizer gives both inputs and the output the same scale,
+    // so that add, sub, max and min run on the int8 values with saturation
+    if (op_type != Operation_ADD && op_type != Operation_SUB && op_type != Operation_MAX && op_type != Operation_MIN && op_type != Operation_RSUB)
+    {
+        NCNN_LOGE("BinaryOp int8 supports add, sub, max, min and rsub only");
+        return -1;
+    }
+
+    const Mat& A = bottom_blobs[0];
+    const Mat& B = bottom_blobs[1];
+
+    if (A.dims != B.dims || A.w != B.w || A.h != B.h || A.d != B.d || A.c * A.elempack != B.c * B.elempack || B.elembits() != 8)
+    {
+        NCNN_LOGE("BinaryOp int8 supports inputs of the same shape only");
+        return -1;
+    }
+
+    Mat A2 = A;
+    Mat B2 = B;
+    if (A.elempack != B.elempack)
+    {
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        convert_packing(A, A2, 1, opt_unpack);
+        if (A2.empty())
+            return -100;
+
+        convert_packing(B, B2, 1, opt_unpack);
+        if (B2.empty())
+            return -100;
+    }
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create_like(A2, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int channels = A2.c;
+    const int size = A2.w * A2.h * A2.d * A2.elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const signed char* ptr = A2.channel(q);
+        const signed char* ptr1 = B2.channel(q);
+        signed char* outptr = top_blob.channel(q);
+
+        binary_op_int8(ptr, ptr1, outptr, size, op_type);
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
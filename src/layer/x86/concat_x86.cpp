@@ -14,6 +14,11 @@ Concat_x86::Concat_x86()
 
 int Concat_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+#if NCNN_INT8
+    if (bottom_blobs[0].elembits() == 8)
+        return forward_int8(bottom_blobs, top_blobs, opt);
+#endif
+
     int dims = bottom_blobs[0].dims;
     int positive_axis = axis < 0 ? dims + axis : axis;
 
@@ -814,4 +819,59 @@ int Concat_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>&
     return 0;
 }
 
+#if NCNN_INT8
+int Concat_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // the quantizer gives all inputs the same scale, so int8 values concat as they are
+    std::vector<Mat> bottom_blobs_unpacked(bottom_blobs.size());
+    for (size_t b = 0; b < bottom_blobs.size(); b++)
+    {
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blobs[b], bottom_blobs_unpacked[b], 1, opt_unpack);
+        if (bottom_blobs_unpacked[b].empty())
+            return -100;
+    }
+
+    const int dims = bottom_blobs[0].dims;
+    const int positive_axis = axis < 0 ? dims + axis : axis;
+
+    int out_elempack = 1;
+    if (opt.use_packing_layout && dims >= 3)
+    {
+        int top_channels = 0;
+        for (size_t b = 0; b < bottom_blobs.size(); b++)
+        {
+            top_channels += bottom_blobs_unpacked[b].c;
+            if (positive_axis != 0)
+                break;
+        }
+
+        out_elempack = top_channels % 8 == 0 ? 8 : 1;
+    }
+
+    Option opt_concat = opt;
+    if (out_elempack != 1)
+        opt_concat.blob_allocator = opt.workspace_allocator;
+
+    int ret = Concat::forward(bottom_blobs_unpacked, top_blobs, opt_concat);
+    if (ret != 0)
+        return ret;
+
+    if (out_elempack != 1)
+    {
+        Mat& top_blob = top_blobs[0];
+
+        Mat top_blob_packed;
+        convert_packing(top_blob, top_blob_packed, out_elempack, opt);
+        if (top_blob_packed.empty())
+            return -100;
+
+        top_blob = top_blob_packed;
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
@@ -0,0 +1,119 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static void conv1x1s1_sparse_2to4_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& weight_index_tm, const Mat& bias_data, const Option& opt)
+{
+    // bottom_blob and top_blob are unpacked
+    const int size = bottom_blob.w * bottom_blob.h;
+    const size_t cstep = bottom_blob.cstep;
+
+    const int groups = weight_index_tm.w;
+    const int outch = top_blob.c;
+
+    const float* bias_data_ptr = bias_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < outch; p++)
+    {
+        const float* kptr0 = weight_data_tm.row(p);
+        const unsigned char* iptr0 = weight_index_tm.row<const unsigned char>(p);
+
+        const float bias0 = bias_data_ptr ? bias_data_ptr[p] : 0.f;
+
+        float* outptr = top_blob.channel(p);
+
+        // accumulate a spatial tile over all kept input channels in registers
+        int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+        for (; i + 15 < size; i += 16)
+        {
+            const float* kptr = kptr0;
+            const unsigned char* iptr = iptr0;
+            const float* ptr = (const float*)bottom_blob.data + i;
+
+            __m512 _sum0 = _mm512_set1_ps(bias0);
+            __m512 _sum1 = _mm512_setzero_ps();
+            for (int g = 0; g < groups; g++)
+            {
+                const float* r0 = ptr + (iptr[0] & 3) * cstep;
+                const float* r1 = ptr + ((iptr[0] >> 2) & 3) * cstep;
+                _sum0 = _mm512_fmadd_ps(_mm512_set1_ps(kptr[0]), _mm512_loadu_ps(r0), _sum0);
+                _sum1 = _mm512_fmadd_ps(_mm512_set1_ps(kptr[1]), _mm512_loadu_ps(r1), _sum1);
+
+                ptr += cstep * 4;
+                kptr += 2;
+                iptr += 1;
+            }
+
+            _mm512_storeu_ps(outptr + i, _mm512_add_ps(_sum0, _sum1));
+        }
+#endif // __AVX512F__
+        for (; i + 7 < size; i += 8)
+        {
+            const float* kptr = kptr0;
+            const unsigned char* iptr = iptr0;
+            const float* ptr = (const float*)bottom_blob.data + i;
+
+            __m256 _sum0 = _mm256_set1_ps(bias0);
+            __m256 _sum1 = _mm256_setzero_ps();
+            for (int g = 0; g < groups; g++)
+            {
+                const float* r0 = ptr + (iptr[0] & 3) * cstep;
+                const float* r1 = ptr + ((iptr[0] >> 2) & 3) * cstep;
+                _sum0 = _mm256_comp_fmadd_ps(_mm256_set1_ps(kptr[0]), _mm256_loadu_ps(r0), _sum0);
+                _sum1 = _mm256_comp_fmadd_ps(_mm256_set1_ps(kptr[1]), _mm256_loadu_ps(r1), _sum1);
+
+                ptr += cstep * 4;
+                kptr += 2;
+                iptr += 1;
+            }
+
+            _mm256_storeu_ps(outptr + i, _mm256_add_ps(_sum0, _sum1));
+        }
+#endif // __AVX__
+        for (; i + 3 < size; i += 4)
+        {
+            const float* kptr = kptr0;
+            const unsigned char* iptr = iptr0;
+            const float* ptr = (const float*)bottom_blob.data + i;
+
+            __m128 _sum0 = _mm_set1_ps(bias0);
+            __m128 _sum1 = _mm_setzero_ps();
+            for (int g = 0; g < groups; g++)
+            {
+                const float* r0 = ptr + (iptr[0] & 3) * cstep;
+                const float* r1 = ptr + ((iptr[0] >> 2) & 3) * cstep;
+                _sum0 = _mm_comp_fmadd_ps(_mm_set1_ps(kptr[0]), _mm_loadu_ps(r0), _sum0);
+                _sum1 = _mm_comp_fmadd_ps(_mm_set1_ps(kptr[1]), _mm_loadu_ps(r1), _sum1);
+
+                ptr += cstep * 4;
+                kptr += 2;
+                iptr += 1;
+            }
+
+            _mm_storeu_ps(outptr + i, _mm_add_ps(_sum0, _sum1));
+        }
+#endif // __SSE2__
+        for (; i < size; i++)
+        {
+            const float* kptr = kptr0;
+            const unsigned char* iptr = iptr0;
+            const float* ptr = (const float*)bottom_blob.data + i;
+
+            float sum = bias0;
+            for (int g = 0; g < groups; g++)
+            {
+                sum += kptr[0] * ptr[(iptr[0] & 3) * cstep];
+                sum += kptr[1] * ptr[((iptr[0] >> 2) & 3) * cstep];
+
+                ptr += cstep * 4;
+                kptr += 2;
+                iptr += 1;
+            }
+
+            outptr[i] = sum;
+        }
+    }
+}
@@ -22,10 +22,13 @@
 #include "cpu.h"
 #include "layer_type.h"
 
+#include "sparse_weight.h"
+
 namespace ncnn {
 
 #include "convolution_3x3.h"
 #include "convolution_5x5.h"
+#include "convolution_1x1_sparse.h"
 
 #include "convolution_3x3_winograd.h"
 #include "convolution_packed.h"
@@ -38,6 +41,7 @@ namespace ncnn {
 #include "convolution_im2col_gemm_int8.h"
 
 #include "convolution_3x3_winograd_int8.h"
+#include "dynamic_quantize_int8.h"
 #endif // NCNN_INT8
 
 #if __SSE2__
@@ -284,6 +288,22 @@ int Convolution_x86::create_pipeline(const Option& opt)
     int kernel_size = kernel_w * kernel_h;
     int num_input = weight_data_size / kernel_size / num_output;
 
+    if (sparse_format == 1 && kernel_w == 1 && kernel_h == 1 && stride_w == 1 && stride_h == 1)
+    {
+        // the kernel skips the pruned half of the input channels
+        int ret = sparse_2to4_pack(weight_data, weight_data_tm, weight_index_tm, num_input, num_output);
+        if (ret != 0)
+        {
+            NCNN_LOGE("Convolution weight is not 2:4 sparse");
+            return ret;
+        }
+
+        if (opt.lightmode)
+            weight_data.release();
+
+        return 0;
+    }
+
     if (!opt.use_packing_layout && kernel_w == kernel_h && dilation_w != 1 && dilation_h == dilation_w && stride_w == 1 && stride_h == 1)
     {
         convolution_dilation1 = ncnn::create_layer_cpu(ncnn::LayerType::Convolution);
@@ -573,6 +593,34 @@ int Convolution_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option
 
     int outw = (w - kernel_extent_w) / stride_w + 1;
     int outh = (h - kernel_extent_h) / stride_h + 1;
+
+    if (!weight_index_tm.empty())
+    {
+        // 2:4 sparse 1x1 on unpacked blobs
+        Mat bottom_blob_unpacked = bottom_blob_bordered;
+        if (elempack != 1)
+        {
+            Option opt_unpack = opt;
+            opt_unpack.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob_bordered, bottom_blob_unpacked, 1, opt_unpack);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        top_blob.create(outw, outh, num_output, elemsize / elempack, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        conv1x1s1_sparse_2to4_sse(bottom_blob_unpacked, top_blob, weight_data_tm, weight_index_tm, bias_data, opt);
+
+        if (activation)
+        {
+            activation->forward_inplace(top_blob, opt);
+        }
+        return 0;
+    }
+
     int out_elempack = 1;
 #if __SSE2__
     if (opt.use_packing_layout)
@@ -906,6 +954,9 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
         convolution_transform_kernel_packed_int8(weight_data, weight_data_tm, num_input, num_output, kernel_w, kernel_h);
     }
 
+    // the activation scale is applied per forward in dynamic mode
+    const float bottom_blob_int8_scale = int8_scale_term == 3 ? 1.f : bottom_blob_int8_scales[0];
+
     scale_in_data.create(num_output);
     for (int p = 0; p < num_output; p++)
     {
@@ -914,7 +965,7 @@ int Convolution_x86::create_pipeline_int8_x86(const Option& opt)
         if (weight_data_int8_scales[p] == 0)
             scale_in = 0;
         else
-            scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+            scale_in = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
 
         scale_in_data[p] = scale_in;
     }
@@ -929,16 +980,46 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
 {
     int elembits = bottom_blob.elembits();
 
+    const bool dynamic_quantize = int8_scale_term == 3;
+    if (dynamic_quantize && elembits == 8)
+    {
+        NCNN_LOGE("Convolution dynamic int8 quantization needs fp32 input");
+        return -1;
+    }
+
+    // dequantize scales with the dynamic activation scale applied
+    Mat scale_in_data_dynamic;
+
     Mat bottom_blob_int8 = bottom_blob;
     if (elembits != 8)
     {
+        Mat bottom_blob_int8_scales_dynamic;
+        if (dynamic_quantize)
+        {
+            bottom_blob_int8_scales_dynamic.create(1, (size_t)4u, 1, opt.workspace_allocator);
+            scale_in_data_dynamic.create(num_output, (size_t)4u, 1, opt.workspace_allocator);
+            if (bottom_blob_int8_scales_dynamic.empty() || scale_in_data_dynamic.empty())
+                return -100;
+
+            const float scale = dynamic_quantize_tensor_scale(bottom_blob, opt);
+            bottom_blob_int8_scales_dynamic[0] = scale;
+
+            const float descale = 1.f / scale;
+            for (int p = 0; p < num_output; p++)
+            {
+                scale_in_data_dynamic[p] = scale_in_data[p] * descale;
+            }
+        }
+
         Option opt_q = opt;
         opt_q.blob_allocator = opt.workspace_allocator;
-        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_q);
+        quantize_to_int8(bottom_blob, bottom_blob_int8, dynamic_quantize ? bottom_blob_int8_scales_dynamic : bottom_blob_int8_scales, opt_q);
         if (bottom_blob_int8.empty())
             return -100;
     }
 
+    const Mat& scale_in = dynamic_quantize ? scale_in_data_dynamic : scale_in_data;
+
     //     NCNN_LOGE("Convolution_x86 input %d x %d  ksize=%d %d  stride=%d %d", w, h, kernel_w, kernel_h, stride_w, stride_h);
 
     Mat bottom_blob_bordered;
@@ -1093,11 +1174,11 @@ int Convolution_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, con
 
     if (use_int8_requantize)
     {
-        requantize_from_int32_to_int8(top_blob_int32, top_blob, scale_in_data, top_blob_int8_scales, bias_data, activation_type, activation_params, opt);
+        requantize_from_int32_to_int8(top_blob_int32, top_blob, scale_in, top_blob_int8_scales, bias_data, activation_type, activation_params, opt);
     }
     else
     {
-        dequantize_from_int32(top_blob_int32, top_blob, scale_in_data, bias_data, opt);
+        dequantize_from_int32(top_blob_int32, top_blob, scale_in, bias_data, opt);
 
         if (activation)
         {
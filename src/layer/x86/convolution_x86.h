@@ -37,6 +37,9 @@ public:
     Mat weight_winograd43_data;
     Mat weight_winograd63_data;
 
+    // 2:4 sparse 1x1
+    Mat weight_index_tm;
+
     // forwardDilation
     Layer* convolution_dilation1;
 
@@ -0,0 +1,139 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static void convdw_kxk_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& _kernel, const Mat& _bias, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int group = bottom_blob.c;
+
+    const int maxk = kernel_w * kernel_h;
+
+    const float* kernel = _kernel;
+    const float* bias = _bias;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < group; g++)
+    {
+        float* outptr = top_blob.channel(g);
+
+        const float bias0 = bias ? bias[g] : 0.f;
+
+        const float* k0 = kernel + maxk * g;
+
+        const Mat img0 = bottom_blob.channel(g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int j = 0;
+#if __SSE2__
+            if (stride_w == 1)
+            {
+                // adjacent output pixels read adjacent input pixels, slide the window over the row
+#if __AVX__
+                for (; j + 7 < outw; j += 8)
+                {
+                    __m256 _sum = _mm256_set1_ps(bias0);
+
+                    const float* kptr = k0;
+
+                    for (int y = 0; y < kernel_h; y++)
+                    {
+                        const float* r0 = img0.row(i * stride_h + y * dilation_h) + j;
+
+                        for (int x = 0; x < kernel_w; x++)
+                        {
+                            _sum = _mm256_comp_fmadd_ps(_mm256_set1_ps(kptr[0]), _mm256_loadu_ps(r0), _sum);
+
+                            r0 += dilation_w;
+                            kptr += 1;
+                        }
+                    }
+
+                    _sum = activation_avx(_sum, activation_type, activation_params);
+
+                    _mm256_storeu_ps(outptr, _sum);
+
+                    outptr += 8;
+                }
+#endif // __AVX__
+                for (; j + 3 < outw; j += 4)
+                {
+                    __m128 _sum = _mm_set1_ps(bias0);
+
+                    const float* kptr = k0;
+
+                    for (int y = 0; y < kernel_h; y++)
+                    {
+                        const float* r0 = img0.row(i * stride_h + y * dilation_h) + j;
+
+                        for (int x = 0; x < kernel_w; x++)
+                        {
+                            _sum = _mm_comp_fmadd_ps(_mm_set1_ps(kptr[0]), _mm_loadu_ps(r0), _sum);
+
+                            r0 += dilation_w;
+                            kptr += 1;
+                        }
+                    }
+
+                    _sum = activation_sse(_sum, activation_type, activation_params);
+
+                    _mm_storeu_ps(outptr, _sum);
+
+                    outptr += 4;
+                }
+            }
+#endif // __SSE2__
+            for (; j + 1 < outw; j += 2)
+            {
+                float sum0 = bias0;
+                float sum1 = bias0;
+
+                const float* kptr = k0;
+
+                for (int y = 0; y < kernel_h; y++)
+                {
+                    const float* r0 = img0.row(i * stride_h + y * dilation_h) + j * stride_w;
+
+                    for (int x = 0; x < kernel_w; x++)
+                    {
+                        sum0 += r0[0] * kptr[0];
+                        sum1 += r0[stride_w] * kptr[0];
+
+                        r0 += dilation_w;
+                        kptr += 1;
+                    }
+                }
+
+                outptr[0] = activation_ss(sum0, activation_type, activation_params);
+                outptr[1] = activation_ss(sum1, activation_type, activation_params);
+
+                outptr += 2;
+            }
+            for (; j < outw; j++)
+            {
+                float sum = bias0;
+
+                const float* kptr = k0;
+
+                for (int y = 0; y < kernel_h; y++)
+                {
+                    const float* r0 = img0.row(i * stride_h + y * dilation_h) + j * stride_w;
+
+                    for (int x = 0; x < kernel_w; x++)
+                    {
+                        sum += r0[0] * kptr[0];
+
+                        r0 += dilation_w;
+                        kptr += 1;
+                    }
+                }
+
+                outptr[0] = activation_ss(sum, activation_type, activation_params);
+
+                outptr += 1;
+            }
+        }
+    }
+}
@@ -0,0 +1,105 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static void convdw_kxk_pack8_avx(const Mat& bottom_blob, Mat& top_blob, const Mat& kernel, const Mat& _bias, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    int outw = top_blob.w;
+    int outh = top_blob.h;
+
+    const int group = bottom_blob.c;
+
+    const float* bias = _bias;
+
+    // offset between two adjacent output pixels and between two kernel taps in a row
+    const int sstep = stride_w * 8;
+    const int dstep = dilation_w * 8;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int g = 0; g < group; g++)
+    {
+        float* outptr = top_blob.channel(g);
+
+        const __m256 _bias0 = bias ? _mm256_loadu_ps(bias + g * 8) : _mm256_setzero_ps();
+
+        const float* k0 = kernel.row(g);
+
+        const Mat img0 = bottom_blob.channel(g);
+
+        for (int i = 0; i < outh; i++)
+        {
+            int j = 0;
+            for (; j + 3 < outw; j += 4)
+            {
+                __m256 _sum0 = _bias0;
+                __m256 _sum1 = _bias0;
+                __m256 _sum2 = _bias0;
+                __m256 _sum3 = _bias0;
+
+                const float* kptr = k0;
+
+                for (int y = 0; y < kernel_h; y++)
+                {
+                    const float* r0 = img0.row(i * stride_h + y * dilation_h) + j * sstep;
+
+                    for (int x = 0; x < kernel_w; x++)
+                    {
+                        __m256 _k = _mm256_loadu_ps(kptr);
+
+                        __m256 _r0 = _mm256_loadu_ps(r0);
+                        __m256 _r1 = _mm256_loadu_ps(r0 + sstep);
+                        __m256 _r2 = _mm256_loadu_ps(r0 + sstep * 2);
+                        __m256 _r3 = _mm256_loadu_ps(r0 + sstep * 3);
+
+                        _sum0 = _mm256_comp_fmadd_ps(_k, _r0, _sum0);
+                        _sum1 = _mm256_comp_fmadd_ps(_k, _r1, _sum1);
+                        _sum2 = _mm256_comp_fmadd_ps(_k, _r2, _sum2);
+                        _sum3 = _mm256_comp_fmadd_ps(_k, _r3, _sum3);
+
+                        r0 += dstep;
+                        kptr += 8;
+                    }
+                }
+
+                _sum0 = activation_avx(_sum0, activation_type, activation_params);
+                _sum1 = activation_avx(_sum1, activation_type, activation_params);
+                _sum2 = activation_avx(_sum2, activation_type, activation_params);
+                _sum3 = activation_avx(_sum3, activation_type, activation_params);
+
+                _mm256_storeu_ps(outptr, _sum0);
+                _mm256_storeu_ps(outptr + 8, _sum1);
+                _mm256_storeu_ps(outptr + 8 * 2, _sum2);
+                _mm256_storeu_ps(outptr + 8 * 3, _sum3);
+
+                outptr += 8 * 4;
+            }
+            for (; j < outw; j++)
+            {
+                __m256 _sum0 = _bias0;
+
+                const float* kptr = k0;
+
+                for (int y = 0; y < kernel_h; y++)
+                {
+                    const float* r0 = img0.row(i * stride_h + y * dilation_h) + j * sstep;
+
+                    for (int x = 0; x < kernel_w; x++)
+                    {
+                        __m256 _k = _mm256_loadu_ps(kptr);
+                        __m256 _r0 = _mm256_loadu_ps(r0);
+
+                        _sum0 = _mm256_comp_fmadd_ps(_k, _r0, _sum0);
+
+                        r0 += dstep;
+                        kptr += 8;
+                    }
+                }
+
+                _sum0 = activation_avx(_sum0, activation_type, activation_params);
+
+                _mm256_storeu_ps(outptr, _sum0);
+
+                outptr += 8;
+            }
+        }
+    }
+}
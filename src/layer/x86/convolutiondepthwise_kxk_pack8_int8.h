@@ -0,0 +1,92 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+static NCNN_FORCEINLINE void convdw_kxk_pack8_int8_accumulate(const signed char* r0, const signed char* kptr, __m128i& _sum0, __m128i& _sum1)
+{
+    // TODO use _mm_cvtepi8_epi16 on sse4.1
+    __m128i _val = _mm_loadl_epi64((const __m128i*)r0);
+    _val = _mm_unpacklo_epi8(_val, _mm_cmpgt_epi8(_mm_setzero_si128(), _val));
+
+    __m128i _w = _mm_loadl_epi64((const __m128i*)kptr);
+    _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+
+    __m128i _sl = _mm_mullo_epi16(_val, _w);
+    __m128i _sh = _mm_mulhi_epi16(_val, _w);
+
+    _sum0 = _mm_add_epi32(_sum0, _mm_unpacklo_epi16(_sl, _sh));
+    _sum1 = _mm_add_epi32(_sum1, _mm_unpackhi_epi16(_sl, _sh));
+}
+
+// compute the int32 accumulators of output row i for one pack8 channel
+static void convdw_kxk_pack8_int8_row_sse(const Mat& img0, const signed char* k0, int* sumptr, int i, int outw, int kernel_w, int kernel_h, int dilation_w, int dilation_h, int stride_w, int stride_h)
+{
+    const int sstep = stride_w * 8;
+    const int dstep = dilation_w * 8;
+
+    int j = 0;
+    for (; j + 3 < outw; j += 4)
+    {
+        __m128i _sum00 = _mm_setzero_si128();
+        __m128i _sum01 = _mm_setzero_si128();
+        __m128i _sum10 = _mm_setzero_si128();
+        __m128i _sum11 = _mm_setzero_si128();
+        __m128i _sum20 = _mm_setzero_si128();
+        __m128i _sum21 = _mm_setzero_si128();
+        __m128i _sum30 = _mm_setzero_si128();
+        __m128i _sum31 = _mm_setzero_si128();
+
+        const signed char* kptr = k0;
+
+        for (int y = 0; y < kernel_h; y++)
+        {
+            const signed char* r0 = img0.row<const signed char>(i * stride_h + y * dilation_h) + j * sstep;
+
+            for (int x = 0; x < kernel_w; x++)
+            {
+                convdw_kxk_pack8_int8_accumulate(r0, kptr, _sum00, _sum01);
+                convdw_kxk_pack8_int8_accumulate(r0 + sstep, kptr, _sum10, _sum11);
+                convdw_kxk_pack8_int8_accumulate(r0 + sstep * 2, kptr, _sum20, _sum21);
+                convdw_kxk_pack8_int8_accumulate(r0 + sstep * 3, kptr, _sum30, _sum31);
+
+                r0 += dstep;
+                kptr += 8;
+            }
+        }
+
+        _mm_storeu_si128((__m128i*)sumptr, _sum00);
+        _mm_storeu_si128((__m128i*)(sumptr + 4), _sum01);
+        _mm_storeu_si128((__m128i*)(sumptr + 8), _sum10);
+        _mm_storeu_si128((__m128i*)(sumptr + 12), _sum11);
+        _mm_storeu_si128((__m128i*)(sumptr + 16), _sum20);
+        _mm_storeu_si128((__m128i*)(sumptr + 20), _sum21);
+        _mm_storeu_si128((__m128i*)(sumptr + 24), _sum30);
+        _mm_storeu_si128((__m128i*)(sumptr + 28), _sum31);
+
+        sumptr += 32;
+    }
+    for (; j < outw; j++)
+    {
+        __m128i _sum0 = _mm_setzero_si128();
+        __m128i _sum1 = _mm_setzero_si128();
+
+        const signed char* kptr = k0;
+
+        for (int y = 0; y < kernel_h; y++)
+        {
+            const signed char* r0 = img0.row<const signed char>(i * stride_h + y * dilation_h) + j * sstep;
+
+            for (int x = 0; x < kernel_w; x++)
+            {
+                convdw_kxk_pack8_int8_accumulate(r0, kptr, _sum0, _sum1);
+
+                r0 += dstep;
+                kptr += 8;
+            }
+        }
+
+        _mm_storeu_si128((__m128i*)sumptr, _sum0);
+        _mm_storeu_si128((__m128i*)(sumptr + 4), _sum1);
+
+        sumptr += 8;
+    }
+}
@@ -20,19 +20,26 @@ namespace ncnn {
 #if __SSE2__
 #include "convolutiondepthwise_3x3_pack4.h"
 #include "convolutiondepthwise_5x5_pack4.h"
+#include "convolutiondepthwise_kxk_pack4.h"
 #if __AVX__
 #include "convolutiondepthwise_3x3_pack8.h"
 #include "convolutiondepthwise_5x5_pack8.h"
+#include "convolutiondepthwise_kxk_pack8.h"
 #if __AVX512F__
 #include "convolutiondepthwise_3x3_pack16.h"
 #include "convolutiondepthwise_5x5_pack16.h"
+#include "convolutiondepthwise_kxk_pack16.h"
 #endif // __AVX512F__
 #endif // __AVX__
 #endif // __SSE2__
 #include "convolutiondepthwise_3x3.h"
+#include "convolutiondepthwise_kxk.h"
 
 #if NCNN_INT8
 #include "convolutiondepthwise_3x3_int8.h"
+#if __SSE2__
+#include "convolutiondepthwise_kxk_pack8_int8.h"
+#endif // __SSE2__
 #endif // NCNN_INT8
 
 ConvolutionDepthWise_x86::ConvolutionDepthWise_x86()
@@ -106,19 +113,7 @@ int ConvolutionDepthWise_x86::create_pipeline(const Option& opt)
 
         if (elempack == 1)
         {
-            // depth-wise specific
-            if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 1 && stride_h == 1)
-            {
-                weight_data_tm = weight_data;
-            }
-            else if (kernel_w == 3 && kernel_h == 3 && dilation_w == 1 && dilation_h == 1 && stride_w == 2 && stride_h == 2)
-            {
-                weight_data_tm = weight_data;
-            }
-            else
-            {
-                create_group_ops(opt);
-            }
+            weight_data_tm = weight_data;
         }
 
         if (opt.lightmode)
@@ -351,66 +346,8 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
 
                 return 0;
             }
-            else
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
-                {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
-                    {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
-                    }
-                }
-
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 16;
-                    const Mat m = bottom_blob_bordered.channel(g);
-
-                    for (int i = 0; i < outh; i++)
-                    {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m512 _sum = _mm512_set1_ps(0.f);
-
-                            if (bias_term)
-                            {
-                                _sum = _mm512_loadu_ps(((const float*)bias_data) + g * 16);
-                            }
-
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 16;
-
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m512 _val = _mm512_loadu_ps(sptr + space_ofs[k] * 16);
-                                __m512 _w = _mm512_loadu_ps(kptr + k * 16);
-                                _sum = _mm512_fmadd_ps(_val, _w, _sum);
-                            }
-
-                            _mm512_storeu_ps(outptr, _sum);
-                            outptr += 16;
-                        }
-                    }
-                }
-
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+                convdw_kxk_pack16_avx512(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt);
 
                 return 0;
             }
@@ -462,67 +399,8 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
 
                 return 0;
             }
-            else
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
-                {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
-                    {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
-                    }
-                }
-
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 8;
-                    const Mat m = bottom_blob_bordered.channel(g);
-
-                    for (int i = 0; i < outh; i++)
-                    {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m256 _sum = _mm256_set1_ps(0.f);
-
-                            if (bias_term)
-                            {
-                                _sum = _mm256_loadu_ps(((const float*)bias_data) + g * 8);
-                            }
-
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 8;
-
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m256 _val = _mm256_loadu_ps(sptr + space_ofs[k] * 8);
-                                __m256 _w = _mm256_loadu_ps(kptr + k * 8);
-                                _sum = _mm256_comp_fmadd_ps(_val, _w, _sum);
-                            }
-
-                            _mm256_storeu_ps(outptr + j * 8, _sum);
-                        }
-
-                        outptr += outw * 8;
-                    }
-                }
-
-                if (activation)
-                {
-                    activation->forward_inplace(top_blob, opt);
-                }
+                convdw_kxk_pack8_avx(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt);
 
                 return 0;
             }
@@ -576,62 +454,7 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                 return 0;
             }
             {
-                const int maxk = kernel_w * kernel_h;
-
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
-                {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
-                    {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
-                    }
-                }
-
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    float* outptr = top_blob.channel(g);
-                    const float* kptr = (const float*)weight_data_tm + maxk * g * 4;
-                    const Mat m = bottom_blob_bordered.channel(g);
-
-                    for (int i = 0; i < outh; i++)
-                    {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m128 _sum = _mm_set1_ps(0.f);
-
-                            if (bias_term)
-                            {
-                                _sum = _mm_loadu_ps(((const float*)bias_data) + g * 4);
-                            }
-
-                            const float* sptr = m.row(i * stride_h) + j * stride_w * 4;
-
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                __m128 _val = _mm_loadu_ps(sptr + space_ofs[k] * 4);
-                                __m128 _w = _mm_loadu_ps(kptr + k * 4);
-                                _sum = _mm_add_ps(_mm_mul_ps(_val, _w), _sum);
-                            }
-
-                            _sum = activation_sse(_sum, activation_type, activation_params);
-
-                            _mm_storeu_ps(outptr + j * 4, _sum);
-                        }
-
-                        outptr += outw * 4;
-                    }
-                }
+                convdw_kxk_pack4_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt);
 
                 return 0;
             }
@@ -660,6 +483,11 @@ int ConvolutionDepthWise_x86::forward(const Mat& bottom_blob, Mat& top_blob, con
                     activation->forward_inplace(top_blob, opt);
                 }
 
+                return 0;
+            }
+            {
+                convdw_kxk_sse(bottom_blob_bordered, top_blob, weight_data_tm, bias_data, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h, activation_type, activation_params, opt);
+
                 return 0;
             }
         }
@@ -925,113 +753,80 @@ int ConvolutionDepthWise_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_
 #if __SSE2__
         if (elempack == 8)
         {
+            #pragma omp parallel for num_threads(opt.num_threads)
+            for (int g = 0; g < channels; g++)
             {
-                const int maxk = kernel_w * kernel_h;
+                signed char* outptr_s8 = top_blob.channel(g);
+                float* outptr_f32 = top_blob.channel(g);
+                const signed char* kptr = (const signed char*)weight_data_tm + kernel_w * kernel_h * g * 8;
+                const Mat m = bottom_blob_bordered.channel(g);
 
-                // kernel offsets
-                std::vector<int> _space_ofs(maxk);
-                int* space_ofs = &_space_ofs[0];
+                __m128 _scale_in0;
+                __m128 _scale_in1;
                 {
-                    int p1 = 0;
-                    int p2 = 0;
-                    int gap = w * dilation_h - kernel_w * dilation_w;
-                    for (int i = 0; i < kernel_h; i++)
-                    {
-                        for (int j = 0; j < kernel_w; j++)
-                        {
-                            space_ofs[p1] = p2;
-                            p1++;
-                            p2 += dilation_w;
-                        }
-                        p2 += gap;
-                    }
+                    __m128 _bottom_blob_int8_scales0 = _mm_loadu_ps((const float*)bottom_blob_int8_scales + g * 8);
+                    __m128 _bottom_blob_int8_scales1 = _mm_loadu_ps((const float*)bottom_blob_int8_scales + g * 8 + 4);
+                    __m128 _weight_data_int8_scales0 = _mm_loadu_ps((const float*)weight_data_int8_scales + g * 8);
+                    __m128 _weight_data_int8_scales1 = _mm_loadu_ps((const float*)weight_data_int8_scales + g * 8 + 4);
+                    _scale_in0 = _mm_rcp_ps(_mm_mul_ps(_bottom_blob_int8_scales0, _weight_data_int8_scales0));
+                    _scale_in1 = _mm_rcp_ps(_mm_mul_ps(_bottom_blob_int8_scales1, _weight_data_int8_scales1));
+
+                    __m128 _m0 = _mm_cmpneq_ps(_weight_data_int8_scales0, _mm_setzero_ps());
+                    __m128 _m1 = _mm_cmpneq_ps(_weight_data_int8_scales1, _mm_setzero_ps());
+                    _scale_in0 = _mm_and_ps(_scale_in0, _m0);
+                    _scale_in1 = _mm_and_ps(_scale_in1, _m1);
                 }
 
-                #pragma omp parallel for num_threads(opt.num_threads)
-                for (int g = 0; g < channels; g++)
-                {
-                    signed char* outptr_s8 = top_blob.channel(g);
-                    float* outptr_f32 = top_blob.channel(g);
-                    const signed char* kptr = (const signed char*)weight_data_tm + maxk * g * 8;
-                    const Mat m = bottom_blob_bordered.channel(g);
-
-                    for (int i = 0; i < outh; i++)
-                    {
-                        for (int j = 0; j < outw; j++)
-                        {
-                            __m128i _sum0 = _mm_setzero_si128();
-                            __m128i _sum1 = _mm_setzero_si128();
-
-                            const signed char* sptr = m.row<const signed char>(i * stride_h) + j * stride_w * 8;
+                __m128 _bias0 = bias_term ? _mm_loadu_ps((const float*)bias_data + g * 8) : _mm_setzero_ps();
+                __m128 _bias1 = bias_term ? _mm_loadu_ps((const float*)bias_data + g * 8 + 4) : _mm_setzero_ps();
 
-                            for (int k = 0; k < maxk; k++)
-                            {
-                                // TODO use _mm_cvtepi8_epi16 on sse4.1
-                                __m128i _val = _mm_loadl_epi64((const __m128i*)(sptr + space_ofs[k] * 8));
-                                _val = _mm_unpacklo_epi8(_val, _mm_cmpgt_epi8(_mm_setzero_si128(), _val));
+                __m128 _scale_out0 = _mm_setzero_ps();
+                __m128 _scale_out1 = _mm_setzero_ps();
+                if (use_int8_requantize)
+                {
+                    _scale_out0 = _mm_loadu_ps((const float*)top_blob_int8_scales + g * 8);
+                    _scale_out1 = _mm_loadu_ps((const float*)top_blob_int8_scales + g * 8 + 4);
+                }
 
-                                __m128i _w = _mm_loadl_epi64((const __m128i*)(kptr + k * 8));
-                                _w = _mm_unpacklo_epi8(_w, _mm_cmpgt_epi8(_mm_setzero_si128(), _w));
+                // int32 accumulators of one output row
+                std::vector<int> sums(outw * 8);
 
-                                __m128i _sl = _mm_mullo_epi16(_val, _w);
-                                __m128i _sh = _mm_mulhi_epi16(_val, _w);
-                                __m128i _s0 = _mm_unpacklo_epi16(_sl, _sh);
-                                __m128i _s1 = _mm_unpackhi_epi16(_sl, _sh);
+                for (int i = 0; i < outh; i++)
+                {
+                    convdw_kxk_pack8_int8_row_sse(m, kptr, &sums[0], i, outw, kernel_w, kernel_h, dilation_w, dilation_h, stride_w, stride_h);
 
-                                _sum0 = _mm_add_epi32(_sum0, _s0);
-                                _sum1 = _mm_add_epi32(_sum1, _s1);
-                            }
+                    const int* sumptr = &sums[0];
 
-                            __m128 _scale_in0;
-                            __m128 _scale_in1;
-                            {
-                                __m128 _bottom_blob_int8_scales0 = _mm_loadu_ps((const float*)bottom_blob_int8_scales + g * 8);
-                                __m128 _bottom_blob_int8_scales1 = _mm_loadu_ps((const float*)bottom_blob_int8_scales + g * 8 + 4);
-                                __m128 _weight_data_int8_scales0 = _mm_loadu_ps((const float*)weight_data_int8_scales + g * 8);
-                                __m128 _weight_data_int8_scales1 = _mm_loadu_ps((const float*)weight_data_int8_scales + g * 8 + 4);
-                                _scale_in0 = _mm_rcp_ps(_mm_mul_ps(_bottom_blob_int8_scales0, _weight_data_int8_scales0));
-                                _scale_in1 = _mm_rcp_ps(_mm_mul_ps(_bottom_blob_int8_scales1, _weight_data_int8_scales1));
-
-                                __m128 _m0 = _mm_cmpneq_ps(_weight_data_int8_scales0, _mm_setzero_ps());
-                                __m128 _m1 = _mm_cmpneq_ps(_weight_data_int8_scales1, _mm_setzero_ps());
-                                _scale_in0 = _mm_and_ps(_scale_in0, _m0);
-                                _scale_in1 = _mm_and_ps(_scale_in1, _m1);
-                            }
+                    for (int j = 0; j < outw; j++)
+                    {
+                        __m128i _sum0 = _mm_loadu_si128((const __m128i*)sumptr);
+                        __m128i _sum1 = _mm_loadu_si128((const __m128i*)(sumptr + 4));
 
-                            __m128 _sumfp32_0 = _mm_mul_ps(_mm_cvtepi32_ps(_sum0), _scale_in0);
-                            __m128 _sumfp32_1 = _mm_mul_ps(_mm_cvtepi32_ps(_sum1), _scale_in1);
+                        __m128 _sumfp32_0 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum0), _scale_in0), _bias0);
+                        __m128 _sumfp32_1 = _mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(_sum1), _scale_in1), _bias1);
 
-                            if (bias_term)
-                            {
-                                __m128 _bias0 = _mm_loadu_ps((const float*)bias_data + g * 8);
-                                __m128 _bias1 = _mm_loadu_ps((const float*)bias_data + g * 8 + 4);
-                                _sumfp32_0 = _mm_add_ps(_sumfp32_0, _bias0);
-                                _sumfp32_1 = _mm_add_ps(_sumfp32_1, _bias1);
-                            }
+                        _sumfp32_0 = activation_sse(_sumfp32_0, activation_type, activation_params);
+                        _sumfp32_1 = activation_sse(_sumfp32_1, activation_type, activation_params);
 
-                            _sumfp32_0 = activation_sse(_sumfp32_0, activation_type, activation_params);
-                            _sumfp32_1 = activation_sse(_sumfp32_1, activation_type, activation_params);
+                        if (use_int8_requantize)
+                        {
+                            // requantize and relu
+                            _sumfp32_0 = _mm_mul_ps(_sumfp32_0, _scale_out0);
+                            _sumfp32_1 = _mm_mul_ps(_sumfp32_1, _scale_out1);
+                            int64_t _sum8 = float2int8_sse(_sumfp32_0, _sumfp32_1);
 
-                            if (use_int8_requantize)
-                            {
-                                // requantize and relu
-                                __m128 _scale_out0 = _mm_loadu_ps((const float*)top_blob_int8_scales + g * 8);
-                                __m128 _scale_out1 = _mm_loadu_ps((const float*)top_blob_int8_scales + g * 8 + 4);
-                                _sumfp32_0 = _mm_mul_ps(_sumfp32_0, _scale_out0);
-                                _sumfp32_1 = _mm_mul_ps(_sumfp32_1, _scale_out1);
-                                int64_t _sum8 = float2int8_sse(_sumfp32_0, _sumfp32_1);
-
-                                *(int64_t*)outptr_s8 = _sum8;
-                                outptr_s8 += 8;
-                            }
-                            else
-                            {
-                                // dequantize and relu
-                                _mm_storeu_ps(outptr_f32, _sumfp32_0);
-                                _mm_storeu_ps(outptr_f32 + 4, _sumfp32_1);
-                                outptr_f32 += 8;
-                            }
+                            *(int64_t*)outptr_s8 = _sum8;
+                            outptr_s8 += 8;
+                        }
+                        else
+                        {
+                            // dequantize and relu
+                            _mm_storeu_ps(outptr_f32, _sumfp32_0);
+                            _mm_storeu_ps(outptr_f32 + 4, _sumfp32_1);
+                            outptr_f32 += 8;
                         }
+
+                        sumptr += 8;
                     }
                 }
             }
@@ -0,0 +1,104 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+// dynamic activation quantization, the scale 127 / absmax is computed on the fly
+// so that the layer needs no calibrated bottom_blob_int8_scales
+
+static float dynamic_quantize_absmax(const float* ptr, int size)
+{
+    float absmax = 0.f;
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _absmax_avx512 = _mm512_setzero_ps();
+    for (; i + 15 < size; i += 16)
+    {
+        _absmax_avx512 = _mm512_max_ps(_absmax_avx512, abs512_ps(_mm512_loadu_ps(ptr + i)));
+    }
+    absmax = std::max(absmax, _mm512_comp_reduce_max_ps(_absmax_avx512));
+#endif // __AVX512F__
+    __m256 _absmax_avx = _mm256_setzero_ps();
+    for (; i + 7 < size; i += 8)
+    {
+        _absmax_avx = _mm256_max_ps(_absmax_avx, abs256_ps(_mm256_loadu_ps(ptr + i)));
+    }
+    absmax = std::max(absmax, _mm256_reduce_max_ps(_absmax_avx));
+#endif // __AVX__
+    __m128 _absmax = _mm_setzero_ps();
+    for (; i + 3 < size; i += 4)
+    {
+        _absmax = _mm_max_ps(_absmax, abs_ps(_mm_loadu_ps(ptr + i)));
+    }
+    absmax = std::max(absmax, _mm_reduce_max_ps(_absmax));
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        absmax = std::max(absmax, (float)fabsf(ptr[i]));
+    }
+
+    return absmax;
+}
+
+static float dynamic_quantize_scale(float absmax)
+{
+    return absmax == 0.f ? 1.f : 127.f / absmax;
+}
+
+// absmax and quantize one row while it is still in cache, returns the scale
+static float dynamic_quantize_row_int8(const float* ptr, signed char* outptr, int size)
+{
+    const float scale = dynamic_quantize_scale(dynamic_quantize_absmax(ptr, size));
+
+    int i = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    __m512 _scale_avx512 = _mm512_set1_ps(scale);
+    for (; i + 15 < size; i += 16)
+    {
+        __m512 _p = _mm512_mul_ps(_mm512_loadu_ps(ptr + i), _scale_avx512);
+        _mm_storeu_si128((__m128i*)(outptr + i), float2int8_avx512(_p));
+    }
+#endif // __AVX512F__
+    __m256 _scale_avx = _mm256_set1_ps(scale);
+    for (; i + 7 < size; i += 8)
+    {
+        __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr + i), _scale_avx);
+        *(int64_t*)(outptr + i) = float2int8_avx(_p);
+    }
+#else  // __AVX__
+    __m128 _scale = _mm_set1_ps(scale);
+    for (; i + 7 < size; i += 8)
+    {
+        __m128 _p0 = _mm_mul_ps(_mm_loadu_ps(ptr + i), _scale);
+        __m128 _p1 = _mm_mul_ps(_mm_loadu_ps(ptr + i + 4), _scale);
+        *(int64_t*)(outptr + i) = float2int8_sse(_p0, _p1);
+    }
+#endif // __AVX__
+#endif // __SSE2__
+    for (; i < size; i++)
+    {
+        outptr[i] = float2int8(ptr[i] * scale);
+    }
+
+    return scale;
+}
+
+// one scale over the whole fp32 blob of any elempack
+static float dynamic_quantize_tensor_scale(const Mat& bottom_blob, const Option& opt)
+{
+    const int channels = bottom_blob.c;
+    const int size = bottom_blob.w * bottom_blob.h * bottom_blob.d * bottom_blob.elempack;
+
+    std::vector<float> absmax(channels);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        absmax[q] = dynamic_quantize_absmax(bottom_blob.channel(q), size);
+    }
+
+    return dynamic_quantize_scale(*std::max_element(absmax.begin(), absmax.end()));
+}
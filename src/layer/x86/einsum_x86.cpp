@@ -0,0 +1,393 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "einsum_x86.h"
+
+#include "layer_type.h"
+
+#include <string.h>
+
+namespace ncnn {
+
+Einsum_x86::Einsum_x86()
+{
+    matmul = 0;
+}
+
+static std::vector<std::string> token_groups(const std::string& token)
+{
+    std::vector<std::string> groups(token.size());
+    for (size_t i = 0; i < token.size(); i++)
+    {
+        groups[i] = std::string(1, token[i]);
+    }
+
+    return groups;
+}
+
+static bool is_token_layout(const std::string& token, const std::vector<std::string>& groups)
+{
+    // every group is exactly one dim of the operand, in the same order
+    std::string letters;
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        if (groups[g].size() != 1)
+            return false;
+
+        letters += groups[g];
+    }
+
+    return letters == token;
+}
+
+int Einsum_x86::create_pipeline(const Option& opt)
+{
+    // only two operand contractions are lowered
+    if (lhs_tokens.size() != 2 || rhs_token.empty())
+        return 0;
+
+    for (int b = 0; b < 2; b++)
+    {
+        const std::string& token = lhs_tokens[b];
+        const std::string& other = lhs_tokens[1 - b];
+
+        for (size_t i = 0; i < token.size(); i++)
+        {
+            // diagonal
+            if (token.find(token[i], i + 1) != std::string::npos)
+                return 0;
+
+            // reduced within a single operand
+            if (other.find(token[i]) == std::string::npos && rhs_token.find(token[i]) == std::string::npos)
+                return 0;
+        }
+    }
+
+    // classify output letters, they are always in ijkl order
+    std::string batch;
+    std::string m;
+    std::string n;
+    for (size_t i = 0; i < rhs_token.size(); i++)
+    {
+        const char x = rhs_token[i];
+        const bool in0 = lhs_tokens[0].find(x) != std::string::npos;
+        const bool in1 = lhs_tokens[1].find(x) != std::string::npos;
+
+        if (in0 && in1)
+            batch += x;
+        else if (in0)
+            m += x;
+        else if (in1)
+            n += x;
+        else
+            return 0;
+    }
+
+    // the operand owning the leading free output letter becomes A
+    a_index = 0;
+    b_index = 1;
+    for (size_t i = 0; i < rhs_token.size(); i++)
+    {
+        if (batch.find(rhs_token[i]) != std::string::npos)
+            continue;
+
+        if (n.find(rhs_token[i]) != std::string::npos)
+        {
+            a_index = 1;
+            b_index = 0;
+            std::swap(m, n);
+        }
+        break;
+    }
+
+    const std::string& a_token = lhs_tokens[a_index];
+    const std::string& b_token = lhs_tokens[b_index];
+
+    // contracted letters, in the order of A
+    std::string k;
+    for (size_t i = 0; i < a_token.size(); i++)
+    {
+        if (b_token.find(a_token[i]) != std::string::npos && rhs_token.find(a_token[i]) == std::string::npos)
+            k += a_token[i];
+    }
+
+    // elementwise products stay on the generic loop
+    if (k.empty() && (m.empty() || n.empty()))
+        return 0;
+
+    // matmul broadcasts over up to two batch dims
+    std::vector<std::string> batch_groups;
+    if (batch.size() <= 2)
+        batch_groups = token_groups(batch);
+    else
+        batch_groups.push_back(batch);
+
+    a_groups = batch_groups;
+    a_groups.push_back(m);
+    a_groups.push_back(k);
+
+    c_groups = batch_groups;
+    c_groups.push_back(m);
+    c_groups.push_back(n);
+
+    // take B as N x K when it is already stored that way
+    b_groups = batch_groups;
+    b_groups.push_back(n);
+    b_groups.push_back(k);
+
+    const int transB = is_token_layout(b_token, b_groups) ? 1 : 0;
+    if (!transB)
+    {
+        b_groups[b_groups.size() - 2] = k;
+        b_groups[b_groups.size() - 1] = n;
+    }
+
+    a_direct = is_token_layout(a_token, a_groups);
+    b_direct = is_token_layout(b_token, b_groups);
+    c_direct = is_token_layout(rhs_token, c_groups);
+
+    matmul = ncnn::create_layer_cpu(ncnn::LayerType::MatMul);
+
+    ncnn::ParamDict pd;
+    pd.set(0, transB); // transB
+
+    matmul->load_param(pd);
+
+    matmul->load_model(ModelBinFromMatArray(0));
+
+    matmul->create_pipeline(opt);
+
+    return 0;
+}
+
+int Einsum_x86::destroy_pipeline(const Option& opt)
+{
+    if (matmul)
+    {
+        matmul->destroy_pipeline(opt);
+        delete matmul;
+        matmul = 0;
+    }
+
+    return 0;
+}
+
+static void resolve_dim_sizes(const Mat& m, const std::string& token, int* dim_sizes)
+{
+    const int dims = m.dims;
+
+    for (int s = 0; s < dims; s++)
+    {
+        int dim_size = 1;
+        if (dims == 1) dim_size = m.w;
+        if (dims == 2 && s == 0) dim_size = m.h;
+        if (dims == 2 && s == 1) dim_size = m.w;
+        if (dims == 3 && s == 0) dim_size = m.c;
+        if (dims == 3 && s == 1) dim_size = m.h;
+        if (dims == 3 && s == 2) dim_size = m.w;
+        if (dims == 4 && s == 0) dim_size = m.c;
+        if (dims == 4 && s == 1) dim_size = m.d;
+        if (dims == 4 && s == 2) dim_size = m.h;
+        if (dims == 4 && s == 3) dim_size = m.w;
+
+        dim_sizes[token[s] - 'i'] = dim_size;
+    }
+}
+
+static void resolve_letter_strides(const Mat& m, const std::vector<std::string>& groups, const int* dim_sizes, size_t* letter_strides)
+{
+    // element stride of each dim of m, outermost first
+    size_t strides[4] = {1, 1, 1, 1};
+    if (m.dims == 2)
+    {
+        strides[0] = m.w;
+    }
+    if (m.dims == 3)
+    {
+        strides[0] = m.cstep;
+        strides[1] = m.w;
+    }
+    if (m.dims == 4)
+    {
+        strides[0] = m.cstep;
+        strides[1] = (size_t)m.w * m.h;
+        strides[2] = m.w;
+    }
+
+    // the letters of a group are merged into one dim of m
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        size_t stride = strides[g];
+        for (int i = (int)groups[g].size() - 1; i >= 0; i--)
+        {
+            const int x = groups[g][i] - 'i';
+            letter_strides[x] = stride;
+            stride *= dim_sizes[x];
+        }
+    }
+}
+
+static Mat create_grouped(const std::vector<std::string>& groups, const int* dim_sizes, size_t elemsize, Allocator* allocator)
+{
+    int shape[4] = {1, 1, 1, 1};
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        for (size_t i = 0; i < groups[g].size(); i++)
+        {
+            shape[g] *= dim_sizes[groups[g][i] - 'i'];
+        }
+    }
+
+    if (groups.size() == 1)
+        return Mat(shape[0], elemsize, allocator);
+    if (groups.size() == 2)
+        return Mat(shape[1], shape[0], elemsize, allocator);
+    if (groups.size() == 3)
+        return Mat(shape[2], shape[1], shape[0], elemsize, allocator);
+
+    return Mat(shape[3], shape[2], shape[1], shape[0], elemsize, allocator);
+}
+
+static void einsum_copy(const Mat& src, const size_t* src_strides, Mat& dst, const size_t* dst_strides, const std::string& token, const int* dim_sizes, const Option& opt)
+{
+    // walk the letters of token, outermost first, padded to 4
+    int n[4];
+    size_t ss[4];
+    size_t ds[4];
+    const int pad = 4 - (int)token.size();
+    for (int i = 0; i < 4; i++)
+    {
+        if (i < pad)
+        {
+            n[i] = 1;
+            ss[i] = 0;
+            ds[i] = 0;
+            continue;
+        }
+
+        const int x = token[i - pad] - 'i';
+        n[i] = dim_sizes[x];
+        ss[i] = src_strides[x];
+        ds[i] = dst_strides[x];
+    }
+
+    const float* sptr = src;
+    float* dptr = dst;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int ab = 0; ab < n[0] * n[1]; ab++)
+    {
+        const int a = ab / n[1];
+        const int b = ab % n[1];
+
+        for (int c = 0; c < n[2]; c++)
+        {
+            const float* p = sptr + a * ss[0] + b * ss[1] + c * ss[2];
+            float* q = dptr + a * ds[0] + b * ds[1] + c * ds[2];
+
+            if (ss[3] == 1 && ds[3] == 1)
+            {
+                memcpy(q, p, n[3] * sizeof(float));
+                continue;
+            }
+
+            for (int d = 0; d < n[3]; d++)
+            {
+                q[d * ds[3]] = p[d * ss[3]];
+            }
+        }
+    }
+}
+
+// permute and merge the letters of an operand into the dims of groups
+static int einsum_arrange(const Mat& src, const std::string& token, Mat& dst, const std::vector<std::string>& groups, const int* dim_sizes, const Option& opt)
+{
+    dst = create_grouped(groups, dim_sizes, src.elemsize, opt.workspace_allocator);
+    if (dst.empty())
+        return -100;
+
+    size_t src_strides[16];
+    size_t dst_strides[16];
+    resolve_letter_strides(src, token_groups(token), dim_sizes, src_strides);
+    resolve_letter_strides(dst, groups, dim_sizes, dst_strides);
+
+    std::string letters;
+    for (size_t g = 0; g < groups.size(); g++)
+    {
+        letters += groups[g];
+    }
+
+    einsum_copy(src, src_strides, dst, dst_strides, letters, dim_sizes, opt);
+
+    return 0;
+}
+
+int Einsum_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    if (!matmul)
+        return Einsum::forward(bottom_blobs, top_blobs, opt);
+
+    const Mat& A = bottom_blobs[a_index];
+    const Mat& B = bottom_blobs[b_index];
+    const std::string& a_token = lhs_tokens[a_index];
+    const std::string& b_token = lhs_tokens[b_index];
+
+    // map ijklmnopqrstuvwx -> dim_size
+    int dim_sizes[16];
+    for (int i = 0; i < 16; i++)
+    {
+        dim_sizes[i] = 1;
+    }
+    resolve_dim_sizes(A, a_token, dim_sizes);
+    resolve_dim_sizes(B, b_token, dim_sizes);
+
+    std::vector<Mat> matmul_bottom_blobs(2);
+    matmul_bottom_blobs[0] = A;
+    matmul_bottom_blobs[1] = B;
+
+    if (!a_direct)
+    {
+        int ret = einsum_arrange(A, a_token, matmul_bottom_blobs[0], a_groups, dim_sizes, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    if (!b_direct)
+    {
+        int ret = einsum_arrange(B, b_token, matmul_bottom_blobs[1], b_groups, dim_sizes, opt);
+        if (ret != 0)
+            return ret;
+    }
+
+    if (c_direct)
+        return matmul->forward(matmul_bottom_blobs, top_blobs, opt);
+
+    Option opt_c = opt;
+    opt_c.blob_allocator = opt.workspace_allocator;
+
+    std::vector<Mat> matmul_top_blobs(1);
+    int ret = matmul->forward(matmul_bottom_blobs, matmul_top_blobs, opt_c);
+    if (ret != 0)
+        return ret;
+
+    const Mat& C = matmul_top_blobs[0];
+
+    // scatter to the output letter order
+    const std::vector<std::string> top_groups = token_groups(rhs_token);
+
+    Mat& top_blob = top_blobs[0];
+    top_blob = create_grouped(top_groups, dim_sizes, C.elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    size_t c_strides[16];
+    size_t top_strides[16];
+    resolve_letter_strides(C, c_groups, dim_sizes, c_strides);
+    resolve_letter_strides(top_blob, top_groups, dim_sizes, top_strides);
+
+    einsum_copy(C, c_strides, top_blob, top_strides, rhs_token, dim_sizes, opt);
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,41 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_EINSUM_X86_H
+#define LAYER_EINSUM_X86_H
+
+#include "einsum.h"
+
+namespace ncnn {
+
+class Einsum_x86 : public Einsum
+{
+public:
+    Einsum_x86();
+
+    virtual int create_pipeline(const Option& opt);
+    virtual int destroy_pipeline(const Option& opt);
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+public:
+    // two operand contraction lowered to matmul, null for the generic loop
+    Layer* matmul;
+
+    // operand index of A and B
+    int a_index;
+    int b_index;
+
+    // letter groups, outermost first
+    std::vector<std::string> a_groups; // batch.. M K
+    std::vector<std::string> b_groups; // batch.. K N  or  batch.. N K with transB
+    std::vector<std::string> c_groups; // batch.. M N
+
+    int a_direct;
+    int b_direct;
+    int c_direct;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_EINSUM_X86_H
@@ -22,6 +22,11 @@ Eltwise_x86::Eltwise_x86()
 
 int Eltwise_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+#if NCNN_INT8
+    if (bottom_blobs[0].elembits() == 8)
+        return forward_int8(bottom_blobs, top_blobs, opt);
+#endif
+
     const Mat& bottom_blob = bottom_blobs[0];
     int w = bottom_blob.w;
     int h = bottom_blob.h;
@@ -529,4 +534,122 @@ int Eltwise_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>&
     return 0;
 }
 
+#if NCNN_INT8
+int Eltwise_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // the quantizer gives all inputs and the output the same scale,
+    // so that sum with unit coefficients and max run on the int8 values with saturation
+    bool unit_coeffs = true;
+    for (int i = 0; i < coeffs.w; i++)
+    {
+        if (coeffs[i] != 1.f)
+            unit_coeffs = false;
+    }
+
+    if (!(op_type == Operation_SUM && unit_coeffs) && op_type != Operation_MAX)
+    {
+        NCNN_LOGE("Eltwise int8 supports sum with unit coefficients and max only");
+        return -1;
+    }
+
+    const Mat& bottom_blob = bottom_blobs[0];
+    const size_t bottom_count = bottom_blobs.size();
+
+    bool same_elempack = true;
+    for (size_t b = 1; b < bottom_count; b++)
+    {
+        const Mat& bottom_blob1 = bottom_blobs[b];
+        if (bottom_blob1.dims != bottom_blob.dims || bottom_blob1.w != bottom_blob.w || bottom_blob1.h != bottom_blob.h || bottom_blob1.d != bottom_blob.d || bottom_blob1.c * bottom_blob1.elempack != bottom_blob.c * bottom_blob.elempack || bottom_blob1.elembits() != 8)
+        {
+            NCNN_LOGE("Eltwise int8 supports int8 inputs of the same shape only");
+            return -1;
+        }
+
+        if (bottom_blob1.elempack != bottom_blob.elempack)
+            same_elempack = false;
+    }
+
+    std::vector<Mat> bottom_blobs2 = bottom_blobs;
+    if (!same_elempack)
+    {
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        for (size_t b = 0; b < bottom_count; b++)
+        {
+            convert_packing(bottom_blobs[b], bottom_blobs2[b], 1, opt_unpack);
+            if (bottom_blobs2[b].empty())
+                return -100;
+        }
+    }
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create_like(bottom_blobs2[0], opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const int channels = top_blob.c;
+    const int size = top_blob.w * top_blob.h * top_blob.d * top_blob.elempack;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        signed char* outptr = top_blob.channel(q);
+
+        int i = 0;
+#if __SSE2__
+        for (; i + 15 < size; i += 16)
+        {
+            const signed char* ptr = (const signed char*)bottom_blobs2[0].channel(q) + i;
+            __m128i _p = _mm_loadu_si128((const __m128i*)ptr);
+
+            if (op_type == Operation_SUM)
+            {
+                // sum in int16 and saturate once, as the fp32 sum would
+                __m128i _sum0 = _mm_srai_epi16(_mm_unpacklo_epi8(_p, _p), 8);
+                __m128i _sum1 = _mm_srai_epi16(_mm_unpackhi_epi8(_p, _p), 8);
+                for (size_t b = 1; b < bottom_count; b++)
+                {
+                    const signed char* ptr1 = (const signed char*)bottom_blobs2[b].channel(q) + i;
+                    __m128i _p1 = _mm_loadu_si128((const __m128i*)ptr1);
+                    _sum0 = _mm_adds_epi16(_sum0, _mm_srai_epi16(_mm_unpacklo_epi8(_p1, _p1), 8));
+                    _sum1 = _mm_adds_epi16(_sum1, _mm_srai_epi16(_mm_unpackhi_epi8(_p1, _p1), 8));
+                }
+                _p = _mm_packs_epi16(_sum0, _sum1);
+            }
+            else
+            {
+                for (size_t b = 1; b < bottom_count; b++)
+                {
+                    const signed char* ptr1 = (const signed char*)bottom_blobs2[b].channel(q) + i;
+                    __m128i _p1 = _mm_loadu_si128((const __m128i*)ptr1);
+
+                    // max without sse4.1
+                    __m128i _gt = _mm_cmpgt_epi8(_p, _p1);
+                    _p = _mm_or_si128(_mm_and_si128(_gt, _p), _mm_andnot_si128(_gt, _p1));
+                }
+            }
+
+            _mm_storeu_si128((__m128i*)(outptr + i), _p);
+        }
+#endif // __SSE2__
+        for (; i < size; i++)
+        {
+            int v = ((const signed char*)bottom_blobs2[0].channel(q))[i];
+            for (size_t b = 1; b < bottom_count; b++)
+            {
+                const int v1 = ((const signed char*)bottom_blobs2[b].channel(q))[i];
+                if (op_type == Operation_SUM)
+                    v += v1;
+                else
+                    v = std::max(v, v1);
+            }
+
+            outptr[i] = (signed char)std::min(std::max(v, -128), 127);
+        }
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
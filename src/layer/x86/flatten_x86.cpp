@@ -66,13 +66,16 @@ int Flatten_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
         return Flatten::forward(bottom_blob, top_blob, opt);
     }
 
-    if (dims == 2 && elempack == 1) // out_elempack == 4 || out_elempack == 8 || out_elempack == 16
+    if ((dims == 2 || bottom_blob.cstep == (size_t)size) && elempack == 1) // out_elempack == 4 || out_elempack == 8 || out_elempack == 16
     {
+        // no channel padding, the packed 1d layout is the same memory
         top_blob = bottom_blob;
         top_blob.dims = 1;
         top_blob.w = total / out_elempack;
         top_blob.h = 1;
-        top_blob.cstep = bottom_blob.cstep / out_elempack;
+        top_blob.d = 1;
+        top_blob.c = 1;
+        top_blob.cstep = total / out_elempack;
         top_blob.elemsize = out_elemsize;
         top_blob.elempack = out_elempack;
         return 0;
@@ -584,13 +587,16 @@ int Flatten_x86::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Optio
         return Flatten::forward(bottom_blob, top_blob, opt);
     }
 
-    if (dims == 2 && elempack == 1) // out_elempack == 8
+    if ((dims == 2 || bottom_blob.cstep == (size_t)size) && elempack == 1) // out_elempack == 8
     {
+        // no channel padding, the packed 1d layout is the same memory
         top_blob = bottom_blob;
         top_blob.dims = 1;
         top_blob.w = total / out_elempack;
         top_blob.h = 1;
-        top_blob.cstep = bottom_blob.cstep / out_elempack;
+        top_blob.d = 1;
+        top_blob.c = 1;
+        top_blob.cstep = total / out_elempack;
         top_blob.elemsize = out_elemsize;
         top_blob.elempack = out_elempack;
         return 0;
@@ -0,0 +1,118 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__
+void innerproduct_sparse_2to4_sse_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& weight_index_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt);
+#endif
+
+static float innerproduct_sparse_2to4_dot(const float* ptr, const float* kptr, const unsigned char* iptr, int groups)
+{
+    float sum = 0.f;
+
+    int g = 0;
+#if __AVX2__
+#if __AVX512F__
+    __m512 _sum16 = _mm512_setzero_ps();
+    {
+        const __m512i _shift = _mm512_setr_epi32(0, 2, 8, 10, 16, 18, 24, 26, 0, 2, 8, 10, 16, 18, 24, 26);
+        const __m512i _base = _mm512_setr_epi32(0, 0, 4, 4, 8, 8, 12, 12, 16, 16, 20, 20, 24, 24, 28, 28);
+        const __m512i _mask = _mm512_set1_epi32(3);
+        for (; g + 7 < groups; g += 8)
+        {
+            int index0;
+            int index1;
+            memcpy(&index0, iptr, sizeof(int));
+            memcpy(&index1, iptr + 4, sizeof(int));
+
+            // 16 offsets from 8 index bytes
+            __m512i _offset = _mm512_inserti64x4(_mm512_castsi256_si512(_mm256_set1_epi32(index0)), _mm256_set1_epi32(index1), 1);
+            _offset = _mm512_and_si512(_mm512_srlv_epi32(_offset, _shift), _mask);
+            _offset = _mm512_add_epi32(_offset, _base);
+
+            __m512 _val = _mm512_i32gather_ps(_offset, ptr, sizeof(float));
+            __m512 _w = _mm512_loadu_ps(kptr);
+            _sum16 = _mm512_fmadd_ps(_val, _w, _sum16);
+
+            ptr += 32;
+            kptr += 16;
+            iptr += 8;
+        }
+    }
+#endif // __AVX512F__
+    __m256 _sum8 = _mm256_setzero_ps();
+    {
+        const __m256i _shift = _mm256_setr_epi32(0, 2, 8, 10, 16, 18, 24, 26);
+        const __m256i _base = _mm256_setr_epi32(0, 0, 4, 4, 8, 8, 12, 12);
+        const __m256i _mask = _mm256_set1_epi32(3);
+        for (; g + 3 < groups; g += 4)
+        {
+            int index;
+            memcpy(&index, iptr, sizeof(int));
+
+            // 8 offsets from 4 index bytes
+            __m256i _offset = _mm256_set1_epi32(index);
+            _offset = _mm256_and_si256(_mm256_srlv_epi32(_offset, _shift), _mask);
+            _offset = _mm256_add_epi32(_offset, _base);
+
+            __m256 _val = _mm256_i32gather_ps(ptr, _offset, sizeof(float));
+            __m256 _w = _mm256_loadu_ps(kptr);
+            _sum8 = _mm256_comp_fmadd_ps(_val, _w, _sum8);
+
+            ptr += 16;
+            kptr += 8;
+            iptr += 4;
+        }
+    }
+#if __AVX512F__
+    sum += _mm512_comp_reduce_add_ps(_sum16);
+#endif
+    sum += _mm256_reduce_add_ps(_sum8);
+#endif // __AVX2__
+    for (; g < groups; g++)
+    {
+        const int index = iptr[0];
+        sum += ptr[index & 3] * kptr[0];
+        sum += ptr[(index >> 2) & 3] * kptr[1];
+
+        ptr += 4;
+        kptr += 2;
+        iptr += 1;
+    }
+
+    return sum;
+}
+
+static void innerproduct_sparse_2to4_sse(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& weight_index_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+#if NCNN_RUNTIME_CPU && NCNN_AVX2 && __AVX__ && !__AVX2__
+    if (ncnn::cpu_support_x86_avx2())
+    {
+        innerproduct_sparse_2to4_sse_avx2(bottom_blob, top_blob, weight_data_tm, weight_index_tm, bias_data, activation_type, activation_params, opt);
+        return;
+    }
+#endif
+
+    // bottom_blob and top_blob are unpacked, one row per sample
+    const int groups = weight_index_tm.w;
+    const int num_output = weight_index_tm.h;
+    const int h = bottom_blob.dims == 2 ? bottom_blob.h : 1;
+
+    const float* bias_data_ptr = bias_data;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int p = 0; p < num_output; p++)
+    {
+        const float* kptr = weight_data_tm.row(p);
+        const unsigned char* iptr = weight_index_tm.row<const unsigned char>(p);
+
+        for (int i = 0; i < h; i++)
+        {
+            const float* ptr = bottom_blob.row(i);
+
+            float sum = bias_data_ptr ? bias_data_ptr[p] : 0.f;
+            sum += innerproduct_sparse_2to4_dot(ptr, kptr, iptr, groups);
+
+            top_blob.row(i)[p] = activation_ss(sum, activation_type, activation_params);
+        }
+    }
+}
@@ -17,10 +17,17 @@
 
 #include "cpu.h"
 
+#include "sparse_weight.h"
+
 namespace ncnn {
 
 #include "innerproduct_fp.h"
 #include "innerproduct_gemm_fp.h"
+#include "innerproduct_sparse.h"
+
+#if NCNN_INT8
+#include "dynamic_quantize_int8.h"
+#endif
 
 #if NCNN_F16C && __AVX__
 #define NCNN_IMPL_FP16S 1
@@ -58,6 +65,11 @@ int InnerProduct_x86::create_pipeline(const Option& opt)
     }
 #endif
 
+    if (sparse_format == 1)
+    {
+        return create_pipeline_sparse(opt);
+    }
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -96,6 +108,11 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     }
 #endif
 
+    if (sparse_format == 1)
+    {
+        return forward_sparse(bottom_blob, top_blob, opt);
+    }
+
 #if NCNN_F16C && __AVX__
     if (cpu_support_x86_f16c() && opt.use_fp16_storage)
     {
@@ -160,6 +177,74 @@ int InnerProduct_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Optio
     return 0;
 }
 
+int InnerProduct_x86::create_pipeline_sparse(const Option& opt)
+{
+    const int num_input = weight_data_size / num_output;
+
+    // the kernels skip the pruned half of the weights
+    int ret = sparse_2to4_pack(weight_data, weight_data_tm, weight_index_tm, num_input, num_output);
+    if (ret != 0)
+    {
+        NCNN_LOGE("InnerProduct weight is not 2:4 sparse");
+        return ret;
+    }
+
+    if (opt.lightmode)
+        weight_data.release();
+
+    return 0;
+}
+
+int InnerProduct_x86::forward_sparse(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int num_input = weight_data_size / num_output;
+
+    if (bottom_blob.dims == 2 && bottom_blob.w == num_input)
+    {
+        // gemm
+        Mat bottom_blob_unpacked = bottom_blob;
+        if (bottom_blob.elempack != 1)
+        {
+            Option opt_unpack = opt;
+            opt_unpack.blob_allocator = opt.workspace_allocator;
+
+            convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_unpack);
+            if (bottom_blob_unpacked.empty())
+                return -100;
+        }
+
+        top_blob.create(num_output, bottom_blob_unpacked.h, bottom_blob_unpacked.elemsize, opt.blob_allocator);
+        if (top_blob.empty())
+            return -100;
+
+        innerproduct_sparse_2to4_sse(bottom_blob_unpacked, top_blob, weight_data_tm, weight_index_tm, bias_data, activation_type, activation_params, opt);
+
+        return 0;
+    }
+
+    // flatten
+    Mat bottom_blob_flattened = bottom_blob;
+    if (bottom_blob.dims != 1)
+    {
+        Option opt_flatten = opt;
+        opt_flatten.blob_allocator = opt.workspace_allocator;
+
+        flatten->forward(bottom_blob, bottom_blob_flattened, opt_flatten);
+        if (bottom_blob_flattened.empty())
+            return -100;
+    }
+
+    size_t elemsize = bottom_blob_flattened.elemsize / bottom_blob_flattened.elempack;
+
+    top_blob.create(num_output, elemsize, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    innerproduct_sparse_2to4_sse(bottom_blob_flattened, top_blob, weight_data_tm, weight_index_tm, bias_data, activation_type, activation_params, opt);
+
+    return 0;
+}
+
 #if NCNN_F16C && __AVX__
 int InnerProduct_x86::create_pipeline_fp16s(const Option& opt)
 {
@@ -263,6 +348,9 @@ int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
         }
     }
 
+    // the activation scale is applied per forward in dynamic mode
+    const float bottom_blob_int8_scale = int8_scale_term == 3 ? 1.f : bottom_blob_int8_scales[0];
+
     scale_in_data.create(num_output);
     for (int p = 0; p < num_output; p++)
     {
@@ -271,7 +359,7 @@ int InnerProduct_x86::create_pipeline_int8_x86(const Option& opt)
         if (weight_data_int8_scales[p] == 0)
             scale_in = 0;
         else
-            scale_in = 1.f / (bottom_blob_int8_scales[0] * weight_data_int8_scales[p]);
+            scale_in = 1.f / (bottom_blob_int8_scale * weight_data_int8_scales[p]);
 
         scale_in_data[p] = scale_in;
     }
@@ -288,16 +376,77 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
 
     int elembits = bottom_blob.elembits();
 
+    const bool dynamic_quantize = int8_scale_term == 3;
+    if (dynamic_quantize && elembits == 8)
+    {
+        NCNN_LOGE("InnerProduct dynamic int8 quantization needs fp32 input");
+        return -1;
+    }
+
+    // reciprocal of the dynamic activation scale, applied on dequantize
+    // one per input row in gemm, otherwise one for the whole blob
+    Mat descale_data_dynamic;
+
     Mat bottom_blob_int8 = bottom_blob;
-    if (elembits != 8)
+    if (dynamic_quantize && bottom_blob.dims == 2 && bottom_blob.w == num_input)
+    {
+        // fused absmax and quantize per row
+        Mat bottom_blob_unpacked;
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_unpack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+
+        const int h = bottom_blob_unpacked.h;
+
+        bottom_blob_int8.create(num_input, h, (size_t)1u, 1, opt.workspace_allocator);
+        if (bottom_blob_int8.empty())
+            return -100;
+
+        descale_data_dynamic.create(h, (size_t)4u, 1, opt.workspace_allocator);
+        if (descale_data_dynamic.empty())
+            return -100;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int j = 0; j < h; j++)
+        {
+            const float scale = dynamic_quantize_row_int8(bottom_blob_unpacked.row(j), bottom_blob_int8.row<signed char>(j), num_input);
+
+            descale_data_dynamic[j] = 1.f / scale;
+        }
+    }
+    else if (elembits != 8)
     {
+        Mat bottom_blob_int8_scales_dynamic;
+        if (dynamic_quantize)
+        {
+            bottom_blob_int8_scales_dynamic.create(1, (size_t)4u, 1, opt.workspace_allocator);
+            if (bottom_blob_int8_scales_dynamic.empty())
+                return -100;
+
+            const float scale = dynamic_quantize_tensor_scale(bottom_blob, opt);
+            bottom_blob_int8_scales_dynamic[0] = scale;
+
+            descale_data_dynamic.create(1, (size_t)4u, 1, opt.workspace_allocator);
+            if (descale_data_dynamic.empty())
+                return -100;
+
+            descale_data_dynamic[0] = 1.f / scale;
+        }
+
         Option opt_q = opt;
         opt_q.blob_allocator = opt.workspace_allocator;
-        quantize_to_int8(bottom_blob, bottom_blob_int8, bottom_blob_int8_scales, opt_q);
+        quantize_to_int8(bottom_blob, bottom_blob_int8, dynamic_quantize ? bottom_blob_int8_scales_dynamic : bottom_blob_int8_scales, opt_q);
         if (bottom_blob_int8.empty())
             return -100;
     }
 
+    // dequantize scale of output p in row j is scale_in_ptr[p] * row_descale(j)
+    const float* scale_in_ptr = scale_in_data;
+    const float* descale_ptr = descale_data_dynamic;
+    const int descale_rowstep = descale_data_dynamic.w > 1 ? 1 : 0;
+
     if (bottom_blob_int8.dims == 2 && bottom_blob_int8.w == num_input)
     {
         // gemm
@@ -338,6 +487,11 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int j = 0; j < outh; j++)
             {
+                __m128 _descale0 = _mm_set1_ps(descale_ptr ? descale_ptr[(j * 4) * descale_rowstep] : 1.f);
+                __m128 _descale1 = _mm_set1_ps(descale_ptr ? descale_ptr[(j * 4 + 1) * descale_rowstep] : 1.f);
+                __m128 _descale2 = _mm_set1_ps(descale_ptr ? descale_ptr[(j * 4 + 2) * descale_rowstep] : 1.f);
+                __m128 _descale3 = _mm_set1_ps(descale_ptr ? descale_ptr[(j * 4 + 3) * descale_rowstep] : 1.f);
+
                 float* outptr = top_blob.row(j);
 
                 for (int p = 0; p < num_output / num_output_elempack; p++)
@@ -403,8 +557,16 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
                     }
 
                     // dequantize and relu
-                    __m128 _scale_in0 = _mm_loadu_ps((const float*)scale_in_data + p * 8);
-                    __m128 _scale_in1 = _mm_loadu_ps((const float*)scale_in_data + p * 8 + 4);
+                    __m128 _scale_in0 = _mm_loadu_ps(scale_in_ptr + p * 8);
+                    __m128 _scale_in1 = _mm_loadu_ps(scale_in_ptr + p * 8 + 4);
+                    __m128 _scale_in00 = _mm_mul_ps(_scale_in0, _descale0);
+                    __m128 _scale_in01 = _mm_mul_ps(_scale_in1, _descale0);
+                    __m128 _scale_in10 = _mm_mul_ps(_scale_in0, _descale1);
+                    __m128 _scale_in11 = _mm_mul_ps(_scale_in1, _descale1);
+                    __m128 _scale_in20 = _mm_mul_ps(_scale_in0, _descale2);
+                    __m128 _scale_in21 = _mm_mul_ps(_scale_in1, _descale2);
+                    __m128 _scale_in30 = _mm_mul_ps(_scale_in0, _descale3);
+                    __m128 _scale_in31 = _mm_mul_ps(_scale_in1, _descale3);
 
                     __m128 _sumfp32_00 = _mm_cvtepi32_ps(_sum00);
                     __m128 _sumfp32_01 = _mm_cvtepi32_ps(_sum01);
@@ -418,25 +580,25 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
                     {
                         __m128 _bias0 = _mm_loadu_ps((const float*)bias_data + p * 8);
                         __m128 _bias1 = _mm_loadu_ps((const float*)bias_data + p * 8 + 4);
-                        _sumfp32_00 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_00, _scale_in0));
-                        _sumfp32_01 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_01, _scale_in1));
-                        _sumfp32_10 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_10, _scale_in0));
-                        _sumfp32_11 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_11, _scale_in1));
-                        _sumfp32_20 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_20, _scale_in0));
-                        _sumfp32_21 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_21, _scale_in1));
-                        _sumfp32_30 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_30, _scale_in0));
-                        _sumfp32_31 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_31, _scale_in1));
+                        _sumfp32_00 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_00, _scale_in00));
+                        _sumfp32_01 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_01, _scale_in01));
+                        _sumfp32_10 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_10, _scale_in10));
+                        _sumfp32_11 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_11, _scale_in11));
+                        _sumfp32_20 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_20, _scale_in20));
+                        _sumfp32_21 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_21, _scale_in21));
+                        _sumfp32_30 = _mm_add_ps(_bias0, _mm_mul_ps(_sumfp32_30, _scale_in30));
+                        _sumfp32_31 = _mm_add_ps(_bias1, _mm_mul_ps(_sumfp32_31, _scale_in31));
                     }
                     else
                     {
-                        _sumfp32_00 = _mm_mul_ps(_sumfp32_00, _scale_in0);
-                        _sumfp32_01 = _mm_mul_ps(_sumfp32_01, _scale_in1);
-                        _sumfp32_10 = _mm_mul_ps(_sumfp32_10, _scale_in0);
-                        _sumfp32_11 = _mm_mul_ps(_sumfp32_11, _scale_in1);
-                        _sumfp32_20 = _mm_mul_ps(_sumfp32_20, _scale_in0);
-                        _sumfp32_21 = _mm_mul_ps(_sumfp32_21, _scale_in1);
-                        _sumfp32_30 = _mm_mul_ps(_sumfp32_30, _scale_in0);
-                        _sumfp32_31 = _mm_mul_ps(_sumfp32_31, _scale_in1);
+                        _sumfp32_00 = _mm_mul_ps(_sumfp32_00, _scale_in00);
+                        _sumfp32_01 = _mm_mul_ps(_sumfp32_01, _scale_in01);
+                        _sumfp32_10 = _mm_mul_ps(_sumfp32_10, _scale_in10);
+                        _sumfp32_11 = _mm_mul_ps(_sumfp32_11, _scale_in11);
+                        _sumfp32_20 = _mm_mul_ps(_sumfp32_20, _scale_in20);
+                        _sumfp32_21 = _mm_mul_ps(_sumfp32_21, _scale_in21);
+                        _sumfp32_30 = _mm_mul_ps(_sumfp32_30, _scale_in30);
+                        _sumfp32_31 = _mm_mul_ps(_sumfp32_31, _scale_in31);
                     }
 
                     _sumfp32_00 = activation_sse(_sumfp32_00, activation_type, activation_params);
@@ -471,6 +633,11 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int j = 0; j < outh; j++)
             {
+                const float descale0 = descale_ptr ? descale_ptr[(j * 4) * descale_rowstep] : 1.f;
+                const float descale1 = descale_ptr ? descale_ptr[(j * 4 + 1) * descale_rowstep] : 1.f;
+                const float descale2 = descale_ptr ? descale_ptr[(j * 4 + 2) * descale_rowstep] : 1.f;
+                const float descale3 = descale_ptr ? descale_ptr[(j * 4 + 3) * descale_rowstep] : 1.f;
+
                 float* outptr = top_blob.row(j);
 
                 for (int p = 0; p < num_output; p++)
@@ -497,10 +664,10 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
                     }
 
                     // dequantize and relu
-                    float sumfp32_0 = sum0 * scale_in_data[p];
-                    float sumfp32_1 = sum1 * scale_in_data[p];
-                    float sumfp32_2 = sum2 * scale_in_data[p];
-                    float sumfp32_3 = sum3 * scale_in_data[p];
+                    float sumfp32_0 = sum0 * (scale_in_ptr[p] * descale0);
+                    float sumfp32_1 = sum1 * (scale_in_ptr[p] * descale1);
+                    float sumfp32_2 = sum2 * (scale_in_ptr[p] * descale2);
+                    float sumfp32_3 = sum3 * (scale_in_ptr[p] * descale3);
 
                     if (bias_term)
                     {
@@ -524,6 +691,8 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int j = 0; j < outh; j++)
             {
+                __m128 _descale = _mm_set1_ps(descale_ptr ? descale_ptr[j * descale_rowstep] : 1.f);
+
                 float* outptr = top_blob.row(j);
 
                 for (int p = 0; p < num_output / num_output_elempack; p++)
@@ -556,8 +725,8 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
                     }
 
                     // dequantize and relu
-                    __m128 _scale_in0 = _mm_loadu_ps((const float*)scale_in_data + p * 8);
-                    __m128 _scale_in1 = _mm_loadu_ps((const float*)scale_in_data + p * 8 + 4);
+                    __m128 _scale_in0 = _mm_mul_ps(_mm_loadu_ps(scale_in_ptr + p * 8), _descale);
+                    __m128 _scale_in1 = _mm_mul_ps(_mm_loadu_ps(scale_in_ptr + p * 8 + 4), _descale);
 
                     __m128 _sumfp32_0 = _mm_cvtepi32_ps(_sum0);
                     __m128 _sumfp32_1 = _mm_cvtepi32_ps(_sum1);
@@ -591,6 +760,8 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             #pragma omp parallel for num_threads(opt.num_threads)
             for (int j = 0; j < outh; j++)
             {
+                const float descale = descale_ptr ? descale_ptr[j * descale_rowstep] : 1.f;
+
                 float* outptr = top_blob.row(j);
 
                 for (int p = 0; p < num_output; p++)
@@ -607,7 +778,7 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
                     }
 
                     // dequantize and relu
-                    float sumfp32 = sum * scale_in_data[p];
+                    float sumfp32 = sum * (scale_in_ptr[p] * descale);
 
                     if (bias_term)
                         sumfp32 += bias_data[p];
@@ -646,9 +817,13 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
     if (top_blob.empty())
         return -100;
 
+    const float descale = descale_ptr ? descale_ptr[0] : 1.f;
+
 #if __SSE2__
     if (out_elempack == 8)
     {
+        __m128 _descale = _mm_set1_ps(descale);
+
         #pragma omp parallel for num_threads(opt.num_threads)
         for (int p = 0; p < num_output / out_elempack; p++)
         {
@@ -680,8 +855,8 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             }
 
             // dequantize and relu
-            __m128 _scale_in0 = _mm_loadu_ps((const float*)scale_in_data + p * 8);
-            __m128 _scale_in1 = _mm_loadu_ps((const float*)scale_in_data + p * 8 + 4);
+            __m128 _scale_in0 = _mm_mul_ps(_mm_loadu_ps(scale_in_ptr + p * 8), _descale);
+            __m128 _scale_in1 = _mm_mul_ps(_mm_loadu_ps(scale_in_ptr + p * 8 + 4), _descale);
 
             __m128 _sumfp32_0 = _mm_cvtepi32_ps(_sum0);
             __m128 _sumfp32_1 = _mm_cvtepi32_ps(_sum1);
@@ -733,7 +908,7 @@ int InnerProduct_x86::forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, co
             }
 
             // dequantize and relu
-            float sumfp32 = sum * scale_in_data[p];
+            float sumfp32 = sum * (scale_in_ptr[p] * descale);
 
             if (bias_term)
                 sumfp32 += bias_data[p];
@@ -23,6 +23,8 @@ protected:
     int create_pipeline_fp16s(const Option& opt);
     int forward_fp16s(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #endif
+    int create_pipeline_sparse(const Option& opt);
+    int forward_sparse(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
 #if NCNN_INT8
     int create_pipeline_int8_x86(const Option& opt);
     int forward_int8_x86(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const;
@@ -33,6 +35,9 @@ public:
 
     Mat weight_data_tm;
 
+    // 2:4 sparse
+    Mat weight_index_tm;
+
 #if NCNN_INT8
     Mat scale_in_data;
 #endif
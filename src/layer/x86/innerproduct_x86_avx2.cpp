@@ -0,0 +1,25 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "innerproduct_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif
+#endif // __SSE2__
+
+#include "x86_activation.h"
+#include "x86_usability.h"
+
+namespace ncnn {
+
+#include "innerproduct_sparse.h"
+
+void innerproduct_sparse_2to4_sse_avx2(const Mat& bottom_blob, Mat& top_blob, const Mat& weight_data_tm, const Mat& weight_index_tm, const Mat& bias_data, int activation_type, const Mat& activation_params, const Option& opt)
+{
+    innerproduct_sparse_2to4_sse(bottom_blob, top_blob, weight_data_tm, weight_index_tm, bias_data, activation_type, activation_params, opt);
+}
+
+} // namespace ncnn
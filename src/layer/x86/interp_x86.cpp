@@ -41,6 +41,11 @@ Interp_x86::Interp_x86()
 
 int Interp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
 {
+#if NCNN_INT8
+    if (bottom_blobs[0].elembits() == 8)
+        return forward_int8(bottom_blobs, top_blobs, opt);
+#endif
+
     const Mat& bottom_blob = bottom_blobs[0];
     const Mat& reference_blob = bottom_blobs[1];
     Mat& top_blob = top_blobs[0];
@@ -901,4 +906,85 @@ int Interp_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>&
     return 0;
 }
 
+#if NCNN_INT8
+template<typename T>
+static void resize_nearest_int8(const Mat& bottom_blob, Mat& top_blob, float hs, float ws, const Option& opt)
+{
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+    const int channels = bottom_blob.c;
+    const int outw = top_blob.w;
+    const int outh = top_blob.h;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int q = 0; q < channels; q++)
+    {
+        const T* ptr = bottom_blob.channel(q);
+        T* outptr = top_blob.channel(q);
+        for (int y = 0; y < outh; y++)
+        {
+            int in_y = std::min((int)(y * hs), (h - 1));
+            for (int x = 0; x < outw; x++)
+            {
+                int in_x = std::min((int)(x * ws), (w - 1));
+                *outptr++ = ptr[in_y * w + in_x];
+            }
+        }
+    }
+}
+
+int Interp_x86::forward_int8(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const Mat& reference_blob = bottom_blobs[1];
+    Mat& top_blob = top_blobs[0];
+
+    // nearest resize only copies int8 values, other resize is never fed with int8
+    if (resize_type != 1 || bottom_blob.dims != 3)
+    {
+        NCNN_LOGE("Interp int8 supports nearest resize on 3d blobs only");
+        return -1;
+    }
+
+    const int w = bottom_blob.w;
+    const int h = bottom_blob.h;
+
+    int outw = reference_blob.w;
+    int outh = reference_blob.h;
+
+    if (!size_expr.empty())
+    {
+        std::vector<Mat> bottom_blob_shapes(bottom_blobs.size());
+        for (size_t i = 0; i < bottom_blobs.size(); i++)
+        {
+            bottom_blob_shapes[i] = bottom_blobs[i].shape();
+        }
+        eval_size_expr(bottom_blob_shapes, outw, outh);
+    }
+
+    if (outw == w && outh == h)
+    {
+        top_blob = bottom_blob;
+        return 0;
+    }
+
+    top_blob.create(outw, outh, bottom_blob.c, bottom_blob.elemsize, bottom_blob.elempack, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    const float hs = (output_height || !size_expr.empty()) ? h / (float)outh : 1.f / height_scale;
+    const float ws = (output_width || !size_expr.empty()) ? w / (float)outw : 1.f / width_scale;
+
+    // copy whole packed elements
+    if (bottom_blob.elemsize == 8)
+        resize_nearest_int8<int64_t>(bottom_blob, top_blob, hs, ws, opt);
+    else if (bottom_blob.elemsize == 4)
+        resize_nearest_int8<int>(bottom_blob, top_blob, hs, ws, opt);
+    else
+        resize_nearest_int8<signed char>(bottom_blob, top_blob, hs, ws, opt);
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
@@ -0,0 +1,183 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "inversespectrogram_x86.h"
+
+#include "cpu.h"
+
+#include "x86_fft.h"
+
+namespace ncnn {
+
+InverseSpectrogram_x86::InverseSpectrogram_x86()
+{
+}
+
+int InverseSpectrogram_x86::create_pipeline(const Option& /*opt*/)
+{
+    fft_factorize(n_fft, fft_factors);
+    fft_make_twiddles(n_fft, fft_factors, fft_twiddles);
+
+    return 0;
+}
+
+int InverseSpectrogram_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    const int frames = bottom_blob.h;
+    const int freqs = bottom_blob.c;
+    // assert freqs == n_fft or freqs == n_fft / 2 + 1
+
+    const int onesided = freqs == n_fft / 2 + 1 ? 1 : 0;
+
+    const int outsize = center ? (frames - 1) * hoplen + (n_fft - n_fft / 2 * 2) : (frames - 1) * hoplen + n_fft;
+
+    const size_t elemsize = bottom_blob.elemsize;
+
+    if (returns == 0)
+    {
+        top_blob.create(2, outsize, elemsize, opt.blob_allocator);
+    }
+    else
+    {
+        top_blob.create(outsize, elemsize, opt.blob_allocator);
+    }
+    if (top_blob.empty())
+        return -100;
+
+    // windowed complex signal of every frame
+    Mat frames_out(n_fft * 2, frames, elemsize, opt.workspace_allocator);
+    if (frames_out.empty())
+        return -100;
+
+    // frames transformed together, one per simd lane
+#if __AVX512F__
+    const int batch = 16;
+#elif __AVX__
+    const int batch = 8;
+#elif __SSE2__
+    const int batch = 4;
+#else
+    const int batch = 1;
+#endif
+    const int nn_batch = (frames + batch - 1) / batch;
+
+    // ping-pong buffers for each thread
+    Mat tmp(n_fft * batch * 4, 1, opt.num_threads, 4u, opt.workspace_allocator);
+    if (tmp.empty())
+        return -100;
+
+    float norm = 1.f / n_fft;
+    if (normalized == 1)
+        norm *= sqrtf(n_fft);
+    if (normalized == 2)
+        norm *= window_data[n_fft];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int bb = 0; bb < nn_batch; bb++)
+    {
+        const int j0 = bb * batch;
+        const int lanes = std::min(batch, frames - j0);
+
+        float* x = tmp.channel(get_omp_thread_num());
+        float* y = x + n_fft * lanes * 2;
+
+        // gather conjugated spectrum, ifft(X) = conj(fft(conj(X))) / n
+        for (int k = 0; k < n_fft; k++)
+        {
+            float* xptr = x + k * lanes * 2;
+
+            const int mirror = onesided && k >= n_fft / 2 + 1;
+            const Mat bottom_k = bottom_blob.channel(mirror ? n_fft - k : k);
+
+            for (int l = 0; l < lanes; l++)
+            {
+                const float* p = bottom_k.row(j0 + l);
+                xptr[l] = p[0];
+                xptr[lanes + l] = mirror ? p[1] : -p[1];
+            }
+        }
+
+        const float* z = fft_batch(x, y, n_fft, fft_factors, fft_twiddles, lanes);
+
+        for (int l = 0; l < lanes; l++)
+        {
+            float* outptr = frames_out.row(j0 + l);
+
+            for (int i = 0; i < n_fft; i++)
+            {
+                const float* zi = z + i * lanes * 2;
+
+                // apply window
+                outptr[0] = zi[l] * norm * window_data[i];
+                outptr[1] = -zi[lanes + l] * norm * window_data[i];
+                outptr += 2;
+            }
+        }
+    }
+
+    // overlap add
+    Mat window_sumsquare(outsize, elemsize, opt.workspace_allocator);
+    if (window_sumsquare.empty())
+        return -100;
+
+    top_blob.fill(0.f);
+    window_sumsquare.fill(0.f);
+
+    for (int j = 0; j < frames; j++)
+    {
+        const float* ptr = frames_out.row(j);
+
+        for (int i = 0; i < n_fft; i++)
+        {
+            int output_index = j * hoplen + i;
+            if (center == 1)
+            {
+                output_index -= n_fft / 2;
+            }
+            if (output_index >= 0 && output_index < outsize)
+            {
+                // square window
+                window_sumsquare[output_index] += window_data[i] * window_data[i];
+
+                if (returns == 0)
+                {
+                    top_blob.row(output_index)[0] += ptr[i * 2];
+                    top_blob.row(output_index)[1] += ptr[i * 2 + 1];
+                }
+                if (returns == 1)
+                {
+                    top_blob[output_index] += ptr[i * 2];
+                }
+                if (returns == 2)
+                {
+                    top_blob[output_index] += ptr[i * 2 + 1];
+                }
+            }
+        }
+    }
+
+    // square window norm
+    if (returns == 0)
+    {
+        for (int i = 0; i < outsize; i++)
+        {
+            if (window_sumsquare[i] != 0.f)
+            {
+                top_blob.row(i)[0] /= window_sumsquare[i];
+                top_blob.row(i)[1] /= window_sumsquare[i];
+            }
+        }
+    }
+    else
+    {
+        for (int i = 0; i < outsize; i++)
+        {
+            if (window_sumsquare[i] != 0.f)
+                top_blob[i] /= window_sumsquare[i];
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
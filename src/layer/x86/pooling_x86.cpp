@@ -54,6 +54,11 @@ int Pooling_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
     // max value in NxN window
     // avg value in NxN window
 
+#if NCNN_INT8
+    if (bottom_blob.elembits() == 8)
+        return forward_int8(bottom_blob, top_blob, opt);
+#endif
+
     if (adaptive_pooling)
     {
         return Pooling::forward(bottom_blob, top_blob, opt);
@@ -815,4 +820,133 @@ int Pooling_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& op
 #endif
 }
 
+#if NCNN_INT8
+int Pooling_x86::forward_int8(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    // max pooling keeps the int8 scale, other pooling is never fed with int8
+    if (pooling_type != PoolMethod_MAX || adaptive_pooling || bottom_blob.dims != 3)
+    {
+        NCNN_LOGE("Pooling int8 supports non-adaptive max pooling on 3d blobs only");
+        return -1;
+    }
+
+    Mat bottom_blob_unpacked = bottom_blob;
+    if (bottom_blob.elempack != 1)
+    {
+        Option opt_unpack = opt;
+        opt_unpack.blob_allocator = opt.workspace_allocator;
+        convert_packing(bottom_blob, bottom_blob_unpacked, 1, opt_unpack);
+        if (bottom_blob_unpacked.empty())
+            return -100;
+    }
+
+    const int channels = bottom_blob_unpacked.c;
+    const int out_elempack = opt.use_packing_layout && channels % 8 == 0 ? 8 : 1;
+
+    Allocator* out_allocator = out_elempack == 1 ? opt.blob_allocator : opt.workspace_allocator;
+
+    Mat top_blob_unpacked;
+    if (global_pooling)
+    {
+        const int size = bottom_blob_unpacked.w * bottom_blob_unpacked.h;
+
+        top_blob_unpacked.create(channels, (size_t)1u, out_allocator);
+        if (top_blob_unpacked.empty())
+            return -100;
+
+        signed char* outptr = top_blob_unpacked;
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const signed char* ptr = bottom_blob_unpacked.channel(q);
+
+            signed char max = ptr[0];
+            for (int i = 0; i < size; i++)
+            {
+                max = std::max(max, ptr[i]);
+            }
+
+            outptr[q] = max;
+        }
+    }
+    else
+    {
+        // padded with -128
+        Mat bottom_blob_bordered;
+        make_padding(bottom_blob_unpacked, bottom_blob_bordered, opt);
+        if (bottom_blob_bordered.empty())
+            return -100;
+
+        const int w = bottom_blob_bordered.w;
+        const int h = bottom_blob_bordered.h;
+
+        const int outw = (w - kernel_w) / stride_w + 1;
+        const int outh = (h - kernel_h) / stride_h + 1;
+
+        top_blob_unpacked.create(outw, outh, channels, (size_t)1u, out_allocator);
+        if (top_blob_unpacked.empty())
+            return -100;
+
+        const int maxk = kernel_w * kernel_h;
+
+        // kernel offsets
+        std::vector<int> _space_ofs(maxk);
+        int* space_ofs = &_space_ofs[0];
+        {
+            int p1 = 0;
+            int p2 = 0;
+            int gap = w - kernel_w;
+            for (int i = 0; i < kernel_h; i++)
+            {
+                for (int j = 0; j < kernel_w; j++)
+                {
+                    space_ofs[p1] = p2;
+                    p1++;
+                    p2++;
+                }
+                p2 += gap;
+            }
+        }
+
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int q = 0; q < channels; q++)
+        {
+            const Mat m = bottom_blob_bordered.channel(q);
+            signed char* outptr = top_blob_unpacked.channel(q);
+
+            for (int i = 0; i < outh; i++)
+            {
+                for (int j = 0; j < outw; j++)
+                {
+                    const signed char* sptr = m.row<const signed char>(i * stride_h) + j * stride_w;
+
+                    signed char max = sptr[0];
+                    for (int k = 0; k < maxk; k++)
+                    {
+                        max = std::max(max, sptr[space_ofs[k]]);
+                    }
+
+                    outptr[j] = max;
+                }
+
+                outptr += outw;
+            }
+        }
+    }
+
+    if (out_elempack == 1)
+    {
+        top_blob = top_blob_unpacked;
+        return 0;
+    }
+
+    convert_packing(top_blob_unpacked, top_blob, out_elempack, opt);
+    if (top_blob.empty())
+        return -100;
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 } // namespace ncnn
@@ -88,6 +88,19 @@ int Reshape_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>&
             return 0;
         }
 
+        if ((dims == 3 || dims == 4) && bottom_blob.c * elempack == outh && elempack == out_elempack && bottom_blob.cstep == (size_t)bottom_blob.w * bottom_blob.h * bottom_blob.d)
+        {
+            // each channel becomes a row, reference the data as is
+            top_blob = bottom_blob;
+            top_blob.dims = 2;
+            top_blob.w = outw;
+            top_blob.h = bottom_blob.c;
+            top_blob.d = 1;
+            top_blob.c = 1;
+            top_blob.cstep = (size_t)outw * bottom_blob.c;
+            return 0;
+        }
+
         if (out_elempack == 1)
         {
             // flatten
@@ -405,17 +418,53 @@ int Reshape_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>&
             return 0;
         }
 
+        const int outsize = outw * outh * outd;
+
+        // channels of the output need no padding
+        const bool outsize_aligned = alignSize(outsize * out_elemsize, 16) / out_elemsize == (size_t)outsize;
+
+        if (dims == 2 && bottom_blob.h * elempack == outc && elempack == out_elempack && outsize_aligned)
+        {
+            // each row becomes a channel, reference the data as is
+            top_blob = bottom_blob;
+            top_blob.dims = ndim;
+            top_blob.w = outw;
+            top_blob.h = outh;
+            top_blob.d = outd;
+            top_blob.c = bottom_blob.h;
+            top_blob.cstep = outsize;
+            return 0;
+        }
+
         // flatten
+        // the flattened data is the unpacked output when channels need no padding
+        const bool flattened_is_output = out_elempack == 1 && outsize_aligned;
+
         Mat bottom_blob_flattened = bottom_blob;
         {
             Option opt_flatten = opt;
-            opt_flatten.blob_allocator = opt.workspace_allocator;
+            if (!flattened_is_output)
+                opt_flatten.blob_allocator = opt.workspace_allocator;
 
             flatten(bottom_blob, bottom_blob_flattened, opt_flatten);
             if (bottom_blob_flattened.empty())
                 return -100;
         }
 
+        if (flattened_is_output)
+        {
+            top_blob = bottom_blob_flattened;
+            top_blob.dims = ndim;
+            top_blob.w = outw;
+            top_blob.h = outh;
+            top_blob.d = outd;
+            top_blob.c = outc;
+            top_blob.cstep = outsize;
+            top_blob.elemsize = out_elemsize;
+            top_blob.elempack = out_elempack;
+            return 0;
+        }
+
         if (ndim == 3)
         {
             top_blob.create(outw, outh, outc / out_elempack, out_elemsize, out_elempack, opt.blob_allocator);
@@ -0,0 +1,229 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "spectrogram_x86.h"
+
+#include "cpu.h"
+
+#include "x86_fft.h"
+
+namespace ncnn {
+
+Spectrogram_x86::Spectrogram_x86()
+{
+}
+
+int Spectrogram_x86::create_pipeline(const Option& /*opt*/)
+{
+    const int fft_size = n_fft % 2 == 0 ? n_fft / 2 : n_fft;
+
+    fft_factorize(fft_size, fft_factors);
+    fft_make_twiddles(fft_size, fft_factors, fft_twiddles);
+
+    if (n_fft % 2 == 0)
+    {
+        // split the half size complex spectrum into the real input spectrum
+        rfft_twiddles.create((n_fft / 2 + 1) * 2);
+
+        float* ptr = rfft_twiddles;
+        for (int k = 0; k < n_fft / 2 + 1; k++)
+        {
+            const double angle = 2 * 3.14159265358979323846 * k / n_fft;
+            ptr[0] = (float)cos(angle);
+            ptr[1] = (float)-sin(angle);
+            ptr += 2;
+        }
+    }
+
+    return 0;
+}
+
+static void store_spectrogram(Mat& top_blob, int power, int k, int j, float re, float im)
+{
+    if (power == 0)
+    {
+        // complex as real
+        float* outptr = top_blob.channel(k).row(j);
+        outptr[0] = re;
+        outptr[1] = im;
+    }
+    if (power == 1)
+    {
+        // magnitude
+        top_blob.row(k)[j] = sqrtf(re * re + im * im);
+    }
+    if (power == 2)
+    {
+        top_blob.row(k)[j] = re * re + im * im;
+    }
+}
+
+int Spectrogram_x86::forward(const Mat& bottom_blob, Mat& top_blob, const Option& opt) const
+{
+    Mat bottom_blob_bordered = bottom_blob;
+    if (center == 1)
+    {
+        Option opt_b = opt;
+        opt_b.blob_allocator = opt.workspace_allocator;
+        if (pad_type == 0)
+            copy_make_border(bottom_blob, bottom_blob_bordered, 0, 0, n_fft / 2, n_fft / 2, BORDER_CONSTANT, 0.f, opt_b);
+        if (pad_type == 1)
+            copy_make_border(bottom_blob, bottom_blob_bordered, 0, 0, n_fft / 2, n_fft / 2, BORDER_REPLICATE, 0.f, opt_b);
+        if (pad_type == 2)
+            copy_make_border(bottom_blob, bottom_blob_bordered, 0, 0, n_fft / 2, n_fft / 2, BORDER_REFLECT, 0.f, opt_b);
+    }
+
+    const int size = bottom_blob_bordered.w;
+
+    const int frames = (size - n_fft) / hoplen + 1;
+    const int freqs_onesided = n_fft / 2 + 1;
+    const int freqs = onesided ? freqs_onesided : n_fft;
+
+    const size_t elemsize = bottom_blob_bordered.elemsize;
+
+    if (power == 0)
+    {
+        top_blob.create(2, frames, freqs, elemsize, opt.blob_allocator);
+    }
+    else
+    {
+        top_blob.create(frames, freqs, elemsize, opt.blob_allocator);
+    }
+    if (top_blob.empty())
+        return -100;
+
+    // even n_fft packs the even and odd samples into one complex sequence of half size
+    const int real_fft = n_fft % 2 == 0 ? 1 : 0;
+    const int fft_size = real_fft ? n_fft / 2 : n_fft;
+
+    // frames transformed together, one per simd lane
+#if __AVX512F__
+    const int batch = 16;
+#elif __AVX__
+    const int batch = 8;
+#elif __SSE2__
+    const int batch = 4;
+#else
+    const int batch = 1;
+#endif
+    const int nn_batch = (frames + batch - 1) / batch;
+
+    // ping-pong buffers for each thread
+    Mat tmp(fft_size * batch * 4, 1, opt.num_threads, 4u, opt.workspace_allocator);
+    if (tmp.empty())
+        return -100;
+
+    float norm = 1.f;
+    if (normalized == 1)
+        norm = 1.f / sqrtf(n_fft);
+    if (normalized == 2)
+        norm = window_data[n_fft];
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int bb = 0; bb < nn_batch; bb++)
+    {
+        const int j0 = bb * batch;
+        const int lanes = std::min(batch, frames - j0);
+
+        float* x = tmp.channel(get_omp_thread_num());
+        float* y = x + fft_size * lanes * 2;
+
+        // gather windowed frames
+        const float* ptr = bottom_blob_bordered;
+        for (int t = 0; t < fft_size; t++)
+        {
+            float* xptr = x + t * lanes * 2;
+
+            for (int l = 0; l < lanes; l++)
+            {
+                const float* p = ptr + (j0 + l) * hoplen;
+                if (real_fft)
+                {
+                    xptr[l] = p[t * 2] * window_data[t * 2];
+                    xptr[lanes + l] = p[t * 2 + 1] * window_data[t * 2 + 1];
+                }
+                else
+                {
+                    xptr[l] = p[t] * window_data[t];
+                    xptr[lanes + l] = 0.f;
+                }
+            }
+        }
+
+        const float* z = fft_batch(x, y, fft_size, fft_factors, fft_twiddles, lanes);
+
+        for (int k = 0; k < freqs_onesided; k++)
+        {
+            if (real_fft)
+            {
+                // X[k] = E[k] + W^k * O[k]
+                // E[k] = (Z[k] + conj(Z[N/2-k])) / 2
+                // O[k] = (Z[k] - conj(Z[N/2-k])) / 2i
+                const float* za = z + (k % fft_size) * lanes * 2;
+                const float* zb = z + ((fft_size - k) % fft_size) * lanes * 2;
+                const float wr = rfft_twiddles[k * 2];
+                const float wi = rfft_twiddles[k * 2 + 1];
+
+                for (int l = 0; l < lanes; l++)
+                {
+                    const float ar = za[l];
+                    const float ai = za[lanes + l];
+                    const float br = zb[l];
+                    const float bi = -zb[lanes + l];
+
+                    const float er = (ar + br) * 0.5f;
+                    const float ei = (ai + bi) * 0.5f;
+                    const float or_ = (ai - bi) * 0.5f;
+                    const float oi = (br - ar) * 0.5f;
+
+                    const float re = er + or_ * wr - oi * wi;
+                    const float im = ei + or_ * wi + oi * wr;
+
+                    store_spectrogram(top_blob, power, k, j0 + l, re * norm, im * norm);
+                }
+            }
+            else
+            {
+                const float* zk = z + k * lanes * 2;
+
+                for (int l = 0; l < lanes; l++)
+                {
+                    store_spectrogram(top_blob, power, k, j0 + l, zk[l] * norm, zk[lanes + l] * norm);
+                }
+            }
+        }
+    }
+
+    if (!onesided)
+    {
+        #pragma omp parallel for num_threads(opt.num_threads)
+        for (int i = freqs_onesided; i < n_fft; i++)
+        {
+            if (power == 0)
+            {
+                const float* ptr = top_blob.channel(n_fft - i);
+                float* outptr = top_blob.channel(i);
+
+                for (int j = 0; j < frames; j++)
+                {
+                    // complex as real
+                    outptr[0] = ptr[0];
+                    outptr[1] = -ptr[1];
+                    ptr += 2;
+                    outptr += 2;
+                }
+            }
+            else // if (power == 1 || power == 2)
+            {
+                const float* ptr = top_blob.row(n_fft - i);
+                float* outptr = top_blob.row(i);
+
+                memcpy(outptr, ptr, frames * sizeof(float));
+            }
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
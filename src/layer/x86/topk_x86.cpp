@@ -0,0 +1,299 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "topk_x86.h"
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+#include <algorithm>
+
+namespace ncnn {
+
+TopK_x86::TopK_x86()
+{
+}
+
+struct TopKKeyGreater
+{
+    // ties keep the lower index first
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+struct TopKKeyIndexLess
+{
+    bool operator()(const std::pair<float, int>& a, const std::pair<float, int>& b) const
+    {
+        return a.second < b.second;
+    }
+};
+
+// offer element j with key to the heap of the k best keys, the heap top is the worst kept one
+// a later element with an equal key never replaces, so ties keep the lower index
+static inline void topk_heap_offer(std::vector<std::pair<float, int> >& heap, float key, int j)
+{
+    if (key > heap.front().first)
+    {
+        std::pop_heap(heap.begin(), heap.end(), TopKKeyGreater());
+        heap.back() = std::make_pair(key, j);
+        std::push_heap(heap.begin(), heap.end(), TopKKeyGreater());
+    }
+}
+
+// select the k best keys of sign * ptr[j] into heap
+// blocks without any element above the current threshold are skipped with one compare
+static void topk_select_heap(const float* ptr, int n, int k, float sign, std::vector<std::pair<float, int> >& heap)
+{
+    heap.resize(k);
+    for (int j = 0; j < k; j++)
+    {
+        heap[j] = std::make_pair(sign * ptr[j], j);
+    }
+    std::make_heap(heap.begin(), heap.end(), TopKKeyGreater());
+
+    int j = k;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+    {
+        __m512 _sign = _mm512_set1_ps(sign);
+        for (; j + 15 < n; j += 16)
+        {
+            __m512 _p = _mm512_mul_ps(_mm512_loadu_ps(ptr + j), _sign);
+            __mmask16 _mask = _mm512_cmp_ps_mask(_p, _mm512_set1_ps(heap.front().first), _CMP_GT_OQ);
+            if (_mask == 0)
+                continue;
+
+            for (int l = 0; l < 16; l++)
+            {
+                if (_mask & (1 << l))
+                    topk_heap_offer(heap, sign * ptr[j + l], j + l);
+            }
+        }
+    }
+#endif // __AVX512F__
+    {
+        __m256 _sign = _mm256_set1_ps(sign);
+        for (; j + 7 < n; j += 8)
+        {
+            __m256 _p = _mm256_mul_ps(_mm256_loadu_ps(ptr + j), _sign);
+            int _mask = _mm256_movemask_ps(_mm256_cmp_ps(_p, _mm256_set1_ps(heap.front().first), _CMP_GT_OQ));
+            if (_mask == 0)
+                continue;
+
+            for (int l = 0; l < 8; l++)
+            {
+                if (_mask & (1 << l))
+                    topk_heap_offer(heap, sign * ptr[j + l], j + l);
+            }
+        }
+    }
+#endif // __AVX__
+    {
+        __m128 _sign = _mm_set1_ps(sign);
+        for (; j + 3 < n; j += 4)
+        {
+            __m128 _p = _mm_mul_ps(_mm_loadu_ps(ptr + j), _sign);
+            int _mask = _mm_movemask_ps(_mm_cmpgt_ps(_p, _mm_set1_ps(heap.front().first)));
+            if (_mask == 0)
+                continue;
+
+            for (int l = 0; l < 4; l++)
+            {
+                if (_mask & (1 << l))
+                    topk_heap_offer(heap, sign * ptr[j + l], j + l);
+            }
+        }
+    }
+#endif // __SSE2__
+    for (; j < n; j++)
+    {
+        topk_heap_offer(heap, sign * ptr[j], j);
+    }
+}
+
+int TopK_x86::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    const Mat& bottom_blob = bottom_blobs[0];
+    const int dims = bottom_blob.dims;
+    const int positive_axis = axis < 0 ? dims + axis : axis;
+
+    if (positive_axis < 0 || positive_axis >= dims)
+    {
+        NCNN_LOGE("TopK axis %d out of range for %d dims", axis, dims);
+        return -1;
+    }
+
+    // shape from the outermost axis
+    int shape[4] = {1, 1, 1, 1};
+    if (dims == 1)
+    {
+        shape[0] = bottom_blob.w;
+    }
+    if (dims == 2)
+    {
+        shape[0] = bottom_blob.h;
+        shape[1] = bottom_blob.w;
+    }
+    if (dims == 3)
+    {
+        shape[0] = bottom_blob.c;
+        shape[1] = bottom_blob.h;
+        shape[2] = bottom_blob.w;
+    }
+    if (dims == 4)
+    {
+        shape[0] = bottom_blob.c;
+        shape[1] = bottom_blob.d;
+        shape[2] = bottom_blob.h;
+        shape[3] = bottom_blob.w;
+    }
+
+    const int n = shape[positive_axis];
+    const int _k = std::min(k, n);
+
+    if (_k <= 0)
+    {
+        NCNN_LOGE("TopK k %d out of range for axis of %d elements", k, n);
+        return -1;
+    }
+
+    int outshape[4] = {shape[0], shape[1], shape[2], shape[3]};
+    outshape[positive_axis] = _k;
+
+    Mat& top_blob = top_blobs[0];
+    if (dims == 1)
+        top_blob.create(outshape[0], 4u, opt.blob_allocator);
+    if (dims == 2)
+        top_blob.create(outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (dims == 3)
+        top_blob.create(outshape[2], outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (dims == 4)
+        top_blob.create(outshape[3], outshape[2], outshape[1], outshape[0], 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    // int32 indices
+    Mat* indices_blob = top_blobs.size() > 1 ? &top_blobs[1] : 0;
+    if (indices_blob)
+    {
+        indices_blob->create_like(top_blob, opt.blob_allocator);
+        if (indices_blob->empty())
+            return -100;
+    }
+
+    // rows of n elements along axis, step elements apart
+    // the channel axis steps over cstep, other axes stay within one channel
+    int channels;
+    int outer;
+    int inner;
+    size_t step;
+    size_t outstep;
+    if (dims >= 3 && positive_axis == 0)
+    {
+        channels = 1;
+        outer = 1;
+        inner = (int)(bottom_blob.w * bottom_blob.h * bottom_blob.d);
+        step = bottom_blob.cstep;
+        outstep = top_blob.cstep;
+    }
+    else
+    {
+        const int plane_axis0 = dims >= 3 ? 1 : 0;
+
+        channels = dims >= 3 ? bottom_blob.c : 1;
+        outer = 1;
+        for (int i = plane_axis0; i < positive_axis; i++)
+        {
+            outer *= shape[i];
+        }
+        inner = 1;
+        for (int i = positive_axis + 1; i < dims; i++)
+        {
+            inner *= shape[i];
+        }
+        step = inner;
+        outstep = inner;
+    }
+
+    const int num_row = channels * outer * inner;
+
+    // the heap pays off when most elements fall below the threshold
+    const bool use_heap = _k * 8 <= n;
+
+    // select on sign * value so that the smallest become the largest
+    const float sign = largest ? 1.f : -1.f;
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int r = 0; r < num_row; r++)
+    {
+        const int q = r / (outer * inner);
+        const int o = r / inner % outer;
+        const int i = r % inner;
+
+        const float* ptr = (const float*)bottom_blob + q * bottom_blob.cstep + (size_t)o * n * inner + i;
+        float* outptr = (float*)top_blob + q * top_blob.cstep + (size_t)o * _k * inner + i;
+        int* indptr = indices_blob ? (int*)*indices_blob + q * indices_blob->cstep + (size_t)o * _k * inner + i : 0;
+
+        // gather strided rows for the contiguous scan
+        std::vector<float> row;
+        if (step != 1)
+        {
+            row.resize(n);
+            for (int j = 0; j < n; j++)
+            {
+                row[j] = ptr[j * step];
+            }
+            ptr = &row[0];
+        }
+
+        std::vector<std::pair<float, int> > vec;
+        if (use_heap)
+        {
+            topk_select_heap(ptr, n, _k, sign, vec);
+
+            if (sorted)
+                std::sort(vec.begin(), vec.end(), TopKKeyGreater());
+        }
+        else
+        {
+            vec.resize(n);
+            for (int j = 0; j < n; j++)
+            {
+                vec[j] = std::make_pair(sign * ptr[j], j);
+            }
+
+            if (sorted)
+            {
+                std::partial_sort(vec.begin(), vec.begin() + _k, vec.end(), TopKKeyGreater());
+            }
+            else
+            {
+                std::nth_element(vec.begin(), vec.begin() + _k - 1, vec.end(), TopKKeyGreater());
+            }
+            vec.resize(_k);
+        }
+
+        // unsorted results follow the input order
+        if (!sorted)
+            std::sort(vec.begin(), vec.end(), TopKKeyIndexLess());
+
+        for (int j = 0; j < _k; j++)
+        {
+            outptr[j * outstep] = ptr[vec[j].second];
+            if (indptr)
+                indptr[j * outstep] = vec[j].second;
+        }
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
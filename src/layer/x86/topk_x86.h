@@ -0,0 +1,21 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_TOPK_X86_H
+#define LAYER_TOPK_X86_H
+
+#include "topk.h"
+
+namespace ncnn {
+
+class TopK_x86 : public TopK
+{
+public:
+    TopK_x86();
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_TOPK_X86_H
@@ -0,0 +1,555 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef X86_FFT_H
+#define X86_FFT_H
+
+#include "mat.h"
+#include "x86_usability.h"
+
+#include <math.h>
+
+#if __SSE2__
+#include <emmintrin.h>
+#if __AVX__
+#include <immintrin.h>
+#endif // __AVX__
+#endif // __SSE2__
+
+// batched complex fft, mixed radix stockham autosort with natural order in and out
+//
+// lanes independent sequences are transformed together, sequence element e is stored
+// at ptr + e * lanes * 2 as lanes real parts followed by lanes imaginary parts,
+// so that every butterfly is a plain vector op across the lanes
+
+static void fft_factorize(int n, std::vector<int>& factors)
+{
+    factors.clear();
+
+    while (n % 4 == 0)
+    {
+        factors.push_back(4);
+        n /= 4;
+    }
+    while (n % 2 == 0)
+    {
+        factors.push_back(2);
+        n /= 2;
+    }
+    for (int p = 3; p <= n; p += 2)
+    {
+        while (n % p == 0)
+        {
+            factors.push_back(p);
+            n /= p;
+        }
+    }
+}
+
+// for each stage, p roots of unity followed by m * (p - 1) twiddles, complex interleaved
+static void fft_make_twiddles(int n, const std::vector<int>& factors, ncnn::Mat& twiddles)
+{
+    int size = 0;
+    {
+        int n_cur = n;
+        for (size_t i = 0; i < factors.size(); i++)
+        {
+            const int p = factors[i];
+            const int m = n_cur / p;
+            size += p * 2 + m * (p - 1) * 2;
+            n_cur = m;
+        }
+    }
+
+    twiddles.create(size > 0 ? size : 1);
+
+    float* ptr = twiddles;
+
+    int n_cur = n;
+    for (size_t i = 0; i < factors.size(); i++)
+    {
+        const int p = factors[i];
+        const int m = n_cur / p;
+
+        for (int t = 0; t < p; t++)
+        {
+            const double angle = 2 * 3.14159265358979323846 * t / p;
+            ptr[0] = (float)cos(angle);
+            ptr[1] = (float)-sin(angle);
+            ptr += 2;
+        }
+
+        for (int q = 0; q < m; q++)
+        {
+            for (int k = 1; k < p; k++)
+            {
+                const double angle = 2 * 3.14159265358979323846 * q * k / n_cur;
+                ptr[0] = (float)cos(angle);
+                ptr[1] = (float)-sin(angle);
+                ptr += 2;
+            }
+        }
+
+        n_cur = m;
+    }
+}
+
+#if __SSE2__
+static NCNN_FORCEINLINE void fft_cmul_sse(__m128& _re, __m128& _im, const __m128& _wr, const __m128& _wi)
+{
+    __m128 _r = _mm_comp_fnmadd_ps(_im, _wi, _mm_mul_ps(_re, _wr));
+    __m128 _i = _mm_comp_fmadd_ps(_re, _wi, _mm_mul_ps(_im, _wr));
+    _re = _r;
+    _im = _i;
+}
+#if __AVX__
+static NCNN_FORCEINLINE void fft_cmul_avx(__m256& _re, __m256& _im, const __m256& _wr, const __m256& _wi)
+{
+    __m256 _r = _mm256_comp_fnmadd_ps(_im, _wi, _mm256_mul_ps(_re, _wr));
+    __m256 _i = _mm256_comp_fmadd_ps(_re, _wi, _mm256_mul_ps(_im, _wr));
+    _re = _r;
+    _im = _i;
+}
+#if __AVX512F__
+static NCNN_FORCEINLINE void fft_cmul_avx512(__m512& _re, __m512& _im, const __m512& _wr, const __m512& _wi)
+{
+    __m512 _r = _mm512_fnmadd_ps(_im, _wi, _mm512_mul_ps(_re, _wr));
+    __m512 _i = _mm512_fmadd_ps(_re, _wi, _mm512_mul_ps(_im, _wr));
+    _re = _r;
+    _im = _i;
+}
+#endif // __AVX512F__
+#endif // __AVX__
+#endif // __SSE2__
+
+static void fft_radix2(const float* x, float* y, int m, int s, const float* tw, int lanes)
+{
+    const int estep = lanes * 2;
+
+    for (int q = 0; q < m; q++)
+    {
+        const float wr = tw[q * 2];
+        const float wi = tw[q * 2 + 1];
+
+        for (int r = 0; r < s; r++)
+        {
+            const float* a = x + (r + s * q) * estep;
+            const float* b = x + (r + s * (q + m)) * estep;
+            float* y0 = y + (r + s * (2 * q)) * estep;
+            float* y1 = y + (r + s * (2 * q + 1)) * estep;
+
+            int l = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+            {
+                __m512 _wr = _mm512_set1_ps(wr);
+                __m512 _wi = _mm512_set1_ps(wi);
+                for (; l + 15 < lanes; l += 16)
+                {
+                    __m512 _ar = _mm512_loadu_ps(a + l);
+                    __m512 _ai = _mm512_loadu_ps(a + lanes + l);
+                    __m512 _br = _mm512_loadu_ps(b + l);
+                    __m512 _bi = _mm512_loadu_ps(b + lanes + l);
+                    __m512 _dr = _mm512_sub_ps(_ar, _br);
+                    __m512 _di = _mm512_sub_ps(_ai, _bi);
+                    fft_cmul_avx512(_dr, _di, _wr, _wi);
+                    _mm512_storeu_ps(y0 + l, _mm512_add_ps(_ar, _br));
+                    _mm512_storeu_ps(y0 + lanes + l, _mm512_add_ps(_ai, _bi));
+                    _mm512_storeu_ps(y1 + l, _dr);
+                    _mm512_storeu_ps(y1 + lanes + l, _di);
+                }
+            }
+#endif // __AVX512F__
+            {
+                __m256 _wr = _mm256_set1_ps(wr);
+                __m256 _wi = _mm256_set1_ps(wi);
+                for (; l + 7 < lanes; l += 8)
+                {
+                    __m256 _ar = _mm256_loadu_ps(a + l);
+                    __m256 _ai = _mm256_loadu_ps(a + lanes + l);
+                    __m256 _br = _mm256_loadu_ps(b + l);
+                    __m256 _bi = _mm256_loadu_ps(b + lanes + l);
+                    __m256 _dr = _mm256_sub_ps(_ar, _br);
+                    __m256 _di = _mm256_sub_ps(_ai, _bi);
+                    fft_cmul_avx(_dr, _di, _wr, _wi);
+                    _mm256_storeu_ps(y0 + l, _mm256_add_ps(_ar, _br));
+                    _mm256_storeu_ps(y0 + lanes + l, _mm256_add_ps(_ai, _bi));
+                    _mm256_storeu_ps(y1 + l, _dr);
+                    _mm256_storeu_ps(y1 + lanes + l, _di);
+                }
+            }
+#endif // __AVX__
+            {
+                __m128 _wr = _mm_set1_ps(wr);
+                __m128 _wi = _mm_set1_ps(wi);
+                for (; l + 3 < lanes; l += 4)
+                {
+                    __m128 _ar = _mm_loadu_ps(a + l);
+                    __m128 _ai = _mm_loadu_ps(a + lanes + l);
+                    __m128 _br = _mm_loadu_ps(b + l);
+                    __m128 _bi = _mm_loadu_ps(b + lanes + l);
+                    __m128 _dr = _mm_sub_ps(_ar, _br);
+                    __m128 _di = _mm_sub_ps(_ai, _bi);
+                    fft_cmul_sse(_dr, _di, _wr, _wi);
+                    _mm_storeu_ps(y0 + l, _mm_add_ps(_ar, _br));
+                    _mm_storeu_ps(y0 + lanes + l, _mm_add_ps(_ai, _bi));
+                    _mm_storeu_ps(y1 + l, _dr);
+                    _mm_storeu_ps(y1 + lanes + l, _di);
+                }
+            }
+#endif // __SSE2__
+            for (; l < lanes; l++)
+            {
+                const float ar = a[l];
+                const float ai = a[lanes + l];
+                const float br = b[l];
+                const float bi = b[lanes + l];
+                const float dr = ar - br;
+                const float di = ai - bi;
+                y0[l] = ar + br;
+                y0[lanes + l] = ai + bi;
+                y1[l] = dr * wr - di * wi;
+                y1[lanes + l] = dr * wi + di * wr;
+            }
+        }
+    }
+}
+
+static void fft_radix4(const float* x, float* y, int m, int s, const float* tw, int lanes)
+{
+    const int estep = lanes * 2;
+
+    for (int q = 0; q < m; q++)
+    {
+        const float w1r = tw[q * 6];
+        const float w1i = tw[q * 6 + 1];
+        const float w2r = tw[q * 6 + 2];
+        const float w2i = tw[q * 6 + 3];
+        const float w3r = tw[q * 6 + 4];
+        const float w3i = tw[q * 6 + 5];
+
+        for (int r = 0; r < s; r++)
+        {
+            const float* a0 = x + (r + s * q) * estep;
+            const float* a1 = x + (r + s * (q + m)) * estep;
+            const float* a2 = x + (r + s * (q + m * 2)) * estep;
+            const float* a3 = x + (r + s * (q + m * 3)) * estep;
+            float* y0 = y + (r + s * (4 * q)) * estep;
+            float* y1 = y + (r + s * (4 * q + 1)) * estep;
+            float* y2 = y + (r + s * (4 * q + 2)) * estep;
+            float* y3 = y + (r + s * (4 * q + 3)) * estep;
+
+            // t0 = a0 + a2  t1 = a0 - a2  t2 = a1 + a3  t3 = a1 - a3
+            // y0 = t0 + t2  y1 = (t1 - i * t3) * w1  y2 = (t0 - t2) * w2  y3 = (t1 + i * t3) * w3
+            int l = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+            {
+                __m512 _w1r = _mm512_set1_ps(w1r);
+                __m512 _w1i = _mm512_set1_ps(w1i);
+                __m512 _w2r = _mm512_set1_ps(w2r);
+                __m512 _w2i = _mm512_set1_ps(w2i);
+                __m512 _w3r = _mm512_set1_ps(w3r);
+                __m512 _w3i = _mm512_set1_ps(w3i);
+                for (; l + 15 < lanes; l += 16)
+                {
+                    __m512 _a0r = _mm512_loadu_ps(a0 + l);
+                    __m512 _a0i = _mm512_loadu_ps(a0 + lanes + l);
+                    __m512 _a1r = _mm512_loadu_ps(a1 + l);
+                    __m512 _a1i = _mm512_loadu_ps(a1 + lanes + l);
+                    __m512 _a2r = _mm512_loadu_ps(a2 + l);
+                    __m512 _a2i = _mm512_loadu_ps(a2 + lanes + l);
+                    __m512 _a3r = _mm512_loadu_ps(a3 + l);
+                    __m512 _a3i = _mm512_loadu_ps(a3 + lanes + l);
+                    __m512 _t0r = _mm512_add_ps(_a0r, _a2r);
+                    __m512 _t0i = _mm512_add_ps(_a0i, _a2i);
+                    __m512 _t1r = _mm512_sub_ps(_a0r, _a2r);
+                    __m512 _t1i = _mm512_sub_ps(_a0i, _a2i);
+                    __m512 _t2r = _mm512_add_ps(_a1r, _a3r);
+                    __m512 _t2i = _mm512_add_ps(_a1i, _a3i);
+                    __m512 _t3r = _mm512_sub_ps(_a1r, _a3r);
+                    __m512 _t3i = _mm512_sub_ps(_a1i, _a3i);
+                    __m512 _y1r = _mm512_add_ps(_t1r, _t3i);
+                    __m512 _y1i = _mm512_sub_ps(_t1i, _t3r);
+                    __m512 _y2r = _mm512_sub_ps(_t0r, _t2r);
+                    __m512 _y2i = _mm512_sub_ps(_t0i, _t2i);
+                    __m512 _y3r = _mm512_sub_ps(_t1r, _t3i);
+                    __m512 _y3i = _mm512_add_ps(_t1i, _t3r);
+                    fft_cmul_avx512(_y1r, _y1i, _w1r, _w1i);
+                    fft_cmul_avx512(_y2r, _y2i, _w2r, _w2i);
+                    fft_cmul_avx512(_y3r, _y3i, _w3r, _w3i);
+                    _mm512_storeu_ps(y0 + l, _mm512_add_ps(_t0r, _t2r));
+                    _mm512_storeu_ps(y0 + lanes + l, _mm512_add_ps(_t0i, _t2i));
+                    _mm512_storeu_ps(y1 + l, _y1r);
+                    _mm512_storeu_ps(y1 + lanes + l, _y1i);
+                    _mm512_storeu_ps(y2 + l, _y2r);
+                    _mm512_storeu_ps(y2 + lanes + l, _y2i);
+                    _mm512_storeu_ps(y3 + l, _y3r);
+                    _mm512_storeu_ps(y3 + lanes + l, _y3i);
+                }
+            }
+#endif // __AVX512F__
+            {
+                __m256 _w1r = _mm256_set1_ps(w1r);
+                __m256 _w1i = _mm256_set1_ps(w1i);
+                __m256 _w2r = _mm256_set1_ps(w2r);
+                __m256 _w2i = _mm256_set1_ps(w2i);
+                __m256 _w3r = _mm256_set1_ps(w3r);
+                __m256 _w3i = _mm256_set1_ps(w3i);
+                for (; l + 7 < lanes; l += 8)
+                {
+                    __m256 _a0r = _mm256_loadu_ps(a0 + l);
+                    __m256 _a0i = _mm256_loadu_ps(a0 + lanes + l);
+                    __m256 _a1r = _mm256_loadu_ps(a1 + l);
+                    __m256 _a1i = _mm256_loadu_ps(a1 + lanes + l);
+                    __m256 _a2r = _mm256_loadu_ps(a2 + l);
+                    __m256 _a2i = _mm256_loadu_ps(a2 + lanes + l);
+                    __m256 _a3r = _mm256_loadu_ps(a3 + l);
+                    __m256 _a3i = _mm256_loadu_ps(a3 + lanes + l);
+                    __m256 _t0r = _mm256_add_ps(_a0r, _a2r);
+                    __m256 _t0i = _mm256_add_ps(_a0i, _a2i);
+                    __m256 _t1r = _mm256_sub_ps(_a0r, _a2r);
+                    __m256 _t1i = _mm256_sub_ps(_a0i, _a2i);
+                    __m256 _t2r = _mm256_add_ps(_a1r, _a3r);
+                    __m256 _t2i = _mm256_add_ps(_a1i, _a3i);
+                    __m256 _t3r = _mm256_sub_ps(_a1r, _a3r);
+                    __m256 _t3i = _mm256_sub_ps(_a1i, _a3i);
+                    __m256 _y1r = _mm256_add_ps(_t1r, _t3i);
+                    __m256 _y1i = _mm256_sub_ps(_t1i, _t3r);
+                    __m256 _y2r = _mm256_sub_ps(_t0r, _t2r);
+                    __m256 _y2i = _mm256_sub_ps(_t0i, _t2i);
+                    __m256 _y3r = _mm256_sub_ps(_t1r, _t3i);
+                    __m256 _y3i = _mm256_add_ps(_t1i, _t3r);
+                    fft_cmul_avx(_y1r, _y1i, _w1r, _w1i);
+                    fft_cmul_avx(_y2r, _y2i, _w2r, _w2i);
+                    fft_cmul_avx(_y3r, _y3i, _w3r, _w3i);
+                    _mm256_storeu_ps(y0 + l, _mm256_add_ps(_t0r, _t2r));
+                    _mm256_storeu_ps(y0 + lanes + l, _mm256_add_ps(_t0i, _t2i));
+                    _mm256_storeu_ps(y1 + l, _y1r);
+                    _mm256_storeu_ps(y1 + lanes + l, _y1i);
+                    _mm256_storeu_ps(y2 + l, _y2r);
+                    _mm256_storeu_ps(y2 + lanes + l, _y2i);
+                    _mm256_storeu_ps(y3 + l, _y3r);
+                    _mm256_storeu_ps(y3 + lanes + l, _y3i);
+                }
+            }
+#endif // __AVX__
+            {
+                __m128 _w1r = _mm_set1_ps(w1r);
+                __m128 _w1i = _mm_set1_ps(w1i);
+                __m128 _w2r = _mm_set1_ps(w2r);
+                __m128 _w2i = _mm_set1_ps(w2i);
+                __m128 _w3r = _mm_set1_ps(w3r);
+                __m128 _w3i = _mm_set1_ps(w3i);
+                for (; l + 3 < lanes; l += 4)
+                {
+                    __m128 _a0r = _mm_loadu_ps(a0 + l);
+                    __m128 _a0i = _mm_loadu_ps(a0 + lanes + l);
+                    __m128 _a1r = _mm_loadu_ps(a1 + l);
+                    __m128 _a1i = _mm_loadu_ps(a1 + lanes + l);
+                    __m128 _a2r = _mm_loadu_ps(a2 + l);
+                    __m128 _a2i = _mm_loadu_ps(a2 + lanes + l);
+                    __m128 _a3r = _mm_loadu_ps(a3 + l);
+                    __m128 _a3i = _mm_loadu_ps(a3 + lanes + l);
+                    __m128 _t0r = _mm_add_ps(_a0r, _a2r);
+                    __m128 _t0i = _mm_add_ps(_a0i, _a2i);
+                    __m128 _t1r = _mm_sub_ps(_a0r, _a2r);
+                    __m128 _t1i = _mm_sub_ps(_a0i, _a2i);
+                    __m128 _t2r = _mm_add_ps(_a1r, _a3r);
+                    __m128 _t2i = _mm_add_ps(_a1i, _a3i);
+                    __m128 _t3r = _mm_sub_ps(_a1r, _a3r);
+                    __m128 _t3i = _mm_sub_ps(_a1i, _a3i);
+                    __m128 _y1r = _mm_add_ps(_t1r, _t3i);
+                    __m128 _y1i = _mm_sub_ps(_t1i, _t3r);
+                    __m128 _y2r = _mm_sub_ps(_t0r, _t2r);
+                    __m128 _y2i = _mm_sub_ps(_t0i, _t2i);
+                    __m128 _y3r = _mm_sub_ps(_t1r, _t3i);
+                    __m128 _y3i = _mm_add_ps(_t1i, _t3r);
+                    fft_cmul_sse(_y1r, _y1i, _w1r, _w1i);
+                    fft_cmul_sse(_y2r, _y2i, _w2r, _w2i);
+                    fft_cmul_sse(_y3r, _y3i, _w3r, _w3i);
+                    _mm_storeu_ps(y0 + l, _mm_add_ps(_t0r, _t2r));
+                    _mm_storeu_ps(y0 + lanes + l, _mm_add_ps(_t0i, _t2i));
+                    _mm_storeu_ps(y1 + l, _y1r);
+                    _mm_storeu_ps(y1 + lanes + l, _y1i);
+                    _mm_storeu_ps(y2 + l, _y2r);
+                    _mm_storeu_ps(y2 + lanes + l, _y2i);
+                    _mm_storeu_ps(y3 + l, _y3r);
+                    _mm_storeu_ps(y3 + lanes + l, _y3i);
+                }
+            }
+#endif // __SSE2__
+            for (; l < lanes; l++)
+            {
+                const float t0r = a0[l] + a2[l];
+                const float t0i = a0[lanes + l] + a2[lanes + l];
+                const float t1r = a0[l] - a2[l];
+                const float t1i = a0[lanes + l] - a2[lanes + l];
+                const float t2r = a1[l] + a3[l];
+                const float t2i = a1[lanes + l] + a3[lanes + l];
+                const float t3r = a1[l] - a3[l];
+                const float t3i = a1[lanes + l] - a3[lanes + l];
+                const float y1r = t1r + t3i;
+                const float y1i = t1i - t3r;
+                const float y2r = t0r - t2r;
+                const float y2i = t0i - t2i;
+                const float y3r = t1r - t3i;
+                const float y3i = t1i + t3r;
+                y0[l] = t0r + t2r;
+                y0[lanes + l] = t0i + t2i;
+                y1[l] = y1r * w1r - y1i * w1i;
+                y1[lanes + l] = y1r * w1i + y1i * w1r;
+                y2[l] = y2r * w2r - y2i * w2i;
+                y2[lanes + l] = y2r * w2i + y2i * w2r;
+                y3[l] = y3r * w3r - y3i * w3i;
+                y3[lanes + l] = y3r * w3i + y3i * w3r;
+            }
+        }
+    }
+}
+
+// odd radix, direct dft of size p with the roots table
+static void fft_radixp(const float* x, float* y, int p, int m, int s, const float* roots, const float* tw, int lanes)
+{
+    const int estep = lanes * 2;
+
+    for (int q = 0; q < m; q++)
+    {
+        for (int r = 0; r < s; r++)
+        {
+            const float* a = x + (r + s * q) * estep;
+            const int astep = s * m * estep;
+
+            for (int k = 0; k < p; k++)
+            {
+                float* yk = y + (r + s * (p * q + k)) * estep;
+
+                const float wr = k == 0 ? 1.f : tw[(q * (p - 1) + k - 1) * 2];
+                const float wi = k == 0 ? 0.f : tw[(q * (p - 1) + k - 1) * 2 + 1];
+
+                int l = 0;
+#if __SSE2__
+#if __AVX__
+#if __AVX512F__
+                for (; l + 15 < lanes; l += 16)
+                {
+                    __m512 _sr = _mm512_setzero_ps();
+                    __m512 _si = _mm512_setzero_ps();
+                    for (int j = 0; j < p; j++)
+                    {
+                        const int t = j * k % p;
+                        __m512 _rr = _mm512_set1_ps(roots[t * 2]);
+                        __m512 _ri = _mm512_set1_ps(roots[t * 2 + 1]);
+                        __m512 _ar = _mm512_loadu_ps(a + j * astep + l);
+                        __m512 _ai = _mm512_loadu_ps(a + j * astep + lanes + l);
+                        _sr = _mm512_fmadd_ps(_ar, _rr, _sr);
+                        _sr = _mm512_fnmadd_ps(_ai, _ri, _sr);
+                        _si = _mm512_fmadd_ps(_ar, _ri, _si);
+                        _si = _mm512_fmadd_ps(_ai, _rr, _si);
+                    }
+                    fft_cmul_avx512(_sr, _si, _mm512_set1_ps(wr), _mm512_set1_ps(wi));
+                    _mm512_storeu_ps(yk + l, _sr);
+                    _mm512_storeu_ps(yk + lanes + l, _si);
+                }
+#endif // __AVX512F__
+                for (; l + 7 < lanes; l += 8)
+                {
+                    __m256 _sr = _mm256_setzero_ps();
+                    __m256 _si = _mm256_setzero_ps();
+                    for (int j = 0; j < p; j++)
+                    {
+                        const int t = j * k % p;
+                        __m256 _rr = _mm256_set1_ps(roots[t * 2]);
+                        __m256 _ri = _mm256_set1_ps(roots[t * 2 + 1]);
+                        __m256 _ar = _mm256_loadu_ps(a + j * astep + l);
+                        __m256 _ai = _mm256_loadu_ps(a + j * astep + lanes + l);
+                        _sr = _mm256_comp_fmadd_ps(_ar, _rr, _sr);
+                        _sr = _mm256_comp_fnmadd_ps(_ai, _ri, _sr);
+                        _si = _mm256_comp_fmadd_ps(_ar, _ri, _si);
+                        _si = _mm256_comp_fmadd_ps(_ai, _rr, _si);
+                    }
+                    fft_cmul_avx(_sr, _si, _mm256_set1_ps(wr), _mm256_set1_ps(wi));
+                    _mm256_storeu_ps(yk + l, _sr);
+                    _mm256_storeu_ps(yk + lanes + l, _si);
+                }
+#endif // __AVX__
+                for (; l + 3 < lanes; l += 4)
+                {
+                    __m128 _sr = _mm_setzero_ps();
+                    __m128 _si = _mm_setzero_ps();
+                    for (int j = 0; j < p; j++)
+                    {
+                        const int t = j * k % p;
+                        __m128 _rr = _mm_set1_ps(roots[t * 2]);
+                        __m128 _ri = _mm_set1_ps(roots[t * 2 + 1]);
+                        __m128 _ar = _mm_loadu_ps(a + j * astep + l);
+                        __m128 _ai = _mm_loadu_ps(a + j * astep + lanes + l);
+                        _sr = _mm_comp_fmadd_ps(_ar, _rr, _sr);
+                        _sr = _mm_comp_fnmadd_ps(_ai, _ri, _sr);
+                        _si = _mm_comp_fmadd_ps(_ar, _ri, _si);
+                        _si = _mm_comp_fmadd_ps(_ai, _rr, _si);
+                    }
+                    fft_cmul_sse(_sr, _si, _mm_set1_ps(wr), _mm_set1_ps(wi));
+                    _mm_storeu_ps(yk + l, _sr);
+                    _mm_storeu_ps(yk + lanes + l, _si);
+                }
+#endif // __SSE2__
+                for (; l < lanes; l++)
+                {
+                    float sr = 0.f;
+                    float si = 0.f;
+                    for (int j = 0; j < p; j++)
+                    {
+                        const int t = j * k % p;
+                        const float ar = a[j * astep + l];
+                        const float ai = a[j * astep + lanes + l];
+                        sr += ar * roots[t * 2] - ai * roots[t * 2 + 1];
+                        si += ar * roots[t * 2 + 1] + ai * roots[t * 2];
+                    }
+                    yk[l] = sr * wr - si * wi;
+                    yk[lanes + l] = sr * wi + si * wr;
+                }
+            }
+        }
+    }
+}
+
+// forward transform of lanes sequences of length n held in x, y is scratch of the same size
+// return the buffer holding the result, either x or y
+static float* fft_batch(float* x, float* y, int n, const std::vector<int>& factors, const ncnn::Mat& twiddles, int lanes)
+{
+    const float* tw = twiddles;
+
+    int n_cur = n;
+    int s = 1;
+    for (size_t i = 0; i < factors.size(); i++)
+    {
+        const int p = factors[i];
+        const int m = n_cur / p;
+
+        const float* roots = tw;
+        const float* stage_tw = tw + p * 2;
+
+        if (p == 4)
+            fft_radix4(x, y, m, s, stage_tw, lanes);
+        else if (p == 2)
+            fft_radix2(x, y, m, s, stage_tw, lanes);
+        else
+            fft_radixp(x, y, p, m, s, roots, stage_tw, lanes);
+
+        tw += p * 2 + m * (p - 1) * 2;
+
+        float* tmp = x;
+        x = y;
+        y = tmp;
+
+        n_cur = m;
+        s *= p;
+    }
+
+    return x;
+}
+
+#endif // X86_FFT_H
@@ -0,0 +1,363 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "yolopostprocess.h"
+
+#include "nms.h"
+
+#include <algorithm>
+#include <float.h>
+#include <math.h>
+
+namespace ncnn {
+
+YoloPostprocess::YoloPostprocess()
+{
+    one_blob_only = false;
+    support_inplace = false;
+}
+
+int YoloPostprocess::load_param(const ParamDict& pd)
+{
+    head_type = pd.get(0, 0);
+    num_class = pd.get(1, 0);
+    reg_max = pd.get(2, 16);
+    confidence_threshold = pd.get(3, 0.25f);
+    nms_threshold = pd.get(4, 0.45f);
+    nms_top_k = pd.get(5, 1000);
+    keep_top_k = pd.get(6, 300);
+    class_agnostic = pd.get(7, 0);
+    sigmoid = pd.get(8, 1);
+    strides = pd.get(9, Mat());
+    anchors = pd.get(10, Mat());
+
+    if (strides.empty())
+    {
+        strides.create(3);
+        int* p = strides;
+        p[0] = 8;
+        p[1] = 16;
+        p[2] = 32;
+    }
+
+    if (head_type == 2 && (anchors.empty() || anchors.w % (strides.w * 2) != 0))
+    {
+        NCNN_LOGE("YoloPostprocess anchor-based head needs %d x num_anchor x 2 anchors", strides.w);
+        return -1;
+    }
+
+    return 0;
+}
+
+struct YoloCandidate
+{
+    float score;
+    int label;
+    int index;
+};
+
+static bool yolo_candidate_greater(const YoloCandidate& a, const YoloCandidate& b)
+{
+    // ties keep the anchor order so that the result does not depend on threading
+    return a.score > b.score || (a.score == b.score && a.index < b.index);
+}
+
+static inline float yolo_sigmoid(float x)
+{
+    return 1.f / (1.f + expf(-x));
+}
+
+static inline float yolo_max(const float* ptr, int size)
+{
+    // independent lanes for vectorization
+    float max0 = -FLT_MAX;
+    float max1 = -FLT_MAX;
+    float max2 = -FLT_MAX;
+    float max3 = -FLT_MAX;
+
+    int i = 0;
+    for (; i + 3 < size; i += 4)
+    {
+        max0 = std::max(max0, ptr[i]);
+        max1 = std::max(max1, ptr[i + 1]);
+        max2 = std::max(max2, ptr[i + 2]);
+        max3 = std::max(max3, ptr[i + 3]);
+    }
+    for (; i < size; i++)
+    {
+        max0 = std::max(max0, ptr[i]);
+    }
+
+    return std::max(std::max(max0, max1), std::max(max2, max3));
+}
+
+static inline int yolo_argmax(const float* ptr, int size, float max)
+{
+    for (int i = 0; i < size; i++)
+    {
+        if (ptr[i] == max)
+            return i;
+    }
+
+    return 0;
+}
+
+// expectation of the softmax distribution over reg_max bins
+static inline float yolo_dfl(const float* ptr, int reg_max)
+{
+    const float max = yolo_max(ptr, reg_max);
+
+    float sum = 0.f;
+    float dis = 0.f;
+    for (int i = 0; i < reg_max; i++)
+    {
+        float e = expf(ptr[i] - max);
+        sum += e;
+        dis += i * e;
+    }
+
+    return dis / sum;
+}
+
+int YoloPostprocess::forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const
+{
+    // pred rows are the anchors of all levels, level after level
+    // anchor-based rows are anchor after anchor within one level, each anchor over the whole grid
+    const Mat& pred = bottom_blobs[0];
+
+    // the network input, only its size is used to derive the grids
+    const Mat& image = bottom_blobs[1];
+
+    if (pred.dims != 2 || pred.elempack != 1)
+        return -1;
+
+    const int num_level = strides.w;
+    const int num_anchor = head_type == 2 ? anchors.w / 2 / num_level : 1;
+    const int box_size = head_type == 0 ? reg_max * 4 : 5;
+    const int _num_class = num_class > 0 ? num_class : pred.w - box_size;
+
+    if (_num_class <= 0 || pred.w < box_size + _num_class)
+    {
+        NCNN_LOGE("YoloPostprocess pred width %d does not fit %d box channels and %d classes", pred.w, box_size, _num_class);
+        return -1;
+    }
+
+    const int* strides_ptr = strides;
+
+    std::vector<int> level_offsets(num_level + 1);
+    std::vector<int> grid_w(num_level);
+    level_offsets[0] = 0;
+    for (int i = 0; i < num_level; i++)
+    {
+        const int stride = strides_ptr[i];
+        grid_w[i] = image.w / stride;
+        level_offsets[i + 1] = level_offsets[i] + num_anchor * grid_w[i] * (image.h / stride);
+    }
+
+    if (level_offsets[num_level] != pred.h)
+    {
+        NCNN_LOGE("YoloPostprocess pred has %d anchors, expect %d for input %d x %d", pred.h, level_offsets[num_level], image.w, image.h);
+        return -1;
+    }
+
+    // threshold on raw scores before any activation
+    float threshold = confidence_threshold;
+    if (sigmoid)
+    {
+        if (confidence_threshold <= 0.f)
+            threshold = -FLT_MAX;
+        else if (confidence_threshold >= 1.f)
+            threshold = FLT_MAX;
+        else
+            threshold = logf(confidence_threshold / (1.f - confidence_threshold));
+    }
+
+    // gather the anchors passing the threshold, without decoding any box
+    const int num_chunk = std::max(opt.num_threads, 1);
+    std::vector<std::vector<YoloCandidate> > chunk_candidates(num_chunk);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int t = 0; t < num_chunk; t++)
+    {
+        const int start = (int)((long long)pred.h * t / num_chunk);
+        const int end = (int)((long long)pred.h * (t + 1) / num_chunk);
+
+        std::vector<YoloCandidate>& candidates = chunk_candidates[t];
+
+        for (int i = start; i < end; i++)
+        {
+            const float* ptr = pred.row(i);
+            const float* class_ptr = ptr + box_size;
+
+            float score;
+            float class_max;
+            if (head_type == 0)
+            {
+                class_max = yolo_max(class_ptr, _num_class);
+                if (class_max < threshold)
+                    continue;
+
+                score = sigmoid ? yolo_sigmoid(class_max) : class_max;
+            }
+            else
+            {
+                // class probability never exceeds 1
+                if (ptr[4] < threshold)
+                    continue;
+
+                class_max = yolo_max(class_ptr, _num_class);
+                if (sigmoid)
+                    score = yolo_sigmoid(ptr[4]) * yolo_sigmoid(class_max);
+                else
+                    score = ptr[4] * class_max;
+
+                if (score < confidence_threshold)
+                    continue;
+            }
+
+            YoloCandidate c = {score, yolo_argmax(class_ptr, _num_class, class_max), i};
+            candidates.push_back(c);
+        }
+    }
+
+    std::vector<YoloCandidate> candidates;
+    for (int t = 0; t < num_chunk; t++)
+    {
+        candidates.insert(candidates.end(), chunk_candidates[t].begin(), chunk_candidates[t].end());
+    }
+
+    // keep the nms_top_k best
+    if (nms_top_k >= 0 && (int)candidates.size() > nms_top_k)
+    {
+        std::partial_sort(candidates.begin(), candidates.begin() + nms_top_k, candidates.end(), yolo_candidate_greater);
+        candidates.resize(nms_top_k);
+    }
+    else
+    {
+        std::sort(candidates.begin(), candidates.end(), yolo_candidate_greater);
+    }
+
+    const int num_candidate = (int)candidates.size();
+
+    // decode the boxes of the candidates only
+    NmsBoxes boxes;
+    boxes.resize(num_candidate);
+
+    #pragma omp parallel for num_threads(opt.num_threads)
+    for (int i = 0; i < num_candidate; i++)
+    {
+        const int index = candidates[i].index;
+        const float* ptr = pred.row(index);
+
+        int level = 0;
+        while (index >= level_offsets[level + 1])
+            level++;
+
+        const int stride = strides_ptr[level];
+        const int gw = grid_w[level];
+        const int grid_size = gw * (image.h / stride);
+
+        const int anchor = (index - level_offsets[level]) / grid_size;
+        const int cell = (index - level_offsets[level]) % grid_size;
+        const int gx = cell % gw;
+        const int gy = cell / gw;
+
+        float x0;
+        float y0;
+        float x1;
+        float y1;
+        if (head_type == 0)
+        {
+            // yolov8 dist2bbox
+            const float cx = (gx + 0.5f) * stride;
+            const float cy = (gy + 0.5f) * stride;
+
+            x0 = cx - yolo_dfl(ptr, reg_max) * stride;
+            y0 = cy - yolo_dfl(ptr + reg_max, reg_max) * stride;
+            x1 = cx + yolo_dfl(ptr + reg_max * 2, reg_max) * stride;
+            y1 = cy + yolo_dfl(ptr + reg_max * 3, reg_max) * stride;
+        }
+        else if (head_type == 1)
+        {
+            // yolox yolo_head decode
+            const float cx = (ptr[0] + gx) * stride;
+            const float cy = (ptr[1] + gy) * stride;
+            const float w = expf(ptr[2]) * stride;
+            const float h = expf(ptr[3]) * stride;
+
+            x0 = cx - w * 0.5f;
+            y0 = cy - h * 0.5f;
+            x1 = cx + w * 0.5f;
+            y1 = cy + h * 0.5f;
+        }
+        else
+        {
+            // yolov5 Detect forward
+            const float* anchor_ptr = (const float*)anchors + (level * num_anchor + anchor) * 2;
+
+            const float dx = sigmoid ? yolo_sigmoid(ptr[0]) : ptr[0];
+            const float dy = sigmoid ? yolo_sigmoid(ptr[1]) : ptr[1];
+            const float dw = sigmoid ? yolo_sigmoid(ptr[2]) : ptr[2];
+            const float dh = sigmoid ? yolo_sigmoid(ptr[3]) : ptr[3];
+
+            const float cx = (dx * 2.f - 0.5f + gx) * stride;
+            const float cy = (dy * 2.f - 0.5f + gy) * stride;
+            const float w = (dw * 2.f) * (dw * 2.f) * anchor_ptr[0];
+            const float h = (dh * 2.f) * (dh * 2.f) * anchor_ptr[1];
+
+            x0 = cx - w * 0.5f;
+            y0 = cy - h * 0.5f;
+            x1 = cx + w * 0.5f;
+            y1 = cy + h * 0.5f;
+        }
+
+        boxes.set(i, x0, y0, x1, y1);
+    }
+
+    // greedy nms within each class, or over all classes if class_agnostic
+    const int max_picked = keep_top_k >= 0 ? std::min(keep_top_k, num_candidate) : num_candidate;
+
+    std::vector<int> order(num_candidate);
+    std::vector<int> labels(num_candidate);
+    for (int i = 0; i < num_candidate; i++)
+    {
+        order[i] = i;
+        labels[i] = candidates[i].label;
+    }
+
+    std::vector<int> picked;
+    if (num_candidate > 0)
+    {
+        if (class_agnostic)
+            nms_sorted(boxes, &order[0], num_candidate, nms_threshold, picked, max_picked);
+        else
+            nms_sorted_batched(boxes, &order[0], num_candidate, &labels[0], _num_class, nms_threshold, picked, max_picked, opt);
+    }
+
+    // fill result
+    int num_detected = (int)picked.size();
+    if (num_detected == 0)
+        return 0;
+
+    Mat& top_blob = top_blobs[0];
+    top_blob.create(6, num_detected, 4u, opt.blob_allocator);
+    if (top_blob.empty())
+        return -100;
+
+    for (int i = 0; i < num_detected; i++)
+    {
+        const int z = picked[i];
+        float* outptr = top_blob.row(i);
+
+        outptr[0] = (float)candidates[z].label;
+        outptr[1] = candidates[z].score;
+        outptr[2] = boxes.x0[z];
+        outptr[3] = boxes.y0[z];
+        outptr[4] = boxes.x1[z];
+        outptr[5] = boxes.y1[z];
+    }
+
+    return 0;
+}
+
+} // namespace ncnn
@@ -0,0 +1,39 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef LAYER_YOLOPOSTPROCESS_H
+#define LAYER_YOLOPOSTPROCESS_H
+
+#include "layer.h"
+
+namespace ncnn {
+
+class YoloPostprocess : public Layer
+{
+public:
+    YoloPostprocess();
+
+    virtual int load_param(const ParamDict& pd);
+
+    virtual int forward(const std::vector<Mat>& bottom_blobs, std::vector<Mat>& top_blobs, const Option& opt) const;
+
+public:
+    // 0 = anchor-free with distribution focal loss box, yolov8 / yolo11
+    // 1 = anchor-free with center size box, yolox
+    // 2 = anchor-based, yolov5 / yolov7
+    int head_type;
+    int num_class;
+    int reg_max;
+    float confidence_threshold;
+    float nms_threshold;
+    int nms_top_k;
+    int keep_top_k;
+    int class_agnostic;
+    int sigmoid;
+    Mat strides;
+    Mat anchors;
+};
+
+} // namespace ncnn
+
+#endif // LAYER_YOLOPOSTPROCESS_H
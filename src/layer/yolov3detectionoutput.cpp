@@ -4,6 +4,7 @@
 #include "yolov3detectionoutput.h"
 
 #include "layer_type.h"
+#include "nms.h"
 
 #include <float.h>
 
@@ -40,88 +41,55 @@ int Yolov3DetectionOutput::load_param(const ParamDict& pd)
     return 0;
 }
 
-static inline float intersection_area(const Yolov3DetectionOutput::BBoxRect& a, const Yolov3DetectionOutput::BBoxRect& b)
+void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas) const
 {
-    if (a.xmin > b.xmax || a.xmax < b.xmin || a.ymin > b.ymax || a.ymax < b.ymin)
-    {
-        // no intersection
-        return 0.f;
-    }
-
-    float inter_width = std::min(a.xmax, b.xmax) - std::max(a.xmin, b.xmin);
-    float inter_height = std::min(a.ymax, b.ymax) - std::max(a.ymin, b.ymin);
-
-    return inter_width * inter_height;
-}
+    if (datas.empty())
+        return;
 
-void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas, int left, int right) const
-{
-    int i = left;
-    int j = right;
-    float p = datas[(left + right) / 2].score;
+    const int n = static_cast<int>(datas.size());
 
-    while (i <= j)
+    std::vector<float> scores(n);
+    for (int i = 0; i < n; i++)
     {
-        while (datas[i].score > p)
-            i++;
-
-        while (datas[j].score < p)
-            j--;
-
-        if (i <= j)
-        {
-            // swap
-            std::swap(datas[i], datas[j]);
-
-            i++;
-            j--;
-        }
+        scores[i] = datas[i].score;
     }
 
-    if (left < j)
-        qsort_descent_inplace(datas, left, j);
-
-    if (i < right)
-        qsort_descent_inplace(datas, i, right);
-}
+    std::vector<int> order;
+    nms_sort_descent(&scores[0], n, order);
 
-void Yolov3DetectionOutput::qsort_descent_inplace(std::vector<BBoxRect>& datas) const
-{
-    if (datas.empty())
-        return;
+    std::vector<BBoxRect> sorted(n);
+    for (int i = 0; i < n; i++)
+    {
+        sorted[i] = datas[order[i]];
+    }
 
-    qsort_descent_inplace(datas, 0, static_cast<int>(datas.size() - 1));
+    datas.swap(sorted);
 }
 
 void Yolov3DetectionOutput::nms_sorted_bboxes(std::vector<BBoxRect>& bboxes, std::vector<size_t>& picked, float nms_threshold) const
 {
     picked.clear();
 
-    const size_t n = bboxes.size();
+    const int n = static_cast<int>(bboxes.size());
+    if (n == 0)
+        return;
 
-    for (size_t i = 0; i < n; i++)
-    {
-        const BBoxRect& a = bboxes[i];
+    NmsBoxes boxes;
+    boxes.resize(n);
 
-        int keep = 1;
-        for (int j = 0; j < (int)picked.size(); j++)
-        {
-            const BBoxRect& b = bboxes[picked[j]];
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+    {
+        const BBoxRect& r = bboxes[i];
+        boxes.set(i, r.xmin, r.ymin, r.xmax, r.ymax);
+        boxes.area[i] = r.area;
+        order[i] = i;
+    }
 
-            // intersection over union
-            float inter_area = intersection_area(a, b);
-            float union_area = a.area + b.area - inter_area;
-            // float IoU = inter_area / union_area
-            if (inter_area > nms_threshold * union_area)
-            {
-                keep = 0;
-                break;
-            }
-        }
+    std::vector<int> kept;
+    nms_sorted(boxes, &order[0], n, nms_threshold, kept);
 
-        if (keep)
-            picked.push_back(i);
-    }
+    picked.assign(kept.begin(), kept.end());
 }
 
 static inline float sigmoid(float x)
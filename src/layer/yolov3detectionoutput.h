@@ -41,7 +41,6 @@ public:
         int label;
     };
 
-    void qsort_descent_inplace(std::vector<BBoxRect>& datas, int left, int right) const;
     void qsort_descent_inplace(std::vector<BBoxRect>& datas) const;
     void nms_sorted_bboxes(std::vector<BBoxRect>& bboxes, std::vector<size_t>& picked, float nms_threshold) const;
 };
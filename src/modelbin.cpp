@@ -52,15 +52,21 @@ Mat ModelBin::load(int w, int h, int d, int c, int type) const
 class ModelBinFromDataReaderPrivate
 {
 public:
-    ModelBinFromDataReaderPrivate(const DataReader& _dr)
-        : dr(_dr)
+    ModelBinFromDataReaderPrivate(const DataReader& _dr, Allocator* _allocator)
+        : dr(_dr), allocator(_allocator)
     {
     }
     const DataReader& dr;
+    Allocator* allocator;
 };
 
 ModelBinFromDataReader::ModelBinFromDataReader(const DataReader& _dr)
-    : ModelBin(), d(new ModelBinFromDataReaderPrivate(_dr))
+    : ModelBin(), d(new ModelBinFromDataReaderPrivate(_dr, 0))
+{
+}
+
+ModelBinFromDataReader::ModelBinFromDataReader(const DataReader& _dr, Allocator* _allocator)
+    : ModelBin(), d(new ModelBinFromDataReaderPrivate(_dr, _allocator))
 {
 }
 
@@ -79,6 +85,19 @@ ModelBinFromDataReader& ModelBinFromDataReader::operator=(const ModelBinFromData
     return *this;
 }
 
+static Mat float16_to_float32(const unsigned short* data, int size, Allocator* allocator)
+{
+    Mat src(size, (void*)data, (size_t)2u);
+    Mat dst;
+
+    Option opt;
+    opt.num_threads = 1;
+    opt.blob_allocator = allocator;
+    cast_float16_to_float32(src, dst, opt);
+
+    return dst;
+}
+
 Mat ModelBinFromDataReader::load(int w, int type) const
 {
     Mat m;
@@ -123,7 +142,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
             nread = d->dr.reference(align_data_size, &refbuf);
             if (nread == align_data_size)
             {
-                m = Mat::from_float16((const unsigned short*)refbuf, w);
+                m = float16_to_float32((const unsigned short*)refbuf, w, d->allocator);
             }
             else
 #endif
@@ -144,7 +163,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
                 }
 #endif
 
-                m = Mat::from_float16(&float16_weights[0], w);
+                m = float16_to_float32(&float16_weights[0], w, d->allocator);
             }
 
             return m;
@@ -174,7 +193,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
                     return Mat();
                 }
 
-                m.create(w, (size_t)1u);
+                m.create(w, (size_t)1u, d->allocator);
                 if (m.empty())
                     return m;
 
@@ -196,7 +215,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
             else
 #endif
             {
-                m.create(w);
+                m.create(w, (size_t)4u, d->allocator);
                 if (m.empty())
                     return m;
 
@@ -221,7 +240,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
 
         if (flag != 0)
         {
-            m.create(w);
+            m.create(w, (size_t)4u, d->allocator);
             if (m.empty())
                 return m;
 
@@ -270,7 +289,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
             else
 #endif
             {
-                m.create(w);
+                m.create(w, (size_t)4u, d->allocator);
                 if (m.empty())
                     return m;
 
@@ -306,7 +325,7 @@ Mat ModelBinFromDataReader::load(int w, int type) const
         else
 #endif
         {
-            m.create(w);
+            m.create(w, (size_t)4u, d->allocator);
             if (m.empty())
                 return m;
 
@@ -34,6 +34,8 @@ class NCNN_EXPORT ModelBinFromDataReader : public ModelBin
 {
 public:
     explicit ModelBinFromDataReader(const DataReader& dr);
+    // the weights copied out of dr come from allocator, null means ncnn::fastMalloc
+    ModelBinFromDataReader(const DataReader& dr, Allocator* allocator);
     virtual ~ModelBinFromDataReader();
 
     virtual Mat load(int w, int type) const;
@@ -9,6 +9,13 @@
 #include "modelbin.h"
 #include "paramdict.h"
 
+#include "layer/convolution.h"
+#include "layer/convolutiondepthwise.h"
+#include "layer/deconvolution.h"
+#include "layer/deconvolutiondepthwise.h"
+#include "layer/innerproduct.h"
+
+#include <algorithm>
 #include <stdarg.h>
 #include <stdint.h>
 #include <string.h>
@@ -24,6 +31,44 @@
 
 namespace ncnn {
 
+// extractor owned state threaded through the cpu forward
+struct ForwardContext
+{
+    // per layer streaming state, null when not streaming
+    std::vector<Mat>* layer_states;
+
+    // bytes of the blobs produced by layout and precision conversions
+    size_t conversion_bytes;
+
+    // per blob channel range the producer may write into, empty for none
+    std::vector<Mat>* blob_presets;
+
+    // per blob the whole blob owning its channel range view, empty for none
+    std::vector<Mat>* keepalive_blobs;
+
+    // the blob and workspace allocators when they are TrackingAllocator, null otherwise
+    TrackingAllocator* tracking_allocators[2];
+};
+
+// layout seen by the last forward of a Concat or Slice along channels
+// the whole blob is split into consecutive channel ranges of the same layout
+struct ChannelAliasRecord
+{
+    // 0 = not aliasable, 1 = aliasable
+    int eligible;
+
+    // layout of the whole blob, dims == 0 if not seen yet
+    int dims;
+    int w;
+    int h;
+    int c;
+    size_t elemsize;
+    int elempack;
+
+    // channels of each part, in elempack units
+    std::vector<int> channels;
+};
+
 class NetPrivate
 {
 public:
@@ -38,7 +83,7 @@ public:
 #endif // NCNN_VULKAN
 
     friend class Extractor;
-    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const;
+    int forward_layer(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Option& opt) const;
 
 #if NCNN_VULKAN
     int forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
@@ -46,7 +91,7 @@ public:
 
     int convert_layout(Mat& bottom_blob, const Layer* layer, const Option& opt) const;
 
-    int do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, const Option& opt) const;
+    int do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, ForwardContext* ctx, Mat* layer_state, const Option& opt) const;
 #if NCNN_VULKAN
     int do_forward_layer(const Layer* layer, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const;
 #endif // NCNN_VULKAN
@@ -56,6 +101,25 @@ public:
     void update_input_output_names();
 #endif // NCNN_STRING
 
+    void plan_layout();
+
+    void create_local_pool_allocator();
+
+    int create_pipeline_parallel();
+
+    // create the pipeline of a lazy layer on its first forward
+    int create_pipeline_lazy(int layer_index, const std::vector<Mat>& blob_mats) const;
+
+    // masked by featmask and with the thread count of the cost model
+    Option get_pipeline_option(int layer_index) const;
+
+    void assign_layer_num_threads();
+
+    void prepare_concat_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, Mat& concat_top, const Option& opt) const;
+    int finish_concat_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Mat& concat_top, const Option& opt) const;
+    int forward_slice_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Option& opt) const;
+    void record_channel_alias(int layer_index, const Mat& whole, const std::vector<Mat>& parts) const;
+
     std::vector<Blob> blobs;
     std::vector<Layer*> layers;
 
@@ -72,6 +136,26 @@ public:
     PoolAllocator* local_blob_allocator;
     PoolAllocator* local_workspace_allocator;
 
+    Allocator* weight_allocator;
+
+    // number of nets holding the layers, null unless shared with Net::share_model()
+    int* layers_refcount;
+
+    // opt.num_threads the layer pipelines were created with, the tiling of some layers depends on it
+    int pipeline_num_threads;
+
+    // per layer channel alias of Concat and Slice, learned from the previous forward
+    mutable std::vector<ChannelAliasRecord> channel_alias_records;
+    mutable Mutex channel_alias_lock;
+
+    // per layer thread count from the cost model, 0 = opt.num_threads, empty unless use_adaptive_num_threads
+    mutable std::vector<int> layer_num_threads;
+
+    // per layer 1 if create_pipeline has run, empty unless use_lazy_create_pipeline
+    // set with release order after the pipeline and layer_num_threads, the lock is only taken to create
+    mutable std::vector<int> layer_pipeline_created;
+    mutable Mutex layer_pipeline_lock;
+
 #if NCNN_VULKAN
     const VulkanDevice* vkdev;
 
@@ -88,6 +172,11 @@ NetPrivate::NetPrivate(Option& _opt)
     local_blob_allocator = 0;
     local_workspace_allocator = 0;
 
+    weight_allocator = 0;
+
+    layers_refcount = 0;
+    pipeline_num_threads = 0;
+
 #if NCNN_VULKAN
     vkdev = 0;
     weight_vkallocator = 0;
@@ -157,12 +246,108 @@ int NetPrivate::upload_model()
 }
 #endif // NCNN_VULKAN
 
-int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, const Option& opt) const
+// the layout of a blob without referencing its data
+static Mat channel_alias_layout(const Mat& m)
+{
+    Mat layout;
+    layout.elemsize = m.elemsize;
+    layout.elempack = m.elempack;
+    layout.dims = m.dims;
+    layout.w = m.w;
+    layout.h = m.h;
+    layout.d = m.d;
+    layout.c = m.c;
+    return layout;
+}
+
+// hand the blob owning a channel range view over to the views derived from it
+// in light mode the consumed views are released, so are the blobs owning them
+static void forward_keepalive(const Layer* layer, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Option& opt)
+{
+    if (!ctx || !ctx->keepalive_blobs)
+        return;
+
+    std::vector<Mat>& keepalive_blobs = *ctx->keepalive_blobs;
+
+    Mat owner;
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        if (!keepalive_blobs[layer->bottoms[i]].empty())
+        {
+            owner = keepalive_blobs[layer->bottoms[i]];
+            break;
+        }
+    }
+
+    if (!owner.empty())
+    {
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            int top_blob_index = layer->tops[i];
+            if (blob_mats[top_blob_index].data && !blob_mats[top_blob_index].refcount && keepalive_blobs[top_blob_index].empty())
+                keepalive_blobs[top_blob_index] = owner;
+        }
+    }
+
+    if (opt.lightmode)
+    {
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            int bottom_blob_index = layer->bottoms[i];
+            if (blob_mats[bottom_blob_index].dims == 0)
+                keepalive_blobs[bottom_blob_index].release();
+        }
+    }
+}
+
+// charge the allocations to the running layer on the tracking allocators of the extractor
+class LayerIndexGuard
+{
+public:
+    LayerIndexGuard(int layer_index, const ForwardContext* ctx)
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            tracking_allocators[i] = ctx ? ctx->tracking_allocators[i] : 0;
+            saved_layer_indexes[i] = -1;
+            if (tracking_allocators[i])
+            {
+                saved_layer_indexes[i] = tracking_allocators[i]->layer_index();
+                tracking_allocators[i]->set_layer_index(layer_index);
+            }
+        }
+    }
+
+    ~LayerIndexGuard()
+    {
+        for (int i = 0; i < 2; i++)
+        {
+            if (tracking_allocators[i])
+                tracking_allocators[i]->set_layer_index(saved_layer_indexes[i]);
+        }
+    }
+
+private:
+    TrackingAllocator* tracking_allocators[2];
+    int saved_layer_indexes[2];
+};
+
+int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Option& opt) const
 {
     const Layer* layer = layers[layer_index];
 
     //     NCNN_LOGE("forward_layer %d %s", layer_index, layer->name.c_str());
 
+    const bool channel_alias = ctx && ctx->blob_presets && layer_index < (int)channel_alias_records.size() && channel_alias_records[layer_index].eligible;
+
+    // let the producers write into the channel ranges of the concat output
+    Mat concat_top;
+    if (channel_alias && layer->typeindex == LayerType::Concat)
+    {
+        LayerIndexGuard layer_index_guard(layer_index, ctx);
+        prepare_concat_alias(layer_index, blob_mats, ctx, concat_top, opt);
+    }
+
     // load bottom blobs
     for (size_t i = 0; i < layer->bottoms.size(); i++)
     {
@@ -170,12 +355,52 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
 
         if (blob_mats[bottom_blob_index].dims == 0)
         {
-            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, opt);
+            int ret = forward_layer(blobs[bottom_blob_index].producer, blob_mats, ctx, opt);
             if (ret != 0)
                 return ret;
         }
     }
 
+    if (!layer_pipeline_created.empty())
+    {
+        int ret = create_pipeline_lazy(layer_index, blob_mats);
+        if (ret != 0)
+            return ret;
+    }
+
+    LayerIndexGuard layer_index_guard(layer_index, ctx);
+
+    if (channel_alias)
+    {
+        int aliased = 0;
+        if (layer->typeindex == LayerType::Concat && !concat_top.empty())
+            aliased = finish_concat_alias(layer_index, blob_mats, ctx, concat_top, opt);
+        if (layer->typeindex == LayerType::Slice)
+            aliased = forward_slice_alias(layer_index, blob_mats, ctx, opt);
+
+        if (aliased)
+        {
+            forward_keepalive(layer, blob_mats, ctx, opt);
+            return 0;
+        }
+    }
+
+    // keep the layout for aliasing the next forward
+    Mat channel_alias_whole;
+    std::vector<Mat> channel_alias_parts;
+    if (channel_alias && layer->typeindex == LayerType::Concat)
+    {
+        channel_alias_parts.resize(layer->bottoms.size());
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            channel_alias_parts[i] = channel_alias_layout(blob_mats[layer->bottoms[i]]);
+        }
+    }
+    if (channel_alias && layer->typeindex == LayerType::Slice)
+    {
+        channel_alias_whole = channel_alias_layout(blob_mats[layer->bottoms[0]]);
+    }
+
 #if NCNN_BENCHMARK
     double start = get_current_time();
     Mat bottom_blob;
@@ -191,14 +416,24 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
         bottom_blob.elemsize = blob_mats[bottom_blob_index].elemsize;
     }
 #endif
+    Mat* layer_state = ctx && ctx->layer_states ? &(*ctx->layer_states)[layer_index] : 0;
+
+    // layers too small to pay the omp fork and join run on fewer threads
+    // in lazy mode this is read after create_pipeline_lazy() acquired the pipeline flag
+    const int layer_threads = layer_num_threads.empty() ? 0 : layer_num_threads[layer_index];
+
     int ret = 0;
-    if (layer->featmask)
+    if (layer->featmask || (layer_threads && layer_threads < opt.num_threads))
     {
-        ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
+        Option opt1 = get_masked_option(opt, layer->featmask);
+        if (layer_threads && layer_threads < opt.num_threads)
+            opt1.num_threads = layer_threads;
+
+        ret = do_forward_layer(layer, blob_mats, ctx, layer_state, opt1);
     }
     else
     {
-        ret = do_forward_layer(layer, blob_mats, opt);
+        ret = do_forward_layer(layer, blob_mats, ctx, layer_state, opt);
     }
 #if NCNN_BENCHMARK
     double end = get_current_time();
@@ -215,6 +450,23 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
     if (ret != 0)
         return ret;
 
+    forward_keepalive(layer, blob_mats, ctx, opt);
+
+    if (channel_alias && layer->typeindex == LayerType::Concat)
+    {
+        channel_alias_whole = channel_alias_layout(blob_mats[layer->tops[0]]);
+        record_channel_alias(layer_index, channel_alias_whole, channel_alias_parts);
+    }
+    if (channel_alias && layer->typeindex == LayerType::Slice)
+    {
+        channel_alias_parts.resize(layer->tops.size());
+        for (size_t i = 0; i < layer->tops.size(); i++)
+        {
+            channel_alias_parts[i] = channel_alias_layout(blob_mats[layer->tops[i]]);
+        }
+        record_channel_alias(layer_index, channel_alias_whole, channel_alias_parts);
+    }
+
     //     NCNN_LOGE("forward_layer %d %s done", layer_index, layer->name.c_str());
     //     const Mat& blob = blob_mats[layer->tops[0]];
     //     NCNN_LOGE("[%-2d %-16s %-16s]  %d    blobs count = %-3d   size = %-3d x %-3d", layer_index, layer->type.c_str(), layer->name.c_str(), layer->tops[0], blob.c, blob.h, blob.w);
@@ -222,6 +474,149 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, cons
     return 0;
 }
 
+void NetPrivate::prepare_concat_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, Mat& concat_top, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    // every part must be produced in this forward
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        if (blob_mats[layer->bottoms[i]].dims != 0)
+            return;
+    }
+
+    ChannelAliasRecord record;
+    {
+        MutexLockGuard lock(channel_alias_lock);
+        record = channel_alias_records[layer_index];
+    }
+
+    if (record.dims != 3)
+        return;
+
+    concat_top.create(record.w, record.h, record.c, record.elemsize, record.elempack, opt.blob_allocator);
+    if (concat_top.empty())
+        return;
+
+    // Mat::create() keeps a matching preset, so the producer writes in place
+    int q = 0;
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        (*ctx->blob_presets)[layer->bottoms[i]] = concat_top.channel_range(q, record.channels[i]);
+        q += record.channels[i];
+    }
+}
+
+int NetPrivate::finish_concat_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Mat& concat_top, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    int aliased = 1;
+    for (size_t i = 0; i < layer->bottoms.size(); i++)
+    {
+        int bottom_blob_index = layer->bottoms[i];
+
+        Mat& preset = (*ctx->blob_presets)[bottom_blob_index];
+        const Mat& m = blob_mats[bottom_blob_index];
+
+        // the producer may have allocated its own output for another layout
+        if (m.data != preset.data || m.dims != preset.dims || m.w != preset.w || m.h != preset.h || m.c != preset.c || m.elemsize != preset.elemsize || m.elempack != preset.elempack || m.cstep != preset.cstep)
+            aliased = 0;
+
+        preset.release();
+    }
+
+    if (!aliased)
+    {
+        // some parts may still be views of the unused concat output
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            (*ctx->keepalive_blobs)[layer->bottoms[i]] = concat_top;
+        }
+
+        return 0;
+    }
+
+    blob_mats[layer->tops[0]] = concat_top;
+
+    if (opt.lightmode)
+    {
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            blob_mats[layer->bottoms[i]].release();
+        }
+    }
+
+    return 1;
+}
+
+int NetPrivate::forward_slice_alias(int layer_index, std::vector<Mat>& blob_mats, ForwardContext* ctx, const Option& opt) const
+{
+    const Layer* layer = layers[layer_index];
+
+    int bottom_blob_index = layer->bottoms[0];
+    const Mat& bottom_blob = blob_mats[bottom_blob_index];
+
+    ChannelAliasRecord record;
+    {
+        MutexLockGuard lock(channel_alias_lock);
+        record = channel_alias_records[layer_index];
+    }
+
+    if (record.dims != 3 || bottom_blob.dims != 3 || bottom_blob.w != record.w || bottom_blob.h != record.h || bottom_blob.c != record.c || bottom_blob.elemsize != record.elemsize || bottom_blob.elempack != record.elempack)
+        return 0;
+
+    // the parts are views without reference counting, keep the whole blob alive until they are consumed
+    const Mat owner = bottom_blob.refcount ? bottom_blob : (*ctx->keepalive_blobs)[bottom_blob_index];
+
+    int q = 0;
+    for (size_t i = 0; i < layer->tops.size(); i++)
+    {
+        (*ctx->keepalive_blobs)[layer->tops[i]] = owner;
+        blob_mats[layer->tops[i]] = bottom_blob.channel_range(q, record.channels[i]);
+        q += record.channels[i];
+    }
+
+    if (opt.lightmode)
+    {
+        blob_mats[bottom_blob_index].release();
+    }
+
+    return 1;
+}
+
+void NetPrivate::record_channel_alias(int layer_index, const Mat& whole, const std::vector<Mat>& parts) const
+{
+    ChannelAliasRecord record;
+    record.eligible = 1;
+    record.dims = 0;
+    record.w = whole.w;
+    record.h = whole.h;
+    record.c = whole.c;
+    record.elemsize = whole.elemsize;
+    record.elempack = whole.elempack;
+    record.channels.resize(parts.size());
+
+    // all parts share the layout of the whole blob and stack along channels
+    int channels = 0;
+    bool aliasable = whole.dims == 3;
+    for (size_t i = 0; i < parts.size(); i++)
+    {
+        const Mat& m = parts[i];
+        if (m.dims != 3 || m.w != whole.w || m.h != whole.h || m.elemsize != whole.elemsize || m.elempack != whole.elempack)
+            aliasable = false;
+
+        record.channels[i] = m.c;
+        channels += m.c;
+    }
+
+    if (aliasable && channels == whole.c)
+        record.dims = 3;
+
+    MutexLockGuard lock(channel_alias_lock);
+    channel_alias_records[layer_index] = record;
+}
+
 #if NCNN_VULKAN
 int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std::vector<VkMat>& blob_mats_gpu, VkCompute& cmd, const Option& opt) const
 {
@@ -333,11 +728,11 @@ int NetPrivate::forward_layer(int layer_index, std::vector<Mat>& blob_mats, std:
 #endif
         if (layer->featmask)
         {
-            ret = do_forward_layer(layer, blob_mats, get_masked_option(opt, layer->featmask));
+            ret = do_forward_layer(layer, blob_mats, 0, 0, get_masked_option(opt, layer->featmask));
         }
         else
         {
-            ret = do_forward_layer(layer, blob_mats, opt);
+            ret = do_forward_layer(layer, blob_mats, 0, 0, opt);
         }
 #if NCNN_BENCHMARK
         double end = get_current_time();
@@ -545,7 +940,7 @@ int NetPrivate::convert_layout(Mat& bottom_blob, const Layer* layer, const Optio
     return 0;
 }
 
-int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, const Option& opt) const
+int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats, ForwardContext* ctx, Mat* layer_state, const Option& opt) const
 {
     if (layer->one_blob_only)
     {
@@ -558,7 +953,7 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
         if (opt.lightmode)
         {
             // deep copy for inplace forward if data is shared
-            if (layer->support_inplace && *bottom_blob_ref.refcount != 1)
+            if (layer->support_inplace && (!bottom_blob_ref.refcount || *bottom_blob_ref.refcount != 1))
             {
                 bottom_blob = bottom_blob_ref.clone(opt.blob_allocator);
                 if (bottom_blob.empty())
@@ -570,12 +965,38 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
             bottom_blob = bottom_blob_ref;
         }
 
-        int ret = convert_layout(bottom_blob, layer, opt);
-        if (ret != 0)
-            return ret;
+        // streaming chunk may produce no new samples for the following layers
+        const bool stream_empty = layer_state && bottom_blob.empty();
+
+        if (!stream_empty)
+        {
+            const void* bottom_data = bottom_blob.data;
+
+            int ret = convert_layout(bottom_blob, layer, opt);
+            if (ret != 0)
+                return ret;
+
+            if (ctx && bottom_blob.data != bottom_data)
+                ctx->conversion_bytes += bottom_blob.total() * bottom_blob.elemsize;
+        }
 
         // forward
-        if (opt.lightmode && layer->support_inplace)
+        if (layer_state && layer->support_streaming)
+        {
+            Mat top_blob;
+            int ret = layer->forward_streaming(bottom_blob, top_blob, *layer_state, opt);
+            if (ret != 0)
+                return ret;
+
+            // store top blob
+            blob_mats[top_blob_index] = top_blob;
+        }
+        else if (stream_empty)
+        {
+            // pass through the empty blob
+            blob_mats[top_blob_index] = bottom_blob;
+        }
+        else if (opt.lightmode && layer->support_inplace)
         {
             Mat& bottom_top_blob = bottom_blob;
             int ret = layer->forward_inplace(bottom_top_blob, opt);
@@ -588,6 +1009,9 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
         else
         {
             Mat top_blob;
+            if (ctx && ctx->blob_presets)
+                top_blob = (*ctx->blob_presets)[top_blob_index];
+
             int ret = layer->forward(bottom_blob, top_blob, opt);
             if (ret != 0)
                 return ret;
@@ -615,7 +1039,7 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
             if (opt.lightmode)
             {
                 // deep copy for inplace forward if data is shared
-                if (layer->support_inplace && *bottom_blob_ref.refcount != 1)
+                if (layer->support_inplace && (!bottom_blob_ref.refcount || *bottom_blob_ref.refcount != 1))
                 {
                     bottom_blobs[i] = bottom_blob_ref.clone(opt.blob_allocator);
                     if (bottom_blobs[i].empty())
@@ -627,9 +1051,14 @@ int NetPrivate::do_forward_layer(const Layer* layer, std::vector<Mat>& blob_mats
                 bottom_blobs[i] = bottom_blob_ref;
             }
 
+            const void* bottom_data = bottom_blobs[i].data;
+
             int ret = convert_layout(bottom_blobs[i], layer, opt);
             if (ret != 0)
                 return ret;
+
+            if (ctx && bottom_blobs[i].data != bottom_data)
+                ctx->conversion_bytes += bottom_blobs[i].total() * bottom_blobs[i].elemsize;
         }
 
         // forward
@@ -830,6 +1259,372 @@ void NetPrivate::update_input_output_indexes()
     }
 }
 
+static size_t shape_size(const Mat& m)
+{
+    return (size_t)m.w * m.h * m.d * m.c * m.elempack;
+}
+
+// multiply-accumulates per output element of the layers with weights, 0 for the others
+static int layer_macs_per_output(const Layer* layer)
+{
+    int num_output = 0;
+    int weight_data_size = 0;
+    if (layer->typeindex == LayerType::Convolution)
+    {
+        num_output = ((const Convolution*)layer)->num_output;
+        weight_data_size = ((const Convolution*)layer)->weight_data_size;
+    }
+    if (layer->typeindex == LayerType::ConvolutionDepthWise)
+    {
+        num_output = ((const ConvolutionDepthWise*)layer)->num_output;
+        weight_data_size = ((const ConvolutionDepthWise*)layer)->weight_data_size;
+    }
+    if (layer->typeindex == LayerType::Deconvolution)
+    {
+        num_output = ((const Deconvolution*)layer)->num_output;
+        weight_data_size = ((const Deconvolution*)layer)->weight_data_size;
+    }
+    if (layer->typeindex == LayerType::DeconvolutionDepthWise)
+    {
+        num_output = ((const DeconvolutionDepthWise*)layer)->num_output;
+        weight_data_size = ((const DeconvolutionDepthWise*)layer)->weight_data_size;
+    }
+    if (layer->typeindex == LayerType::InnerProduct)
+    {
+        num_output = ((const InnerProduct*)layer)->num_output;
+        weight_data_size = ((const InnerProduct*)layer)->weight_data_size;
+    }
+
+    return num_output > 0 ? weight_data_size / num_output : 0;
+}
+
+// output elements of the layers with weights when only the input is known, 0 for the others
+static size_t estimate_layer_top_size(const Layer* layer, const Mat& bottom_shape)
+{
+    const size_t spatial = (size_t)bottom_shape.w * bottom_shape.h * bottom_shape.d;
+
+    if (layer->typeindex == LayerType::Convolution)
+    {
+        const Convolution* op = (const Convolution*)layer;
+        return spatial / (op->stride_w * op->stride_h) * op->num_output;
+    }
+    if (layer->typeindex == LayerType::ConvolutionDepthWise)
+    {
+        const ConvolutionDepthWise* op = (const ConvolutionDepthWise*)layer;
+        return spatial / (op->stride_w * op->stride_h) * op->num_output;
+    }
+    if (layer->typeindex == LayerType::Deconvolution)
+    {
+        const Deconvolution* op = (const Deconvolution*)layer;
+        return spatial * op->stride_w * op->stride_h * op->num_output;
+    }
+    if (layer->typeindex == LayerType::DeconvolutionDepthWise)
+    {
+        const DeconvolutionDepthWise* op = (const DeconvolutionDepthWise*)layer;
+        return spatial * op->stride_w * op->stride_h * op->num_output;
+    }
+    if (layer->typeindex == LayerType::InnerProduct)
+    {
+        const InnerProduct* op = (const InnerProduct*)layer;
+        return (size_t)(bottom_shape.dims == 2 ? bottom_shape.h : 1) * op->num_output;
+    }
+
+    return 0;
+}
+
+// one thread per this many elements touched, below it the omp fork and join outweighs the work
+static const size_t layer_work_per_thread = 32768;
+
+// threads worth using for a layer from the elements it reads and writes and its multiply-accumulates
+// the tops are estimated from the bottoms if unknown, 0 if the cost can not be estimated
+static int estimate_layer_num_threads(const Layer* layer, const std::vector<Mat>& bottom_shapes, const std::vector<Mat>& top_shapes, int num_threads)
+{
+    size_t bottom_size = 0;
+    for (size_t i = 0; i < bottom_shapes.size(); i++)
+    {
+        if (bottom_shapes[i].dims == 0)
+            return 0;
+
+        bottom_size += shape_size(bottom_shapes[i]);
+    }
+
+    size_t top_size = 0;
+    for (size_t i = 0; i < top_shapes.size(); i++)
+    {
+        if (top_shapes[i].dims == 0)
+        {
+            top_size = 0;
+            break;
+        }
+
+        top_size += shape_size(top_shapes[i]);
+    }
+
+    if (top_size == 0 && !bottom_shapes.empty())
+    {
+        const int macs_per_output = layer_macs_per_output(layer);
+        top_size = macs_per_output ? estimate_layer_top_size(layer, bottom_shapes[0]) : bottom_size;
+    }
+
+    if (bottom_size == 0 && top_size == 0)
+        return 0;
+
+    // fma over simd lanes, roughly 8 macs for one element of memory traffic
+    const size_t work = bottom_size + top_size + top_size * layer_macs_per_output(layer) / 8;
+
+    const size_t threads = work / layer_work_per_thread + 1;
+    return (int)std::min(threads, (size_t)num_threads);
+}
+
+void NetPrivate::assign_layer_num_threads()
+{
+    layer_num_threads.clear();
+    if (!opt.use_adaptive_num_threads || opt.num_threads <= 1)
+        return;
+
+    layer_num_threads.resize(layers.size(), 0);
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const Layer* layer = layers[i];
+        if (!layer)
+            continue;
+
+        // custom layers and overwritten builtin layers have an unknown cost
+        bool overwritten = (layer->typeindex & LayerType::CustomBit) != 0;
+        for (size_t j = 0; j < overwrite_builtin_layer_registry.size(); j++)
+        {
+            if (overwrite_builtin_layer_registry[j].typeindex == layer->typeindex)
+                overwritten = true;
+        }
+
+        if (overwritten)
+        {
+            layer_num_threads[i] = opt.num_threads;
+            continue;
+        }
+
+        layer_num_threads[i] = estimate_layer_num_threads(layer, layer->bottom_shapes, layer->top_shapes, opt.num_threads);
+    }
+}
+
+Option NetPrivate::get_pipeline_option(int layer_index) const
+{
+    const Layer* layer = layers[layer_index];
+
+    Option opt1 = get_masked_option(opt, layer->featmask);
+
+    if (!layer_num_threads.empty() && layer_num_threads[layer_index])
+        opt1.num_threads = layer_num_threads[layer_index];
+
+    return opt1;
+}
+
+// all weights are loaded, prepare the layer pipelines on opt.num_threads threads
+// layers are handed out one at a time so that a few heavy winograd transforms do not serialize the rest
+int NetPrivate::create_pipeline_parallel()
+{
+    const int layer_count = (int)layers.size();
+
+    Mutex lock;
+    int next_layer_index = 0;
+    int ret = 0;
+
+    #pragma omp parallel num_threads(opt.num_threads)
+    {
+        for (;;)
+        {
+            lock.lock();
+            const int i = ret == 0 ? next_layer_index++ : layer_count;
+            lock.unlock();
+
+            if (i >= layer_count)
+                break;
+
+            Layer* layer = layers[i];
+
+            Option opt1 = get_pipeline_option(i);
+
+            // user allocators are not required to be thread-safe
+            opt1.blob_allocator = 0;
+            opt1.workspace_allocator = 0;
+
+            int cret = layer->create_pipeline(opt1);
+            if (cret != 0)
+            {
+#if NCNN_STRING
+                NCNN_LOGE("layer create_pipeline %d %s failed", i, layer->name.c_str());
+#else
+                NCNN_LOGE("layer create_pipeline %d failed", i);
+#endif
+                lock.lock();
+                ret = -1;
+                lock.unlock();
+            }
+        }
+    }
+
+    return ret;
+}
+
+int NetPrivate::create_pipeline_lazy(int layer_index, const std::vector<Mat>& blob_mats) const
+{
+    if (load_acquire(&layer_pipeline_created[layer_index]))
+        return 0;
+
+    // extractors on other threads may reach the same layer at once
+    MutexLockGuard lock(layer_pipeline_lock);
+
+    if (layer_pipeline_created[layer_index])
+        return 0;
+
+    Layer* layer = layers[layer_index];
+
+    // the bottom blobs of the first forward calibrate the layers without shape hints
+    if (!layer_num_threads.empty() && layer_num_threads[layer_index] == 0 && !blob_mats.empty())
+    {
+        std::vector<Mat> bottom_shapes(layer->bottoms.size());
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            bottom_shapes[i] = blob_mats[layer->bottoms[i]];
+        }
+
+        layer_num_threads[layer_index] = estimate_layer_num_threads(layer, bottom_shapes, std::vector<Mat>(), opt.num_threads);
+    }
+
+    Option opt1 = get_pipeline_option(layer_index);
+
+    // user allocators may be in use by the inference of another thread
+    opt1.blob_allocator = 0;
+    opt1.workspace_allocator = 0;
+
+    int cret = layer->create_pipeline(opt1);
+    if (cret != 0)
+    {
+#if NCNN_STRING
+        NCNN_LOGE("layer create_pipeline %d %s failed", layer_index, layer->name.c_str());
+#else
+        NCNN_LOGE("layer create_pipeline %d failed", layer_index);
+#endif
+        return -1;
+    }
+
+    // publish the pipeline and layer_num_threads to the lock free check
+    store_release(&layer_pipeline_created[layer_index], 1);
+
+    return 0;
+}
+
+void NetPrivate::create_local_pool_allocator()
+{
+    if (!opt.use_local_pool_allocator)
+        return;
+
+    if (opt.blob_allocator == 0)
+    {
+        if (!local_blob_allocator)
+        {
+            local_blob_allocator = new PoolAllocator;
+            local_blob_allocator->set_size_compare_ratio(0.f);
+        }
+    }
+    if (opt.workspace_allocator == 0)
+    {
+        if (!local_workspace_allocator)
+        {
+            local_workspace_allocator = new PoolAllocator;
+            local_workspace_allocator->set_size_compare_ratio(0.f);
+        }
+    }
+}
+
+void NetPrivate::plan_layout()
+{
+    if (opt.use_vulkan_compute)
+        return;
+
+    // convert_layout() adapts a blob to each consumer on every inference
+    // a Split passes its input to all branches, so a conversion wanted by every branch
+    // is hoisted in front of the Split and runs once instead of once per branch
+    // visit in reverse order so that nested Splits are planned before their producer
+    for (int i = (int)layers.size() - 1; i >= 0; i--)
+    {
+        Layer* layer = layers[i];
+        if (layer->typeindex != LayerType::Split)
+            continue;
+
+        bool packing = false;
+        bool fp16_storage = false;
+        bool bf16_storage = false;
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            int consumer = blobs[layer->tops[j]].consumer;
+            if (consumer == -1)
+            {
+                // extracted as fp32 without packing
+                continue;
+            }
+
+            const Layer* consumer_layer = layers[consumer];
+            packing = packing || consumer_layer->support_packing;
+            fp16_storage = fp16_storage || (consumer_layer->support_fp16_storage && !(consumer_layer->featmask & (1 << 1)));
+            bf16_storage = bf16_storage || (consumer_layer->support_bf16_storage && !(consumer_layer->featmask & (1 << 2)));
+        }
+
+        layer->support_packing = layer->support_packing && packing;
+        layer->support_fp16_storage = layer->support_fp16_storage && fp16_storage;
+        layer->support_bf16_storage = layer->support_bf16_storage && bf16_storage;
+    }
+
+    // a Concat along channels may let its producers write into the output directly
+    // and a Slice along channels may hand out views of its input
+    // the layout is only known after the first forward, see record_channel_alias()
+    channel_alias_records.resize(layers.size());
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        const Layer* layer = layers[i];
+
+        ChannelAliasRecord& record = channel_alias_records[i];
+        record.eligible = 0;
+        record.dims = 0;
+
+        if (layer->typeindex == LayerType::Slice)
+        {
+            record.eligible = layer->tops.size() > 0;
+        }
+
+        if (layer->typeindex == LayerType::Concat && layer->bottoms.size() >= 2)
+        {
+            bool eligible = true;
+            for (size_t j = 0; j < layer->bottoms.size(); j++)
+            {
+                int bottom_blob_index = layer->bottoms[j];
+
+                // the same blob twice can not live in two channel ranges
+                for (size_t k = 0; k < j; k++)
+                {
+                    if (layer->bottoms[k] == bottom_blob_index)
+                        eligible = false;
+                }
+
+                // only a plain single output producer writes into a preset top blob
+                // and no other layer may read the part after the Concat
+                const Blob& blob = blobs[bottom_blob_index];
+                if (blob.producer == -1 || blob.consumer != (int)i)
+                {
+                    eligible = false;
+                    continue;
+                }
+
+                const Layer* producer = layers[blob.producer];
+                if (!producer->one_blob_only || producer->typeindex == LayerType::Input || producer->support_inplace)
+                    eligible = false;
+            }
+
+            record.eligible = eligible;
+        }
+    }
+}
+
 #if NCNN_STRING
 void NetPrivate::update_input_output_names()
 {
@@ -1555,7 +2350,25 @@ int Net::load_model(const DataReader& dr)
     }
 #endif // NCNN_VULKAN
 
-    ModelBinFromDataReader mb(dr);
+    // the nested omp regions inside create_pipeline would wait forever on the busy simpleomp workers
+#if NCNN_SIMPLEOMP
+    const bool parallel_create_pipeline = false;
+#else
+    const bool parallel_create_pipeline = opt.use_parallel_create_pipeline && !opt.use_lazy_create_pipeline && !opt.use_vulkan_compute && opt.num_threads > 1;
+#endif
+
+    // the pipelines are created by forward_layer on first use
+    const bool lazy_create_pipeline = opt.use_lazy_create_pipeline && !opt.use_vulkan_compute;
+
+    d->layer_pipeline_created.clear();
+    if (lazy_create_pipeline)
+        d->layer_pipeline_created.resize(layer_count, 0);
+
+    d->assign_layer_num_threads();
+
+    d->pipeline_num_threads = opt.num_threads;
+
+    ModelBinFromDataReader mb(dr, d->weight_allocator);
     for (int i = 0; i < layer_count; i++)
     {
         Layer* layer = d->layers[i];
@@ -1580,7 +2393,10 @@ int Net::load_model(const DataReader& dr)
             break;
         }
 
-        Option opt1 = get_masked_option(opt, layer->featmask);
+        if (parallel_create_pipeline || lazy_create_pipeline)
+            continue;
+
+        Option opt1 = d->get_pipeline_option(i);
 
         int cret = layer->create_pipeline(opt1);
         if (cret != 0)
@@ -1595,24 +2411,16 @@ int Net::load_model(const DataReader& dr)
         }
     }
 
-    if (opt.use_local_pool_allocator)
+    if (ret == 0 && parallel_create_pipeline)
     {
-        if (opt.blob_allocator == 0)
-        {
-            if (!d->local_blob_allocator)
-            {
-                d->local_blob_allocator = new PoolAllocator;
-                d->local_blob_allocator->set_size_compare_ratio(0.f);
-            }
-        }
-        if (opt.workspace_allocator == 0)
-        {
-            if (!d->local_workspace_allocator)
-            {
-                d->local_workspace_allocator = new PoolAllocator;
-                d->local_workspace_allocator->set_size_compare_ratio(0.f);
-            }
-        }
+        ret = d->create_pipeline_parallel();
+    }
+
+    d->create_local_pool_allocator();
+
+    if (ret == 0)
+    {
+        d->plan_layout();
     }
 
 #if NCNN_VULKAN
@@ -1780,14 +2588,28 @@ int Net::load_model(AAssetManager* mgr, const char* assetpath)
 
 void Net::clear()
 {
+    // the layers stay alive while another net shares them
+    bool layers_shared = false;
+    if (d->layers_refcount)
+    {
+        layers_shared = NCNN_XADD(d->layers_refcount, -1) != 1;
+        if (!layers_shared)
+            delete d->layers_refcount;
+
+        d->layers_refcount = 0;
+    }
+
     d->blobs.clear();
-    for (size_t i = 0; i < d->layers.size(); i++)
+    for (size_t i = 0; i < d->layers.size() && !layers_shared; i++)
     {
         Layer* layer = d->layers[i];
 
         Option opt1 = get_masked_option(opt, layer->featmask);
 
-        int dret = layer->destroy_pipeline(opt1);
+        // lazy layers never reached have no pipeline
+        const bool pipeline_created = d->layer_pipeline_created.empty() || d->layer_pipeline_created[i];
+
+        int dret = pipeline_created ? layer->destroy_pipeline(opt1) : 0;
         if (dret != 0)
         {
             NCNN_LOGE("layer destroy_pipeline failed");
@@ -1831,6 +2653,8 @@ void Net::clear()
         }
     }
     d->layers.clear();
+    d->layer_pipeline_created.clear();
+    d->layer_num_threads.clear();
 
     if (d->local_blob_allocator)
     {
@@ -1863,6 +2687,82 @@ void Net::clear()
 #endif // NCNN_VULKAN
 }
 
+int Net::share_model(const Net& base)
+{
+    if (base.d->layers.empty())
+    {
+        NCNN_LOGE("base network graph not ready");
+        return -1;
+    }
+
+    if (base.opt.use_vulkan_compute)
+    {
+        NCNN_LOGE("share_model supports cpu network only");
+        return -1;
+    }
+
+    if (&base == this)
+        return 0;
+
+    // the pipelines of base would run with a thread count they were not created for
+    if (base.opt.num_threads != base.d->pipeline_num_threads)
+    {
+        NCNN_LOGE("share_model base num_threads %d differs from the %d its pipelines were created with", base.opt.num_threads, base.d->pipeline_num_threads);
+        return -1;
+    }
+
+    // any net may forward a shared layer first, so the lazy pipelines are all created now
+    if (!base.d->layer_pipeline_created.empty())
+    {
+        for (int i = 0; i < (int)base.d->layers.size(); i++)
+        {
+            int ret = base.d->create_pipeline_lazy(i, std::vector<Mat>());
+            if (ret != 0)
+                return ret;
+        }
+    }
+
+    clear();
+
+    if (!base.d->layers_refcount)
+        base.d->layers_refcount = new int(1);
+
+    NCNN_XADD(base.d->layers_refcount, 1);
+    d->layers_refcount = base.d->layers_refcount;
+
+    opt = base.opt;
+
+    d->blobs = base.d->blobs;
+    d->layers = base.d->layers;
+
+    // whichever net is cleared last destroys the custom layers
+    d->custom_layer_registry = base.d->custom_layer_registry;
+    d->overwrite_builtin_layer_registry = base.d->overwrite_builtin_layer_registry;
+
+    d->layer_num_threads = base.d->layer_num_threads;
+    d->pipeline_num_threads = base.d->pipeline_num_threads;
+
+    d->input_blob_indexes = base.d->input_blob_indexes;
+    d->output_blob_indexes = base.d->output_blob_indexes;
+#if NCNN_STRING
+    d->update_input_output_names();
+#endif // NCNN_STRING
+
+    // the channel alias layouts are learned again by this net
+    {
+        MutexLockGuard lock(base.d->channel_alias_lock);
+        d->channel_alias_records = base.d->channel_alias_records;
+    }
+    for (size_t i = 0; i < d->channel_alias_records.size(); i++)
+    {
+        d->channel_alias_records[i].dims = 0;
+    }
+
+    d->create_local_pool_allocator();
+
+    return 0;
+}
+
 Extractor Net::create_extractor() const
 {
     return Extractor(this, d->blobs.size());
@@ -1910,6 +2810,14 @@ std::vector<Layer*>& Net::mutable_layers()
     return d->layers;
 }
 
+int Net::layer_num_threads(int layer_index) const
+{
+    if (layer_index < 0 || layer_index >= (int)d->layer_num_threads.size() || d->layer_num_threads[layer_index] == 0)
+        return opt.num_threads;
+
+    return std::min(d->layer_num_threads[layer_index], opt.num_threads);
+}
+
 #if NCNN_VULKAN
 void Net::set_vulkan_device(int device_index)
 {
@@ -1929,6 +2837,11 @@ const VulkanDevice* Net::vulkan_device() const
 }
 #endif // NCNN_VULKAN
 
+void Net::set_weight_allocator(Allocator* allocator)
+{
+    d->weight_allocator = allocator;
+}
+
 #if NCNN_STRING
 int Net::find_blob_index_by_name(const char* name) const
 {
@@ -2035,13 +2948,23 @@ class ExtractorPrivate
 {
 public:
     ExtractorPrivate(const Net* _net)
-        : net(_net)
+        : net(_net), streaming(false), conversion_bytes(0)
     {
     }
     const Net* net;
     std::vector<Mat> blob_mats;
     Option opt;
 
+    // per layer left context kept across chunks
+    bool streaming;
+    std::vector<Mat> layer_states;
+
+    size_t conversion_bytes;
+
+    // per blob the channel range view producers may write into, and the whole blob owning it
+    std::vector<Mat> blob_presets;
+    std::vector<Mat> keepalive_blobs;
+
 #if NCNN_VULKAN
     VkAllocator* local_blob_vkallocator;
     VkAllocator* local_staging_vkallocator;
@@ -2054,6 +2977,8 @@ Extractor::Extractor(const Net* _net, size_t blob_count)
     : d(new ExtractorPrivate(_net))
 {
     d->blob_mats.resize(blob_count);
+    d->blob_presets.resize(blob_count);
+    d->keepalive_blobs.resize(blob_count);
     d->opt = d->net->opt;
 
 #if NCNN_VULKAN
@@ -2080,6 +3005,12 @@ Extractor::Extractor(const Extractor& rhs)
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->streaming = rhs.d->streaming;
+    d->layer_states = rhs.d->layer_states;
+    d->conversion_bytes = rhs.d->conversion_bytes;
+    d->blob_presets.clear();
+    d->blob_presets.resize(rhs.d->blob_presets.size());
+    d->keepalive_blobs = rhs.d->keepalive_blobs;
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2097,6 +3028,12 @@ Extractor& Extractor::operator=(const Extractor& rhs)
     d->net = rhs.d->net;
     d->blob_mats = rhs.d->blob_mats;
     d->opt = rhs.d->opt;
+    d->streaming = rhs.d->streaming;
+    d->layer_states = rhs.d->layer_states;
+    d->conversion_bytes = rhs.d->conversion_bytes;
+    d->blob_presets.clear();
+    d->blob_presets.resize(rhs.d->blob_presets.size());
+    d->keepalive_blobs = rhs.d->keepalive_blobs;
 
 #if NCNN_VULKAN
     d->local_blob_vkallocator = 0;
@@ -2111,6 +3048,9 @@ Extractor& Extractor::operator=(const Extractor& rhs)
 void Extractor::clear()
 {
     d->blob_mats.clear();
+    d->layer_states.clear();
+    d->blob_presets.clear();
+    d->keepalive_blobs.clear();
 
 #if NCNN_VULKAN
     if (d->opt.use_vulkan_compute)
@@ -2131,6 +3071,47 @@ void Extractor::clear()
 #endif // NCNN_VULKAN
 }
 
+void Extractor::set_streaming(bool enable)
+{
+#if NCNN_VULKAN
+    if (enable && d->opt.use_vulkan_compute)
+    {
+        NCNN_LOGE("streaming is not supported with vulkan compute");
+        return;
+    }
+#endif // NCNN_VULKAN
+
+    d->streaming = enable;
+    d->layer_states.clear();
+    if (enable)
+    {
+        d->layer_states.resize(d->net->layers().size());
+    }
+}
+
+void Extractor::next_chunk()
+{
+    d->blob_mats.clear();
+    d->blob_mats.resize(d->net->blobs().size());
+    d->keepalive_blobs.clear();
+    d->keepalive_blobs.resize(d->net->blobs().size());
+}
+
+void Extractor::reset_streaming()
+{
+    next_chunk();
+
+    for (size_t i = 0; i < d->layer_states.size(); i++)
+    {
+        d->layer_states[i].release();
+    }
+}
+
+size_t Extractor::conversion_bytes() const
+{
+    return d->conversion_bytes;
+}
+
 void Extractor::set_light_mode(bool enable)
 {
     d->opt.lightmode = enable;
@@ -2228,6 +3209,13 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     if (blob_index < 0 || blob_index >= (int)d->blob_mats.size())
         return -1;
 
+    // the shared pipelines only run with the thread count they were created with
+    if (d->net->d->layers_refcount && d->opt.num_threads != d->net->d->pipeline_num_threads)
+    {
+        NCNN_LOGE("net sharing its layers has num_threads %d, the shared pipelines were created with %d", d->opt.num_threads, d->net->d->pipeline_num_threads);
+        return -1;
+    }
+
     int old_blocktime = get_kmp_blocktime();
     set_kmp_blocktime(d->opt.openmp_blocktime);
 
@@ -2240,6 +3228,12 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     {
         int layer_index = d->net->blobs()[blob_index].producer;
 
+        ForwardContext ctx;
+        ctx.layer_states = d->streaming ? &d->layer_states : 0;
+        ctx.conversion_bytes = 0;
+        ctx.blob_presets = &d->blob_presets;
+        ctx.keepalive_blobs = &d->keepalive_blobs;
+
         // use local allocator
         if (d->opt.use_local_pool_allocator)
         {
@@ -2253,6 +3247,9 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
             }
         }
 
+        ctx.tracking_allocators[0] = TrackingAllocator::find(d->opt.blob_allocator);
+        ctx.tracking_allocators[1] = d->opt.workspace_allocator == d->opt.blob_allocator ? 0 : TrackingAllocator::find(d->opt.workspace_allocator);
+
 #if NCNN_VULKAN
         if (d->opt.use_vulkan_compute)
         {
@@ -2304,11 +3301,13 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
         }
         else
         {
-            ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+            ret = d->net->d->forward_layer(layer_index, d->blob_mats, &ctx, d->opt);
         }
 #else
-        ret = d->net->d->forward_layer(layer_index, d->blob_mats, d->opt);
+        ret = d->net->d->forward_layer(layer_index, d->blob_mats, &ctx, d->opt);
 #endif // NCNN_VULKAN
+
+        d->conversion_bytes += ctx.conversion_bytes;
     }
 
     feat = d->blob_mats[blob_index];
@@ -2316,6 +3315,14 @@ int Extractor::extract(int blob_index, Mat& feat, int type)
     // empty is valid for outputs
     if (!feat.empty())
     {
+        if (!feat.refcount)
+        {
+            // a channel range view of Concat or Slice must not outlive this extractor
+            feat = feat.clone();
+            if (feat.empty())
+                return -100;
+        }
+
         if (d->opt.use_packing_layout && (type == 0) && feat.elempack != 1)
         {
             Mat bottom_blob_unpacked;
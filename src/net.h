@@ -46,6 +46,12 @@ public:
     const VulkanDevice* vulkan_device() const;
 #endif // NCNN_VULKAN
 
+    // allocator of the weights load_model copies out of the model data, such as HugePageAllocator
+    // weights referenced in place and the copies packed by create_pipeline are not affected
+    // it must outlive the net and every net sharing its layers, null means ncnn::fastMalloc
+    // set before load_model, cpu only
+    void set_weight_allocator(Allocator* allocator);
+
 #if NCNN_STRING
     // register custom layer or overwrite built-in layer by layer type name
     // return 0 if success
@@ -115,6 +121,17 @@ public:
     // unload network structure and weight data
     void clear();
 
+    // share the layers and prepared weights of a loaded cpu network instead of loading them again
+    // opt is copied from base, afterwards only lightmode, openmp_blocktime, flush_denormals
+    // and the allocators may be changed, the layer pipelines keep the options base was loaded with
+    // num_threads is fixed by the pipelines of base, base must not have changed it since load_model
+    // and extractors of a net sharing layers fail with a differing value,
+    // load another net for each thread count or packing configuration
+    // the layers are destroyed with the last net sharing them
+    // not thread-safe with other calls on base
+    // return 0 if success
+    int share_model(const Net& base);
+
     // construct an Extractor from network
     Extractor create_extractor() const;
 
@@ -132,6 +149,9 @@ public:
     std::vector<Blob>& mutable_blobs();
     std::vector<Layer*>& mutable_layers();
 
+    // threads the layer runs with, chosen by the cost model of opt.use_adaptive_num_threads
+    int layer_num_threads(int layer_index) const;
+
 protected:
     friend class Extractor;
 #if NCNN_STRING
@@ -181,6 +201,22 @@ public:
     // set workspace memory allocator
     void set_workspace_allocator(Allocator* allocator);
 
+    // enable streaming mode for feeding one stream in consecutive chunks along w
+    // layers supporting streaming keep their left context in this extractor
+    // and produce only the outputs completed by each chunk, other layers run on the chunk as is
+    // cpu only, disabled by default
+    void set_streaming(bool enable);
+
+    // drop the blobs of the current chunk and keep the streaming state, call before feeding the next chunk
+    void next_chunk();
+
+    // drop the streaming state to begin a new stream
+    void reset_streaming();
+
+    // bytes of the blobs produced by layout and precision conversions between cpu layers
+    // accumulated over all extract calls of this extractor
+    size_t conversion_bytes() const;
+
 #if NCNN_VULKAN
     // deprecated, no-op
     // instead, set net.opt.use_vulkan_compute before net.load_param()
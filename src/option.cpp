@@ -67,9 +67,9 @@ Option::Option()
     use_fp16_uniform = true;
     use_int8_uniform = true;
 
-    use_reserved_9 = false;
-    use_reserved_10 = false;
-    use_reserved_11 = false;
+    use_parallel_create_pipeline = false;
+    use_lazy_create_pipeline = false;
+    use_adaptive_num_threads = false;
 }
 
 } // namespace ncnn
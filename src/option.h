@@ -141,9 +141,16 @@ public:
     bool use_fp16_uniform;
     bool use_int8_uniform;
 
-    bool use_reserved_9;
-    bool use_reserved_10;
-    bool use_reserved_11;
+    // read all weights first, then run create_pipeline of the layers on num_threads threads
+    // cpu only, ignored with simpleomp
+    bool use_parallel_create_pipeline;
+    // defer create_pipeline of each layer until the first forward reaches it
+    // layers of unused outputs never prepare, and weights loaded from memory are not paged in for them
+    // cpu only
+    bool use_lazy_create_pipeline;
+    // let small layers run on fewer threads than num_threads, estimated from the shape hints at load
+    // layers without shape hints keep num_threads, or with lazy pipelines are estimated on the first forward
+    bool use_adaptive_num_threads;
 };
 
 } // namespace ncnn
@@ -0,0 +1,653 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "stagedextractor.h"
+
+#include "benchmark.h"
+#include "layer.h"
+
+#include <float.h>
+#include <algorithm>
+#include <list>
+
+namespace ncnn {
+
+// the mats one frame carries into the next stage
+struct StagedFrame
+{
+    std::vector<Mat> mats;
+    int ret;
+};
+
+class StagedExtractorPrivate;
+struct StagedExtractorStageArgs
+{
+    StagedExtractorPrivate* d;
+    int stage;
+};
+
+class StagedExtractorPrivate
+{
+public:
+    // mark the blobs and layers the outputs depend on, stopping at the inputs
+    void resolve_needed(std::vector<char>& blob_needed, std::vector<char>& layer_needed) const;
+
+    // run the needed layers one at a time on the sample inputs, keep the fastest of a few rounds
+    int measure_layer_cost(const std::vector<Mat>& sample_inputs, const std::vector<char>& layer_needed, std::vector<double>& layer_cost) const;
+
+    // cut contiguous layer ranges minimizing the slowest stage, each stage speeds up with the threads it runs
+    void partition(const std::vector<double>& layer_cost);
+
+    // the blobs crossing each cut, the last stage hands out the outputs
+    void resolve_stage_outputs(const std::vector<char>& blob_needed);
+
+    // run the layers of one stage on the mats of the frame
+    void run_stage(int stage, StagedFrame* frame) const;
+
+    const Net* net;
+    std::vector<CpuSet> stage_cpus;
+    int queue_size;
+    bool prepared;
+
+    std::vector<int> input_indexes;
+    std::vector<int> output_indexes;
+
+    // stage i runs layers [stage_begins[i], stage_begins[i + 1])
+    std::vector<int> stage_begins;
+    std::vector<std::vector<int> > stage_outputs;
+
+    // blob mats are released by the next stage thread, so the blob allocators are locked
+    std::vector<PoolAllocator*> blob_allocators;
+    std::vector<UnlockedPoolAllocator*> workspace_allocators;
+
+    // queues[i] feeds stage i, the last one holds the finished frames
+    std::vector<std::list<StagedFrame*> > queues;
+    int inflight_count;
+    bool stopping;
+
+    std::vector<Thread*> threads;
+    std::vector<StagedExtractorStageArgs> stage_args;
+
+    Mutex lock;
+    ConditionVariable condition;
+};
+
+void StagedExtractorPrivate::resolve_needed(std::vector<char>& blob_needed, std::vector<char>& layer_needed) const
+{
+    const std::vector<Blob>& blobs = net->blobs();
+    const std::vector<Layer*>& layers = net->layers();
+
+    blob_needed.assign(blobs.size(), 0);
+    layer_needed.assign(layers.size(), 0);
+
+    std::vector<char> blob_is_input(blobs.size(), 0);
+    for (size_t i = 0; i < input_indexes.size(); i++)
+    {
+        blob_is_input[input_indexes[i]] = 1;
+    }
+
+    std::vector<int> pending = output_indexes;
+    while (!pending.empty())
+    {
+        int blob_index = pending.back();
+        pending.pop_back();
+
+        if (blob_needed[blob_index])
+            continue;
+
+        blob_needed[blob_index] = 1;
+
+        const int producer = blobs[blob_index].producer;
+        if (blob_is_input[blob_index] || producer < 0 || layer_needed[producer])
+            continue;
+
+        layer_needed[producer] = 1;
+
+        const Layer* layer = layers[producer];
+        for (size_t i = 0; i < layer->bottoms.size(); i++)
+        {
+            pending.push_back(layer->bottoms[i]);
+        }
+    }
+}
+
+int StagedExtractorPrivate::measure_layer_cost(const std::vector<Mat>& sample_inputs, const std::vector<char>& layer_needed, std::vector<double>& layer_cost) const
+{
+    const std::vector<Layer*>& layers = net->layers();
+
+    layer_cost.assign(layers.size(), DBL_MAX);
+
+    // warm up the allocators and the lazily created pipelines
+    const int round_count = 4;
+    for (int r = 0; r < round_count; r++)
+    {
+        Extractor ex = net->create_extractor();
+        ex.set_light_mode(false);
+
+        for (size_t i = 0; i < input_indexes.size(); i++)
+        {
+            int ret = ex.input(input_indexes[i], sample_inputs[i]);
+            if (ret != 0)
+                return ret;
+        }
+
+        // every bottom is computed already, so extracting the first top runs this layer only
+        for (size_t i = 0; i < layers.size(); i++)
+        {
+            if (!layer_needed[i] || layers[i]->tops.empty())
+                continue;
+
+            double start = get_current_time();
+
+            Mat top;
+            int ret = ex.extract(layers[i]->tops[0], top, 1);
+            if (ret != 0)
+                return ret;
+
+            double cost = get_current_time() - start;
+            if (r > 0 && cost < layer_cost[i])
+                layer_cost[i] = cost;
+        }
+    }
+
+    for (size_t i = 0; i < layers.size(); i++)
+    {
+        if (layer_cost[i] == DBL_MAX)
+            layer_cost[i] = 0.0;
+    }
+
+    return 0;
+}
+
+void StagedExtractorPrivate::partition(const std::vector<double>& layer_cost)
+{
+    const int layer_count = (int)layer_cost.size();
+    const int stage_count = std::min((int)stage_cpus.size(), layer_count);
+
+    std::vector<double> prefix(layer_count + 1, 0.0);
+    for (int i = 0; i < layer_count; i++)
+    {
+        prefix[i + 1] = prefix[i] + layer_cost[i];
+    }
+
+    // best[s][j] is the slowest stage when s stages run layers [0, j), cut[s][j] is where the last one begins
+    std::vector<std::vector<double> > best(stage_count + 1, std::vector<double>(layer_count + 1, DBL_MAX));
+    std::vector<std::vector<int> > cut(stage_count + 1, std::vector<int>(layer_count + 1, 0));
+    best[0][0] = 0.0;
+
+    for (int s = 1; s <= stage_count; s++)
+    {
+        const double capacity = (double)std::max(std::min(stage_cpus[s - 1].num_enabled(), net->opt.num_threads), 1);
+
+        for (int j = s; j <= layer_count - (stage_count - s); j++)
+        {
+            for (int i = s - 1; i < j; i++)
+            {
+                if (best[s - 1][i] == DBL_MAX)
+                    continue;
+
+                const double load = std::max(best[s - 1][i], (prefix[j] - prefix[i]) / capacity);
+                if (load < best[s][j])
+                {
+                    best[s][j] = load;
+                    cut[s][j] = i;
+                }
+            }
+        }
+    }
+
+    stage_begins.resize(stage_count + 1);
+    stage_begins[stage_count] = layer_count;
+    for (int s = stage_count; s > 0; s--)
+    {
+        stage_begins[s - 1] = cut[s][stage_begins[s]];
+    }
+}
+
+void StagedExtractorPrivate::resolve_stage_outputs(const std::vector<char>& blob_needed)
+{
+    const std::vector<Blob>& blobs = net->blobs();
+    const int stage_count = (int)stage_begins.size() - 1;
+
+    std::vector<char> blob_is_input(blobs.size(), 0);
+    for (size_t i = 0; i < input_indexes.size(); i++)
+    {
+        blob_is_input[input_indexes[i]] = 1;
+    }
+
+    std::vector<char> blob_is_output(blobs.size(), 0);
+    for (size_t i = 0; i < output_indexes.size(); i++)
+    {
+        blob_is_output[output_indexes[i]] = 1;
+    }
+
+    stage_outputs.resize(stage_count);
+    for (int s = 0; s + 1 < stage_count; s++)
+    {
+        const int end = stage_begins[s + 1];
+
+        stage_outputs[s].clear();
+        for (size_t i = 0; i < blobs.size(); i++)
+        {
+            if (!blob_needed[i])
+                continue;
+
+            // available before the cut and used after it
+            const int available = blob_is_input[i] ? -1 : blobs[i].producer;
+            if (available < end && (blobs[i].consumer >= end || blob_is_output[i]))
+                stage_outputs[s].push_back((int)i);
+        }
+    }
+
+    stage_outputs[stage_count - 1] = output_indexes;
+}
+
+void StagedExtractorPrivate::run_stage(int stage, StagedFrame* frame) const
+{
+    if (frame->ret != 0)
+        return;
+
+    const std::vector<int>& bottoms = stage == 0 ? input_indexes : stage_outputs[stage - 1];
+    const std::vector<int>& tops = stage_outputs[stage];
+    const bool last_stage = stage + 1 == (int)stage_outputs.size();
+
+    int ret = 0;
+    std::vector<Mat> top_mats(tops.size());
+    {
+        Extractor ex = net->create_extractor();
+        ex.set_blob_allocator(blob_allocators[stage]);
+        ex.set_workspace_allocator(workspace_allocators[stage]);
+
+        for (size_t i = 0; i < bottoms.size() && ret == 0; i++)
+        {
+            ret = ex.input(bottoms[i], frame->mats[i]);
+        }
+
+        for (size_t i = 0; i < tops.size() && ret == 0; i++)
+        {
+            if (last_stage)
+            {
+                // the stage blob allocator is not shared with the caller
+                Mat out;
+                ret = ex.extract(tops[i], out);
+                top_mats[i] = out.allocator ? out.clone() : out;
+            }
+            else
+            {
+                // hand over in the computed layout, the next stage converts as needed
+                ret = ex.extract(tops[i], top_mats[i], 1);
+            }
+        }
+    }
+
+    frame->mats = top_mats;
+    frame->ret = ret;
+}
+
+static void* staged_extractor_stage(void* args)
+{
+    StagedExtractorStageArgs* stage_args = (StagedExtractorStageArgs*)args;
+    StagedExtractorPrivate* d = stage_args->d;
+    const int stage = stage_args->stage;
+
+    if (set_cpu_thread_affinity(d->stage_cpus[stage]) != 0)
+    {
+        NCNN_LOGE("StagedExtractor stage %d set cpu affinity failed", stage);
+    }
+
+    for (;;)
+    {
+        StagedFrame* frame = 0;
+        {
+            MutexLockGuard guard(d->lock);
+
+            while (d->queues[stage].empty() && !d->stopping)
+            {
+                d->condition.wait(d->lock);
+            }
+
+            if (d->stopping)
+                break;
+
+            frame = d->queues[stage].front();
+            d->queues[stage].pop_front();
+        }
+
+        d->condition.broadcast();
+
+        d->run_stage(stage, frame);
+
+        {
+            MutexLockGuard guard(d->lock);
+
+            std::list<StagedFrame*>& next_queue = d->queues[stage + 1];
+            while ((int)next_queue.size() >= d->queue_size && !d->stopping)
+            {
+                d->condition.wait(d->lock);
+            }
+
+            if (d->stopping)
+            {
+                delete frame;
+                break;
+            }
+
+            next_queue.push_back(frame);
+        }
+
+        d->condition.broadcast();
+    }
+
+    return 0;
+}
+
+StagedExtractor::StagedExtractor(const Net* net, const std::vector<CpuSet>& stage_cpus, int queue_size)
+    : d(new StagedExtractorPrivate)
+{
+    d->net = net;
+    d->stage_cpus = stage_cpus;
+    d->queue_size = queue_size > 0 ? queue_size : 1;
+    d->prepared = false;
+    d->inflight_count = 0;
+    d->stopping = false;
+}
+
+StagedExtractor::~StagedExtractor()
+{
+    {
+        MutexLockGuard guard(d->lock);
+        d->stopping = true;
+    }
+
+    d->condition.broadcast();
+
+    for (size_t i = 0; i < d->threads.size(); i++)
+    {
+        d->threads[i]->join();
+        delete d->threads[i];
+    }
+
+    // release the frame mats before their allocators
+    for (size_t i = 0; i < d->queues.size(); i++)
+    {
+        std::list<StagedFrame*>::iterator it = d->queues[i].begin();
+        for (; it != d->queues[i].end(); it++)
+        {
+            delete *it;
+        }
+    }
+
+    for (size_t i = 0; i < d->blob_allocators.size(); i++)
+    {
+        delete d->blob_allocators[i];
+        delete d->workspace_allocators[i];
+    }
+
+    delete d;
+}
+
+StagedExtractor::StagedExtractor(const StagedExtractor&)
+    : d(0)
+{
+}
+
+StagedExtractor& StagedExtractor::operator=(const StagedExtractor&)
+{
+    return *this;
+}
+
+#if NCNN_STRING
+static int find_blob_indexes(const Net* net, const std::vector<const char*>& names, std::vector<int>& indexes)
+{
+    const std::vector<Blob>& blobs = net->blobs();
+
+    indexes.resize(names.size());
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        indexes[i] = -1;
+        for (size_t j = 0; j < blobs.size(); j++)
+        {
+            if (blobs[j].name == names[i])
+            {
+                indexes[i] = (int)j;
+                break;
+            }
+        }
+
+        if (indexes[i] == -1)
+        {
+            NCNN_LOGE("StagedExtractor blob %s not exists", names[i]);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int StagedExtractor::prepare(const std::vector<const char*>& input_names, const std::vector<Mat>& sample_inputs, const std::vector<const char*>& output_names)
+{
+    std::vector<int> input_indexes;
+    std::vector<int> output_indexes;
+    if (find_blob_indexes(d->net, input_names, input_indexes) != 0 || find_blob_indexes(d->net, output_names, output_indexes) != 0)
+        return -1;
+
+    return prepare(input_indexes, sample_inputs, output_indexes);
+}
+#endif // NCNN_STRING
+
+int StagedExtractor::prepare(const std::vector<int>& input_indexes, const std::vector<Mat>& sample_inputs, const std::vector<int>& output_indexes)
+{
+    if (d->prepared)
+    {
+        NCNN_LOGE("StagedExtractor is already prepared");
+        return -1;
+    }
+
+    if (d->stage_cpus.empty() || d->net->layers().empty())
+    {
+        NCNN_LOGE("StagedExtractor needs at least one cpu set and one layer");
+        return -1;
+    }
+
+    if (input_indexes.size() != sample_inputs.size() || output_indexes.empty())
+    {
+        NCNN_LOGE("StagedExtractor %d input indexes for %d sample inputs, %d outputs", (int)input_indexes.size(), (int)sample_inputs.size(), (int)output_indexes.size());
+        return -1;
+    }
+
+    // the pipelines are tiled for net->opt.num_threads, so every stage runs that many threads
+    for (size_t i = 0; i < d->stage_cpus.size(); i++)
+    {
+        if (d->net->opt.num_threads > d->stage_cpus[i].num_enabled())
+        {
+            NCNN_LOGE("StagedExtractor num_threads %d exceeds the %d cpus of stage %d", d->net->opt.num_threads, d->stage_cpus[i].num_enabled(), (int)i);
+            return -1;
+        }
+    }
+
+    const int blob_count = (int)d->net->blobs().size();
+    for (size_t i = 0; i < input_indexes.size(); i++)
+    {
+        if (input_indexes[i] < 0 || input_indexes[i] >= blob_count)
+            return -1;
+    }
+    for (size_t i = 0; i < output_indexes.size(); i++)
+    {
+        if (output_indexes[i] < 0 || output_indexes[i] >= blob_count)
+            return -1;
+    }
+
+    d->input_indexes = input_indexes;
+    d->output_indexes = output_indexes;
+
+    std::vector<char> blob_needed;
+    std::vector<char> layer_needed;
+    d->resolve_needed(blob_needed, layer_needed);
+
+    std::vector<double> layer_cost;
+    int ret = d->measure_layer_cost(sample_inputs, layer_needed, layer_cost);
+    if (ret != 0)
+    {
+        NCNN_LOGE("StagedExtractor measure layer cost failed %d", ret);
+        return ret;
+    }
+
+    d->partition(layer_cost);
+    d->resolve_stage_outputs(blob_needed);
+
+    const int stage_count = (int)d->stage_outputs.size();
+
+    d->blob_allocators.resize(stage_count);
+    d->workspace_allocators.resize(stage_count);
+    for (int i = 0; i < stage_count; i++)
+    {
+        d->blob_allocators[i] = new PoolAllocator;
+        d->workspace_allocators[i] = new UnlockedPoolAllocator;
+    }
+
+    d->queues.resize(stage_count + 1);
+
+#if NCNN_THREADS
+    d->stage_args.resize(stage_count);
+    d->threads.resize(stage_count);
+    for (int i = 0; i < stage_count; i++)
+    {
+        d->stage_args[i].d = d;
+        d->stage_args[i].stage = i;
+        d->threads[i] = new Thread(staged_extractor_stage, &d->stage_args[i]);
+    }
+#endif // NCNN_THREADS
+
+    d->prepared = true;
+
+    return 0;
+}
+
+int StagedExtractor::stage_count() const
+{
+    return (int)d->stage_outputs.size();
+}
+
+int StagedExtractor::stage_layer_begin(int stage) const
+{
+    if (stage < 0 || stage >= stage_count())
+        return -1;
+
+    return d->stage_begins[stage];
+}
+
+int StagedExtractor::stage_layer_end(int stage) const
+{
+    if (stage < 0 || stage >= stage_count())
+        return -1;
+
+    return d->stage_begins[stage + 1];
+}
+
+int StagedExtractor::push(const std::vector<Mat>& inputs)
+{
+    if (!d->prepared)
+    {
+        NCNN_LOGE("StagedExtractor push before prepare");
+        return -1;
+    }
+
+    if (inputs.size() != d->input_indexes.size())
+    {
+        NCNN_LOGE("StagedExtractor push %d inputs, expect %d", (int)inputs.size(), (int)d->input_indexes.size());
+        return -1;
+    }
+
+    StagedFrame* frame = new StagedFrame;
+    frame->mats = inputs;
+    frame->ret = 0;
+
+#if NCNN_THREADS
+    {
+        MutexLockGuard guard(d->lock);
+
+        while ((int)d->queues[0].size() >= d->queue_size)
+        {
+            d->condition.wait(d->lock);
+        }
+
+        d->queues[0].push_back(frame);
+        d->inflight_count++;
+    }
+
+    d->condition.broadcast();
+#else
+    for (int i = 0; i < stage_count(); i++)
+    {
+        d->run_stage(i, frame);
+    }
+
+    d->queues.back().push_back(frame);
+    d->inflight_count++;
+#endif // NCNN_THREADS
+
+    return 0;
+}
+
+int StagedExtractor::pop(std::vector<Mat>& outputs)
+{
+    StagedFrame* frame = 0;
+    {
+        MutexLockGuard guard(d->lock);
+
+        if (d->inflight_count == 0)
+            return -1;
+
+        std::list<StagedFrame*>& finished = d->queues.back();
+        while (finished.empty())
+        {
+            d->condition.wait(d->lock);
+        }
+
+        frame = finished.front();
+        finished.pop_front();
+        d->inflight_count--;
+    }
+
+    d->condition.broadcast();
+
+    outputs = frame->mats;
+    int ret = frame->ret;
+    delete frame;
+
+    return ret;
+}
+
+int StagedExtractor::inflight_count() const
+{
+    MutexLockGuard guard(d->lock);
+    return d->inflight_count;
+}
+
+void StagedExtractor::split_cpu_set(const CpuSet& cpus, int group_count, std::vector<CpuSet>& groups)
+{
+    std::vector<int> enabled;
+    for (int i = 0; i < get_cpu_count(); i++)
+    {
+        if (cpus.is_enabled(i))
+            enabled.push_back(i);
+    }
+
+    group_count = std::max(std::min(group_count, (int)enabled.size()), 1);
+
+    groups.resize(group_count);
+    for (int g = 0; g < group_count; g++)
+    {
+        groups[g].disable_all();
+
+        // group sizes differ by at most one cpu
+        const int begin = (int)enabled.size() * g / group_count;
+        const int end = (int)enabled.size() * (g + 1) / group_count;
+        for (int i = begin; i < end; i++)
+        {
+            groups[g].enable(enabled[i]);
+        }
+    }
+}
+
+} // namespace ncnn
@@ -0,0 +1,76 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#ifndef NCNN_STAGEDEXTRACTOR_H
+#define NCNN_STAGEDEXTRACTOR_H
+
+#include "cpu.h"
+#include "mat.h"
+#include "net.h"
+#include "platform.h"
+
+namespace ncnn {
+
+// stream frames through one loaded net split into pipeline stages
+//
+// the layer sequence is cut into contiguous stages balanced by the layer cost measured in prepare(),
+// each stage runs on its own thread pinned to its cpu set, and hands the blobs crossing the cut
+// to the next stage through a bounded queue, so up to stage_count() frames are computed at once
+// frames leave the last stage in the push order
+//
+// every stage runs layers with net->opt.num_threads threads, prepare() fails if a stage cpu set is smaller,
+// load the net with the size of the smallest stage cpu set, see split_cpu_set()
+// without NCNN_THREADS all stages run in push()
+class StagedExtractorPrivate;
+class NCNN_EXPORT StagedExtractor
+{
+public:
+    // net must be loaded and must outlive the staged extractor
+    // one stage per cpu set, at most queue_size frames wait in front of each stage
+    StagedExtractor(const Net* net, const std::vector<CpuSet>& stage_cpus, int queue_size);
+
+    // frames not popped yet are dropped
+    virtual ~StagedExtractor();
+
+#if NCNN_STRING
+    // measure the layer cost on the sample inputs, cut the stages and start the stage threads
+    // return 0 if success
+    int prepare(const std::vector<const char*>& input_names, const std::vector<Mat>& sample_inputs, const std::vector<const char*>& output_names);
+#endif // NCNN_STRING
+
+    // prepare by blob indexes
+    int prepare(const std::vector<int>& input_indexes, const std::vector<Mat>& sample_inputs, const std::vector<int>& output_indexes);
+
+    // less than the cpu set count if the net has fewer layers
+    int stage_count() const;
+
+    // the layer index range [begin, end) run by the stage
+    int stage_layer_begin(int stage) const;
+    int stage_layer_end(int stage) const;
+
+    // feed one frame in the order of the prepared input blobs, block while the first stage queue is full
+    // the input mats are referenced until the first stage has run
+    // return 0 if success
+    int push(const std::vector<Mat>& inputs);
+
+    // block until the next frame leaves the last stage, get the outputs in the order of the prepared output blobs
+    // return the extract result of the frame, 0 if success, -1 if no frame is in flight
+    int pop(std::vector<Mat>& outputs);
+
+    // frames pushed and not popped yet
+    int inflight_count() const;
+
+    // split the enabled cpus of cpus into group_count sets of consecutive cpus
+    static void split_cpu_set(const CpuSet& cpus, int group_count, std::vector<CpuSet>& groups);
+
+private:
+    StagedExtractor(const StagedExtractor&);
+    StagedExtractor& operator=(const StagedExtractor&);
+
+private:
+    StagedExtractorPrivate* const d;
+};
+
+} // namespace ncnn
+
+#endif // NCNN_STAGEDEXTRACTOR_H
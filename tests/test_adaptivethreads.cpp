@@ -0,0 +1,146 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+// a heavy convolution followed by a global pooling and a tiny classifier
+static const char* g_param_shape_hints = "7767517\n"
+                                         "5 5\n"
+                                         "Input        data 0 1 data -23330=4,3,56,56,32\n"
+                                         "Convolution  conv 1 1 data conv 0=64 1=3 4=1 5=1 6=18432 -23330=4,3,56,56,64\n"
+                                         "Pooling      gap  1 1 conv gap 0=1 4=1 -23330=4,1,64,0,0\n"
+                                         "InnerProduct fc   1 1 gap fc 0=16 1=1 2=1024 -23330=4,1,16,0,0\n"
+                                         "ReLU         relu 1 1 fc out -23330=4,1,16,0,0\n";
+
+static const char* g_param = "7767517\n"
+                             "5 5\n"
+                             "Input        data 0 1 data\n"
+                             "Convolution  conv 1 1 data conv 0=64 1=3 4=1 5=1 6=18432\n"
+                             "Pooling      gap  1 1 conv gap 0=1 4=1\n"
+                             "InnerProduct fc   1 1 gap fc 0=16 1=1 2=1024\n"
+                             "ReLU         relu 1 1 fc out\n";
+
+static std::vector<float> g_weights;
+
+static void generate_weights()
+{
+    const int weight_sizes[2] = {18432, 1024};
+    const int bias_sizes[2] = {64, 16};
+
+    g_weights.clear();
+    for (int i = 0; i < 2; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        g_weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            g_weights.push_back(RandomFloat(-0.1f, 0.1f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            g_weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+}
+
+static int load_net(ncnn::Net& net, const char* param, bool adaptive, bool lazy)
+{
+    net.opt.num_threads = 8;
+    net.opt.use_adaptive_num_threads = adaptive;
+    net.opt.use_lazy_create_pipeline = lazy;
+
+    return load_net_mem(net, param, g_weights);
+}
+
+static int extract(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("out", out);
+}
+
+static int check_layer_num_threads(const ncnn::Net& net, const int* expect, const char* when)
+{
+    for (int i = 0; i < 5; i++)
+    {
+        if (net.layer_num_threads(i) != expect[i])
+        {
+            fprintf(stderr, "layer %d num_threads %d expect %d %s\n", i, net.layer_num_threads(i), expect[i], when);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_adaptivethreads_0()
+{
+    ncnn::Mat in = RandomMat(56, 56, 32);
+
+    ncnn::Mat out_ref;
+    {
+        ncnn::Net net;
+        if (load_net(net, g_param_shape_hints, false, false) != 0)
+            return -1;
+
+        const int expect[5] = {8, 8, 8, 8, 8};
+        if (check_layer_num_threads(net, expect, "without cost model") != 0)
+            return -1;
+
+        extract(net, in, out_ref);
+    }
+
+    // chosen at load from the shape hints
+    {
+        ncnn::Net net;
+        if (load_net(net, g_param_shape_hints, true, false) != 0)
+            return -1;
+
+        const int expect[5] = {4, 8, 7, 1, 1};
+        if (check_layer_num_threads(net, expect, "from shape hints") != 0)
+            return -1;
+
+        ncnn::Mat out;
+        if (extract(net, in, out) != 0 || CompareMat(out, out_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_adaptivethreads_0 shape hints output mismatch\n");
+            return -1;
+        }
+    }
+
+    // chosen on the first forward from the bottom blobs
+    {
+        ncnn::Net net;
+        if (load_net(net, g_param, true, true) != 0)
+            return -1;
+
+        const int expect_before[5] = {8, 8, 8, 8, 8};
+        if (check_layer_num_threads(net, expect_before, "before first forward") != 0)
+            return -1;
+
+        ncnn::Mat out;
+        if (extract(net, in, out) != 0 || CompareMat(out, out_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_adaptivethreads_0 lazy output mismatch\n");
+            return -1;
+        }
+
+        // the input layer is never forwarded
+        const int expect_after[5] = {8, 8, 8, 1, 1};
+        if (check_layer_num_threads(net, expect_after, "after first forward") != 0)
+            return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    generate_weights();
+
+    return test_adaptivethreads_0();
+}
@@ -0,0 +1,225 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "asyncextractor.h"
+#include "net.h"
+#include "platform.h"
+
+// out = data + relu(data), out2 = relu(data)
+static const char* g_param = "7767517\n"
+                             "5 7\n"
+                             "Input   data   0 1 data\n"
+                             "Split   split0 1 2 data data_0 data_1\n"
+                             "ReLU    relu   1 1 data_1 relu\n"
+                             "Split   split1 1 2 relu relu_0 out2\n"
+                             "Eltwise sum    2 1 data_0 relu_0 out 0=1\n";
+
+static int check_output(const ncnn::Mat& out, float expect)
+{
+    if (out.w != 7 || out.h != 5 || out.c != 16)
+    {
+        fprintf(stderr, "output shape %d %d %d\n", out.w, out.h, out.c);
+        return -1;
+    }
+
+    for (int q = 0; q < out.c; q++)
+    {
+        const float* ptr = out.channel(q);
+        for (int i = 0; i < out.w * out.h; i++)
+        {
+            if (ptr[i] != expect)
+            {
+                fprintf(stderr, "output %f expect %f\n", ptr[i], expect);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static float relu(float v)
+{
+    return v > 0.f ? v : 0.f;
+}
+
+struct CallbackContext
+{
+    ncnn::Mutex lock;
+    int count;
+    int failed;
+};
+
+static void callback(int ret, const std::vector<ncnn::Mat>& outputs, void* userdata)
+{
+    CallbackContext* ctx = (CallbackContext*)userdata;
+
+    ncnn::MutexLockGuard guard(ctx->lock);
+    ctx->count++;
+    if (ret != 0 || outputs.size() != 2 || outputs[0].empty() || outputs[1].empty())
+        ctx->failed++;
+}
+
+// more requests than queue slots, outputs must match their own inputs
+static int test_asyncextractor_0(const ncnn::Net& net)
+{
+    const int request_count = 64;
+
+    CallbackContext ctx;
+    ctx.count = 0;
+    ctx.failed = 0;
+
+    std::vector<ncnn::ExtractFuture> futures(request_count);
+    {
+        ncnn::AsyncExtractor async_extractor(&net, 3, 4);
+
+        std::vector<const char*> input_names(1, "data");
+        std::vector<const char*> output_names;
+        output_names.push_back("out");
+        output_names.push_back("out2");
+
+        for (int i = 0; i < request_count; i++)
+        {
+            std::vector<ncnn::Mat> inputs(1);
+            inputs[0].create(7, 5, 16);
+            inputs[0].fill((float)(i - 32));
+
+            futures[i] = async_extractor.submit(input_names, inputs, output_names, callback, &ctx);
+            if (!futures[i].valid())
+            {
+                fprintf(stderr, "test_asyncextractor_0 submit %d failed\n", i);
+                return -1;
+            }
+
+            if (async_extractor.pending_count() > 4)
+            {
+                fprintf(stderr, "test_asyncextractor_0 pending %d exceeds the queue size\n", async_extractor.pending_count());
+                return -1;
+            }
+        }
+
+        async_extractor.wait_all();
+
+        for (int i = 0; i < request_count; i++)
+        {
+            if (!futures[i].ready())
+            {
+                fprintf(stderr, "test_asyncextractor_0 request %d not ready after wait_all\n", i);
+                return -1;
+            }
+        }
+    }
+
+    for (int i = 0; i < request_count; i++)
+    {
+        std::vector<ncnn::Mat> outputs;
+        int ret = futures[i].get(outputs);
+        if (ret != 0 || outputs.size() != 2)
+        {
+            fprintf(stderr, "test_asyncextractor_0 request %d failed %d\n", i, ret);
+            return -1;
+        }
+
+        const float v = (float)(i - 32);
+        if (check_output(outputs[0], v + relu(v)) != 0 || check_output(outputs[1], relu(v)) != 0)
+        {
+            fprintf(stderr, "test_asyncextractor_0 request %d output mismatch\n", i);
+            return -1;
+        }
+    }
+
+    if (ctx.count != request_count || ctx.failed != 0)
+    {
+        fprintf(stderr, "test_asyncextractor_0 callback count %d failed %d\n", ctx.count, ctx.failed);
+        return -1;
+    }
+
+    return 0;
+}
+
+// blob indexes, try_submit and unknown names
+static int test_asyncextractor_1(const ncnn::Net& net)
+{
+    ncnn::AsyncExtractor async_extractor(&net, 2, 2);
+
+    {
+        std::vector<const char*> input_names(1, "data");
+        std::vector<const char*> output_names(1, "nonexistent");
+        std::vector<ncnn::Mat> inputs(1, ncnn::Mat(7, 5, 16));
+
+        ncnn::ExtractFuture future = async_extractor.submit(input_names, inputs, output_names);
+        if (future.valid())
+        {
+            fprintf(stderr, "test_asyncextractor_1 unknown blob name accepted\n");
+            return -1;
+        }
+    }
+
+    std::vector<int> input_indexes(1, -1);
+    std::vector<int> output_indexes(1, -1);
+    for (size_t i = 0; i < net.blobs().size(); i++)
+    {
+        if (net.blobs()[i].name == "data")
+            input_indexes[0] = (int)i;
+        if (net.blobs()[i].name == "out")
+            output_indexes[0] = (int)i;
+    }
+
+    std::vector<ncnn::ExtractFuture> futures;
+    std::vector<float> values;
+    for (int i = 0; i < 32; i++)
+    {
+        std::vector<ncnn::Mat> inputs(1);
+        inputs[0].create(7, 5, 16);
+        inputs[0].fill((float)i * 0.5f - 4.f);
+
+        ncnn::ExtractFuture future = async_extractor.try_submit(input_indexes, inputs, output_indexes);
+        if (!future.valid())
+        {
+            // full queue, let the workers catch up
+            async_extractor.wait_all();
+            continue;
+        }
+
+        futures.push_back(future);
+        values.push_back((float)i * 0.5f - 4.f);
+    }
+
+    if (futures.empty())
+    {
+        fprintf(stderr, "test_asyncextractor_1 no request queued\n");
+        return -1;
+    }
+
+    for (size_t i = 0; i < futures.size(); i++)
+    {
+        std::vector<ncnn::Mat> outputs;
+        int ret = futures[i].get(outputs);
+
+        const float v = values[i];
+        if (ret != 0 || outputs.size() != 1 || check_output(outputs[0], v + relu(v)) != 0)
+        {
+            fprintf(stderr, "test_asyncextractor_1 request %d failed %d\n", (int)i, ret);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    ncnn::Net net;
+    net.opt.num_threads = 1;
+    if (load_net_mem(net, g_param) != 0)
+    {
+        fprintf(stderr, "load failed\n");
+        return -1;
+    }
+
+    return 0
+           || test_asyncextractor_0(net)
+           || test_asyncextractor_1(net);
+}
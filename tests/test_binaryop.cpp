@@ -366,6 +366,46 @@ static int test_binaryop_6()
     return 0;
 }
 
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+// int8 add, sub, max, min and rsub on same shaped inputs run on the x86 cpu layer only
+static int test_binaryop_int8(const ncnn::Mat& _a, const ncnn::Mat& _b, int _op_type)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, _op_type);
+
+    std::vector<ncnn::Mat> ab(2);
+    ab[0] = _a;
+    ab[1] = _b;
+
+    int ret = test_layer_int8_passthrough("BinaryOp", pd, ab);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_binaryop_int8 failed a=(%d %d %d) op_type=%d\n", _a.w, _a.h, _a.c, _op_type);
+    }
+
+    return ret;
+}
+#endif
+
+static int test_binaryop_7()
+{
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+    const int op_types[5] = {0, 1, 4, 5, 7};
+    for (int i = 0; i < 5; i++)
+    {
+        int ret = 0
+                  || test_binaryop_int8(RandomS8Mat(13, 7, 16), RandomS8Mat(13, 7, 16), op_types[i])
+                  || test_binaryop_int8(RandomS8Mat(5, 3, 3), RandomS8Mat(5, 3, 3), op_types[i])
+                  || test_binaryop_int8(RandomS8Mat(31, 1, 8), RandomS8Mat(31, 1, 8), op_types[i]);
+
+        if (ret != 0)
+            return ret;
+    }
+#endif
+
+    return 0;
+}
+
 int main()
 {
     SRAND(7767517);
@@ -384,5 +424,5 @@ int main()
             return ret;
     }
 
-    return 0;
+    return test_binaryop_7();
 }
@@ -0,0 +1,178 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+static int load_net(ncnn::Net& net, const char* param, const std::vector<float>& weights)
+{
+    net.opt.num_threads = 1;
+    net.opt.use_fp16_packed = false;
+    net.opt.use_fp16_storage = false;
+    net.opt.use_fp16_arithmetic = false;
+    net.opt.use_bf16_storage = false;
+
+    return load_net_mem(net, param, weights);
+}
+
+// append a convolution weight with the raw float32 flag, then bias
+static void append_conv_weights(std::vector<float>& weights, int weight_data_size, int num_output)
+{
+    weights.push_back(0.f);
+    for (int i = 0; i < weight_data_size + num_output; i++)
+    {
+        weights.push_back(RandomFloat(-1.f, 1.f));
+    }
+}
+
+// counts the blob allocations alive
+class CountingAllocator : public ncnn::Allocator
+{
+public:
+    CountingAllocator()
+        : live_count(0)
+    {
+    }
+
+    virtual void* fastMalloc(size_t size)
+    {
+        live_count++;
+        return ncnn::fastMalloc(size);
+    }
+
+    virtual void fastFree(void* ptr)
+    {
+        live_count--;
+        ncnn::fastFree(ptr);
+    }
+
+    int live_count;
+};
+
+static int extract_outputs(ncnn::Net& net, const ncnn::Mat& a, bool lightmode, ncnn::Mat& out, ncnn::Mat& s0)
+{
+    CountingAllocator blob_allocator;
+
+    ncnn::Extractor ex = net.create_extractor();
+    ex.set_light_mode(lightmode);
+    ex.set_blob_allocator(&blob_allocator);
+    ex.input("data", a);
+
+    int ret = ex.extract("out", out);
+    if (ret != 0)
+        return ret;
+
+    // intermediate blobs are only kept without lightmode
+    if (!lightmode)
+        ret = ex.extract("s0", s0);
+
+    if (lightmode)
+    {
+        // only the output blob and its unpacked copy, the sliced blobs are gone
+        const int out_live_count = *out.refcount == 1 ? 2 : 1;
+        if (blob_allocator.live_count != out_live_count)
+        {
+            fprintf(stderr, "extract_outputs %d blobs alive in lightmode\n", blob_allocator.live_count);
+            ret = -1;
+        }
+    }
+
+    // the allocator goes away with the extractor
+    out = out.clone();
+    s0 = s0.clone();
+
+    return ret;
+}
+
+// the first forward learns the layouts, the following ones let the convolutions
+// write into the concat output and the slice outputs view the concat output
+static int test_channelalias_concat_slice(int w, int h, int c, int outch0, int outch1, int slice0)
+{
+    char param[1024];
+    sprintf(param, "7767517\n"
+            "9 12\n"
+            "Input       data   0 1 data\n"
+            "Split       splitd 1 2 data d0 d1\n"
+            "Convolution conv0  1 1 d0 c0 0=%d 1=3 4=1 5=1 6=%d\n"
+            "Convolution conv1  1 1 d1 c1 0=%d 1=1 5=1 6=%d\n"
+            "Concat      cat    2 1 c0 c1 cat 0=0\n"
+            "Slice       slice  1 2 cat s0 s1 -23300=2,%d,-233 1=0\n"
+            "Convolution conv2  1 1 s0 o0 0=16 1=1 5=1 6=%d\n"
+            "Convolution conv3  1 1 s1 o1 0=16 1=1 5=1 6=%d\n"
+            "Concat      out    2 1 o0 o1 out 0=0\n",
+            outch0, outch0 * c * 9, outch1, outch1 * c, slice0, 16 * slice0, 16 * (outch0 + outch1 - slice0));
+
+    std::vector<float> weights;
+    append_conv_weights(weights, outch0 * c * 9, outch0);
+    append_conv_weights(weights, outch1 * c, outch1);
+    append_conv_weights(weights, 16 * slice0, 16);
+    append_conv_weights(weights, 16 * (outch0 + outch1 - slice0), 16);
+
+    ncnn::Mat a = RandomMat(w, h, c);
+    ncnn::Mat b = RandomMat(w / 2 + 1, h / 2 + 1, c);
+
+    // reference from nets forwarding each input for the first time
+    ncnn::Mat out_a_ref;
+    ncnn::Mat s0_a_ref;
+    ncnn::Mat out_b_ref;
+    ncnn::Mat s0_b_ref;
+    {
+        ncnn::Net net_a;
+        ncnn::Net net_b;
+        if (load_net(net_a, param, weights) != 0 || load_net(net_b, param, weights) != 0)
+        {
+            fprintf(stderr, "test_channelalias_concat_slice load failed\n");
+            return -1;
+        }
+
+        if (extract_outputs(net_a, a, false, out_a_ref, s0_a_ref) != 0 || extract_outputs(net_b, b, false, out_b_ref, s0_b_ref) != 0)
+        {
+            fprintf(stderr, "test_channelalias_concat_slice reference extract failed\n");
+            return -1;
+        }
+    }
+
+    ncnn::Net net;
+    if (load_net(net, param, weights) != 0)
+    {
+        fprintf(stderr, "test_channelalias_concat_slice load failed\n");
+        return -1;
+    }
+
+    // the input shape changes in between, which must fall back to copying
+    const int order[6] = {0, 0, 1, 0, 1, 1};
+    for (int i = 0; i < 6; i++)
+    {
+        const bool is_a = order[i] == 0;
+        const bool lightmode = i % 2 == 1;
+
+        ncnn::Mat out;
+        ncnn::Mat s0;
+        if (extract_outputs(net, is_a ? a : b, lightmode, out, s0) != 0)
+        {
+            fprintf(stderr, "test_channelalias_concat_slice extract failed\n");
+            return -1;
+        }
+
+        if (CompareMat(out, is_a ? out_a_ref : out_b_ref, 0.001) != 0 || (!lightmode && CompareMat(s0, is_a ? s0_a_ref : s0_b_ref, 0.001) != 0))
+        {
+            fprintf(stderr, "test_channelalias_concat_slice failed w=%d h=%d c=%d outch0=%d outch1=%d slice0=%d run=%d\n", w, h, c, outch0, outch1, slice0, i);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_channelalias_concat_slice(13, 11, 3, 32, 16, 16)
+           || test_channelalias_concat_slice(8, 8, 8, 16, 16, 16)
+           || test_channelalias_concat_slice(10, 7, 16, 16, 8, 16)
+           || test_channelalias_concat_slice(7, 5, 4, 12, 8, 4)
+           || test_channelalias_concat_slice(9, 6, 5, 3, 5, 2);
+}
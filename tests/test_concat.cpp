@@ -307,6 +307,48 @@ static int test_concat_9()
     return 0;
 }
 
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+// int8 concat runs on the x86 cpu layer only
+static int test_concat_int8(const std::vector<ncnn::Mat>& a, int axis)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, axis);
+
+    int ret = test_layer_int8_passthrough("Concat", pd, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_concat_int8 failed a[0]=(%d %d %d) axis=%d\n", a[0].w, a[0].h, a[0].c, axis);
+    }
+
+    return ret;
+}
+#endif
+
+static int test_concat_10()
+{
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+    std::vector<ncnn::Mat> a(3);
+    a[0] = RandomS8Mat(7, 5, 8);
+    a[1] = RandomS8Mat(7, 5, 3);
+    a[2] = RandomS8Mat(7, 5, 16);
+
+    std::vector<ncnn::Mat> b(2);
+    b[0] = RandomS8Mat(7, 5, 16);
+    b[1] = RandomS8Mat(7, 5, 8);
+
+    std::vector<ncnn::Mat> c(2);
+    c[0] = RandomS8Mat(7, 5, 16);
+    c[1] = RandomS8Mat(7, 3, 16);
+
+    return 0
+           || test_concat_int8(a, 0)
+           || test_concat_int8(b, 0)
+           || test_concat_int8(c, 1);
+#else
+    return 0;
+#endif
+}
+
 int main()
 {
     SRAND(7767517);
@@ -321,5 +363,6 @@ int main()
            || test_concat_6()
            || test_concat_7()
            || test_concat_8()
-           || test_concat_9();
+           || test_concat_9()
+           || test_concat_10();
 }
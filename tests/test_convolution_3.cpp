@@ -128,6 +128,68 @@ static int test_convolution_3()
     return 0;
 }
 
+static ncnn::Mat RandomSparseIndexMat(int groups)
+{
+    // one byte per group of 4, two distinct offsets in bit 0-1 and bit 2-3
+    static const unsigned char offset_pairs[6] = {0x4, 0x8, 0xc, 0x9, 0xd, 0xe};
+
+    ncnn::Mat m(groups, (size_t)1u);
+
+    unsigned char* p = (unsigned char*)m.data;
+    for (int i = 0; i < groups; i++)
+    {
+        p[i] = offset_pairs[RAND() % 6];
+    }
+
+    return m;
+}
+
+static int test_convolution_sparse(int w, int h, int c, int outch, int kernel, int pad, int bias)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);  // num_output
+    pd.set(1, kernel); // kernel_w
+    pd.set(4, pad);    // pad_w
+    pd.set(5, bias);   // bias_term
+    pd.set(6, outch * c * kernel * kernel);
+    pd.set(20, 1); // sparse_format
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 3 : 2);
+    weights[0] = RandomMat(outch * c * kernel * kernel / 2);
+    weights[1] = RandomSparseIndexMat(outch * c * kernel * kernel / 4);
+    if (bias)
+        weights[2] = RandomMat(outch);
+
+    int ret = test_layer("Convolution", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_convolution_sparse failed w=%d h=%d c=%d outch=%d kernel=%d pad=%d bias=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, pad, bias, activation_type, activation_params[0], activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_convolution_4()
+{
+    return 0
+           || test_convolution_sparse(11, 10, 4, 1, 1, 0, 1)
+           || test_convolution_sparse(11, 10, 8, 13, 1, 0, 0)
+           || test_convolution_sparse(7, 5, 12, 16, 1, 1, 1)
+           || test_convolution_sparse(6, 4, 16, 8, 1, 0, 1)
+           || test_convolution_sparse(13, 9, 32, 24, 1, 0, 0)
+           || test_convolution_sparse(2, 1, 64, 12, 1, 0, 1)
+           || test_convolution_sparse(9, 8, 4, 8, 3, 1, 1);
+}
+
 #if NCNN_INT8
 static int test_convolution_int8(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias, bool requant = false)
 {
@@ -434,6 +496,64 @@ static int test_convolution_1_2()
            || test_convolution_int8(19, 17, 31, 32, 5, 2, 2, 0, 1)
            || test_convolution_int8(19, 17, 32, 32, 5, 2, 2, 0, 0);
 }
+static int test_convolution_int8_dynamic(int w, int h, int c, int outch, int kernel, int dilation, int stride, int pad, int bias)
+{
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, kernel);
+    pd.set(2, dilation);
+    pd.set(3, stride);
+    pd.set(4, pad);
+    pd.set(5, bias);
+    pd.set(6, outch * c * kernel * kernel);
+    pd.set(8, 3); // int8_scale_term dynamic
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    // no input scales, they are computed from the input on the fly
+    std::vector<ncnn::Mat> weights(bias ? 3 : 2);
+    weights[0] = RandomMat(outch * c * kernel * kernel);
+
+    ncnn::Mat weight_scales = scales_mat(weights[0], outch, c * kernel * kernel, c * kernel * kernel);
+
+    if (bias)
+    {
+        weights[1] = RandomMat(outch);
+        weights[2] = weight_scales;
+    }
+    else
+    {
+        weights[1] = weight_scales;
+    }
+
+    int flag = TEST_LAYER_DISABLE_GPU_TESTING;
+    int ret = test_layer("Convolution", pd, weights, a, 0.001f, 0, flag);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_convolution_int8_dynamic failed w=%d h=%d c=%d outch=%d kernel=%d dilation=%d stride=%d pad=%d bias=%d act=%d actparams=[%f,%f]\n", w, h, c, outch, kernel, dilation, stride, pad, bias, activation_type, activation_params[0], activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_convolution_1_3()
+{
+    return 0
+           || test_convolution_int8_dynamic(9, 7, 1, 1, 1, 1, 1, 0, 1)
+           || test_convolution_int8_dynamic(9, 7, 3, 4, 3, 1, 1, 1, 0)
+           || test_convolution_int8_dynamic(9, 7, 8, 8, 3, 1, 2, 1, 1)
+           || test_convolution_int8_dynamic(11, 11, 16, 24, 3, 1, 1, 1, 1)
+           || test_convolution_int8_dynamic(13, 9, 15, 16, 1, 1, 1, 0, 0)
+           || test_convolution_int8_dynamic(19, 17, 31, 8, 5, 2, 2, 0, 1)
+           || test_convolution_int8_dynamic(7, 7, 64, 64, 3, 1, 2, 0, 1);
+}
 #endif // NCNN_INT8
 
 int main()
@@ -444,11 +564,14 @@ int main()
     return 0
            || test_convolution_1()
            || test_convolution_1_2()
+           || test_convolution_1_3()
            || test_convolution_2()
-           || test_convolution_3();
+           || test_convolution_3()
+           || test_convolution_4();
 #else
     return 0
            || test_convolution_2()
-           || test_convolution_3();
+           || test_convolution_3()
+           || test_convolution_4();
 #endif
 }
@@ -39,7 +39,7 @@ static int test_convolutiondepthwise(int w, int h, int c, int outch, int kernel,
 
 static int test_convolutiondepthwise_0()
 {
-    static const int kdsp[16][4] = {
+    static const int kdsp[22][4] = {
         {1, 1, 1, 0},
         {1, 1, 2, 0},
         {2, 1, 1, 1},
@@ -56,9 +56,15 @@ static int test_convolutiondepthwise_0()
         {7, 1, 1, 3},
         {7, 1, 2, 3},
         {7, 2, 1, -233},
+        {9, 1, 2, 4},
+        {11, 2, 1, -233},
+        {13, 1, 1, 6},
+        {13, 2, 2, -233},
+        {31, 1, 2, 15},
+        {31, 2, 1, -233},
     };
 
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < 22; i++)
     {
         const int k = kdsp[i][0];
         const int d = kdsp[i][1];
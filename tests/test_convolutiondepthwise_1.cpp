@@ -137,7 +137,7 @@ static int test_convolutiondepthwise_int8(int w, int h, int c, int outch, int ke
 
 static int test_convolutiondepthwise_1()
 {
-    static const int kdsp[16][4] = {
+    static const int kdsp[20][4] = {
         {1, 1, 1, 0},
         {1, 1, 2, 0},
         {2, 1, 1, 1},
@@ -154,9 +154,13 @@ static int test_convolutiondepthwise_1()
         {7, 1, 1, 3},
         {7, 1, 2, 3},
         {7, 2, 1, -233},
+        {13, 1, 1, 6},
+        {13, 2, 2, -233},
+        {31, 1, 2, 15},
+        {31, 2, 1, -233},
     };
 
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < 20; i++)
     {
         const int k = kdsp[i][0];
         const int d = kdsp[i][1];
@@ -182,7 +186,7 @@ static int test_convolutiondepthwise_1()
             return -1;
     }
 
-    for (int i = 0; i < 16; i++)
+    for (int i = 0; i < 20; i++)
     {
         const int k = kdsp[i][0];
         const int d = kdsp[i][1];
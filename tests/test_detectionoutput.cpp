@@ -0,0 +1,201 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include <algorithm>
+
+struct Detection
+{
+    int label;
+    float score;
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    int index;
+};
+
+static bool detection_greater(const Detection& a, const Detection& b)
+{
+    return a.score > b.score || (a.score == b.score && a.index < b.index);
+}
+
+static float iou(const Detection& a, const Detection& b)
+{
+    float inter_w = std::max(std::min(a.x1, b.x1) - std::max(a.x0, b.x0), 0.f);
+    float inter_h = std::max(std::min(a.y1, b.y1) - std::max(a.y0, b.y0), 0.f);
+    float inter_area = inter_w * inter_h;
+    float union_area = (a.x1 - a.x0) * (a.y1 - a.y0) + (b.x1 - b.x0) * (b.y1 - b.y0) - inter_area;
+    return inter_area / union_area;
+}
+
+// caffe-ssd decode, per class sort and nms, then global sort
+static void detectionoutput_reference(const ncnn::Mat& location, const ncnn::Mat& confidence, const ncnn::Mat& priorbox, int num_class, float nms_threshold, int nms_top_k, int keep_top_k, float confidence_threshold, std::vector<Detection>& dets)
+{
+    const int num_prior = priorbox.w / 4;
+
+    std::vector<Detection> all;
+    for (int c = 1; c < num_class; c++)
+    {
+        std::vector<Detection> proposals;
+        for (int i = 0; i < num_prior; i++)
+        {
+            float score = confidence[i * num_class + c];
+            if (score <= confidence_threshold)
+                continue;
+
+            const float* loc = (const float*)location + i * 4;
+            const float* pb = priorbox.row(0) + i * 4;
+            const float* var = priorbox.row(1) + i * 4;
+
+            float pb_w = pb[2] - pb[0];
+            float pb_h = pb[3] - pb[1];
+            float pb_cx = (pb[0] + pb[2]) * 0.5f;
+            float pb_cy = (pb[1] + pb[3]) * 0.5f;
+
+            float cx = var[0] * loc[0] * pb_w + pb_cx;
+            float cy = var[1] * loc[1] * pb_h + pb_cy;
+            float w = expf(var[2] * loc[2]) * pb_w;
+            float h = expf(var[3] * loc[3]) * pb_h;
+
+            Detection d = {c, score, cx - w * 0.5f, cy - h * 0.5f, cx + w * 0.5f, cy + h * 0.5f, i};
+            proposals.push_back(d);
+        }
+
+        std::sort(proposals.begin(), proposals.end(), detection_greater);
+        if ((int)proposals.size() > nms_top_k)
+            proposals.resize(nms_top_k);
+
+        std::vector<Detection> picked;
+        for (size_t i = 0; i < proposals.size(); i++)
+        {
+            bool keep = true;
+            for (size_t j = 0; j < picked.size(); j++)
+            {
+                if (iou(proposals[i], picked[j]) > nms_threshold)
+                    keep = false;
+            }
+
+            if (keep)
+                picked.push_back(proposals[i]);
+        }
+
+        all.insert(all.end(), picked.begin(), picked.end());
+    }
+
+    // ties keep the class order
+    for (size_t i = 0; i < all.size(); i++)
+    {
+        all[i].index = (int)i;
+    }
+
+    std::sort(all.begin(), all.end(), detection_greater);
+    if ((int)all.size() > keep_top_k)
+        all.resize(keep_top_k);
+
+    dets = all;
+}
+
+static int test_detectionoutput(int num_prior, int num_class, float nms_threshold, int nms_top_k, int keep_top_k, float confidence_threshold)
+{
+    std::vector<ncnn::Mat> a(3);
+    a[0] = RandomMat(num_prior * 4, -1.f, 1.f);
+    a[1] = RandomMat(num_prior * num_class, 0.f, 1.f);
+    a[2].create(num_prior * 4, 2);
+
+    // background scores low enough to decode every prior
+    for (int i = 0; i < num_prior; i++)
+    {
+        a[1][i * num_class] = RandomFloat(0.f, 1.f - confidence_threshold - 0.01f);
+    }
+
+    // heavily overlapping priors
+    for (int i = 0; i < num_prior; i++)
+    {
+        float* pb = a[2].row(0) + i * 4;
+        float* var = a[2].row(1) + i * 4;
+
+        float cx = RandomFloat(0.3f, 0.7f);
+        float cy = RandomFloat(0.3f, 0.7f);
+        float w = RandomFloat(0.2f, 0.5f);
+        float h = RandomFloat(0.2f, 0.5f);
+
+        pb[0] = cx - w * 0.5f;
+        pb[1] = cy - h * 0.5f;
+        pb[2] = cx + w * 0.5f;
+        pb[3] = cy + h * 0.5f;
+
+        var[0] = 0.1f;
+        var[1] = 0.1f;
+        var[2] = 0.2f;
+        var[3] = 0.2f;
+    }
+
+    ncnn::ParamDict pd;
+    pd.set(0, num_class);
+    pd.set(1, nms_threshold);
+    pd.set(2, nms_top_k);
+    pd.set(3, keep_top_k);
+    pd.set(4, confidence_threshold);
+
+    ncnn::Layer* op = ncnn::create_layer_cpu("DetectionOutput");
+    op->load_param(pd);
+
+    ncnn::Option opt;
+    opt.num_threads = 2;
+
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> b(1);
+    int ret = op->forward(a, b, opt);
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_detectionoutput forward failed %d\n", ret);
+        return -1;
+    }
+
+    std::vector<Detection> dets;
+    detectionoutput_reference(a[0], a[1], a[2], num_class, nms_threshold, nms_top_k, keep_top_k, confidence_threshold, dets);
+
+    if (dets.empty() || b[0].h != (int)dets.size())
+    {
+        fprintf(stderr, "test_detectionoutput detected %d expect %d num_prior=%d num_class=%d\n", b[0].h, (int)dets.size(), num_prior, num_class);
+        return -1;
+    }
+
+    for (int i = 0; i < b[0].h; i++)
+    {
+        const float* p = b[0].row(i);
+        const Detection& d = dets[i];
+        if ((int)p[0] != d.label || fabsf(p[1] - d.score) > 0.001f || fabsf(p[2] - d.x0) > 0.001f || fabsf(p[3] - d.y0) > 0.001f || fabsf(p[4] - d.x1) > 0.001f || fabsf(p[5] - d.y1) > 0.001f)
+        {
+            fprintf(stderr, "test_detectionoutput detection %d mismatch num_prior=%d num_class=%d\n", i, num_prior, num_class);
+            fprintf(stderr, "  got    %d %f %f %f %f %f\n", (int)p[0], p[1], p[2], p[3], p[4], p[5]);
+            fprintf(stderr, "  expect %d %f %f %f %f %f\n", d.label, d.score, d.x0, d.y0, d.x1, d.y1);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_detectionoutput_0()
+{
+    return 0
+           || test_detectionoutput(200, 5, 0.45f, 100, 50, 0.3f)
+           || test_detectionoutput(64, 21, 0.3f, 300, 100, 0.5f)
+           || test_detectionoutput(500, 3, 0.6f, 40, 20, 0.2f)
+           || test_detectionoutput(17, 2, 0.05f, 300, 100, 0.1f);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return test_detectionoutput_0();
+}
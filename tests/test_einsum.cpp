@@ -149,6 +149,53 @@ static int test_einsum_11()
     return test_einsum(a, "imnj,kmln->ijkl");
 }
 
+static int test_einsum_12()
+{
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomMat(19, 23);
+    a[1] = RandomMat(17, 19);
+    std::vector<ncnn::Mat> b(2);
+    b[0] = RandomMat(19, 23);
+    b[1] = RandomMat(19, 17);
+    std::vector<ncnn::Mat> c(2);
+    c[0] = RandomMat(23, 19);
+    c[1] = RandomMat(17, 23);
+
+    return 0
+           || test_einsum(a, "ik,kj->ij")
+           || test_einsum(b, "ik,jk->ij")
+           || test_einsum(c, "ki,jk->ij");
+}
+
+static int test_einsum_13()
+{
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomMat(16, 13, 4, 2);
+    a[1] = RandomMat(16, 11, 4, 2);
+    std::vector<ncnn::Mat> b(2);
+    b[0] = RandomMat(11, 13, 4, 2);
+    b[1] = RandomMat(16, 11, 4, 2);
+
+    // attention scores and weighted sum
+    return 0
+           || test_einsum(a, "ijkm,ijlm->ijkl")
+           || test_einsum(b, "ijkm,ijml->ijkl");
+}
+
+static int test_einsum_14()
+{
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomMat(12, 5, 3, 2);
+    a[1] = RandomMat(12, 5, 3, 2);
+    std::vector<ncnn::Mat> b(2);
+    b[0] = RandomMat(6, 9, 4);
+    b[1] = RandomMat(8, 6, 4);
+
+    return 0
+           || test_einsum(a, "ijkm,ijkm->ijk")
+           || test_einsum(b, "mki,mlj->ijkl");
+}
+
 int main()
 {
     SRAND(7767517);
@@ -165,5 +212,8 @@ int main()
            || test_einsum_8()
            || test_einsum_9()
            || test_einsum_10()
-           || test_einsum_11();
+           || test_einsum_11()
+           || test_einsum_12()
+           || test_einsum_13()
+           || test_einsum_14();
 }
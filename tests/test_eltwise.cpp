@@ -342,6 +342,57 @@ static int test_eltwise_12()
            || test_eltwise(c, 2, RandomMat(4));
 }
 
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+// int8 sum with unit coefficients and max run on the x86 cpu layer only
+static int test_eltwise_int8(const std::vector<ncnn::Mat>& a, int op_type, const ncnn::Mat& coeffs)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, op_type);
+    pd.set(1, coeffs);
+
+    int ret = test_layer_int8_passthrough("Eltwise", pd, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_eltwise_int8 failed a[0]=(%d %d %d) inputs=%d op_type=%d\n", a[0].w, a[0].h, a[0].c, (int)a.size(), op_type);
+    }
+
+    return ret;
+}
+#endif
+
+static int test_eltwise_13()
+{
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomS8Mat(13, 7, 16);
+    a[1] = RandomS8Mat(13, 7, 16);
+
+    std::vector<ncnn::Mat> b(3);
+    b[0] = RandomS8Mat(5, 3, 3);
+    b[1] = RandomS8Mat(5, 3, 3);
+    b[2] = RandomS8Mat(5, 3, 3);
+
+    std::vector<ncnn::Mat> c(4);
+    c[0] = RandomS8Mat(31, 1, 8);
+    c[1] = RandomS8Mat(31, 1, 8);
+    c[2] = RandomS8Mat(31, 1, 8);
+    c[3] = RandomS8Mat(31, 1, 8);
+
+    ncnn::Mat ones(3);
+    ones.fill(1.f);
+
+    return 0
+           || test_eltwise_int8(a, 1, ncnn::Mat())
+           || test_eltwise_int8(a, 2, ncnn::Mat())
+           || test_eltwise_int8(b, 1, ones)
+           || test_eltwise_int8(b, 2, ncnn::Mat())
+           || test_eltwise_int8(c, 1, ncnn::Mat())
+           || test_eltwise_int8(c, 2, ncnn::Mat());
+#else
+    return 0;
+#endif
+}
+
 int main()
 {
     SRAND(7767517);
@@ -359,5 +410,6 @@ int main()
            || test_eltwise_9()
            || test_eltwise_10()
            || test_eltwise_11()
-           || test_eltwise_12();
+           || test_eltwise_12()
+           || test_eltwise_13();
 }
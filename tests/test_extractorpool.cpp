@@ -0,0 +1,172 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "extractorpool.h"
+#include "net.h"
+#include "platform.h"
+
+static const char* g_param = "7767517\n"
+                             "3 3\n"
+                             "Input   data 0 1 data\n"
+                             "ReLU    relu 1 1 data relu\n"
+                             "Eltwise sum  2 1 data relu out 0=1\n";
+
+struct WorkerContext
+{
+    const ncnn::Net* net;
+    ncnn::ExtractorPool* pool;
+    int seed;
+    int ret;
+};
+
+static int run_once(const ncnn::Net& net, ncnn::ExtractorPool& pool, float v)
+{
+    ncnn::Mat in(7, 5, 16);
+    in.fill(v);
+
+    ncnn::Mat out;
+
+    int worker = pool.acquire();
+    if (worker < 0 || worker >= pool.worker_count())
+    {
+        fprintf(stderr, "acquire returned invalid worker %d\n", worker);
+        return -1;
+    }
+
+    {
+        ncnn::Extractor ex = pool.create_extractor(worker);
+        ex.input("data", in);
+        ex.extract("out", out);
+    }
+
+    pool.release(worker);
+
+    // out = data + relu(data)
+    const float expect = v > 0.f ? v * 2 : v;
+    for (int q = 0; q < out.c; q++)
+    {
+        const float* ptr = out.channel(q);
+        for (int i = 0; i < out.w * out.h; i++)
+        {
+            if (ptr[i] != expect)
+            {
+                fprintf(stderr, "value mismatch %f != %f\n", ptr[i], expect);
+                return -1;
+            }
+        }
+    }
+
+    return 0;
+}
+
+static void* worker_func(void* args)
+{
+    WorkerContext* ctx = (WorkerContext*)args;
+
+    for (int i = 0; i < 20; i++)
+    {
+        const float v = (ctx->seed * 20 + i) % 7 - 3.f;
+        ctx->ret = run_once(*ctx->net, *ctx->pool, v);
+        if (ctx->ret != 0)
+            break;
+    }
+
+    return 0;
+}
+
+static int test_extractorpool_0()
+{
+    ncnn::Net net;
+    net.opt.num_threads = ncnn::ExtractorPool::threads_per_worker(2, 2);
+    if (load_net_mem(net, g_param) != 0)
+    {
+        fprintf(stderr, "test_extractorpool_0 load failed\n");
+        return -1;
+    }
+
+    ncnn::ExtractorPool pool(&net, 2);
+
+    if (pool.worker_count() != 2)
+    {
+        fprintf(stderr, "worker_count %d != 2\n", pool.worker_count());
+        return -1;
+    }
+
+    // try_acquire fails once all workers are busy
+    {
+        int w0 = pool.try_acquire();
+        int w1 = pool.try_acquire();
+        int w2 = pool.try_acquire();
+        if (w0 == -1 || w1 == -1 || w0 == w1 || w2 != -1)
+        {
+            fprintf(stderr, "try_acquire failed %d %d %d\n", w0, w1, w2);
+            return -1;
+        }
+        pool.release(w0);
+        pool.release(w1);
+    }
+
+    // more threads than workers
+    const int thread_count = 4;
+
+    WorkerContext contexts[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        contexts[i].net = &net;
+        contexts[i].pool = &pool;
+        contexts[i].seed = i;
+        contexts[i].ret = 0;
+    }
+
+#if NCNN_THREADS
+    ncnn::Thread* threads[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i] = new ncnn::Thread(worker_func, &contexts[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+#else
+    for (int i = 0; i < thread_count; i++)
+    {
+        worker_func(&contexts[i]);
+    }
+#endif
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (contexts[i].ret != 0)
+        {
+            fprintf(stderr, "test_extractorpool_0 thread %d failed\n", i);
+            return -1;
+        }
+    }
+
+    pool.clear();
+
+    return 0;
+}
+
+static int test_extractorpool_1()
+{
+    if (ncnn::ExtractorPool::threads_per_worker(4, 8) != 2)
+        return -1;
+
+    if (ncnn::ExtractorPool::threads_per_worker(16, 8) != 1)
+        return -1;
+
+    if (ncnn::ExtractorPool::threads_per_worker(3, 8) != 2)
+        return -1;
+
+    return 0;
+}
+
+int main()
+{
+    return test_extractorpool_0() || test_extractorpool_1();
+}
@@ -33,6 +33,9 @@ static int test_flatten_0()
            || test_flatten(RandomMat(9, 10, 16))
            || test_flatten(RandomMat(1, 7, 1))
            || test_flatten(RandomMat(6, 6, 15))
+           || test_flatten(RandomMat(4, 4, 3))
+           || test_flatten(RandomMat(2, 2, 5))
+           || test_flatten(RandomMat(3, 4, 7))
            || test_flatten(RandomMat(13, 13))
            || test_flatten(RandomMat(16, 16))
            || test_flatten(RandomMat(8, 12))
@@ -72,6 +75,7 @@ static int test_flatten_1()
            || test_flatten_int8(RandomS8Mat(9, 10, 64))
            || test_flatten_int8(RandomS8Mat(1, 7, 4))
            || test_flatten_int8(RandomS8Mat(6, 6, 70))
+           || test_flatten_int8(RandomS8Mat(4, 4, 5))
            || test_flatten_int8(RandomS8Mat(13, 52))
            || test_flatten_int8(RandomS8Mat(16, 64))
            || test_flatten_int8(RandomS8Mat(8, 48))
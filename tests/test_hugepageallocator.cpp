@@ -0,0 +1,171 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "allocator.h"
+#include "net.h"
+
+static int check_stats(const ncnn::HugePageAllocator& allocator, size_t allocated_bytes, size_t huge_bytes, const char* when)
+{
+    // without huge page support the large buffers are counted as fallbacks instead
+    const size_t huge_page_bytes = allocator.fallback_count() == 0 ? huge_bytes : 0;
+    if (allocator.allocated_bytes() != allocated_bytes || allocator.huge_page_bytes() != huge_page_bytes)
+    {
+        fprintf(stderr, "allocated %d huge %d expect %d %d %s\n", (int)allocator.allocated_bytes(), (int)allocator.huge_page_bytes(), (int)allocated_bytes, (int)huge_bytes, when);
+        return -1;
+    }
+
+    return 0;
+}
+
+static int test_hugepageallocator_0()
+{
+    ncnn::HugePageAllocator allocator;
+    allocator.set_size_drop_threshold(2);
+
+    const size_t large_size = 3 * 1024 * 1024 + 100;
+    const size_t small_size = 1000;
+
+    unsigned char* large = (unsigned char*)allocator.fastMalloc(large_size);
+    unsigned char* small = (unsigned char*)allocator.fastMalloc(small_size);
+    if (!large || !small || (size_t)large % NCNN_MALLOC_ALIGN != 0 || (size_t)small % NCNN_MALLOC_ALIGN != 0)
+    {
+        fprintf(stderr, "test_hugepageallocator_0 bad buffers %p %p\n", large, small);
+        return -1;
+    }
+
+    // the whole buffer and the overread tail are writable
+    memset(large, 1, large_size + NCNN_MALLOC_OVERREAD);
+    memset(small, 2, small_size + NCNN_MALLOC_OVERREAD);
+
+    if (check_stats(allocator, large_size + small_size, large_size, "after malloc") != 0)
+        return -1;
+
+    allocator.fastFree(small);
+    allocator.fastFree(large);
+
+    if (check_stats(allocator, 0, 0, "after free") != 0)
+        return -1;
+
+    if (allocator.peak_allocated_bytes() != large_size + small_size)
+    {
+        fprintf(stderr, "test_hugepageallocator_0 peak %d\n", (int)allocator.peak_allocated_bytes());
+        return -1;
+    }
+
+#if defined __ANDROID__ || defined __linux__
+    // the kept mapping is reused
+    unsigned char* large2 = (unsigned char*)allocator.fastMalloc(large_size - 4096);
+    if (large2 != large)
+    {
+        fprintf(stderr, "test_hugepageallocator_0 kept mapping not reused\n");
+        return -1;
+    }
+
+    allocator.fastFree(large2);
+#endif
+
+    allocator.clear();
+
+    return 0;
+}
+
+// a large classifier whose weights come from the huge page allocator
+static const char* g_param = "7767517\n"
+                             "3 3\n"
+                             "Input        data 0 1 data\n"
+                             "InnerProduct fc0  1 1 data fc0 0=1024 1=1 2=1048576 9=1\n"
+                             "InnerProduct fc1  1 1 fc0 out 0=16 1=1 2=16384\n";
+
+static int load_net(ncnn::Net& net, const std::vector<float>& weights, ncnn::Allocator* weight_allocator)
+{
+    net.opt.num_threads = 1;
+    // keep the loaded weights after create_pipeline
+    net.opt.lightmode = false;
+    net.set_weight_allocator(weight_allocator);
+
+    return load_net_mem(net, g_param, weights);
+}
+
+static int test_hugepageallocator_1()
+{
+    std::vector<float> weights;
+    const int weight_sizes[2] = {1048576, 16384};
+    const int bias_sizes[2] = {1024, 16};
+    for (int i = 0; i < 2; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-0.05f, 0.05f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+
+    ncnn::Mat in = RandomMat(1024);
+
+    ncnn::Mat out_ref;
+    {
+        ncnn::Net net;
+        if (load_net(net, weights, 0) != 0)
+            return -1;
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", in);
+        ex.extract("out", out_ref);
+    }
+
+    ncnn::HugePageAllocator weight_allocator;
+    {
+        ncnn::Net net;
+        if (load_net(net, weights, &weight_allocator) != 0)
+            return -1;
+
+        // the fc0 weight at least
+        if (weight_allocator.allocated_bytes() < 1048576 * sizeof(float))
+        {
+            fprintf(stderr, "test_hugepageallocator_1 weights allocated %d\n", (int)weight_allocator.allocated_bytes());
+            return -1;
+        }
+
+        ncnn::Mat out;
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", in);
+        ex.extract("out", out);
+
+        if (CompareMat(out, out_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_hugepageallocator_1 output mismatch\n");
+            return -1;
+        }
+
+        // inference blobs do not go through the weight allocator
+        if (out.allocator == &weight_allocator)
+        {
+            fprintf(stderr, "test_hugepageallocator_1 output from weight allocator\n");
+            return -1;
+        }
+    }
+
+    if (weight_allocator.allocated_bytes() != 0)
+    {
+        fprintf(stderr, "test_hugepageallocator_1 %d bytes left after net destroyed\n", (int)weight_allocator.allocated_bytes());
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_hugepageallocator_0()
+           || test_hugepageallocator_1();
+}
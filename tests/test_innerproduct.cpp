@@ -194,6 +194,68 @@ static int test_innerproduct_4()
            || test_innerproduct_gemm(RandomMat(18, 14), 32, 1);
 }
 
+static ncnn::Mat RandomSparseIndexMat(int groups)
+{
+    // one byte per group of 4, two distinct offsets in bit 0-1 and bit 2-3
+    static const unsigned char offset_pairs[6] = {0x4, 0x8, 0xc, 0x9, 0xd, 0xe};
+
+    ncnn::Mat m(groups, (size_t)1u);
+
+    unsigned char* p = (unsigned char*)m.data;
+    for (int i = 0; i < groups; i++)
+    {
+        p[i] = offset_pairs[RAND() % 6];
+    }
+
+    return m;
+}
+
+static int test_innerproduct_sparse(const ncnn::Mat& a, int outch, int bias, bool gemm)
+{
+    const int num_input = gemm ? a.w : a.w * a.h * a.c;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch); // num_output
+    pd.set(1, bias);  // bias_term
+    pd.set(2, outch * num_input);
+    pd.set(11, 1); // sparse_format
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    std::vector<ncnn::Mat> weights(bias ? 3 : 2);
+    weights[0] = RandomMat(outch * num_input / 2);
+    weights[1] = RandomSparseIndexMat(outch * num_input / 4);
+    if (bias)
+        weights[2] = RandomMat(outch);
+
+    int ret = test_layer("InnerProduct", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_innerproduct_sparse failed a.dims=%d a=(%d %d %d) outch=%d bias=%d gemm=%d act=%d actparams=[%f,%f]\n", a.dims, a.w, a.h, a.c, outch, bias, gemm, activation_type, activation_params[0], activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_innerproduct_7()
+{
+    return 0
+           || test_innerproduct_sparse(RandomMat(4), 1, 1, false)
+           || test_innerproduct_sparse(RandomMat(12), 7, 0, false)
+           || test_innerproduct_sparse(RandomMat(32), 16, 1, false)
+           || test_innerproduct_sparse(RandomMat(100), 12, 1, false)
+           || test_innerproduct_sparse(RandomMat(3, 2, 8), 8, 0, false)
+           || test_innerproduct_sparse(RandomMat(5, 4, 16), 15, 1, false)
+           || test_innerproduct_sparse(RandomMat(12, 1), 5, 1, true)
+           || test_innerproduct_sparse(RandomMat(36, 7), 16, 0, true)
+           || test_innerproduct_sparse(RandomMat(64, 16), 24, 1, true);
+}
+
 #if NCNN_INT8
 static int test_innerproduct_gemm_int8(const ncnn::Mat& a, int outch, int bias)
 {
@@ -244,6 +306,70 @@ static int test_innerproduct_5()
            || test_innerproduct_gemm_int8(RandomMat(6, 16), 16, 0)
            || test_innerproduct_gemm_int8(RandomMat(12, 16), 7, 1);
 }
+static int test_innerproduct_int8_dynamic(const ncnn::Mat& a, int outch, int bias)
+{
+    const int k = a.dims == 2 ? a.w : a.w * a.h * a.c;
+
+    ncnn::ParamDict pd;
+    pd.set(0, outch);
+    pd.set(1, bias);
+    pd.set(2, outch * k);
+    pd.set(8, 3); // int8_scale_term dynamic
+
+    int activation_type = RAND() % 7; // 0 1 2 3 4 5 6
+    ncnn::Mat activation_params(2);
+    activation_params[0] = (activation_type == 6) ? RandomFloat(0, 1) : RandomFloat(-1, 0); // alpha
+    activation_params[1] = RandomFloat(0, 1);                                               // beta
+    pd.set(9, activation_type);
+    pd.set(10, activation_params);
+
+    // no input scales, they are computed per row in gemm and per blob otherwise
+    std::vector<ncnn::Mat> weights(bias ? 3 : 2);
+    weights[0] = RandomMat(outch * k);
+    ncnn::Mat weight_scales = scales_mat(weights[0], outch, k, k);
+
+    if (bias)
+    {
+        weights[1] = RandomMat(outch);
+        weights[2] = weight_scales;
+    }
+    else
+    {
+        weights[1] = weight_scales;
+    }
+
+    int flag = TEST_LAYER_DISABLE_GPU_TESTING;
+    int ret = test_layer("InnerProduct", pd, weights, a, 0.001f, 0, flag);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_innerproduct_int8_dynamic failed a.dims=%d a=(%d %d %d) outch=%d bias=%d act=%d actparams=[%f,%f]\n", a.dims, a.w, a.h, a.c, outch, bias, activation_type, activation_params[0], activation_params[1]);
+    }
+
+    return ret;
+}
+
+static int test_innerproduct_6()
+{
+    ncnn::Mat b = RandomMat(12, 16);
+    for (int i = 0; i < 12; i++)
+    {
+        // rows of very different ranges
+        b.row(3)[i] *= 100.f;
+        b.row(9)[i] *= 0.01f;
+    }
+
+    return 0
+           || test_innerproduct_int8_dynamic(RandomMat(3, 2, 2), 2, 1)
+           || test_innerproduct_int8_dynamic(RandomMat(7, 2, 3), 12, 0)
+           || test_innerproduct_int8_dynamic(RandomMat(6, 3, 16), 16, 1)
+           || test_innerproduct_int8_dynamic(RandomMat(1, 5), 1, 1)
+           || test_innerproduct_int8_dynamic(RandomMat(9, 8), 7, 1)
+           || test_innerproduct_int8_dynamic(RandomMat(13, 12), 8, 0)
+           || test_innerproduct_int8_dynamic(RandomMat(4, 15), 8, 1)
+           || test_innerproduct_int8_dynamic(RandomMat(6, 16), 16, 0)
+           || test_innerproduct_int8_dynamic(b, 16, 1)
+           || test_innerproduct_int8_dynamic(b, 7, 0);
+}
 #endif // NCNN_INT8
 
 int main()
@@ -257,12 +383,15 @@ int main()
            || test_innerproduct_2()
            || test_innerproduct_3()
            || test_innerproduct_4()
-           || test_innerproduct_5();
+           || test_innerproduct_5()
+           || test_innerproduct_6()
+           || test_innerproduct_7();
 #else
     return 0
            || test_innerproduct_0()
            || test_innerproduct_1()
            || test_innerproduct_2()
-           || test_innerproduct_4();
+           || test_innerproduct_4()
+           || test_innerproduct_7();
 #endif
 }
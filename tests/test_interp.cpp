@@ -496,6 +496,43 @@ static int test_interp_6()
            || test_interp_ref(c, 1, 14, 17);
 }
 
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+// int8 nearest interp runs on the x86 cpu layer only
+static int test_interp_int8(const ncnn::Mat& a, float height_scale, float width_scale, int output_height, int output_width)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, 1); // nearest
+    pd.set(1, height_scale);
+    pd.set(2, width_scale);
+    pd.set(3, output_height);
+    pd.set(4, output_width);
+
+    std::vector<ncnn::Mat> as(1);
+    as[0] = a;
+
+    int ret = test_layer_int8_passthrough("Interp", pd, as);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_interp_int8 failed a=(%d %d %d) height_scale=%f width_scale=%f output_height=%d output_width=%d\n", a.w, a.h, a.c, height_scale, width_scale, output_height, output_width);
+    }
+
+    return ret;
+}
+#endif
+
+static int test_interp_7()
+{
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+    return 0
+           || test_interp_int8(RandomS8Mat(5, 7, 16), 2.f, 2.f, 0, 0)
+           || test_interp_int8(RandomS8Mat(6, 4, 3), 2.f, 3.f, 0, 0)
+           || test_interp_int8(RandomS8Mat(9, 8, 8), 1.f, 1.f, 5, 13)
+           || test_interp_int8(RandomS8Mat(4, 4, 24), 1.f, 1.f, 4, 4);
+#else
+    return 0;
+#endif
+}
+
 int main()
 {
     SRAND(7767517);
@@ -507,5 +544,6 @@ int main()
            || test_interp_3()
            || test_interp_4()
            || test_interp_5()
-           || test_interp_6();
+           || test_interp_6()
+           || test_interp_7();
 }
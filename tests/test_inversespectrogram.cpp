@@ -37,9 +37,18 @@ static int test_inversespectrogram_0()
            || test_inversespectrogram(124, 28, 55, 2, 12, 55, 1, 1, 2);
 }
 
+static int test_inversespectrogram_1()
+{
+    return 0
+           || test_inversespectrogram(20, 257, 512, 1, 128, 512, 1, 1, 0)
+           || test_inversespectrogram(23, 400, 400, 0, 100, 300, 2, 0, 1)
+           || test_inversespectrogram(17, 33, 64, 2, 16, 64, 1, 1, 2)
+           || test_inversespectrogram(9, 24, 24, 1, 6, 20, 0, 0, 0);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_inversespectrogram_0();
+    return test_inversespectrogram_0() || test_inversespectrogram_1();
 }
@@ -0,0 +1,108 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+static int load_net(ncnn::Net& net, const char* param, const std::vector<float>& weights)
+{
+    net.opt.num_threads = 1;
+    net.opt.use_fp16_packed = false;
+    net.opt.use_fp16_storage = false;
+    net.opt.use_fp16_arithmetic = false;
+    net.opt.use_bf16_storage = false;
+
+    return load_net_mem(net, param, weights);
+}
+
+// the packed convolution output feeds two layers without packing support
+// the unpacking is planned in front of the split and runs once
+static int test_layoutplan_split(int w, int h, int c, int outch)
+{
+    char param_split[512];
+    sprintf(param_split, "7767517\n"
+            "5 6\n"
+            "Input       data   0 1 data\n"
+            "Convolution conv   1 1 data conv 0=%d 1=3 4=1 5=1 6=%d\n"
+            "Split       split  1 2 conv conv_0 conv_1\n"
+            "Threshold   t0     1 1 conv_0 out0 0=0.1\n"
+            "Threshold   t1     1 1 conv_1 out1 0=0.2\n",
+            outch, outch * c * 9);
+
+    char param_single[512];
+    sprintf(param_single, "7767517\n"
+            "3 3\n"
+            "Input       data   0 1 data\n"
+            "Convolution conv   1 1 data conv 0=%d 1=3 4=1 5=1 6=%d\n"
+            "Threshold   t0     1 1 conv out0 0=0.1\n",
+            outch, outch * c * 9);
+
+    // weight with the raw float32 flag, then bias
+    std::vector<float> weights(1 + outch * c * 9 + outch);
+    memset(&weights[0], 0, sizeof(float));
+    for (size_t i = 1; i < weights.size(); i++)
+    {
+        weights[i] = RandomFloat(-1.f, 1.f);
+    }
+
+    ncnn::Net net_split;
+    ncnn::Net net_single;
+    if (load_net(net_split, param_split, weights) != 0 || load_net(net_single, param_single, weights) != 0)
+    {
+        fprintf(stderr, "test_layoutplan_split load failed\n");
+        return -1;
+    }
+
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::Mat out0_split;
+    ncnn::Mat out1_split;
+    size_t conversion_bytes_split = 0;
+    {
+        ncnn::Extractor ex = net_split.create_extractor();
+        ex.input("data", a);
+        ex.extract("out0", out0_split);
+        ex.extract("out1", out1_split);
+        conversion_bytes_split = ex.conversion_bytes();
+    }
+
+    ncnn::Mat out0_single;
+    size_t conversion_bytes_single = 0;
+    {
+        ncnn::Extractor ex = net_single.create_extractor();
+        ex.input("data", a);
+        ex.extract("out0", out0_single);
+        conversion_bytes_single = ex.conversion_bytes();
+    }
+
+    if (CompareMat(out0_split, out0_single, 0.001) != 0)
+    {
+        fprintf(stderr, "test_layoutplan_split output mismatch w=%d h=%d c=%d outch=%d\n", w, h, c, outch);
+        return -1;
+    }
+
+    if (out1_split.w != out0_split.w || out1_split.h != out0_split.h || out1_split.c != out0_split.c)
+    {
+        fprintf(stderr, "test_layoutplan_split output shape mismatch w=%d h=%d c=%d outch=%d\n", w, h, c, outch);
+        return -1;
+    }
+
+    if (conversion_bytes_split != conversion_bytes_single)
+    {
+        fprintf(stderr, "test_layoutplan_split conversion bytes %lu expect %lu w=%d h=%d c=%d outch=%d\n", (unsigned long)conversion_bytes_split, (unsigned long)conversion_bytes_single, w, h, c, outch);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_layoutplan_split(13, 11, 3, 16)
+           || test_layoutplan_split(8, 8, 8, 32)
+           || test_layoutplan_split(7, 5, 4, 12);
+}
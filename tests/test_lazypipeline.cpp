@@ -0,0 +1,266 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+#include "platform.h"
+
+// live pipelines of each head
+static int g_pipeline_count[2] = {0, 0};
+
+// passthrough layer counting its create_pipeline and destroy_pipeline calls
+class PipelineCounter : public ncnn::Layer
+{
+public:
+    PipelineCounter()
+    {
+        one_blob_only = true;
+        support_inplace = true;
+    }
+
+    virtual int load_param(const ncnn::ParamDict& pd)
+    {
+        head = pd.get(0, 0);
+        return 0;
+    }
+
+    virtual int create_pipeline(const ncnn::Option& /*opt*/)
+    {
+        g_pipeline_count[head]++;
+        return 0;
+    }
+
+    virtual int destroy_pipeline(const ncnn::Option& /*opt*/)
+    {
+        g_pipeline_count[head]--;
+        return 0;
+    }
+
+    virtual int forward_inplace(ncnn::Mat& /*bottom_top_blob*/, const ncnn::Option& /*opt*/) const
+    {
+        return 0;
+    }
+
+public:
+    int head;
+};
+
+DEFINE_LAYER_CREATOR(PipelineCounter)
+
+// a shared trunk and two heads
+static const char* g_param = "7767517\n"
+                             "7 8\n"
+                             "Input           data   0 1 data\n"
+                             "Convolution     conv0  1 1 data conv0 0=16 1=3 4=1 5=1 6=432 9=1\n"
+                             "Split           split  1 2 conv0 conv0_0 conv0_1\n"
+                             "PipelineCounter counta 1 1 conv0_0 a 0=0\n"
+                             "Convolution     conva  1 1 a outa 0=8 1=3 4=1 5=1 6=1152\n"
+                             "PipelineCounter countb 1 1 conv0_1 b 0=1\n"
+                             "Convolution     convb  1 1 b outb 0=4 1=1 5=1 6=64\n";
+
+static std::vector<float> g_weights;
+
+static void generate_weights()
+{
+    const int weight_sizes[3] = {432, 1152, 64};
+    const int bias_sizes[3] = {16, 8, 4};
+
+    g_weights.clear();
+    for (int i = 0; i < 3; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        g_weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            g_weights.push_back(RandomFloat(-0.2f, 0.2f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            g_weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+}
+
+static int load_net(ncnn::Net& net, bool lazy)
+{
+    net.opt.num_threads = 2;
+    net.opt.use_lazy_create_pipeline = lazy;
+
+    net.register_custom_layer("PipelineCounter", PipelineCounter_layer_creator);
+
+    return load_net_mem(net, g_param, g_weights);
+}
+
+static int extract(const ncnn::Net& net, const ncnn::Mat& in, const char* name, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract(name, out);
+}
+
+static int check_pipeline_count(int a, int b, const char* when)
+{
+    if (g_pipeline_count[0] != a || g_pipeline_count[1] != b)
+    {
+        fprintf(stderr, "pipeline count %d %d expect %d %d %s\n", g_pipeline_count[0], g_pipeline_count[1], a, b, when);
+        return -1;
+    }
+
+    return 0;
+}
+
+// the unused head is never prepared
+static int test_lazypipeline_0()
+{
+    ncnn::Mat in = RandomMat(12, 10, 3);
+
+    ncnn::Mat outa_ref;
+    ncnn::Mat outb_ref;
+    {
+        ncnn::Net net;
+        if (load_net(net, false) != 0)
+            return -1;
+
+        if (check_pipeline_count(1, 1, "after eager load") != 0)
+            return -1;
+
+        extract(net, in, "outa", outa_ref);
+        extract(net, in, "outb", outb_ref);
+    }
+
+    if (check_pipeline_count(0, 0, "after eager clear") != 0)
+        return -1;
+
+    {
+        ncnn::Net net;
+        if (load_net(net, true) != 0)
+            return -1;
+
+        if (check_pipeline_count(0, 0, "after lazy load") != 0)
+            return -1;
+
+        ncnn::Mat outa;
+        if (extract(net, in, "outa", outa) != 0 || CompareMat(outa, outa_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_lazypipeline_0 outa mismatch\n");
+            return -1;
+        }
+
+        if (check_pipeline_count(1, 0, "after extract outa") != 0)
+            return -1;
+
+        ncnn::Mat outb;
+        if (extract(net, in, "outb", outb) != 0 || CompareMat(outb, outb_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_lazypipeline_0 outb mismatch\n");
+            return -1;
+        }
+
+        if (check_pipeline_count(1, 1, "after extract outb") != 0)
+            return -1;
+
+        extract(net, in, "outa", outa);
+        extract(net, in, "outb", outb);
+
+        if (check_pipeline_count(1, 1, "after extract again") != 0)
+            return -1;
+    }
+
+    // only the prepared layers are destroyed
+    {
+        ncnn::Net net;
+        if (load_net(net, true) != 0)
+            return -1;
+
+        ncnn::Mat outb;
+        extract(net, in, "outb", outb);
+    }
+
+    return check_pipeline_count(0, 0, "after lazy clear");
+}
+
+struct WorkerContext
+{
+    const ncnn::Net* net;
+    ncnn::Mat in;
+    ncnn::Mat out;
+    int ret;
+};
+
+static void* worker_func(void* args)
+{
+    WorkerContext* ctx = (WorkerContext*)args;
+    ctx->ret = extract(*ctx->net, ctx->in, "outb", ctx->out);
+    return 0;
+}
+
+// extractors on several threads reach the same lazy layers at once
+static int test_lazypipeline_1()
+{
+    ncnn::Mat in = RandomMat(9, 7, 3);
+
+    ncnn::Mat outb_ref;
+    {
+        ncnn::Net net;
+        if (load_net(net, false) != 0)
+            return -1;
+
+        extract(net, in, "outb", outb_ref);
+    }
+
+    ncnn::Net net;
+    if (load_net(net, true) != 0)
+        return -1;
+
+    const int thread_count = 4;
+
+    WorkerContext contexts[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        contexts[i].net = &net;
+        contexts[i].in = in;
+        contexts[i].ret = 0;
+    }
+
+#if NCNN_THREADS
+    ncnn::Thread* threads[thread_count];
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i] = new ncnn::Thread(worker_func, &contexts[i]);
+    }
+    for (int i = 0; i < thread_count; i++)
+    {
+        threads[i]->join();
+        delete threads[i];
+    }
+#else
+    for (int i = 0; i < thread_count; i++)
+    {
+        worker_func(&contexts[i]);
+    }
+#endif
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        if (contexts[i].ret != 0 || CompareMat(contexts[i].out, outb_ref, 0.001) != 0)
+        {
+            fprintf(stderr, "test_lazypipeline_1 thread %d mismatch\n", i);
+            return -1;
+        }
+    }
+
+    return check_pipeline_count(0, 1, "after threaded extract outb");
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    generate_weights();
+
+    return 0
+           || test_lazypipeline_0()
+           || test_lazypipeline_1()
+           || check_pipeline_count(0, 0, "at exit");
+}
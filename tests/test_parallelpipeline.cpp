@@ -0,0 +1,108 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+static int load_net(ncnn::Net& net, const char* param, const std::vector<float>& weights, int num_threads, bool parallel)
+{
+    net.opt.num_threads = num_threads;
+    net.opt.use_parallel_create_pipeline = parallel;
+    net.opt.use_fp16_packed = false;
+    net.opt.use_fp16_storage = false;
+    net.opt.use_fp16_arithmetic = false;
+    net.opt.use_bf16_storage = false;
+
+    return load_net_mem(net, param, weights);
+}
+
+// append a weight with the raw float32 flag, then the bias
+static void append_weights(std::vector<float>& weights, int weight_size, int bias_size)
+{
+    weights.push_back(0.f);
+    for (int i = 0; i < weight_size; i++)
+    {
+        weights.push_back(RandomFloat(-0.2f, 0.2f));
+    }
+    for (int i = 0; i < bias_size; i++)
+    {
+        weights.push_back(RandomFloat(-1.f, 1.f));
+    }
+}
+
+// winograd, sgemm, depthwise and innerproduct pipelines prepared concurrently
+// must produce the same output as the serial load
+static int test_parallelpipeline(int w, int h, int c, int outch, int num_threads)
+{
+    const int outw = (w + 1) / 2;
+    const int outh = (h + 1) / 2;
+
+    char param[1024];
+    sprintf(param, "7767517\n"
+            "7 7\n"
+            "Input                data   0 1 data\n"
+            "Convolution          conv0  1 1 data conv0 0=%d 1=3 4=1 5=1 6=%d 9=1\n"
+            "Convolution          conv1  1 1 conv0 conv1 0=%d 1=1 5=1 6=%d\n"
+            "ConvolutionDepthWise dw     1 1 conv1 dw 0=%d 1=3 4=1 5=1 6=%d 7=%d\n"
+            "Convolution          conv2  1 1 dw conv2 0=%d 1=3 3=2 4=1 5=1 6=%d 9=1\n"
+            "Convolution          conv3  1 1 conv2 conv3 0=%d 1=3 4=1 5=1 6=%d\n"
+            "InnerProduct         fc     1 1 conv3 out 0=10 1=1 2=%d\n",
+            outch, outch * c * 9,
+            outch * 2, outch * 2 * outch,
+            outch * 2, outch * 2 * 9, outch * 2,
+            outch, outch * outch * 2 * 9,
+            outch, outch * outch * 9,
+            10 * outch * outw * outh);
+
+    std::vector<float> weights;
+    append_weights(weights, outch * c * 9, outch);
+    append_weights(weights, outch * 2 * outch, outch * 2);
+    append_weights(weights, outch * 2 * 9, outch * 2);
+    append_weights(weights, outch * outch * 2 * 9, outch);
+    append_weights(weights, outch * outch * 9, outch);
+    append_weights(weights, 10 * outch * outw * outh, 10);
+
+    ncnn::Net net_serial;
+    ncnn::Net net_parallel;
+    if (load_net(net_serial, param, weights, num_threads, false) != 0 || load_net(net_parallel, param, weights, num_threads, true) != 0)
+    {
+        fprintf(stderr, "test_parallelpipeline load failed\n");
+        return -1;
+    }
+
+    ncnn::Mat a = RandomMat(w, h, c);
+
+    ncnn::Mat out_serial;
+    {
+        ncnn::Extractor ex = net_serial.create_extractor();
+        ex.input("data", a);
+        ex.extract("out", out_serial);
+    }
+
+    ncnn::Mat out_parallel;
+    {
+        ncnn::Extractor ex = net_parallel.create_extractor();
+        ex.input("data", a);
+        ex.extract("out", out_parallel);
+    }
+
+    if (out_serial.empty() || CompareMat(out_serial, out_parallel, 0.001) != 0)
+    {
+        fprintf(stderr, "test_parallelpipeline output mismatch w=%d h=%d c=%d outch=%d num_threads=%d\n", w, h, c, outch, num_threads);
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_parallelpipeline(16, 16, 3, 16, 4)
+           || test_parallelpipeline(13, 11, 8, 32, 2)
+           || test_parallelpipeline(9, 7, 4, 24, 1)
+           || test_parallelpipeline(20, 18, 16, 64, 8);
+}
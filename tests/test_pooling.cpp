@@ -242,6 +242,44 @@ static int test_pooling_4()
            || test_pooling(13, 11, 16, 0, 1, 1, 0, 0, 0, 1, 0, 12);
 }
 
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+// int8 max pooling runs on the x86 cpu layer only
+static int test_pooling_int8(const ncnn::Mat& a, int kernel, int stride, int pad, int global_pooling)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, 0); // max
+    pd.set(1, kernel);
+    pd.set(2, stride);
+    pd.set(3, pad);
+    pd.set(4, global_pooling);
+
+    std::vector<ncnn::Mat> as(1);
+    as[0] = a;
+
+    int ret = test_layer_int8_passthrough("Pooling", pd, as);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_pooling_int8 failed a=(%d %d %d) kernel=%d stride=%d pad=%d global_pooling=%d\n", a.w, a.h, a.c, kernel, stride, pad, global_pooling);
+    }
+
+    return ret;
+}
+#endif
+
+static int test_pooling_5()
+{
+#if NCNN_INT8 && (defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64))
+    return 0
+           || test_pooling_int8(RandomS8Mat(13, 11, 16), 3, 2, 1, 0)
+           || test_pooling_int8(RandomS8Mat(8, 9, 3), 2, 2, 0, 0)
+           || test_pooling_int8(RandomS8Mat(7, 7, 24), 3, 1, 1, 0)
+           || test_pooling_int8(RandomS8Mat(5, 6, 32), 1, 1, 0, 1)
+           || test_pooling_int8(RandomS8Mat(9, 4, 5), 1, 1, 0, 1);
+#else
+    return 0;
+#endif
+}
+
 int main()
 {
     SRAND(7767517);
@@ -251,5 +289,6 @@ int main()
            || test_pooling_1()
            || test_pooling_2()
            || test_pooling_3()
-           || test_pooling_4();
+           || test_pooling_4()
+           || test_pooling_5();
 }
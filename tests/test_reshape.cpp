@@ -207,6 +207,28 @@ static int test_reshape_9()
     return test_reshape(a, 19, 15, -233, 18);
 }
 
+static int test_reshape_10()
+{
+    ncnn::Mat a = RandomMat(7, 9, 32);
+    ncnn::Mat b = RandomMat(3, 5, 2, 16);
+    ncnn::Mat c = RandomMat(12, 48);
+    ncnn::Mat d = RandomMat(10, 24);
+    ncnn::Mat e = RandomMat(8, 5);
+    ncnn::Mat f = RandomMat(4, 2, 6);
+
+    return 0
+           || test_reshape(a, 63, 32, -233, -233)
+           || test_reshape(a, -1, 0, -233, -233)
+           || test_reshape(b, 30, 16, -233, -233)
+           || test_reshape(c, 3, 4, -233, 48)
+           || test_reshape(c, 2, 3, 2, 48)
+           || test_reshape(d, 5, 2, -233, 24)
+           || test_reshape(d, 5, -1, -233, 0)
+           || test_reshape(e, 2, 4, -233, 5)
+           || test_reshape(f, 4, 4, -233, 3)
+           || test_reshape(f, 2, 2, 4, 3);
+}
+
 int main()
 {
     SRAND(7767517);
@@ -221,5 +243,6 @@ int main()
            || test_reshape_6()
            || test_reshape_7()
            || test_reshape_8()
-           || test_reshape_9();
+           || test_reshape_9()
+           || test_reshape_10();
 }
@@ -0,0 +1,241 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+// live instances and pipelines of the custom layer
+static int g_layer_count = 0;
+static int g_pipeline_count = 0;
+
+// passthrough layer counting its lifetime
+class LifetimeCounter : public ncnn::Layer
+{
+public:
+    LifetimeCounter()
+    {
+        one_blob_only = true;
+        support_inplace = true;
+        g_layer_count++;
+    }
+
+    ~LifetimeCounter()
+    {
+        g_layer_count--;
+    }
+
+    virtual int create_pipeline(const ncnn::Option& /*opt*/)
+    {
+        g_pipeline_count++;
+        return 0;
+    }
+
+    virtual int destroy_pipeline(const ncnn::Option& /*opt*/)
+    {
+        g_pipeline_count--;
+        return 0;
+    }
+
+    virtual int forward_inplace(ncnn::Mat& /*bottom_top_blob*/, const ncnn::Option& /*opt*/) const
+    {
+        return 0;
+    }
+};
+
+DEFINE_LAYER_CREATOR(LifetimeCounter)
+
+static const char* g_param = "7767517\n"
+                             "5 5\n"
+                             "Input           data   0 1 data\n"
+                             "Convolution     conv0  1 1 data conv0 0=16 1=3 4=1 5=1 6=432 9=1\n"
+                             "LifetimeCounter count  1 1 conv0 count\n"
+                             "Convolution     conv1  1 1 count conv1 0=24 1=1 5=1 6=384 9=1\n"
+                             "InnerProduct    fc     1 1 conv1 out 0=10 1=1 2=%d\n";
+
+static int load_net(ncnn::Net& net, bool lazy, int w, int h)
+{
+    char param[1024];
+    sprintf(param, g_param, 10 * 24 * w * h);
+
+    std::vector<float> weights;
+    const int weight_sizes[3] = {432, 384, 10 * 24 * w * h};
+    const int bias_sizes[3] = {16, 24, 10};
+    for (int i = 0; i < 3; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-0.2f, 0.2f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+
+    net.opt.num_threads = 4;
+    net.opt.use_lazy_create_pipeline = lazy;
+
+    net.register_custom_layer("LifetimeCounter", LifetimeCounter_layer_creator);
+
+    return load_net_mem(net, param, weights);
+}
+
+static int extract(const ncnn::Net& net, const ncnn::Mat& in, ncnn::Mat& out)
+{
+    ncnn::Extractor ex = net.create_extractor();
+    ex.input("data", in);
+    return ex.extract("out", out);
+}
+
+static int check_count(int layer_count, int pipeline_count, const char* when)
+{
+    if (g_layer_count != layer_count || g_pipeline_count != pipeline_count)
+    {
+        fprintf(stderr, "layer count %d pipeline count %d expect %d %d %s\n", g_layer_count, g_pipeline_count, layer_count, pipeline_count, when);
+        return -1;
+    }
+
+    return 0;
+}
+
+// nets sharing the layers of base run with their own options and outlive base
+static int test_sharemodel(bool lazy)
+{
+    const int w = 9;
+    const int h = 7;
+
+    ncnn::Mat in = RandomMat(w, h, 3);
+
+    ncnn::Net* base = new ncnn::Net;
+    if (load_net(*base, lazy, w, h) != 0)
+    {
+        fprintf(stderr, "test_sharemodel load failed\n");
+        return -1;
+    }
+
+    ncnn::PoolAllocator blob_allocator;
+    ncnn::UnlockedPoolAllocator workspace_allocator;
+
+    ncnn::Net net1;
+    ncnn::Net net2;
+    if (net1.share_model(*base) != 0 || net2.share_model(net1) != 0)
+    {
+        fprintf(stderr, "test_sharemodel share_model failed\n");
+        return -1;
+    }
+
+    net1.opt.workspace_allocator = &workspace_allocator;
+    net1.opt.use_local_pool_allocator = false;
+    net2.opt.blob_allocator = &blob_allocator;
+    net2.opt.lightmode = false;
+
+    // the lazy pipelines are created by share_model
+    if (check_count(1, 1, "after share") != 0)
+        return -1;
+
+    ncnn::Mat out_ref;
+    if (extract(*base, in, out_ref) != 0)
+        return -1;
+
+    delete base;
+
+    if (check_count(1, 1, "after base deleted") != 0)
+        return -1;
+
+    ncnn::Mat out1;
+    ncnn::Mat out2;
+    if (extract(net1, in, out1) != 0 || extract(net2, in, out2) != 0)
+    {
+        fprintf(stderr, "test_sharemodel extract failed\n");
+        return -1;
+    }
+
+    if (CompareMat(out1, out_ref, 0.001) != 0 || CompareMat(out2, out_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_sharemodel output mismatch lazy=%d\n", lazy);
+        return -1;
+    }
+
+    net1.clear();
+
+    if (check_count(1, 1, "after net1 cleared") != 0)
+        return -1;
+
+    net2.clear();
+
+    return check_count(0, 0, "after net2 cleared");
+}
+
+// the shared pipelines are created for the thread count of base
+static int test_sharemodel_num_threads()
+{
+    const int w = 9;
+    const int h = 7;
+
+    ncnn::Mat in = RandomMat(w, h, 3);
+
+    ncnn::Net base;
+    if (load_net(base, false, w, h) != 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads load failed\n");
+        return -1;
+    }
+
+    ncnn::Mat out_ref;
+    if (extract(base, in, out_ref) != 0)
+        return -1;
+
+    ncnn::Net net1;
+
+    base.opt.num_threads = 2;
+    if (net1.share_model(base) == 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads share_model should reject changed num_threads\n");
+        return -1;
+    }
+
+    base.opt.num_threads = 4;
+    if (net1.share_model(base) != 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads share_model failed\n");
+        return -1;
+    }
+
+    // the pipelines only run with the thread count of base
+    net1.opt.num_threads = 2;
+
+    ncnn::Mat out1;
+    if (extract(net1, in, out1) == 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads extract should reject changed num_threads\n");
+        return -1;
+    }
+
+    net1.opt.num_threads = 4;
+    if (extract(net1, in, out1) != 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads extract failed\n");
+        return -1;
+    }
+
+    if (CompareMat(out1, out_ref, 0.001) != 0)
+    {
+        fprintf(stderr, "test_sharemodel_num_threads output mismatch\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_sharemodel(false)
+           || test_sharemodel(true)
+           || test_sharemodel_num_threads();
+}
@@ -39,9 +39,18 @@ static int test_spectrogram_0()
            || test_spectrogram(124, 55, 2, 12, 55, 1, 1, 2, 2, 0);
 }
 
+static int test_spectrogram_1()
+{
+    return 0
+           || test_spectrogram(1600, 512, 2, 160, 400, 1, 1, 2, 0, 1)
+           || test_spectrogram(800, 400, 0, 160, 400, 2, 1, 2, 1, 0)
+           || test_spectrogram(333, 64, 1, 16, 64, 1, 0, 0, 2, 1)
+           || test_spectrogram(97, 24, 0, 3, 20, 0, 1, 1, 0, 1);
+}
+
 int main()
 {
     SRAND(7767517);
 
-    return test_spectrogram_0();
+    return test_spectrogram_0() || test_spectrogram_1();
 }
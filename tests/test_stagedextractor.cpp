@@ -0,0 +1,228 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "cpu.h"
+#include "net.h"
+#include "stagedextractor.h"
+
+// a residual block whose skip branch crosses the stage cuts, and an intermediate feature output
+static const char* g_param = "7767517\n"
+                             "10 12\n"
+                             "Input        data   0 1 data\n"
+                             "Convolution  conv0  1 1 data conv0 0=16 1=3 4=1 5=1 6=432 9=1\n"
+                             "Split        split0 1 2 conv0 conv0_0 conv0_1\n"
+                             "Convolution  conv1  1 1 conv0_0 conv1 0=16 1=3 4=1 5=1 6=2304 9=1\n"
+                             "Convolution  conv2  1 1 conv1 conv2 0=16 1=3 4=1 5=1 6=2304 9=1\n"
+                             "Eltwise      sum    2 1 conv0_1 conv2 sum 0=1\n"
+                             "Convolution  conv3  1 1 sum conv3 0=24 1=1 5=1 6=384 9=1\n"
+                             "Split        split1 1 2 conv3 conv3_0 feat\n"
+                             "Pooling      gap    1 1 conv3_0 gap 0=1 4=1\n"
+                             "InnerProduct fc     1 1 gap out 0=10 1=1 2=240\n";
+
+static int load_net(ncnn::Net& net)
+{
+    std::vector<float> weights;
+    const int weight_sizes[5] = {432, 2304, 2304, 384, 240};
+    const int bias_sizes[5] = {16, 16, 16, 24, 10};
+    for (int i = 0; i < 5; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-0.2f, 0.2f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+
+    net.opt.num_threads = 1;
+
+    return load_net_mem(net, g_param, weights);
+}
+
+static int test_stagedextractor(const ncnn::Net& net, const std::vector<ncnn::CpuSet>& stage_cpus, int expect_stage_count)
+{
+    const int frame_count = 24;
+
+    std::vector<ncnn::Mat> inputs(frame_count);
+    std::vector<ncnn::Mat> outs_ref(frame_count);
+    std::vector<ncnn::Mat> feats_ref(frame_count);
+    for (int i = 0; i < frame_count; i++)
+    {
+        inputs[i] = RandomMat(13, 11, 3);
+
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", inputs[i]);
+        ex.extract("out", outs_ref[i]);
+        ex.extract("feat", feats_ref[i]);
+    }
+
+    ncnn::StagedExtractor staged_extractor(&net, stage_cpus, 2);
+
+    std::vector<const char*> input_names(1, "data");
+    std::vector<const char*> output_names;
+    output_names.push_back("out");
+    output_names.push_back("feat");
+
+    if (staged_extractor.prepare(input_names, std::vector<ncnn::Mat>(1, inputs[0]), output_names) != 0)
+    {
+        fprintf(stderr, "test_stagedextractor prepare failed\n");
+        return -1;
+    }
+
+    if (staged_extractor.stage_count() != expect_stage_count)
+    {
+        fprintf(stderr, "test_stagedextractor stage count %d expect %d\n", staged_extractor.stage_count(), expect_stage_count);
+        return -1;
+    }
+
+    // the stages cover all layers in order
+    int layer_end = 0;
+    for (int i = 0; i < staged_extractor.stage_count(); i++)
+    {
+        const int begin = staged_extractor.stage_layer_begin(i);
+        const int end = staged_extractor.stage_layer_end(i);
+        if (begin != layer_end || end <= begin)
+        {
+            fprintf(stderr, "test_stagedextractor stage %d runs layers [%d, %d)\n", i, begin, end);
+            return -1;
+        }
+
+        layer_end = end;
+    }
+
+    if (layer_end != (int)net.layers().size())
+    {
+        fprintf(stderr, "test_stagedextractor stages end at layer %d\n", layer_end);
+        return -1;
+    }
+
+    // keep a few frames in flight, frames come out in push order
+    int popped = 0;
+    for (int i = 0; i < frame_count + 3; i++)
+    {
+        if (i < frame_count && staged_extractor.push(std::vector<ncnn::Mat>(1, inputs[i])) != 0)
+        {
+            fprintf(stderr, "test_stagedextractor push %d failed\n", i);
+            return -1;
+        }
+
+        if (i < 3)
+            continue;
+
+        std::vector<ncnn::Mat> outputs;
+        int ret = staged_extractor.pop(outputs);
+        if (ret != 0 || outputs.size() != 2)
+        {
+            fprintf(stderr, "test_stagedextractor pop %d failed %d\n", popped, ret);
+            return -1;
+        }
+
+        if (CompareMat(outputs[0], outs_ref[popped], 0.001) != 0 || CompareMat(outputs[1], feats_ref[popped], 0.001) != 0)
+        {
+            fprintf(stderr, "test_stagedextractor frame %d output mismatch\n", popped);
+            return -1;
+        }
+
+        popped++;
+    }
+
+    if (popped != frame_count || staged_extractor.inflight_count() != 0)
+    {
+        fprintf(stderr, "test_stagedextractor popped %d inflight %d\n", popped, staged_extractor.inflight_count());
+        return -1;
+    }
+
+    std::vector<ncnn::Mat> outputs;
+    if (staged_extractor.pop(outputs) != -1)
+    {
+        fprintf(stderr, "test_stagedextractor pop without frame in flight\n");
+        return -1;
+    }
+
+    // dropped on destruction
+    for (int i = 0; i < 4; i++)
+    {
+        staged_extractor.push(std::vector<ncnn::Mat>(1, inputs[i]));
+    }
+
+    return 0;
+}
+
+static int test_stagedextractor_0(const ncnn::Net& net)
+{
+    // stages sharing all cpus
+    const ncnn::CpuSet& all_cpus = ncnn::get_cpu_thread_affinity_mask(0);
+    std::vector<ncnn::CpuSet> stage_cpus(4, all_cpus);
+
+    return test_stagedextractor(net, stage_cpus, 4);
+}
+
+static int test_stagedextractor_1(const ncnn::Net& net)
+{
+    // one stage per cpu group, more stages than layers
+    std::vector<ncnn::CpuSet> stage_cpus;
+    ncnn::StagedExtractor::split_cpu_set(ncnn::get_cpu_thread_affinity_mask(0), 16, stage_cpus);
+
+    int cpu_count = 0;
+    for (size_t i = 0; i < stage_cpus.size(); i++)
+    {
+        if (stage_cpus[i].num_enabled() == 0)
+        {
+            fprintf(stderr, "test_stagedextractor_1 empty cpu group %d\n", (int)i);
+            return -1;
+        }
+
+        cpu_count += stage_cpus[i].num_enabled();
+    }
+
+    if (cpu_count != ncnn::get_cpu_thread_affinity_mask(0).num_enabled())
+    {
+        fprintf(stderr, "test_stagedextractor_1 cpu groups hold %d cpus\n", cpu_count);
+        return -1;
+    }
+
+    const int layer_count = (int)net.layers().size();
+    return test_stagedextractor(net, stage_cpus, std::min((int)stage_cpus.size(), layer_count));
+}
+
+static int test_stagedextractor_2(const ncnn::Net& net)
+{
+    // a stage with fewer cpus than num_threads is rejected
+    std::vector<ncnn::CpuSet> stage_cpus(2, ncnn::get_cpu_thread_affinity_mask(0));
+    stage_cpus[1].disable_all();
+
+    std::vector<const char*> input_names(1, "data");
+    std::vector<const char*> output_names(1, "out");
+
+    ncnn::StagedExtractor staged_extractor(&net, stage_cpus, 2);
+    if (staged_extractor.prepare(input_names, std::vector<ncnn::Mat>(1, RandomMat(13, 11, 3)), output_names) == 0)
+    {
+        fprintf(stderr, "test_stagedextractor_2 prepare should fail\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    ncnn::Net net;
+    if (load_net(net) != 0)
+    {
+        fprintf(stderr, "load net failed\n");
+        return -1;
+    }
+
+    return 0
+           || test_stagedextractor_0(net)
+           || test_stagedextractor_1(net)
+           || test_stagedextractor_2(net);
+}
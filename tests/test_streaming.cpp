@@ -0,0 +1,318 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "net.h"
+
+// append b to a along w for 2d blobs and along h for 3d blobs
+static ncnn::Mat concat_stream(const ncnn::Mat& a, const ncnn::Mat& b)
+{
+    if (a.dims == 0)
+        return b.clone();
+
+    if (b.empty())
+        return a;
+
+    ncnn::Mat c;
+    if (a.dims == 3)
+    {
+        c.create(a.w, a.h + b.h, a.c);
+        for (int q = 0; q < a.c; q++)
+        {
+            memcpy(c.channel(q), a.channel(q), a.w * a.h * sizeof(float));
+            memcpy(c.channel(q).row(a.h), b.channel(q), b.w * b.h * sizeof(float));
+        }
+    }
+    else
+    {
+        c.create(a.w + b.w, a.h);
+        for (int i = 0; i < a.h; i++)
+        {
+            memcpy(c.row(i), a.row(i), a.w * sizeof(float));
+            memcpy(c.row(i) + a.w, b.row(i), b.w * sizeof(float));
+        }
+    }
+
+    return c;
+}
+
+// the whole stream output is a prefix of the non-streaming output, which also pads the stream end
+static int compare_stream(const ncnn::Mat& whole, const ncnn::Mat& stream)
+{
+    ncnn::Mat prefix;
+    if (whole.dims == 3)
+        ncnn::copy_cut_border(whole, prefix, 0, whole.h - stream.h, 0, 0);
+    else
+        ncnn::copy_cut_border(whole, prefix, 0, 0, 0, whole.w - stream.w);
+
+    return CompareMat(prefix, stream, 0.001);
+}
+
+static int test_streaming_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& a, int chunk)
+{
+    ncnn::Option opt;
+    opt.num_threads = 1;
+    opt.use_packing_layout = true;
+    opt.use_fp16_packed = false;
+    opt.use_fp16_storage = false;
+    opt.use_fp16_arithmetic = false;
+    opt.use_bf16_storage = false;
+
+    ncnn::Layer* op = ncnn::create_layer_cpu(layer_type);
+
+    op->load_param(pd);
+
+    ncnn::ModelBinFromMatArray mb(weights.data());
+
+    op->load_model(mb);
+
+    op->create_pipeline(opt);
+
+    int ret = 0;
+
+    if (!op->support_streaming)
+    {
+        fprintf(stderr, "%s does not support streaming\n", layer_type);
+        ret = -1;
+    }
+
+    ncnn::Mat whole;
+    if (ret == 0)
+    {
+        ncnn::Mat b;
+        ret = op->forward(a, b, opt);
+        if (ret == 0)
+            ret = convert_to_vanilla_layout(b, whole, opt, op, 0);
+    }
+
+    ncnn::Mat stream;
+    ncnn::Mat state;
+    for (int i = 0; ret == 0 && i < a.w; i += chunk)
+    {
+        const int size = std::min(chunk, a.w - i);
+
+        ncnn::Mat a_chunk;
+        ncnn::copy_cut_border(a, a_chunk, 0, 0, i, a.w - i - size);
+
+        ncnn::Mat b;
+        ret = op->forward_streaming(a_chunk, b, state, opt);
+        if (ret != 0)
+            break;
+
+        if (b.empty())
+            continue;
+
+        ncnn::Mat b_vanilla;
+        ret = convert_to_vanilla_layout(b, b_vanilla, opt, op, 0);
+
+        stream = concat_stream(stream, b_vanilla);
+    }
+
+    if (ret == 0)
+        ret = compare_stream(whole, stream);
+
+    op->destroy_pipeline(opt);
+
+    delete op;
+
+    return ret;
+}
+
+static int test_streaming_convolution1d(int w, int h, int outh, int kernel, int dilation, int stride, int pad, int chunk)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    ncnn::ParamDict pd;
+    pd.set(0, outh);     // num_output
+    pd.set(1, kernel);   // kernel_w
+    pd.set(2, dilation); // dilation_w
+    pd.set(3, stride);   // stride_w
+    pd.set(4, pad);      // pad_left
+    pd.set(15, 0);       // pad_right
+    pd.set(5, 1);        // bias_term
+    pd.set(6, outh * h * kernel);
+
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(outh * h * kernel);
+    weights[1] = RandomMat(outh);
+
+    int ret = test_streaming_layer("Convolution1D", pd, weights, a, chunk);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_streaming_convolution1d failed w=%d h=%d outh=%d kernel=%d dilation=%d stride=%d pad=%d chunk=%d\n", w, h, outh, kernel, dilation, stride, pad, chunk);
+    }
+
+    return ret;
+}
+
+static int test_streaming_convolutiondepthwise1d(int w, int h, int kernel, int dilation, int stride, int pad, int chunk)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    ncnn::ParamDict pd;
+    pd.set(0, h);        // num_output
+    pd.set(1, kernel);   // kernel_w
+    pd.set(2, dilation); // dilation_w
+    pd.set(3, stride);   // stride_w
+    pd.set(4, pad);      // pad_left
+    pd.set(15, 0);       // pad_right
+    pd.set(5, 1);        // bias_term
+    pd.set(6, h * kernel);
+    pd.set(7, h); // group
+
+    std::vector<ncnn::Mat> weights(2);
+    weights[0] = RandomMat(h * kernel);
+    weights[1] = RandomMat(h);
+
+    int ret = test_streaming_layer("ConvolutionDepthWise1D", pd, weights, a, chunk);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_streaming_convolutiondepthwise1d failed w=%d h=%d kernel=%d dilation=%d stride=%d pad=%d chunk=%d\n", w, h, kernel, dilation, stride, pad, chunk);
+    }
+
+    return ret;
+}
+
+static int test_streaming_pooling1d(int w, int h, int pooling_type, int kernel, int stride, int pad, int chunk)
+{
+    ncnn::Mat a = RandomMat(w, h);
+
+    ncnn::ParamDict pd;
+    pd.set(0, pooling_type); // pooling_type
+    pd.set(1, kernel);       // kernel_w
+    pd.set(2, stride);       // stride_w
+    pd.set(3, pad);          // pad_left
+    pd.set(14, 0);           // pad_right
+    pd.set(5, 1);            // pad_mode
+    pd.set(6, 1);            // avgpool_count_include_pad
+
+    std::vector<ncnn::Mat> weights(0);
+
+    int ret = test_streaming_layer("Pooling1D", pd, weights, a, chunk);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_streaming_pooling1d failed w=%d h=%d pooling_type=%d kernel=%d stride=%d pad=%d chunk=%d\n", w, h, pooling_type, kernel, stride, pad, chunk);
+    }
+
+    return ret;
+}
+
+static int test_streaming_spectrogram(int size, int n_fft, int power, int hoplen, int center, int pad_type, int chunk)
+{
+    ncnn::Mat a = RandomMat(size);
+
+    ncnn::ParamDict pd;
+    pd.set(0, n_fft);
+    pd.set(1, power);
+    pd.set(2, hoplen);
+    pd.set(3, n_fft);
+    pd.set(4, 1); // hann window
+    pd.set(5, center);
+    pd.set(6, pad_type);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    int ret = test_streaming_layer("Spectrogram", pd, weights, a, chunk);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_streaming_spectrogram failed size=%d n_fft=%d power=%d hoplen=%d center=%d pad_type=%d chunk=%d\n", size, n_fft, power, hoplen, center, pad_type, chunk);
+    }
+
+    return ret;
+}
+
+static int test_streaming_0()
+{
+    return 0
+           || test_streaming_convolution1d(64, 3, 8, 3, 1, 1, 2, 7)
+           || test_streaming_convolution1d(64, 8, 16, 5, 2, 1, 0, 16)
+           || test_streaming_convolution1d(67, 4, 12, 3, 1, 2, 1, 5)
+           || test_streaming_convolution1d(80, 16, 4, 4, 1, 3, 2, 1)
+           || test_streaming_convolutiondepthwise1d(64, 8, 3, 1, 1, 2, 7)
+           || test_streaming_convolutiondepthwise1d(61, 12, 5, 2, 2, 1, 9)
+           || test_streaming_convolutiondepthwise1d(48, 16, 4, 1, 3, 0, 1)
+           || test_streaming_pooling1d(64, 8, 0, 3, 1, 1, 7)
+           || test_streaming_pooling1d(65, 4, 1, 2, 2, 0, 3)
+           || test_streaming_pooling1d(70, 16, 0, 4, 3, 1, 11)
+           || test_streaming_spectrogram(1600, 400, 2, 160, 1, 2, 320)
+           || test_streaming_spectrogram(1024, 64, 0, 16, 1, 0, 50)
+           || test_streaming_spectrogram(300, 17, 1, 5, 0, 0, 13);
+}
+
+static int test_streaming_extractor()
+{
+    static const char* param = "7767517\n"
+                               "3 3\n"
+                               "Input         data  0 1 data\n"
+                               "Convolution1D conv  1 1 data conv 0=8 1=3 3=1 4=2 15=0 5=1 6=96 9=1\n"
+                               "Pooling1D     pool  1 1 conv out 0=0 1=2 2=2 5=1\n";
+
+    // weight with the raw float32 flag, then bias
+    std::vector<float> weights(1 + 96 + 8);
+    memset(&weights[0], 0, sizeof(float));
+    for (size_t i = 1; i < weights.size(); i++)
+    {
+        weights[i] = RandomFloat(-1.f, 1.f);
+    }
+
+    ncnn::Net net;
+    net.opt.num_threads = 1;
+    if (load_net_mem(net, param, weights) != 0)
+    {
+        fprintf(stderr, "test_streaming_extractor load failed\n");
+        return -1;
+    }
+
+    ncnn::Mat a = RandomMat(100, 4);
+
+    ncnn::Mat whole;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.input("data", a);
+        ex.extract("out", whole);
+    }
+
+    ncnn::Mat stream;
+    {
+        ncnn::Extractor ex = net.create_extractor();
+        ex.set_streaming(true);
+
+        const int chunk = 9;
+        for (int i = 0; i < a.w; i += chunk)
+        {
+            const int size = std::min(chunk, a.w - i);
+
+            ncnn::Mat a_chunk;
+            ncnn::copy_cut_border(a, a_chunk, 0, 0, i, a.w - i - size);
+
+            ncnn::Mat b;
+            ex.input("data", a_chunk);
+            int ret = ex.extract("out", b);
+            if (ret != 0)
+            {
+                fprintf(stderr, "test_streaming_extractor extract failed %d\n", ret);
+                return -1;
+            }
+
+            stream = concat_stream(stream, b);
+
+            ex.next_chunk();
+        }
+    }
+
+    if (compare_stream(whole, stream) != 0)
+    {
+        fprintf(stderr, "test_streaming_extractor failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return test_streaming_0() || test_streaming_extractor();
+}
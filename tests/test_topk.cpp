@@ -0,0 +1,172 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include <algorithm>
+
+static int test_topk(const ncnn::Mat& a, int axis, int k, int largest, int sorted)
+{
+    ncnn::ParamDict pd;
+    pd.set(0, axis);
+    pd.set(1, k);
+    pd.set(2, largest);
+    pd.set(3, sorted);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    std::vector<ncnn::Mat> as(1);
+    as[0] = a;
+
+    int ret = test_layer("TopK", pd, weights, as, 2);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_topk failed a.dims=%d a=(%d %d %d %d) axis=%d k=%d largest=%d sorted=%d\n", a.dims, a.w, a.h, a.d, a.c, axis, k, largest, sorted);
+    }
+
+    return ret;
+}
+
+struct ValueIndex
+{
+    float value;
+    int index;
+};
+
+static bool value_index_greater(const ValueIndex& a, const ValueIndex& b)
+{
+    return a.value > b.value || (a.value == b.value && a.index < b.index);
+}
+
+static bool value_index_less(const ValueIndex& a, const ValueIndex& b)
+{
+    return a.value < b.value || (a.value == b.value && a.index < b.index);
+}
+
+// long rows with many equal values, the indices must match exactly
+static int test_topk_indices(int w, int k, int largest)
+{
+    ncnn::Mat a(w);
+    for (int i = 0; i < w; i++)
+    {
+        a[i] = (float)(RandomInt(0, 63) - 32);
+    }
+
+    std::vector<ValueIndex> ref(w);
+    for (int i = 0; i < w; i++)
+    {
+        ref[i].value = a[i];
+        ref[i].index = i;
+    }
+    std::sort(ref.begin(), ref.end(), largest ? value_index_greater : value_index_less);
+
+    ncnn::ParamDict pd;
+    pd.set(0, 0);
+    pd.set(1, k);
+    pd.set(2, largest);
+    pd.set(3, 1);
+
+    ncnn::Layer* op = ncnn::create_layer_cpu("TopK");
+    op->load_param(pd);
+
+    ncnn::Option opt;
+    opt.num_threads = 1;
+
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> as(1);
+    as[0] = a;
+    std::vector<ncnn::Mat> b(2);
+    int ret = op->forward(as, b, opt);
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_topk_indices forward failed %d\n", ret);
+        return -1;
+    }
+
+    const int* indices = b[1];
+    for (int i = 0; i < k; i++)
+    {
+        if (b[0][i] != ref[i].value || indices[i] != ref[i].index)
+        {
+            fprintf(stderr, "test_topk_indices failed w=%d k=%d largest=%d at %d got %f %d expect %f %d\n", w, k, largest, i, b[0][i], indices[i], ref[i].value, ref[i].index);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_topk_0()
+{
+    ncnn::Mat a = RandomMat(20000);
+    ncnn::Mat b = RandomMat(37);
+
+    return 0
+           || test_topk(a, 0, 5, 1, 1)
+           || test_topk(a, 0, 100, 0, 1)
+           || test_topk(a, -1, 17, 1, 0)
+           || test_topk(b, 0, 37, 1, 1)
+           || test_topk(b, 0, 50, 0, 0)
+           || test_topk(b, 0, 9, 1, 1);
+}
+
+static int test_topk_1()
+{
+    ncnn::Mat a = RandomMat(1000, 7);
+    ncnn::Mat b = RandomMat(13, 96);
+
+    return 0
+           || test_topk(a, 1, 10, 1, 1)
+           || test_topk(a, -1, 3, 0, 1)
+           || test_topk(a, 0, 2, 1, 1)
+           || test_topk(b, 0, 5, 1, 0)
+           || test_topk(b, 1, 13, 0, 1);
+}
+
+static int test_topk_2()
+{
+    ncnn::Mat a = RandomMat(64, 5, 12);
+
+    return 0
+           || test_topk(a, 0, 3, 1, 1)
+           || test_topk(a, 1, 2, 0, 1)
+           || test_topk(a, 2, 7, 1, 0)
+           || test_topk(a, -1, 1, 1, 1);
+}
+
+static int test_topk_3()
+{
+    ncnn::Mat a = RandomMat(40, 3, 4, 6);
+
+    return 0
+           || test_topk(a, 0, 2, 1, 1)
+           || test_topk(a, 1, 4, 0, 1)
+           || test_topk(a, 2, 1, 1, 1)
+           || test_topk(a, 3, 5, 0, 0);
+}
+
+static int test_topk_4()
+{
+    return 0
+           || test_topk_indices(5000, 20, 1)
+           || test_topk_indices(5000, 20, 0)
+           || test_topk_indices(301, 100, 1)
+           || test_topk_indices(64, 1, 0);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_topk_0()
+           || test_topk_1()
+           || test_topk_2()
+           || test_topk_3()
+           || test_topk_4();
+}
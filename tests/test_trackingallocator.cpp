@@ -0,0 +1,201 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include "allocator.h"
+#include "net.h"
+
+// the wide conv0 output is still alive while conv1 allocates its output
+static const char* g_param = "7767517\n"
+                             "4 4\n"
+                             "Input        data  0 1 data\n"
+                             "Convolution  conv0 1 1 data conv0 0=64 1=3 4=1 5=1 6=1728\n"
+                             "Convolution  conv1 1 1 conv0 conv1 0=8 1=3 4=1 5=1 6=4608\n"
+                             "Pooling      gap   1 1 conv1 out 0=1 4=1\n";
+
+static int load_net(ncnn::Net& net)
+{
+    std::vector<float> weights;
+    const int weight_sizes[2] = {1728, 4608};
+    const int bias_sizes[2] = {64, 8};
+    for (int i = 0; i < 2; i++)
+    {
+        // weight with the raw float32 flag, then bias
+        weights.push_back(0.f);
+        for (int j = 0; j < weight_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-0.2f, 0.2f));
+        }
+        for (int j = 0; j < bias_sizes[i]; j++)
+        {
+            weights.push_back(RandomFloat(-1.f, 1.f));
+        }
+    }
+
+    // plain fp32 blobs of known size
+    net.opt.num_threads = 1;
+    net.opt.use_packing_layout = false;
+    net.opt.use_fp16_storage = false;
+    net.opt.use_fp16_arithmetic = false;
+    net.opt.use_bf16_storage = false;
+
+    return load_net_mem(net, g_param, weights);
+}
+
+static const ncnn::TrackingAllocator::LayerStats* find_layer_stats(const std::vector<ncnn::TrackingAllocator::LayerStats>& layer_stats, int layer_index)
+{
+    for (size_t i = 0; i < layer_stats.size(); i++)
+    {
+        if (layer_stats[i].layer_index == layer_index)
+            return &layer_stats[i];
+    }
+
+    return 0;
+}
+
+static int test_trackingallocator_0()
+{
+    ncnn::Net net;
+    if (load_net(net) != 0)
+    {
+        fprintf(stderr, "test_trackingallocator_0 load failed\n");
+        return -1;
+    }
+
+    ncnn::Mat in = RandomMat(32, 32, 3);
+
+    ncnn::UnlockedPoolAllocator blob_pool_allocator;
+    ncnn::TrackingAllocator blob_allocator(&blob_pool_allocator);
+
+    // 32 x 32 x 64 fp32, and the refcount Mat keeps after the data
+    const size_t conv0_bytes = 32 * 32 * 64 * sizeof(float) + sizeof(int);
+
+    {
+        ncnn::Mat out;
+        {
+            ncnn::Extractor ex = net.create_extractor();
+            ex.set_blob_allocator(&blob_allocator);
+            ex.input("data", in);
+            ex.extract("out", out);
+        }
+
+        if (blob_allocator.layer_index() != -1)
+        {
+            fprintf(stderr, "test_trackingallocator_0 layer index %d left on the allocator\n", blob_allocator.layer_index());
+            return -1;
+        }
+
+        // only the output is alive
+        const size_t out_bytes = ncnn::alignSize(out.total() * out.elemsize, 4) + sizeof(int);
+        if (blob_allocator.live_bytes() != out_bytes)
+        {
+            fprintf(stderr, "test_trackingallocator_0 live %d bytes with output %d bytes\n", (int)blob_allocator.live_bytes(), (int)out_bytes);
+            return -1;
+        }
+    }
+
+    if (blob_allocator.live_bytes() != 0 || blob_allocator.malloc_count() < 3 || blob_allocator.peak_bytes() < conv0_bytes)
+    {
+        fprintf(stderr, "test_trackingallocator_0 live %d peak %d mallocs %d\n", (int)blob_allocator.live_bytes(), (int)blob_allocator.peak_bytes(), blob_allocator.malloc_count());
+        return -1;
+    }
+
+    const std::vector<ncnn::TrackingAllocator::LayerStats> layer_stats = blob_allocator.layer_stats();
+
+    size_t bytes_at_peak = 0;
+    for (size_t i = 0; i < layer_stats.size(); i++)
+    {
+        bytes_at_peak += layer_stats[i].bytes_at_peak;
+    }
+
+    if (bytes_at_peak != blob_allocator.peak_bytes())
+    {
+        fprintf(stderr, "test_trackingallocator_0 layers hold %d bytes at peak %d\n", (int)bytes_at_peak, (int)blob_allocator.peak_bytes());
+        return -1;
+    }
+
+    // conv0 output is the largest buffer, and alive at the peak
+    const ncnn::TrackingAllocator::LayerStats* conv0 = find_layer_stats(layer_stats, 1);
+    const ncnn::TrackingAllocator::LayerStats* conv1 = find_layer_stats(layer_stats, 2);
+    if (!conv0 || !conv1 || conv0->bytes_at_peak != conv0_bytes || conv0->peak_bytes != conv0_bytes || conv0->size_histogram[18] != 1)
+    {
+        fprintf(stderr, "test_trackingallocator_0 conv0 stats mismatch\n");
+        return -1;
+    }
+
+    if (conv1->malloc_count < 1 || conv1->live_bytes != 0)
+    {
+        fprintf(stderr, "test_trackingallocator_0 conv1 mallocs %d live %d\n", conv1->malloc_count, (int)conv1->live_bytes);
+        return -1;
+    }
+
+    blob_allocator.print_report(net.layers(), 3);
+
+    // counting starts over
+    blob_allocator.reset();
+    if (blob_allocator.peak_bytes() != 0 || blob_allocator.malloc_count() != 0 || !blob_allocator.layer_stats().empty())
+    {
+        fprintf(stderr, "test_trackingallocator_0 reset failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+static void* malloc_on_worker(void* args)
+{
+    ncnn::Allocator* allocator = (ncnn::Allocator*)args;
+    allocator->fastFree(allocator->fastMalloc(1000));
+    return 0;
+}
+
+static int test_trackingallocator_1()
+{
+    ncnn::TrackingAllocator allocator;
+    ncnn::TrackingAllocator other_allocator;
+    ncnn::PoolAllocator pool_allocator;
+
+    if (ncnn::TrackingAllocator::find(&allocator) != &allocator || ncnn::TrackingAllocator::find(&pool_allocator) != 0 || ncnn::TrackingAllocator::find(0) != 0)
+    {
+        fprintf(stderr, "test_trackingallocator_1 find failed\n");
+        return -1;
+    }
+
+    // a worker thread is charged to the layer set on the allocator, other allocators are not affected
+    allocator.set_layer_index(5);
+    {
+        ncnn::Thread worker(malloc_on_worker, &allocator);
+        worker.join();
+
+        ncnn::Thread other_worker(malloc_on_worker, &other_allocator);
+        other_worker.join();
+    }
+    allocator.set_layer_index(-1);
+
+    const std::vector<ncnn::TrackingAllocator::LayerStats> layer_stats = allocator.layer_stats();
+    const ncnn::TrackingAllocator::LayerStats* layer5 = find_layer_stats(layer_stats, 5);
+    if (!layer5 || layer5->malloc_count != 1 || layer5->bytes_at_peak != 1000 || layer_stats.size() != 1)
+    {
+        fprintf(stderr, "test_trackingallocator_1 worker malloc not charged to layer 5\n");
+        return -1;
+    }
+
+    const std::vector<ncnn::TrackingAllocator::LayerStats> other_layer_stats = other_allocator.layer_stats();
+    if (other_layer_stats.size() != 1 || other_layer_stats[0].layer_index != -1)
+    {
+        fprintf(stderr, "test_trackingallocator_1 other allocator charged to a layer\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_trackingallocator_0()
+           || test_trackingallocator_1();
+}
@@ -0,0 +1,288 @@
+// Copyright 2025 Tencent
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "testutil.h"
+
+#include <algorithm>
+
+static ncnn::Mat IntArrayMat(int a0, int a1, int a2)
+{
+    ncnn::Mat m(3);
+    int* p = m;
+    p[0] = a0;
+    p[1] = a1;
+    p[2] = a2;
+    return m;
+}
+
+static ncnn::Mat FloatArrayMat(const float* src, int length)
+{
+    ncnn::Mat m(length);
+    memcpy(m, src, length * sizeof(float));
+    return m;
+}
+
+static float sigmoid(float x)
+{
+    return 1.f / (1.f + expf(-x));
+}
+
+struct Detection
+{
+    int label;
+    float score;
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+    int index;
+};
+
+static bool detection_greater(const Detection& a, const Detection& b)
+{
+    return a.score > b.score || (a.score == b.score && a.index < b.index);
+}
+
+// decode every anchor and suppress like the yolo examples
+static void yolopostprocess_reference(const ncnn::Mat& pred, int image_w, int image_h, int head_type, int num_class, int reg_max, float confidence_threshold, float nms_threshold, const ncnn::Mat& anchors, std::vector<Detection>& dets)
+{
+    const int strides[3] = {8, 16, 32};
+    const int num_anchor = head_type == 2 ? anchors.w / 6 : 1;
+    const int box_size = head_type == 0 ? reg_max * 4 : 5;
+
+    std::vector<Detection> proposals;
+
+    int index = 0;
+    for (int s = 0; s < 3; s++)
+    {
+        const int stride = strides[s];
+        const int gw = image_w / stride;
+        const int gh = image_h / stride;
+
+        for (int q = 0; q < num_anchor; q++)
+        {
+            for (int gy = 0; gy < gh; gy++)
+            {
+                for (int gx = 0; gx < gw; gx++)
+                {
+                    const float* p = pred.row(index);
+
+                    int label = 0;
+                    for (int k = 1; k < num_class; k++)
+                    {
+                        if (p[box_size + k] > p[box_size + label])
+                            label = k;
+                    }
+
+                    Detection d;
+                    d.label = label;
+                    d.index = index;
+                    if (head_type == 0)
+                    {
+                        d.score = sigmoid(p[box_size + label]);
+
+                        float ltrb[4];
+                        for (int k = 0; k < 4; k++)
+                        {
+                            const float* bins = p + k * reg_max;
+                            float max = bins[0];
+                            for (int l = 1; l < reg_max; l++)
+                                max = std::max(max, bins[l]);
+
+                            float sum = 0.f;
+                            float dis = 0.f;
+                            for (int l = 0; l < reg_max; l++)
+                            {
+                                sum += expf(bins[l] - max);
+                                dis += l * expf(bins[l] - max);
+                            }
+
+                            ltrb[k] = dis / sum * stride;
+                        }
+
+                        d.x0 = (gx + 0.5f) * stride - ltrb[0];
+                        d.y0 = (gy + 0.5f) * stride - ltrb[1];
+                        d.x1 = (gx + 0.5f) * stride + ltrb[2];
+                        d.y1 = (gy + 0.5f) * stride + ltrb[3];
+                    }
+                    else if (head_type == 1)
+                    {
+                        d.score = sigmoid(p[4]) * sigmoid(p[5 + label]);
+
+                        const float cx = (p[0] + gx) * stride;
+                        const float cy = (p[1] + gy) * stride;
+                        const float w = expf(p[2]) * stride;
+                        const float h = expf(p[3]) * stride;
+
+                        d.x0 = cx - w * 0.5f;
+                        d.y0 = cy - h * 0.5f;
+                        d.x1 = cx + w * 0.5f;
+                        d.y1 = cy + h * 0.5f;
+                    }
+                    else
+                    {
+                        d.score = sigmoid(p[4]) * sigmoid(p[5 + label]);
+
+                        const float anchor_w = anchors[(s * num_anchor + q) * 2];
+                        const float anchor_h = anchors[(s * num_anchor + q) * 2 + 1];
+
+                        const float cx = (sigmoid(p[0]) * 2.f - 0.5f + gx) * stride;
+                        const float cy = (sigmoid(p[1]) * 2.f - 0.5f + gy) * stride;
+                        const float w = powf(sigmoid(p[2]) * 2.f, 2.f) * anchor_w;
+                        const float h = powf(sigmoid(p[3]) * 2.f, 2.f) * anchor_h;
+
+                        d.x0 = cx - w * 0.5f;
+                        d.y0 = cy - h * 0.5f;
+                        d.x1 = cx + w * 0.5f;
+                        d.y1 = cy + h * 0.5f;
+                    }
+
+                    if (d.score >= confidence_threshold)
+                        proposals.push_back(d);
+
+                    index++;
+                }
+            }
+        }
+    }
+
+    std::sort(proposals.begin(), proposals.end(), detection_greater);
+
+    dets.clear();
+    for (size_t i = 0; i < proposals.size(); i++)
+    {
+        const Detection& a = proposals[i];
+
+        bool keep = true;
+        for (size_t j = 0; j < dets.size(); j++)
+        {
+            const Detection& b = dets[j];
+            if (a.label != b.label)
+                continue;
+
+            const float inter_w = std::max(std::min(a.x1, b.x1) - std::max(a.x0, b.x0), 0.f);
+            const float inter_h = std::max(std::min(a.y1, b.y1) - std::max(a.y0, b.y0), 0.f);
+            const float inter_area = inter_w * inter_h;
+            const float union_area = (a.x1 - a.x0) * (a.y1 - a.y0) + (b.x1 - b.x0) * (b.y1 - b.y0) - inter_area;
+            if (inter_area / union_area > nms_threshold)
+                keep = false;
+        }
+
+        if (keep)
+            dets.push_back(a);
+    }
+}
+
+static int test_yolopostprocess(int image_w, int image_h, int head_type, int num_class, float confidence_threshold, float nms_threshold, const ncnn::Mat& anchors)
+{
+    const int reg_max = 16;
+    const int num_anchor = head_type == 2 ? anchors.w / 6 : 1;
+    const int box_size = head_type == 0 ? reg_max * 4 : 5;
+    const int num_row = num_anchor * ((image_w / 8) * (image_h / 8) + (image_w / 16) * (image_h / 16) + (image_w / 32) * (image_h / 32));
+
+    std::vector<ncnn::Mat> a(2);
+    a[0] = RandomMat(box_size + num_class, num_row, -3.f, 3.f);
+    a[1] = RandomMat(image_w, image_h, 3);
+
+    ncnn::ParamDict pd;
+    pd.set(0, head_type);
+    pd.set(1, num_class);
+    pd.set(2, reg_max);
+    pd.set(3, confidence_threshold);
+    pd.set(4, nms_threshold);
+    pd.set(5, -1);
+    pd.set(6, -1);
+    pd.set(9, IntArrayMat(8, 16, 32));
+    pd.set(10, anchors);
+
+    std::vector<ncnn::Mat> weights(0);
+
+    int ret = test_layer("YoloPostprocess", pd, weights, a);
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_yolopostprocess failed image=%dx%d head_type=%d num_class=%d confidence_threshold=%f nms_threshold=%f\n", image_w, image_h, head_type, num_class, confidence_threshold, nms_threshold);
+        return ret;
+    }
+
+    // compare with the full decode of every anchor
+    ncnn::Layer* op = ncnn::create_layer_cpu("YoloPostprocess");
+    op->load_param(pd);
+
+    ncnn::Option opt;
+    opt.num_threads = 2;
+
+    op->create_pipeline(opt);
+
+    std::vector<ncnn::Mat> b(1);
+    ret = op->forward(a, b, opt);
+
+    op->destroy_pipeline(opt);
+    delete op;
+
+    if (ret != 0)
+    {
+        fprintf(stderr, "test_yolopostprocess forward failed %d\n", ret);
+        return -1;
+    }
+
+    std::vector<Detection> dets;
+    yolopostprocess_reference(a[0], image_w, image_h, head_type, num_class, reg_max, confidence_threshold, nms_threshold, anchors, dets);
+
+    if (dets.empty())
+    {
+        fprintf(stderr, "test_yolopostprocess nothing detected\n");
+        return -1;
+    }
+
+    if (b[0].h != (int)dets.size())
+    {
+        fprintf(stderr, "test_yolopostprocess detected %d expect %d head_type=%d\n", b[0].h, (int)dets.size(), head_type);
+        return -1;
+    }
+
+    for (int i = 0; i < b[0].h; i++)
+    {
+        const float* p = b[0].row(i);
+        const Detection& d = dets[i];
+        if ((int)p[0] != d.label || fabsf(p[1] - d.score) > 0.001f || fabsf(p[2] - d.x0) > 0.01f || fabsf(p[3] - d.y0) > 0.01f || fabsf(p[4] - d.x1) > 0.01f || fabsf(p[5] - d.y1) > 0.01f)
+        {
+            fprintf(stderr, "test_yolopostprocess detection %d mismatch head_type=%d\n", i, head_type);
+            fprintf(stderr, "  got    %d %f %f %f %f %f\n", (int)p[0], p[1], p[2], p[3], p[4], p[5]);
+            fprintf(stderr, "  expect %d %f %f %f %f %f\n", d.label, d.score, d.x0, d.y0, d.x1, d.y1);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+static int test_yolopostprocess_0()
+{
+    ncnn::Mat anchors;
+
+    return 0
+           || test_yolopostprocess(64, 64, 0, 80, 0.25f, 0.45f, anchors)
+           || test_yolopostprocess(96, 64, 0, 3, 0.5f, 0.6f, anchors)
+           || test_yolopostprocess(64, 128, 1, 7, 0.3f, 0.45f, anchors)
+           || test_yolopostprocess(160, 96, 1, 1, 0.4f, 0.5f, anchors);
+}
+
+static int test_yolopostprocess_1()
+{
+    const float yolov5_anchors[18] = {10, 13, 16, 30, 33, 23, 30, 61, 62, 45, 59, 119, 116, 90, 156, 198, 373, 326};
+
+    ncnn::Mat anchors = FloatArrayMat(yolov5_anchors, 18);
+
+    return 0
+           || test_yolopostprocess(64, 64, 2, 80, 0.25f, 0.45f, anchors)
+           || test_yolopostprocess(128, 96, 2, 5, 0.5f, 0.3f, anchors);
+}
+
+int main()
+{
+    SRAND(7767517);
+
+    return 0
+           || test_yolopostprocess_0()
+           || test_yolopostprocess_1();
+}
@@ -4,13 +4,17 @@
 #include "testutil.h"
 
 #include "cpu.h"
+#include "datareader.h"
 #include "layer.h"
 #include "mat.h"
+#include "net.h"
 #include "prng.h"
 
+#include <algorithm>
 #include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if NCNN_VULKAN
 #include "command.h"
@@ -313,7 +317,65 @@ int CompareMat(const std::vector<ncnn::Mat>& a, const std::vector<ncnn::Mat>& b,
     return 0;
 }
 
-static int convert_to_optimal_layout(const ncnn::Mat& a, ncnn::Mat& a4, const ncnn::Option& opt, const ncnn::Layer* op, int flag)
+#if NCNN_STRING
+class DataReaderFromFloats : public ncnn::DataReader
+{
+public:
+    DataReaderFromFloats(const std::vector<float>& _data)
+        : data(_data), offset(0)
+    {
+    }
+
+    virtual size_t read(void* buf, size_t size) const
+    {
+        if (offset + size > data.size() * sizeof(float))
+            return 0;
+
+        memcpy(buf, (const unsigned char*)&data[0] + offset, size);
+        offset += size;
+        return size;
+    }
+
+    const std::vector<float>& data;
+    mutable size_t offset;
+};
+
+class DataReaderFromEmpty : public ncnn::DataReader
+{
+public:
+    virtual int scan(const char* /*format*/, void* /*p*/) const
+    {
+        return 0;
+    }
+    virtual size_t read(void* buf, size_t size) const
+    {
+        memset(buf, 0, size);
+        return size;
+    }
+};
+
+int load_net_mem(ncnn::Net& net, const char* param, const std::vector<float>& weights)
+{
+    int ret = net.load_param_mem(param);
+    if (ret != 0)
+        return ret;
+
+    DataReaderFromFloats dr(weights);
+    return net.load_model(dr);
+}
+
+int load_net_mem(ncnn::Net& net, const char* param)
+{
+    int ret = net.load_param_mem(param);
+    if (ret != 0)
+        return ret;
+
+    DataReaderFromEmpty dr;
+    return net.load_model(dr);
+}
+#endif // NCNN_STRING
+
+int convert_to_optimal_layout(const ncnn::Mat& a, ncnn::Mat& a4, const ncnn::Option& opt, const ncnn::Layer* op, int flag)
 {
     // clang-format off
     // *INDENT-OFF*
@@ -431,7 +493,7 @@ static int convert_to_optimal_layout(const ncnn::Mat& a, ncnn::Mat& a4, const nc
     return 0;
 }
 
-static int convert_to_vanilla_layout(const ncnn::Mat& c4, ncnn::Mat& c, const ncnn::Option& opt, const ncnn::Layer* op, int flag)
+int convert_to_vanilla_layout(const ncnn::Mat& c4, ncnn::Mat& c, const ncnn::Option& opt, const ncnn::Layer* op, int flag)
 {
     ncnn::Mat c4_unpacked;
     if (c4.elempack != 1)
@@ -1503,6 +1565,118 @@ void TestOOMAllocator::fastFree(void* ptr)
     lock.unlock();
 }
 
+#if NCNN_INT8
+static ncnn::Mat int8_to_float32(const ncnn::Mat& a)
+{
+    ncnn::Mat b;
+    if (a.dims == 1) b.create(a.w);
+    if (a.dims == 2) b.create(a.w, a.h);
+    if (a.dims == 3) b.create(a.w, a.h, a.c);
+    if (a.dims == 4) b.create(a.w, a.h, a.d, a.c);
+
+    for (int q = 0; q < a.c; q++)
+    {
+        const signed char* ptr = a.channel(q);
+        float* outptr = b.channel(q);
+        for (int i = 0; i < a.w * a.h * a.d; i++)
+        {
+            outptr[i] = ptr[i];
+        }
+    }
+
+    return b;
+}
+
+static int forward_layer(const ncnn::Layer* op, const std::vector<ncnn::Mat>& a, std::vector<ncnn::Mat>& b, const ncnn::Option& opt)
+{
+    if (op->one_blob_only)
+        return op->forward(a[0], b[0], opt);
+
+    return op->forward(a, b, opt);
+}
+
+int test_layer_int8_passthrough(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& a, int top_blob_count)
+{
+    for (int packing = 0; packing < 2; packing++)
+    {
+        ncnn::Option opt;
+        opt.num_threads = 1;
+        opt.use_packing_layout = packing;
+        opt.use_fp16_packed = false;
+        opt.use_fp16_storage = false;
+        opt.use_fp16_arithmetic = false;
+        opt.use_bf16_storage = false;
+
+        ncnn::Layer* op = ncnn::create_layer_cpu(layer_type);
+        op->load_param(pd);
+        op->create_pipeline(opt);
+
+        // the fp32 reference on unpacked blobs
+        ncnn::Option opt_ref = opt;
+        opt_ref.use_packing_layout = false;
+
+        std::vector<ncnn::Mat> af(a.size());
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            af[i] = int8_to_float32(a[i]);
+        }
+
+        std::vector<ncnn::Mat> bf(top_blob_count);
+        int ret = forward_layer(op, af, bf, opt_ref);
+        if (ret == 0)
+        {
+            // int8 blobs packed the way the net packs them
+            std::vector<ncnn::Mat> a8(a.size());
+            for (size_t i = 0; i < a.size(); i++)
+            {
+                const int elempack = packing && op->support_packing && a[i].dims >= 3 && a[i].c % 8 == 0 ? 8 : 1;
+                ncnn::convert_packing(a[i], a8[i], elempack, opt);
+            }
+
+            std::vector<ncnn::Mat> b8(top_blob_count);
+            ret = forward_layer(op, a8, b8, opt);
+
+            for (int i = 0; ret == 0 && i < top_blob_count; i++)
+            {
+                if (b8[i].elembits() != 8)
+                {
+                    fprintf(stderr, "test_layer_int8_passthrough %s top %d is not int8\n", layer_type, i);
+                    ret = -1;
+                    break;
+                }
+
+                ncnn::Mat b8_unpacked;
+                ncnn::convert_packing(b8[i], b8_unpacked, 1, opt);
+
+                ncnn::Mat bf_unpacked;
+                ncnn::convert_packing(bf[i], bf_unpacked, 1, opt);
+                for (size_t j = 0; j < bf_unpacked.total(); j++)
+                {
+                    bf_unpacked[j] = std::min(std::max(bf_unpacked[j], -128.f), 127.f);
+                }
+
+                if (CompareMat(int8_to_float32(b8_unpacked), bf_unpacked, 0.f) != 0)
+                {
+                    fprintf(stderr, "test_layer_int8_passthrough %s top %d mismatch packing=%d\n", layer_type, i, packing);
+                    ret = -1;
+                }
+            }
+        }
+
+        op->destroy_pipeline(opt);
+        delete op;
+
+        if (ret != 0)
+        {
+            fprintf(stderr, "test_layer_int8_passthrough %s failed packing=%d\n", layer_type, packing);
+            return -1;
+        }
+    }
+
+    return 0;
+}
+#endif // NCNN_INT8
+
 int test_layer_oom_opt(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Option& _opt, const std::vector<ncnn::Mat>& a, int top_blob_count, int flag)
 {
     int typeindex = ncnn::layer_to_index(layer_type);
@@ -12,6 +12,10 @@
 #include <stdint.h>
 #include <stdlib.h>
 
+namespace ncnn {
+class Net;
+} // namespace ncnn
+
 #define TEST_LAYER_DISABLE_AUTO_INPUT_PACKING (1 << 0)
 #define TEST_LAYER_DISABLE_AUTO_INPUT_CASTING (1 << 1)
 #define TEST_LAYER_DISABLE_GPU_TESTING        (1 << 2)
@@ -67,6 +71,20 @@ int CompareMat(const ncnn::Mat& a, const ncnn::Mat& b, float epsilon = 0.001);
 
 int CompareMat(const std::vector<ncnn::Mat>& a, const std::vector<ncnn::Mat>& b, float epsilon = 0.001);
 
+#if NCNN_STRING
+// load net from param text and raw model data, the weights are copied into the net
+int load_net_mem(ncnn::Net& net, const char* param, const std::vector<float>& weights);
+
+// load net from param text with all weights zero
+int load_net_mem(ncnn::Net& net, const char* param);
+#endif // NCNN_STRING
+
+// cast and pack the input blob the way the cpu layer expects it
+int convert_to_optimal_layout(const ncnn::Mat& a, ncnn::Mat& a4, const ncnn::Option& opt, const ncnn::Layer* op, int flag);
+
+// unpack and cast the output blob back to fp32 pack1
+int convert_to_vanilla_layout(const ncnn::Mat& c4, ncnn::Mat& c, const ncnn::Option& opt, const ncnn::Layer* op, int flag);
+
 int test_layer_naive(int typeindex, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const std::vector<ncnn::Mat>& a, int top_blob_count, std::vector<ncnn::Mat>& b, void (*func)(ncnn::Layer*), int flag);
 
 int test_layer_cpu(int typeindex, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Option& _opt, const std::vector<ncnn::Mat>& a, int top_blob_count, std::vector<ncnn::Mat>& c, const std::vector<ncnn::Mat>& top_shapes, void (*func)(ncnn::Layer*), int flag);
@@ -95,6 +113,12 @@ int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vec
 
 int test_layer(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Mat& a, float epsilon = 0.001, void (*func)(ncnn::Layer*) = 0, int flag = 0);
 
+#if NCNN_INT8
+// run the cpu layer on int8 blobs and on the same values in fp32, the int8 results must match
+// the fp32 results saturated to int8 exactly, for layers that keep int8 activations as is
+int test_layer_int8_passthrough(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& a, int top_blob_count = 1);
+#endif // NCNN_INT8
+
 // oom test
 
 int test_layer_oom_opt(const char* layer_type, const ncnn::ParamDict& pd, const std::vector<ncnn::Mat>& weights, const ncnn::Option& opt, const std::vector<ncnn::Mat>& a, int top_blob_count = 1, int flag = 0);
@@ -104,6 +104,8 @@
 #include "layer/yolodetectionoutput.h"
 #include "layer/yolov3detectionoutput.h"
 
+#include "layer/sparse_weight.h"
+
 // for gen_random_weight
 #include "../tests/prng.h"
 
@@ -657,6 +659,10 @@ int ModelWriter::fwrite_weight_tag_data(const ncnn::Mat& data, FILE* bp, float a
 
 int ModelWriter::fwrite_weight_data(const ncnn::Mat& data, FILE* bp, float a, float b)
 {
+    // nothing to write, such as the top scales of a convolution without requantize
+    if (data.empty())
+        return 0;
+
     int p0 = ftell(bp);
 
     ncnn::Mat data_flattened = data.reshape(data.w * data.h * data.d * data.c);
@@ -887,9 +893,27 @@ int ModelWriter::save(const char* parampath, const char* binpath)
             }
             fprintf_param_value(" 19=%d", dynamic_weight)
 
+            // keep 2:4 sparse only while the weight still is
+            ncnn::Mat weight_sparse_data;
+            ncnn::Mat weight_sparse_index;
+            if (op->sparse_format == 1 && ncnn::sparse_2to4_pack(op->weight_data, weight_sparse_data, weight_sparse_index, op->weight_data_size / op->num_output, op->num_output) != 0)
+            {
+                fprintf(stderr, "%s weight is not 2:4 sparse, write dense\n", op->name.c_str());
+                op->sparse_format = 0;
+            }
+            fprintf_param_value(" 20=%d", sparse_format)
+
             if (op->dynamic_weight == 0)
             {
-                fwrite_weight_tag_data(op->weight_data, bp);
+                if (op->sparse_format == 1)
+                {
+                    fwrite_weight_tag_data(weight_sparse_data, bp);
+                    fwrite_weight_tag_data(weight_sparse_index, bp);
+                }
+                else
+                {
+                    fwrite_weight_tag_data(op->weight_data, bp);
+                }
                 fwrite_weight_data(op->bias_data, bp);
 
 #if NCNN_INT8
@@ -1889,7 +1913,25 @@ int ModelWriter::save(const char* parampath, const char* binpath)
                 if (!op->activation_params.empty()) fprintf_param_float_array(10, op->activation_params, pp);
             }
 
-            fwrite_weight_tag_data(op->weight_data, bp);
+            // keep 2:4 sparse only while the weight still is
+            ncnn::Mat weight_sparse_data;
+            ncnn::Mat weight_sparse_index;
+            if (op->sparse_format == 1 && ncnn::sparse_2to4_pack(op->weight_data, weight_sparse_data, weight_sparse_index, op->weight_data_size / op->num_output, op->num_output) != 0)
+            {
+                fprintf(stderr, "%s weight is not 2:4 sparse, write dense\n", op->name.c_str());
+                op->sparse_format = 0;
+            }
+            fprintf_param_value(" 11=%d", sparse_format)
+
+            if (op->sparse_format == 1)
+            {
+                fwrite_weight_tag_data(weight_sparse_data, bp);
+                fwrite_weight_tag_data(weight_sparse_index, bp);
+            }
+            else
+            {
+                fwrite_weight_tag_data(op->weight_data, bp);
+            }
             fwrite_weight_data(op->bias_data, bp);
 
 #if NCNN_INT8
@@ -75,6 +75,8 @@ public:
     int replace_prelu_with_leaky_relu();
     int replace_convolution_with_innerproduct_after_global_pooling();
     int replace_convolution_with_innerproduct_after_innerproduct();
+
+    int convert_weight_to_sparse_2to4();
 };
 
 NetOptimize::NetOptimize()
@@ -2748,6 +2750,56 @@ int NetOptimize::replace_convolution_with_innerproduct_after_innerproduct()
     return 0;
 }
 
+int NetOptimize::convert_weight_to_sparse_2to4()
+{
+    const size_t layer_count = layers.size();
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type == "InnerProduct")
+        {
+            ncnn::InnerProduct* innerproduct = (ncnn::InnerProduct*)layers[i];
+            if (innerproduct->sparse_format != 0 || innerproduct->int8_scale_term != 0)
+                continue;
+
+            // pruned weight with at most 2 non-zeros in every 4
+            const int num_input = innerproduct->weight_data_size / innerproduct->num_output;
+
+            ncnn::Mat weight_sparse_data;
+            ncnn::Mat weight_sparse_index;
+            if (ncnn::sparse_2to4_pack(innerproduct->weight_data, weight_sparse_data, weight_sparse_index, num_input, innerproduct->num_output) != 0)
+                continue;
+
+            fprintf(stderr, "convert_weight_to_sparse_2to4 %s\n", innerproduct->name.c_str());
+
+            innerproduct->sparse_format = 1;
+        }
+
+        if (layers[i]->type == "Convolution")
+        {
+            ncnn::Convolution* convolution = (ncnn::Convolution*)layers[i];
+            if (convolution->sparse_format != 0 || convolution->int8_scale_term != 0 || convolution->dynamic_weight != 0)
+                continue;
+
+            // only the 1x1 convolution has a sparse kernel
+            if (convolution->kernel_w != 1 || convolution->kernel_h != 1 || convolution->stride_w != 1 || convolution->stride_h != 1)
+                continue;
+
+            const int num_input = convolution->weight_data_size / convolution->num_output;
+
+            ncnn::Mat weight_sparse_data;
+            ncnn::Mat weight_sparse_index;
+            if (ncnn::sparse_2to4_pack(convolution->weight_data, weight_sparse_data, weight_sparse_index, num_input, convolution->num_output) != 0)
+                continue;
+
+            fprintf(stderr, "convert_weight_to_sparse_2to4 %s\n", convolution->name.c_str());
+
+            convolution->sparse_format = 1;
+        }
+    }
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
     if (argc < 6)
@@ -2838,6 +2890,8 @@ int main(int argc, char** argv)
     optimizer.replace_convolution_with_innerproduct_after_global_pooling();
     optimizer.replace_convolution_with_innerproduct_after_innerproduct();
 
+    optimizer.convert_weight_to_sparse_2to4();
+
     optimizer.eliminate_flatten_after_innerproduct();
     optimizer.eliminate_orphaned_memorydata();
 
@@ -6,6 +6,7 @@
 #endif
 
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <map>
 #include <set>
@@ -126,7 +127,11 @@ public:
     int quantize_gemm();
     int quantize_multiheadattention();
 
+    int quantize_dynamic();
+
     int fuse_requantize();
+
+    int fuse_int8_dataflow();
 };
 
 NetQuantize::NetQuantize()
@@ -842,6 +847,102 @@ int NetQuantize::quantize_multiheadattention()
     return 0;
 }
 
+static void compute_weight_int8_scales(const ncnn::Mat& weight_data, int num_output, ncnn::Mat& weight_data_int8_scales)
+{
+    const int size = (int)(weight_data.total() / num_output);
+
+    weight_data_int8_scales.create(num_output);
+    for (int p = 0; p < num_output; p++)
+    {
+        const float* ptr = (const float*)weight_data + size * p;
+
+        float absmax = 0.f;
+        for (int i = 0; i < size; i++)
+        {
+            absmax = std::max(absmax, (float)fabs(ptr[i]));
+        }
+
+        weight_data_int8_scales[p] = absmax == 0.f ? 0.f : 127.f / absmax;
+    }
+}
+
+int NetQuantize::quantize_dynamic()
+{
+    // Convolution and InnerProduct without calibration get int8 weights with per channel scales
+    // and quantize the activations at runtime with int8_scale_term 3
+    const int layer_count = static_cast<int>(layers.size());
+    for (int i = 0; i < layer_count; i++)
+    {
+        if (layers[i]->type == "Convolution")
+        {
+            ncnn::Convolution* convolution = (ncnn::Convolution*)layers[i];
+            if (convolution->int8_scale_term || convolution->dynamic_weight || convolution->weight_data.elemsize != 4u)
+                continue;
+
+            fprintf(stderr, "quantize_dynamic %s\n", convolution->name.c_str());
+
+            ncnn::Mat weight_data_int8_scales;
+            compute_weight_int8_scales(convolution->weight_data, convolution->num_output, weight_data_int8_scales);
+
+            const int maxk = convolution->kernel_w * convolution->kernel_h;
+            const int num_input = convolution->weight_data_size / convolution->num_output / maxk;
+
+            ncnn::Mat weight_data_r2 = convolution->weight_data.reshape(maxk, num_input, convolution->num_output);
+
+            ncnn::Mat weight_data_int8;
+
+            ncnn::Option opt_q = opt;
+            opt_q.blob_allocator = convolution->weight_data.allocator;
+            opt_q.use_packing_layout = false;
+            ncnn::quantize_to_int8(weight_data_r2, weight_data_int8, weight_data_int8_scales, opt_q);
+            if (weight_data_int8.empty())
+                return -100;
+
+            convolution->weight_data = weight_data_int8.reshape(convolution->weight_data_size);
+            convolution->int8_scale_term = 3;
+            convolution->weight_data_int8_scales = weight_data_int8_scales;
+        }
+
+        if (layers[i]->type == "InnerProduct")
+        {
+            ncnn::InnerProduct* fc = (ncnn::InnerProduct*)layers[i];
+            if (fc->int8_scale_term || fc->weight_data.elemsize != 4u)
+                continue;
+
+            fprintf(stderr, "quantize_dynamic %s\n", fc->name.c_str());
+
+            ncnn::Mat weight_data_int8_scales;
+            compute_weight_int8_scales(fc->weight_data, fc->num_output, weight_data_int8_scales);
+
+            const int num_input = fc->weight_data_size / fc->num_output;
+
+            ncnn::Mat weight_data_r2 = fc->weight_data.reshape(num_input, fc->num_output);
+
+            ncnn::Mat weight_data_int8;
+            ncnn::Option opt_q = opt;
+            opt_q.use_packing_layout = false;
+            ncnn::quantize_to_int8(weight_data_r2, weight_data_int8, weight_data_int8_scales, opt_q);
+            if (weight_data_int8.empty())
+                return -100;
+
+            fc->weight_data = weight_data_int8.reshape(fc->weight_data_size);
+            fc->int8_scale_term = 3;
+            fc->weight_data_int8_scales = weight_data_int8_scales;
+        }
+    }
+
+    return 0;
+}
+
+// dynamic quantized layers neither take nor produce int8 blobs
+static bool is_dynamic_int8(const ncnn::Layer* layer)
+{
+    if (layer->type == "Convolution")
+        return ((const ncnn::Convolution*)layer)->int8_scale_term == 3;
+
+    return false;
+}
+
 int NetQuantize::fuse_requantize()
 {
     const size_t layer_count = layers.size();
@@ -850,6 +951,9 @@ int NetQuantize::fuse_requantize()
         if (layers[i]->type != "Convolution" && layers[i]->type != "ConvolutionDepthWise")
             continue;
 
+        if (is_dynamic_int8(layers[i]))
+            continue;
+
         // Convolution/ConvolutionDepthWise - Convolution/ConvolutionDepthWise
         int top_blob_index = layers[i]->tops[0];
 
@@ -869,6 +973,9 @@ int NetQuantize::fuse_requantize()
         if (j == layer_count)
             continue;
 
+        if (is_dynamic_int8(layers[j]))
+            continue;
+
         // fuse requantize
         fprintf(stderr, "fuse_requantize %s %s\n", layers[i]->name.c_str(), layers[j]->name.c_str());
 
@@ -923,6 +1030,9 @@ int NetQuantize::fuse_requantize()
         if (layers[i]->type != "Convolution" && layers[i]->type != "ConvolutionDepthWise")
             continue;
 
+        if (is_dynamic_int8(layers[i]))
+            continue;
+
         // Convolution/ConvolutionDepthWise - Split - Convolution/ConvolutionDepthWise
         int top_blob_index = layers[i]->tops[0];
 
@@ -962,7 +1072,7 @@ int NetQuantize::fuse_requantize()
                     break;
             }
 
-            if (k == layer_count)
+            if (k == layer_count || is_dynamic_int8(layers[k]))
             {
                 all_conv = false;
                 break;
@@ -1045,11 +1155,213 @@ int NetQuantize::fuse_requantize()
     return 0;
 }
 
+// layers that pass int8 activations through unchanged in value range
+static bool is_int8_dataflow_layer(const ncnn::Layer* layer)
+{
+    if (layer->type == "Split" || layer->type == "Concat")
+        return true;
+
+    if (layer->type == "Pooling")
+    {
+        const ncnn::Pooling* pooling = (const ncnn::Pooling*)layer;
+        return pooling->pooling_type == ncnn::Pooling::PoolMethod_MAX && !pooling->adaptive_pooling;
+    }
+
+    if (layer->type == "Interp")
+    {
+        const ncnn::Interp* interp = (const ncnn::Interp*)layer;
+        return interp->resize_type == 1;
+    }
+
+    if (layer->type == "BinaryOp")
+    {
+        const ncnn::BinaryOp* binaryop = (const ncnn::BinaryOp*)layer;
+        if (binaryop->with_scalar || layer->bottoms.size() != 2)
+            return false;
+
+        const int op_type = binaryop->op_type;
+        return op_type == ncnn::BinaryOp::Operation_ADD || op_type == ncnn::BinaryOp::Operation_SUB || op_type == ncnn::BinaryOp::Operation_MAX || op_type == ncnn::BinaryOp::Operation_MIN || op_type == ncnn::BinaryOp::Operation_RSUB;
+    }
+
+    if (layer->type == "Eltwise")
+    {
+        const ncnn::Eltwise* eltwise = (const ncnn::Eltwise*)layer;
+        if (eltwise->op_type == ncnn::Eltwise::Operation_MAX)
+            return true;
+
+        if (eltwise->op_type != ncnn::Eltwise::Operation_SUM)
+            return false;
+
+        for (int i = 0; i < eltwise->coeffs.w; i++)
+        {
+            if (eltwise->coeffs[i] != 1.f)
+                return false;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+static bool is_int8_convolution(const ncnn::Layer* layer)
+{
+    if (is_dynamic_int8(layer))
+        return false;
+
+    if (layer->type == "Convolution")
+        return ((const ncnn::Convolution*)layer)->weight_data.elemsize == 1u;
+
+    if (layer->type == "ConvolutionDepthWise")
+        return ((const ncnn::ConvolutionDepthWise*)layer)->weight_data.elemsize == 1u;
+
+    return false;
+}
+
+static float int8_convolution_bottom_scale(const ncnn::Layer* layer)
+{
+    if (layer->type == "Convolution")
+        return ((const ncnn::Convolution*)layer)->bottom_blob_int8_scales[0];
+
+    return ((const ncnn::ConvolutionDepthWise*)layer)->bottom_blob_int8_scales[0];
+}
+
+static int find_blob_root(std::vector<int>& parent, int i)
+{
+    while (parent[i] != i)
+    {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+
+    return i;
+}
+
+int NetQuantize::fuse_int8_dataflow()
+{
+    // Convolution/ConvolutionDepthWise - Concat/Pooling/Interp/BinaryOp/Eltwise/Split ... - Convolution/ConvolutionDepthWise
+    // the blobs connected through dataflow layers form one region sharing a single int8 scale,
+    // so that int8 values are concatenated, compared and added without rescaling
+    const size_t layer_count = layers.size();
+    const size_t blob_count = blobs.size();
+
+    std::vector<int> parent(blob_count);
+    for (size_t i = 0; i < blob_count; i++)
+    {
+        parent[i] = (int)i;
+    }
+
+    std::vector<int> region_has_dataflow(blob_count, 0);
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        const ncnn::Layer* layer = layers[i];
+        if (!is_int8_dataflow_layer(layer))
+            continue;
+
+        // interp reads only the shape of the reference blob
+        const size_t bottom_count = layer->type == "Interp" ? 1 : layer->bottoms.size();
+
+        int root = find_blob_root(parent, layer->bottoms[0]);
+        for (size_t j = 1; j < bottom_count; j++)
+        {
+            parent[find_blob_root(parent, layer->bottoms[j])] = root;
+        }
+        for (size_t j = 0; j < layer->tops.size(); j++)
+        {
+            parent[find_blob_root(parent, layer->tops[j])] = root;
+        }
+    }
+
+    for (size_t i = 0; i < layer_count; i++)
+    {
+        if (is_int8_dataflow_layer(layers[i]))
+            region_has_dataflow[find_blob_root(parent, layers[i]->bottoms[0])] = 1;
+    }
+
+    // a region qualifies when every producer and every consumer stays int8
+    std::vector<int> region_ok(blob_count, 1);
+    std::vector<float> region_scale(blob_count, 0.f);
+    for (size_t i = 0; i < blob_count; i++)
+    {
+        const int root = find_blob_root(parent, (int)i);
+        if (!region_has_dataflow[root])
+            continue;
+
+        const ncnn::Blob& blob = blobs[i];
+        if (blob.producer < 0 || blob.consumer < 0)
+        {
+            region_ok[root] = 0;
+            continue;
+        }
+
+        const ncnn::Layer* producer = layers[blob.producer];
+        if (!is_int8_dataflow_layer(producer) && !is_int8_convolution(producer))
+            region_ok[root] = 0;
+
+        const ncnn::Layer* consumer = layers[blob.consumer];
+        if (is_int8_dataflow_layer(consumer))
+            continue;
+
+        if (!is_int8_convolution(consumer) || consumer->bottoms.size() != 1)
+        {
+            region_ok[root] = 0;
+            continue;
+        }
+
+        // the smallest scale covers the widest range of all consumers
+        const float scale = int8_convolution_bottom_scale(consumer);
+        if (region_scale[root] == 0.f || scale < region_scale[root])
+            region_scale[root] = scale;
+    }
+
+    for (size_t i = 0; i < blob_count; i++)
+    {
+        const int root = find_blob_root(parent, (int)i);
+        if (!region_has_dataflow[root] || !region_ok[root] || region_scale[root] == 0.f)
+            continue;
+
+        ncnn::Mat scales(1);
+        scales[0] = region_scale[root];
+
+        ncnn::Layer* producer = layers[blobs[i].producer];
+        if (producer->type == "Convolution")
+        {
+            ncnn::Convolution* convolution = (ncnn::Convolution*)producer;
+            if (convolution->int8_scale_term < 100)
+                convolution->int8_scale_term += 100;
+            convolution->top_blob_int8_scales = scales;
+
+            fprintf(stderr, "fuse_int8_dataflow %s %s\n", producer->name.c_str(), blobs[i].name.c_str());
+        }
+        if (producer->type == "ConvolutionDepthWise")
+        {
+            ncnn::ConvolutionDepthWise* convolution = (ncnn::ConvolutionDepthWise*)producer;
+            if (convolution->int8_scale_term < 100)
+                convolution->int8_scale_term += 100;
+            convolution->top_blob_int8_scales = scales;
+
+            fprintf(stderr, "fuse_int8_dataflow %s %s\n", producer->name.c_str(), blobs[i].name.c_str());
+        }
+
+        ncnn::Layer* consumer = layers[blobs[i].consumer];
+        if (consumer->type == "Convolution")
+        {
+            ((ncnn::Convolution*)consumer)->bottom_blob_int8_scales = scales;
+        }
+        if (consumer->type == "ConvolutionDepthWise")
+        {
+            ((ncnn::ConvolutionDepthWise*)consumer)->bottom_blob_int8_scales = scales;
+        }
+    }
+
+    return 0;
+}
+
 int main(int argc, char** argv)
 {
-    if (argc != 5 && argc != 6)
+    if (argc < 5)
     {
-        fprintf(stderr, "usage: %s [inparam] [inbin] [outparam] [outbin] [calibration table]\n", argv[0]);
+        fprintf(stderr, "usage: %s [inparam] [inbin] [outparam] [outbin] [calibration table] [int8_dataflow=0/1] [dynamic_quantize=0/1]\n", argv[0]);
         return -1;
     }
 
@@ -1057,7 +1369,41 @@ int main(int argc, char** argv)
     const char* inbin = argv[2];
     const char* outparam = argv[3];
     const char* outbin = argv[4];
-    const char* int8scale_table_path = argc == 6 ? argv[5] : NULL;
+    const char* int8scale_table_path = NULL;
+    int int8_dataflow = 0;
+    int dynamic_quantize = 0;
+
+    for (int i = 5; i < argc; i++)
+    {
+        // key=value options follow the optional calibration table
+        const char* eq = strchr(argv[i], '=');
+        if (!eq)
+        {
+            if (i != 5)
+            {
+                fprintf(stderr, "unexpected argument %s\n", argv[i]);
+                return -1;
+            }
+
+            int8scale_table_path = argv[i];
+            continue;
+        }
+
+        std::string key(argv[i], eq - argv[i]);
+        if (key == "int8_dataflow")
+        {
+            int8_dataflow = atoi(eq + 1);
+        }
+        else if (key == "dynamic_quantize")
+        {
+            dynamic_quantize = atoi(eq + 1);
+        }
+        else
+        {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return -1;
+        }
+    }
 
     NetQuantize quantizer;
     quantizer.storage_type = 1; // use fp16 where int8 not applied
@@ -1094,8 +1440,14 @@ int main(int argc, char** argv)
     quantizer.quantize_gemm();
     quantizer.quantize_multiheadattention();
 
+    if (dynamic_quantize)
+        quantizer.quantize_dynamic();
+
     quantizer.fuse_requantize();
 
+    if (int8_dataflow)
+        quantizer.fuse_int8_dataflow();
+
     quantizer.save(outparam, outbin);
 
     return 0;